@@ -217,18 +217,40 @@ static uint8_t *mpy_data_get_buf(mpy_info_t *info) {
     return (uint8_t *)info + sizeof(info->mpy_size) + strlen(info->mpy_name) + 1;
 }
 
+/** Kinds of entries in the program data. */
+typedef enum {
+    /** A MicroPython module in .mpy format. */
+    MPY_DATA_KIND_MODULE,
+    /** A data file, which is any entry that is not a .mpy file. */
+    MPY_DATA_KIND_FILE,
+} mpy_data_kind_t;
+
 /**
- * Finds a MicroPython module in the program data.
- * @param [in]  name    The fully qualified name of the module.
- * @return              A pointer to the .mpy file in user RAM or NULL if the
- *                      module was not found.
+ * Gets the kind of a script or data file in the program data.
+ * @param [in]  info    A pointer to an mpy info header.
+ * @return              The kind of entry.
  */
-static mpy_info_t *mpy_data_find(qstr name) {
-    const char *name_str = qstr_str(name);
+static mpy_data_kind_t mpy_data_get_kind(mpy_info_t *info) {
+    const uint8_t *buf = mpy_data_get_buf(info);
+
+    if (pbio_get_uint32_le(info->mpy_size) >= 2 && buf[0] == 'M' && buf[1] == MPY_VERSION) {
+        return MPY_DATA_KIND_MODULE;
+    }
+
+    return MPY_DATA_KIND_FILE;
+}
 
+/**
+ * Finds a MicroPython module or data file in the program data.
+ * @param [in]  name    The fully qualified name of the module or file.
+ * @param [in]  kind    The kind of entry to find.
+ * @return              A pointer to the info header in user RAM or NULL if the
+ *                      module was not found.
+ */
+static mpy_info_t *mpy_data_find(const char *name, mpy_data_kind_t kind) {
     for (mpy_info_t *info = mpy_first; info < mpy_end;
          info = (mpy_info_t *)(mpy_data_get_buf(info) + pbio_get_uint32_le(info->mpy_size))) {
-        if (strcmp(info->mpy_name, name_str) == 0) {
+        if (strcmp(info->mpy_name, name) == 0 && mpy_data_get_kind(info) == kind) {
             return info;
         }
     }
@@ -236,6 +258,23 @@ static mpy_info_t *mpy_data_find(qstr name) {
     return NULL;
 }
 
+/**
+ * Gets a data file that was downloaded along with the program. The data is
+ * not copied, so it can be used directly until the program ends.
+ * @param [in]  name    The name of the file.
+ * @param [out] size    The size of the file.
+ * @return              A pointer to the file data in user RAM or NULL if the
+ *                      file was not found.
+ */
+const uint8_t *pb_user_program_get_data(const char *name, size_t *size) {
+    mpy_info_t *info = mpy_data_find(name, MPY_DATA_KIND_FILE);
+    if (!info) {
+        return NULL;
+    }
+    *size = pbio_get_uint32_le(info->mpy_size);
+    return mpy_data_get_buf(info);
+}
+
 /**
  * Runs the __main__ module from user RAM.
  */
@@ -248,7 +287,7 @@ static void run_user_program(void) {
     if (nlr_push(&nlr) == 0) {
         nlr_set_abort(&nlr);
 
-        mpy_info_t *info = mpy_data_find(MP_QSTR___main__);
+        mpy_info_t *info = mpy_data_find("__main__", MPY_DATA_KIND_MODULE);
 
         if (!info) {
             mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("no __main__ module"));
@@ -432,7 +471,7 @@ mp_obj_t pb_builtin_import(size_t n_args, const mp_obj_t *args) {
     }
 
     // Check for presence of user program in user RAM.
-    mpy_info_t *info = mpy_data_find(module_name_qstr);
+    mpy_info_t *info = mpy_data_find(qstr_str(module_name_qstr), MPY_DATA_KIND_MODULE);
 
     // If a downloaded module was found but not yet loaded, load it.
     if (info) {
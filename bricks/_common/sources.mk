@@ -61,6 +61,7 @@ PYBRICKS_PYBRICKS_SRC_C = $(addprefix pybricks/,\
 	iodevices/pb_type_iodevices_i2cdevice.c \
 	iodevices/pb_type_iodevices_lwp3device.c \
 	iodevices/pb_type_iodevices_pupdevice.c \
+	iodevices/pb_type_iodevices_pybricks_hub.c \
 	iodevices/pb_type_iodevices_uartdevice.c \
 	iodevices/pb_type_iodevices_xbox_controller.c \
 	media/pb_module_media.c \
@@ -95,6 +96,8 @@ PYBRICKS_PYBRICKS_SRC_C = $(addprefix pybricks/,\
 	robotics/pb_module_robotics.c \
 	robotics/pb_type_car.c \
 	robotics/pb_type_drivebase.c \
+	robotics/pb_type_motiongroup.c \
+	robotics/pb_type_reflex.c \
 	robotics/pb_type_spikebase.c \
 	tools/pb_module_tools.c \
 	tools/pb_type_awaitable.c \
@@ -154,6 +157,7 @@ PBIO_SRC_C = $(addprefix lib/pbio/,\
 	drv/gpio/gpio_stm32f4.c \
 	drv/gpio/gpio_stm32l4.c \
 	drv/imu/imu_lsm6ds3tr_c_stm32.c \
+	drv/imu/imu_test.c \
 	drv/ioport/ioport_pup.c \
 	drv/ioport/ioport_debug_uart.c \
 	drv/led/led_array_pwm.c \
@@ -195,6 +199,7 @@ PBIO_SRC_C = $(addprefix lib/pbio/,\
 	platform/$(PBIO_PLATFORM)/platform.c \
 	src/angle.c \
 	src/battery.c \
+	src/color/calibration.c \
 	src/color/conversion.c \
 	src/color/util.c \
 	src/control.c \
@@ -212,13 +217,18 @@ PBIO_SRC_C = $(addprefix lib/pbio/,\
 	src/light/light_matrix.c \
 	src/logger.c \
 	src/main.c \
+	src/motion_group.c \
 	src/motor_process.c \
 	src/motor/servo_settings.c \
 	src/observer.c \
 	src/parent.c \
+	src/protocol/broadcast.c \
 	src/protocol/nus.c \
 	src/protocol/pybricks.c \
+	src/reflex.c \
 	src/servo.c \
+	src/sound/adpcm.c \
+	src/sound/sound.c \
 	src/tacho.c \
 	src/task.c \
 	src/trajectory.c \
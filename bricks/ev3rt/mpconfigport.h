@@ -43,6 +43,8 @@
 #define PYBRICKS_PY_PUPDEVICES          (0)
 #define PYBRICKS_PY_ROBOTICS            (0)
 #define PYBRICKS_PY_ROBOTICS_DRIVEBASE_SPIKE (0)
+#define PYBRICKS_PY_ROBOTICS_MOTION_GROUP (0)
+#define PYBRICKS_PY_ROBOTICS_REFLEX (0)
 #define PYBRICKS_PY_TOOLS               (1)
 #define PYBRICKS_PY_TOOLS_HUB_MENU      (0)
 #define PYBRICKS_PY_TOOLS_APP_DATA      (0)
@@ -15,6 +15,7 @@
 // Pybricks modules
 #define PYBRICKS_PY_COMMON                      (1)
 #define PYBRICKS_PY_COMMON_BLE                  (1)
+#define PYBRICKS_PY_COMMON_BLE_FRAGMENTS        (1)
 #define PYBRICKS_PY_COMMON_CHARGER              (1)
 #define PYBRICKS_PY_COMMON_COLOR_LIGHT          (1)
 #define PYBRICKS_PY_COMMON_CONTROL              (1)
@@ -33,6 +34,7 @@
 #define PYBRICKS_PY_HUBS                        (1)
 #define PYBRICKS_PY_IODEVICES                   (1)
 #define PYBRICKS_PY_IODEVICES_XBOX_CONTROLLER   (1)
+#define PYBRICKS_PY_IODEVICES_PYBRICKS_HUB      (1)
 #define PYBRICKS_PY_MEDIA                       (1)
 #define PYBRICKS_PY_MEDIA_EV3DEV                (0)
 #define PYBRICKS_PY_NXTDEVICES                  (0)
@@ -45,6 +47,8 @@
 #define PYBRICKS_PY_ROBOTICS                    (1)
 #define PYBRICKS_PY_ROBOTICS_DRIVEBASE_GYRO     (1)
 #define PYBRICKS_PY_ROBOTICS_DRIVEBASE_SPIKE    (1)
+#define PYBRICKS_PY_ROBOTICS_MOTION_GROUP       (1)
+#define PYBRICKS_PY_ROBOTICS_REFLEX             (1)
 #define PYBRICKS_PY_TOOLS                       (1)
 #define PYBRICKS_PY_TOOLS_HUB_MENU              (1)
 #define PYBRICKS_PY_TOOLS_APP_DATA              (1)
@@ -13,6 +13,7 @@
 // Pybricks modules
 #define PYBRICKS_PY_COMMON                      (1)
 #define PYBRICKS_PY_COMMON_BLE                  (1)
+#define PYBRICKS_PY_COMMON_BLE_FRAGMENTS        (1)
 #define PYBRICKS_PY_COMMON_CHARGER              (0)
 #define PYBRICKS_PY_COMMON_COLOR_LIGHT          (1)
 #define PYBRICKS_PY_COMMON_CONTROL              (1)
@@ -31,6 +32,7 @@
 #define PYBRICKS_PY_HUBS                        (1)
 #define PYBRICKS_PY_IODEVICES                   (1)
 #define PYBRICKS_PY_IODEVICES_XBOX_CONTROLLER   (1)
+#define PYBRICKS_PY_IODEVICES_PYBRICKS_HUB      (1)
 #define PYBRICKS_PY_MEDIA                       (0)
 #define PYBRICKS_PY_MEDIA_EV3DEV                (0)
 #define PYBRICKS_PY_NXTDEVICES                  (0)
@@ -43,6 +45,8 @@
 #define PYBRICKS_PY_ROBOTICS                    (1)
 #define PYBRICKS_PY_ROBOTICS_DRIVEBASE_GYRO     (1)
 #define PYBRICKS_PY_ROBOTICS_DRIVEBASE_SPIKE    (0)
+#define PYBRICKS_PY_ROBOTICS_MOTION_GROUP       (1)
+#define PYBRICKS_PY_ROBOTICS_REFLEX             (1)
 #define PYBRICKS_PY_TOOLS                       (1)
 #define PYBRICKS_PY_TOOLS_HUB_MENU              (0)
 #define PYBRICKS_PY_TOOLS_APP_DATA              (1)
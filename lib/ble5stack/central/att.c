@@ -91,7 +91,12 @@ bStatus_t ATT_ExecuteWriteRsp(uint16_t connHandle) {
 }
 
 bStatus_t ATT_HandleValueNoti(uint16_t connHandle, attHandleValueNoti_t *pNoti) {
-    uint8_t buf[32];
+    // value can be up to the largest negotiated MTU minus the ATT header
+    uint8_t buf[5 + ATT_MAX_MTU_SIZE - 3];
+
+    if (pNoti->len > ATT_MAX_MTU_SIZE - 3) {
+        return bleInvalidRange;
+    }
 
     buf[0] = connHandle & 0xFF;
     buf[1] = (connHandle >> 8) & 0xFF;
@@ -301,6 +301,25 @@ typedef enum {
     LUMP_CMD_VERSION = 0x7,
 } lump_cmd_t;
 
+/**
+ * First payload byte of a ::LUMP_CMD_WRITE message that sets up a mode
+ * combination on Powered Up devices.
+ *
+ * The lower bits give the index of the combination. Each of the remaining
+ * payload bytes selects one value, with the mode in the upper 4 bits and the
+ * index of the value within that mode (the dataset) in the lower 4 bits.
+ *
+ * The device acknowledges the combination by sending the same message back.
+ * From then on, it sends all selected values in one ::LUMP_MSG_TYPE_DATA
+ * message, in the same order, using the mode of the first value.
+ */
+#define LUMP_WRITE_COMBI_SET 0x20
+
+/**
+ * The maximum number of values in a mode combination.
+ */
+#define LUMP_MAX_COMBI_ITEMS 8
+
 /**
  * Mode information message type.
  *
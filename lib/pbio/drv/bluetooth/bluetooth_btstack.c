@@ -16,6 +16,7 @@
 #include <contiki-lib.h>
 
 #include <pbdrv/bluetooth.h>
+#include <pbio/int_math.h>
 #include <pbio/protocol.h>
 #include <pbio/task.h>
 #include <pbio/version.h>
@@ -106,6 +107,27 @@ static const pbdrv_bluetooth_btstack_platform_data_t *pdata = &pbdrv_bluetooth_b
 
 static bool is_broadcasting;
 static bool is_observing;
+
+// Default broadcast interval in milliseconds.
+#define BROADCAST_INTERVAL_DEFAULT (100)
+
+// Broadcast scheduler state.
+static struct {
+    /** Advertising data that is given to BTStack, which doesn't copy it. */
+    uint8_t data[LE_ADVERTISING_DATA_SIZE];
+    /** Advertising data waiting to be sent. */
+    uint8_t pending_data[LE_ADVERTISING_DATA_SIZE];
+    uint8_t pending_size;
+    /** Whether there is data waiting to be sent. */
+    bool pending;
+    /** Advertising interval in units of 0.625 ms. */
+    uint16_t interval;
+    pbdrv_bluetooth_broadcast_stats_t stats;
+    /** Task that sends pending data while broadcasting. */
+    pbio_task_t update_task;
+} broadcast = {
+    .interval = BROADCAST_INTERVAL_DEFAULT * 8 / 5,
+};
 static pbdrv_bluetooth_start_observing_callback_t observe_callback;
 
 // note on baud rate: with a 48MHz clock, 3000000 baud is the highest we can
@@ -133,6 +155,9 @@ static pbio_error_t att_error_to_pbio_error(uint8_t status) {
             return PBIO_ERROR_NO_DEV;
         case ATT_ERROR_TIMEOUT:
             return PBIO_ERROR_TIMEDOUT;
+        case PBIO_PYBRICKS_ERROR_BUSY:
+            // Remote Pybricks hub could not accept the command yet.
+            return PBIO_ERROR_BUSY;
         default:
             return PBIO_ERROR_FAILED;
     }
@@ -712,6 +737,25 @@ bool pbdrv_bluetooth_is_connected(pbdrv_bluetooth_connection_t connection) {
     return false;
 }
 
+uint16_t pbdrv_bluetooth_get_mtu(pbdrv_bluetooth_connection_t connection) {
+    uint16_t mtu = ATT_DEFAULT_MTU;
+
+    if (connection == PBDRV_BLUETOOTH_CONNECTION_PYBRICKS && pybricks_con_handle != HCI_CON_HANDLE_INVALID) {
+        mtu = att_server_get_mtu(pybricks_con_handle);
+    }
+
+    if (connection == PBDRV_BLUETOOTH_CONNECTION_PERIPHERAL && peripheral_singleton.con_handle != HCI_CON_HANDLE_INVALID) {
+        // The MTU exchange is done automatically by the GATT client before
+        // the first query, so this is only meaningful after discovery.
+        if (gatt_client_get_mtu(peripheral_singleton.con_handle, &mtu) != ERROR_CODE_SUCCESS) {
+            mtu = ATT_DEFAULT_MTU;
+        }
+    }
+
+    // Buffers are only sized for the configured maximum.
+    return pbio_int_math_min(mtu, PBDRV_BLUETOOTH_MAX_MTU_SIZE);
+}
+
 void pbdrv_bluetooth_set_on_event(pbdrv_bluetooth_on_event_t on_event) {
     bluetooth_on_event = on_event;
 }
@@ -1019,21 +1063,23 @@ static PT_THREAD(start_broadcasting_task(struct pt *pt, pbio_task_t *task)) {
     }
 
     // have to keep copy of data here since BTStack doesn't copy
-    static uint8_t static_data[LE_ADVERTISING_DATA_SIZE];
-    memcpy(static_data, value->data, value->size);
+    memcpy(broadcast.data, value->data, value->size);
 
-    gap_advertisements_set_data(value->size, static_data);
+    gap_advertisements_set_data(value->size, broadcast.data);
 
     if (!is_broadcasting) {
         bd_addr_t null_addr = { };
-        gap_advertisements_set_params(0xA0, 0xA0, PBDRV_BLUETOOTH_AD_TYPE_ADV_NONCONN_IND, 0, null_addr, 0x7, 0);
+        gap_advertisements_set_params(broadcast.interval, broadcast.interval, PBDRV_BLUETOOTH_AD_TYPE_ADV_NONCONN_IND, 0, null_addr, 0x7, 0);
         gap_advertisements_enable(true);
         is_broadcasting = true;
+        broadcast.stats.submitted = 0;
+        broadcast.stats.replaced = 0;
     }
 
     // Wait advertising enable command to complete.
     PT_WAIT_UNTIL(pt, event_packet && HCI_EVENT_IS_COMMAND_COMPLETE(event_packet, hci_le_set_advertising_data));
 
+    broadcast.stats.submitted++;
     task->status = PBIO_SUCCESS;
 
     PT_END(pt);
@@ -1043,6 +1089,69 @@ void pbdrv_bluetooth_start_broadcasting(pbio_task_t *task, pbdrv_bluetooth_value
     start_task(task, start_broadcasting_task, value);
 }
 
+static PT_THREAD(update_broadcasting_task(struct pt *pt, pbio_task_t *task)) {
+    PT_BEGIN(pt);
+
+    // Keep sending until there is no newer data. Data that arrives while
+    // waiting replaces any older pending data.
+    while (broadcast.pending && is_broadcasting) {
+        memcpy(broadcast.data, broadcast.pending_data, broadcast.pending_size);
+        broadcast.pending = false;
+
+        gap_advertisements_set_data(broadcast.pending_size, broadcast.data);
+        PT_WAIT_UNTIL(pt, event_packet && HCI_EVENT_IS_COMMAND_COMPLETE(event_packet, hci_le_set_advertising_data));
+
+        broadcast.stats.submitted++;
+    }
+
+    broadcast.pending = false;
+    task->status = PBIO_SUCCESS;
+
+    PT_END(pt);
+}
+
+pbio_error_t pbdrv_bluetooth_update_broadcasting(const pbdrv_bluetooth_value_t *value) {
+    if (!is_broadcasting) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    if (value->size > LE_ADVERTISING_DATA_SIZE) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    if (broadcast.pending) {
+        broadcast.stats.replaced++;
+    }
+
+    memcpy(broadcast.pending_data, value->data, value->size);
+    broadcast.pending_size = value->size;
+    broadcast.pending = true;
+
+    if (broadcast.update_task.status != PBIO_ERROR_AGAIN) {
+        start_task(&broadcast.update_task, update_broadcasting_task, NULL);
+    }
+
+    return PBIO_SUCCESS;
+}
+
+pbio_error_t pbdrv_bluetooth_set_broadcast_interval(uint32_t interval) {
+    if (interval == 0) {
+        interval = BROADCAST_INTERVAL_DEFAULT;
+    }
+
+    if (interval < PBDRV_BLUETOOTH_BROADCAST_INTERVAL_MIN || interval > PBDRV_BLUETOOTH_BROADCAST_INTERVAL_MAX) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Convert to units of 0.625 ms.
+    broadcast.interval = interval * 8 / 5;
+    return PBIO_SUCCESS;
+}
+
+void pbdrv_bluetooth_get_broadcast_stats(pbdrv_bluetooth_broadcast_stats_t *stats) {
+    *stats = broadcast.stats;
+}
+
 static PT_THREAD(stop_broadcasting_task(struct pt *pt, pbio_task_t *task)) {
     PT_BEGIN(pt);
 
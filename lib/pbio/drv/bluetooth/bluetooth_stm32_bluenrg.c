@@ -104,6 +104,18 @@ static bool is_broadcasting;
 static bool is_observing;
 static pbdrv_bluetooth_start_observing_callback_t observe_callback;
 
+// Broadcast scheduler state.
+static struct {
+    /** Advertising data waiting to be sent. */
+    uint8_t pending_data[MAX_ADV_DATA_LEN];
+    uint8_t pending_size;
+    /** Whether there is data waiting to be sent. */
+    bool pending;
+    pbdrv_bluetooth_broadcast_stats_t stats;
+    /** Task that sends pending data while broadcasting. */
+    pbio_task_t update_task;
+} broadcast;
+
 // Pybricks GATT service handles
 static uint16_t pybricks_service_handle;
 static uint16_t pybricks_command_event_char_handle;
@@ -353,6 +365,11 @@ bool pbdrv_bluetooth_is_connected(pbdrv_bluetooth_connection_t connection) {
     return false;
 }
 
+uint16_t pbdrv_bluetooth_get_mtu(pbdrv_bluetooth_connection_t connection) {
+    // MTU exchange is not supported on this chip.
+    return ATT_MTU;
+}
+
 void pbdrv_bluetooth_set_on_event(pbdrv_bluetooth_on_event_t on_event) {
     bluetooth_on_event = on_event;
 }
@@ -789,6 +806,8 @@ static PT_THREAD(broadcast_task(struct pt *pt, pbio_task_t *task)) {
         // if the AD does not exist, which is OK.
 
         is_broadcasting = true;
+        broadcast.stats.submitted = 0;
+        broadcast.stats.replaced = 0;
     }
 
     // This has to be done _after_ other data is delete to make sure it fits.
@@ -803,6 +822,7 @@ static PT_THREAD(broadcast_task(struct pt *pt, pbio_task_t *task)) {
         PT_EXIT(pt);
     }
 
+    broadcast.stats.submitted++;
     task->status = PBIO_SUCCESS;
 
     PT_END(pt);
@@ -812,6 +832,63 @@ void pbdrv_bluetooth_start_broadcasting(pbio_task_t *task, pbdrv_bluetooth_value
     start_task(task, broadcast_task, value);
 }
 
+static PT_THREAD(update_broadcast_task(struct pt *pt, pbio_task_t *task)) {
+    PT_BEGIN(pt);
+
+    // Keep sending until there is no newer data. Data that arrives while
+    // waiting replaces any older pending data.
+    while (broadcast.pending && is_broadcasting) {
+        PT_WAIT_WHILE(pt, write_xfer_size);
+        // The data is copied into the command, so it may change after this.
+        aci_gap_update_adv_data_begin(broadcast.pending_size, broadcast.pending_data);
+        broadcast.pending = false;
+        PT_WAIT_UNTIL(pt, hci_command_complete);
+
+        if (aci_gap_update_adv_data_end() == BLE_STATUS_SUCCESS) {
+            broadcast.stats.submitted++;
+        }
+    }
+
+    broadcast.pending = false;
+    task->status = PBIO_SUCCESS;
+
+    PT_END(pt);
+}
+
+pbio_error_t pbdrv_bluetooth_update_broadcasting(const pbdrv_bluetooth_value_t *value) {
+    if (!is_broadcasting) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    if (value->size > MAX_ADV_DATA_LEN) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    if (broadcast.pending) {
+        broadcast.stats.replaced++;
+    }
+
+    memcpy(broadcast.pending_data, value->data, value->size);
+    broadcast.pending_size = value->size;
+    broadcast.pending = true;
+
+    if (broadcast.update_task.status != PBIO_ERROR_AGAIN) {
+        start_task(&broadcast.update_task, update_broadcast_task, NULL);
+    }
+
+    return PBIO_SUCCESS;
+}
+
+pbio_error_t pbdrv_bluetooth_set_broadcast_interval(uint32_t interval) {
+    // The non-connectable advertising command of this chip has no interval
+    // parameter, so only the default is supported.
+    return interval == 0 ? PBIO_SUCCESS : PBIO_ERROR_NOT_SUPPORTED;
+}
+
+void pbdrv_bluetooth_get_broadcast_stats(pbdrv_bluetooth_broadcast_stats_t *stats) {
+    *stats = broadcast.stats;
+}
+
 static PT_THREAD(stop_broadcast_task(struct pt *pt, pbio_task_t *task)) {
     PT_BEGIN(pt);
 
@@ -1492,6 +1569,7 @@ PROCESS_THREAD(pbdrv_bluetooth_spi_process, ev, data) {
         spi_disable_cs();
         bluetooth_reset(true);
         bluetooth_ready = pybricks_notify_en = uart_tx_notify_en = is_broadcasting = is_observing = false;
+        broadcast.pending = false;
         conn_handle = peripheral_singleton.con_handle = 0;
 
         pbio_task_t *task;
@@ -43,6 +43,10 @@
 
 #include "./bluetooth_stm32_cc2640.h"
 
+#if PBDRV_BLUETOOTH_MAX_MTU_SIZE > ATT_MAX_MTU_SIZE
+#error PBDRV_CONFIG_BLUETOOTH_MAX_MTU_SIZE is larger than ATT_HandleValueNoti() can send
+#endif
+
 #define DEBUG_LL (0x01)
 #define DEBUG_PT (0x02)
 
@@ -117,6 +121,35 @@ static bool is_broadcasting;
 static bool is_observing;
 static pbdrv_bluetooth_start_observing_callback_t observe_callback;
 
+// Default advertising interval in units of 0.625 ms.
+#define ADV_INTERVAL_DEFAULT (40)
+
+// Broadcast scheduler state.
+static struct {
+    /** Advertising data waiting to be sent. */
+    uint8_t pending_data[B_MAX_ADV_LEN];
+    uint8_t pending_size;
+    /** Whether there is data waiting to be sent. */
+    bool pending;
+    /** Advertising interval in units of 0.625 ms. */
+    uint16_t interval;
+    /** Whether the Bluetooth chip is using an interval other than the default. */
+    bool interval_changed;
+    pbdrv_bluetooth_broadcast_stats_t stats;
+    /** Task that sends pending data while broadcasting. */
+    pbio_task_t update_task;
+} broadcast = {
+    .interval = ADV_INTERVAL_DEFAULT,
+};
+
+// Parameters that set the advertising interval.
+static const uint8_t adv_interval_params[] = {
+    TGAP_GEN_DISC_ADV_INT_MIN,
+    TGAP_GEN_DISC_ADV_INT_MAX,
+    TGAP_CONN_ADV_INT_MIN,
+    TGAP_CONN_ADV_INT_MAX,
+};
+
 // set to the pending hci command opcode when a command is sent
 static uint16_t hci_command_opcode;
 // set to false when hci command is started and true when command status is received
@@ -415,6 +448,15 @@ bool pbdrv_bluetooth_is_connected(pbdrv_bluetooth_connection_t connection) {
     return false;
 }
 
+uint16_t pbdrv_bluetooth_get_mtu(pbdrv_bluetooth_connection_t connection) {
+    if (connection == PBDRV_BLUETOOTH_CONNECTION_PYBRICKS && pybricks_notify_en) {
+        return conn_mtu;
+    }
+
+    // REVISIT: MTU exchange is not implemented for peripheral connections.
+    return ATT_MTU_SIZE;
+}
+
 void pbdrv_bluetooth_set_on_event(pbdrv_bluetooth_on_event_t on_event) {
     bluetooth_on_event = on_event;
 }
@@ -1035,7 +1077,8 @@ retry:
             if (event == ATT_EVENT_ERROR_RSP && payload[0] == ATT_WRITE_REQ
                 && pbio_get_uint16_le(&payload[1]) == pbio_get_uint16_le(value->handle)) {
 
-                task->status = PBIO_ERROR_FAILED;
+                // Remote Pybricks hub could not accept the command yet.
+                task->status = payload[3] == PBIO_PYBRICKS_ERROR_BUSY ? PBIO_ERROR_BUSY : PBIO_ERROR_FAILED;
                 PT_EXIT(pt);
             }
 
@@ -1100,6 +1143,18 @@ static PT_THREAD(broadcast_task(struct pt *pt, pbio_task_t *task)) {
     PT_WAIT_UNTIL(pt, hci_command_complete);
 
     if (!is_broadcasting) {
+        static uint8_t i;
+
+        if (broadcast.interval != ADV_INTERVAL_DEFAULT) {
+            broadcast.interval_changed = true;
+            for (i = 0; i < PBIO_ARRAY_SIZE(adv_interval_params); i++) {
+                PT_WAIT_WHILE(pt, write_xfer_size);
+                GAP_SetParamValue(adv_interval_params[i], broadcast.interval);
+                PT_WAIT_UNTIL(pt, hci_command_status);
+                // ignoring response data
+            }
+        }
+
         PT_WAIT_WHILE(pt, write_xfer_size);
         GAP_makeDiscoverable(
             ADV_IND,
@@ -1116,8 +1171,11 @@ static PT_THREAD(broadcast_task(struct pt *pt, pbio_task_t *task)) {
         PT_WAIT_UNTIL(pt, hci_command_complete);
 
         is_broadcasting = true;
+        broadcast.stats.submitted = 0;
+        broadcast.stats.replaced = 0;
     }
 
+    broadcast.stats.submitted++;
     task->status = PBIO_SUCCESS;
 
     PT_END(pt);
@@ -1127,6 +1185,70 @@ void pbdrv_bluetooth_start_broadcasting(pbio_task_t *task, pbdrv_bluetooth_value
     start_task(task, broadcast_task, value);
 }
 
+static PT_THREAD(update_broadcast_task(struct pt *pt, pbio_task_t *task)) {
+    PT_BEGIN(pt);
+
+    // Keep sending until there is no newer data. Data that arrives while
+    // waiting replaces any older pending data.
+    while (broadcast.pending && is_broadcasting) {
+        PT_WAIT_WHILE(pt, write_xfer_size);
+        // The data is copied into the command, so it may change after this.
+        HCI_LE_setAdvertisingData(broadcast.pending_size, broadcast.pending_data);
+        broadcast.pending = false;
+        PT_WAIT_UNTIL(pt, hci_command_complete);
+
+        broadcast.stats.submitted++;
+    }
+
+    broadcast.pending = false;
+    task->status = PBIO_SUCCESS;
+
+    PT_END(pt);
+}
+
+pbio_error_t pbdrv_bluetooth_update_broadcasting(const pbdrv_bluetooth_value_t *value) {
+    if (!is_broadcasting) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    if (value->size > B_MAX_ADV_LEN) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    if (broadcast.pending) {
+        broadcast.stats.replaced++;
+    }
+
+    memcpy(broadcast.pending_data, value->data, value->size);
+    broadcast.pending_size = value->size;
+    broadcast.pending = true;
+
+    if (broadcast.update_task.status != PBIO_ERROR_AGAIN) {
+        start_task(&broadcast.update_task, update_broadcast_task, NULL);
+    }
+
+    return PBIO_SUCCESS;
+}
+
+pbio_error_t pbdrv_bluetooth_set_broadcast_interval(uint32_t interval) {
+    if (interval == 0) {
+        broadcast.interval = ADV_INTERVAL_DEFAULT;
+        return PBIO_SUCCESS;
+    }
+
+    if (interval < PBDRV_BLUETOOTH_BROADCAST_INTERVAL_MIN || interval > PBDRV_BLUETOOTH_BROADCAST_INTERVAL_MAX) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Convert to units of 0.625 ms.
+    broadcast.interval = interval * 8 / 5;
+    return PBIO_SUCCESS;
+}
+
+void pbdrv_bluetooth_get_broadcast_stats(pbdrv_bluetooth_broadcast_stats_t *stats) {
+    *stats = broadcast.stats;
+}
+
 static PT_THREAD(stop_broadcast_task(struct pt *pt, pbio_task_t *task)) {
     PT_BEGIN(pt);
 
@@ -1145,6 +1267,18 @@ static PT_THREAD(stop_broadcast_task(struct pt *pt, pbio_task_t *task)) {
         // This is not expected, but should be safe to ignore.
 
         is_broadcasting = false;
+
+        // Restore the interval used for advertising to connect.
+        if (broadcast.interval_changed) {
+            static uint8_t i;
+            broadcast.interval_changed = false;
+            for (i = 0; i < PBIO_ARRAY_SIZE(adv_interval_params); i++) {
+                PT_WAIT_WHILE(pt, write_xfer_size);
+                GAP_SetParamValue(adv_interval_params[i], ADV_INTERVAL_DEFAULT);
+                PT_WAIT_UNTIL(pt, hci_command_status);
+                // ignoring response data
+            }
+        }
     }
 
     task->status = PBIO_SUCCESS;
@@ -1926,22 +2060,22 @@ static PT_THREAD(gap_init(struct pt *pt)) {
     // ignoring response data
 
     PT_WAIT_WHILE(pt, write_xfer_size);
-    GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MIN, 40);
+    GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MIN, ADV_INTERVAL_DEFAULT);
     PT_WAIT_UNTIL(pt, hci_command_status);
     // ignoring response data
 
     PT_WAIT_WHILE(pt, write_xfer_size);
-    GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MAX, 40);
+    GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MAX, ADV_INTERVAL_DEFAULT);
     PT_WAIT_UNTIL(pt, hci_command_status);
     // ignoring response data
 
     PT_WAIT_WHILE(pt, write_xfer_size);
-    GAP_SetParamValue(TGAP_CONN_ADV_INT_MIN, 40);
+    GAP_SetParamValue(TGAP_CONN_ADV_INT_MIN, ADV_INTERVAL_DEFAULT);
     PT_WAIT_UNTIL(pt, hci_command_status);
     // ignoring response data
 
     PT_WAIT_WHILE(pt, write_xfer_size);
-    GAP_SetParamValue(TGAP_CONN_ADV_INT_MAX, 40);
+    GAP_SetParamValue(TGAP_CONN_ADV_INT_MAX, ADV_INTERVAL_DEFAULT);
     PT_WAIT_UNTIL(pt, hci_command_status);
     // ignoring response data
 
@@ -2261,6 +2395,7 @@ PROCESS_THREAD(pbdrv_bluetooth_spi_process, ev, data) {
         bluetooth_reset(RESET_STATE_OUT_LOW);
         bluetooth_ready = pybricks_notify_en = uart_tx_notify_en =
             is_broadcasting = is_observing = observe_restart_enabled = false;
+        broadcast.pending = broadcast.interval_changed = false;
         conn_handle = peripheral_singleton.con_handle = NO_CONNECTION;
 
         pbio_task_t *task;
@@ -27,6 +27,21 @@
 #include "../core.h"
 #include "./imu_lsm6ds3tr_c_stm32.h"
 
+#if PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_FIFO_FRAMES
+/**
+ * Maximum number of frames read from the FIFO at once. This is more than the
+ * watermark so the driver catches up if it was delayed.
+ */
+#define LSM6DS3TR_MAX_FRAMES (PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_FIFO_FRAMES * 2)
+
+/**
+ * Number of words in the FIFO at which INT1 is raised.
+ */
+#define LSM6DS3TR_FIFO_WATERMARK (PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_FIFO_FRAMES * 6)
+#else
+#define LSM6DS3TR_MAX_FRAMES (1)
+#endif
+
 typedef enum {
     /** Initialization is not complete yet. */
     IMU_INIT_STATE_BUSY,
@@ -47,8 +62,8 @@ struct _pbdrv_imu_dev_t {
     pbdrv_imu_handle_frame_data_func_t handle_frame_data;
     /* Callback to process unfiltered gyro and accelerometer data recorded while stationary. */
     pbdrv_imu_handle_stationary_data_func_t handle_stationary_data;
-    /** Raw data. */
-    int16_t data[6];
+    /** Raw data, one frame per sample. */
+    int16_t data[LSM6DS3TR_MAX_FRAMES * 6];
     /** Start time of window in which stationary samples are recorded (us)*/
     uint32_t stationary_time_start;
     /** Raw data point to which new samples are compared to detect stationary. */
@@ -61,20 +76,30 @@ struct _pbdrv_imu_dev_t {
     uint32_t stationary_sample_count;
     /** Whether it is currently stationary, to be polled by higher level APIs. */
     bool stationary_now;
+    /** Most recent temperature reading in degrees Celsius. */
+    float temperature;
+    /** Time of the most recent temperature reading (ms). */
+    uint32_t temperature_time;
     /** Initialization state. */
     imu_init_state_t init_state;
+    /** Result of starting the most recent register read or write. */
+    HAL_StatusTypeDef transfer_status;
     /** INT1 oneshot. */
     volatile bool int1;
 };
 
-/** The size of the data field in pbdrv_imu_dev_t in bytes. */
-#define NUM_DATA_BYTES sizeof(((struct _pbdrv_imu_dev_t *)0)->data)
+/** The size of one frame of gyro and accel data in bytes. */
+#define NUM_FRAME_BYTES (6 * sizeof(int16_t))
 
 /** All data rate dependent values should be defined here so it is clear
  *  what needs to be changed when the data rate is changed. */
 #define LSM6DS3TR_INITIAL_DATA_RATE (833)
 #define LSM6DS3TR_GYRO_DATA_RATE (LSM6DS3TR_C_GY_ODR_833Hz)
 #define LSM6DS3TR_ACCL_DATA_RATE (LSM6DS3TR_C_XL_ODR_833Hz)
+#define LSM6DS3TR_FIFO_DATA_RATE (LSM6DS3TR_C_FIFO_833Hz)
+
+/** Time between temperature readings (ms). */
+#define LSM6DS3TR_TEMPERATURE_INTERVAL (1000)
 
 static pbdrv_imu_dev_t global_imu_dev;
 PROCESS(pbdrv_imu_lsm6ds3tr_c_stm32_process, "LSM6DS3TR-C");
@@ -138,6 +163,7 @@ static void pbdrv_imu_lsm6ds3tr_c_stm32_i2c_reset(I2C_HandleTypeDef *hi2c) {
 
 static void pbdrv_imu_lsm6ds3tr_c_stm32_write_reg(void *handle, uint8_t reg, uint8_t *data, uint16_t len) {
     HAL_StatusTypeDef ret = HAL_I2C_Mem_Write_IT(&global_imu_dev.hi2c, LSM6DS3TR_C_I2C_ADD_L, reg, I2C_MEMADD_SIZE_8BIT, data, len);
+    global_imu_dev.transfer_status = ret;
 
     if (ret != HAL_OK) {
         // If there was an error, the interrupt will never come so we have to set the flag here.
@@ -147,6 +173,7 @@ static void pbdrv_imu_lsm6ds3tr_c_stm32_write_reg(void *handle, uint8_t reg, uin
 
 static void pbdrv_imu_lsm6ds3tr_c_stm32_read_reg(void *handle, uint8_t reg, uint8_t *data, uint16_t len) {
     HAL_StatusTypeDef ret = HAL_I2C_Mem_Read_IT(&global_imu_dev.hi2c, LSM6DS3TR_C_I2C_ADD_L, reg, I2C_MEMADD_SIZE_8BIT, data, len);
+    global_imu_dev.transfer_status = ret;
 
     if (ret != HAL_OK) {
         // If there was an error, the interrupt will never come so we have to set the flag here.
@@ -154,6 +181,16 @@ static void pbdrv_imu_lsm6ds3tr_c_stm32_read_reg(void *handle, uint8_t reg, uint
     }
 }
 
+/**
+ * Checks if the most recent register read or write failed.
+ *
+ * This includes transfers that could not be started, such as when the
+ * peripheral was still busy, which leave the data buffer unchanged.
+ */
+static bool pbdrv_imu_lsm6ds3tr_c_stm32_transfer_failed(pbdrv_imu_dev_t *imu_dev) {
+    return imu_dev->transfer_status != HAL_OK || HAL_I2C_GetError(&imu_dev->hi2c) != HAL_I2C_ERROR_NONE;
+}
+
 static PT_THREAD(pbdrv_imu_lsm6ds3tr_c_stm32_init(struct pt *pt)) {
     const pbdrv_imu_lsm6s3tr_c_stm32_platform_data_t *pdata = &pbdrv_imu_lsm6s3tr_c_stm32_platform_data;
     pbdrv_imu_dev_t *imu_dev = &global_imu_dev;
@@ -163,6 +200,7 @@ static PT_THREAD(pbdrv_imu_lsm6ds3tr_c_stm32_init(struct pt *pt)) {
     static struct pt child;
     static uint8_t id;
     static uint8_t rst;
+    static int16_t temperature;
 
     PT_BEGIN(pt);
 
@@ -233,6 +271,20 @@ static PT_THREAD(pbdrv_imu_lsm6ds3tr_c_stm32_init(struct pt *pt)) {
     imu_dev->config.gyro_stationary_threshold = 0;
     imu_dev->config.accel_stationary_threshold = 0;
 
+    #if PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_FIFO_FRAMES
+    // Store gyro and accel samples in the FIFO, in that order, so that each
+    // frame is six consecutive words. The watermark is given in words.
+    PT_SPAWN(pt, &child, lsm6ds3tr_c_fifo_gy_batch_set(&child, ctx, LSM6DS3TR_C_FIFO_GY_NO_DEC));
+    PT_SPAWN(pt, &child, lsm6ds3tr_c_fifo_xl_batch_set(&child, ctx, LSM6DS3TR_C_FIFO_XL_NO_DEC));
+    PT_SPAWN(pt, &child, lsm6ds3tr_c_fifo_watermark_set(&child, ctx, LSM6DS3TR_FIFO_WATERMARK));
+    PT_SPAWN(pt, &child, lsm6ds3tr_c_fifo_data_rate_set(&child, ctx, LSM6DS3TR_FIFO_DATA_RATE));
+    PT_SPAWN(pt, &child, lsm6ds3tr_c_fifo_mode_set(&child, ctx, LSM6DS3TR_C_STREAM_MODE));
+
+    // Configure INT1 to trigger when the FIFO reaches the watermark.
+    PT_SPAWN(pt, &child, lsm6ds3tr_c_pin_int1_route_set(&child, ctx, (lsm6ds3tr_c_int1_route_t) {
+        .int1_fth = 1,
+    }));
+    #else
     // Configure INT1 to trigger when new gyro data is ready.
     PT_SPAWN(pt, &child, lsm6ds3tr_c_pin_int1_route_set(&child, ctx, (lsm6ds3tr_c_int1_route_t) {
         .int1_drdy_g = 1,
@@ -240,10 +292,16 @@ static PT_THREAD(pbdrv_imu_lsm6ds3tr_c_stm32_init(struct pt *pt)) {
 
     // If we leave the default latched mode, sometimes we don't get the INT1 interrupt.
     PT_SPAWN(pt, &child, lsm6ds3tr_c_data_ready_mode_set(&child, ctx, LSM6DS3TR_C_DRDY_PULSED));
+    #endif
 
     // Enable rounding mode so we can get gyro + accel in continuous reads.
     PT_SPAWN(pt, &child, lsm6ds3tr_c_rounding_mode_set(&child, ctx, LSM6DS3TR_C_ROUND_GY_XL));
 
+    // Get initial temperature so bias compensation can be used right away.
+    PT_SPAWN(pt, &child, lsm6ds3tr_c_temperature_raw_get(&child, ctx, (uint8_t *)&temperature));
+    imu_dev->temperature = lsm6ds3tr_c_from_lsb_to_celsius(temperature);
+    imu_dev->temperature_time = pbdrv_clock_get_ms();
+
     if (HAL_I2C_GetError(hi2c) != HAL_I2C_ERROR_NONE) {
         imu_dev->init_state = IMU_INIT_STATE_FAILED;
         PT_EXIT(pt);
@@ -258,40 +316,47 @@ static inline bool is_bounded(int16_t diff, int16_t threshold) {
     return diff < threshold && diff > -threshold;
 }
 
-static void pbdrv_imu_lsm6ds3tr_c_stm32_reset_stationary_buffer(pbdrv_imu_dev_t *imu_dev) {
+static void pbdrv_imu_lsm6ds3tr_c_stm32_reset_stationary_buffer(pbdrv_imu_dev_t *imu_dev, uint32_t time) {
     imu_dev->stationary_sample_count = 0;
-    imu_dev->stationary_time_start = pbdrv_clock_get_us();
+    imu_dev->stationary_time_start = time;
     memset(&imu_dev->stationary_accel_data_sum, 0, sizeof(imu_dev->stationary_accel_data_sum));
     memset(&imu_dev->stationary_gyro_data_sum, 0, sizeof(imu_dev->stationary_gyro_data_sum));
 }
 
-static void pbdrv_imu_lsm6ds3tr_c_stm32_update_stationary_status(pbdrv_imu_dev_t *imu_dev) {
+/**
+ * Updates the stationary status with one frame of data.
+ *
+ * @param [in]  imu_dev     The IMU device instance.
+ * @param [in]  data        The frame of gyro (xyz) and accel (xyz) data.
+ * @param [in]  time        Time at which the frame was sampled (us).
+ */
+static void pbdrv_imu_lsm6ds3tr_c_stm32_update_stationary_status(pbdrv_imu_dev_t *imu_dev, const int16_t *data, uint32_t time) {
 
     // Check whether still stationary compared to constant start sample.
-    if (!is_bounded(imu_dev->data[0] - imu_dev->stationary_data_start[0], imu_dev->config.gyro_stationary_threshold) ||
-        !is_bounded(imu_dev->data[1] - imu_dev->stationary_data_start[1], imu_dev->config.gyro_stationary_threshold) ||
-        !is_bounded(imu_dev->data[2] - imu_dev->stationary_data_start[2], imu_dev->config.gyro_stationary_threshold) ||
-        !is_bounded(imu_dev->data[3] - imu_dev->stationary_data_start[3], imu_dev->config.accel_stationary_threshold) ||
-        !is_bounded(imu_dev->data[4] - imu_dev->stationary_data_start[4], imu_dev->config.accel_stationary_threshold) ||
-        !is_bounded(imu_dev->data[5] - imu_dev->stationary_data_start[5], imu_dev->config.accel_stationary_threshold)
+    if (!is_bounded(data[0] - imu_dev->stationary_data_start[0], imu_dev->config.gyro_stationary_threshold) ||
+        !is_bounded(data[1] - imu_dev->stationary_data_start[1], imu_dev->config.gyro_stationary_threshold) ||
+        !is_bounded(data[2] - imu_dev->stationary_data_start[2], imu_dev->config.gyro_stationary_threshold) ||
+        !is_bounded(data[3] - imu_dev->stationary_data_start[3], imu_dev->config.accel_stationary_threshold) ||
+        !is_bounded(data[4] - imu_dev->stationary_data_start[4], imu_dev->config.accel_stationary_threshold) ||
+        !is_bounded(data[5] - imu_dev->stationary_data_start[5], imu_dev->config.accel_stationary_threshold)
         ) {
         // Not stationary anymore, so reset counter and gyro sum data so we can start over.
         imu_dev->stationary_now = false;
-        pbdrv_imu_lsm6ds3tr_c_stm32_reset_stationary_buffer(imu_dev);
+        pbdrv_imu_lsm6ds3tr_c_stm32_reset_stationary_buffer(imu_dev, time);
 
         // Current sample becomes new starting value to compare to.
-        memcpy(&imu_dev->stationary_data_start[0], &imu_dev->data[0], NUM_DATA_BYTES);
+        memcpy(&imu_dev->stationary_data_start[0], data, NUM_FRAME_BYTES);
         return;
     }
 
     // Updating running sum of stationary data.
     imu_dev->stationary_sample_count++;
-    imu_dev->stationary_gyro_data_sum[0] += imu_dev->data[0];
-    imu_dev->stationary_gyro_data_sum[1] += imu_dev->data[1];
-    imu_dev->stationary_gyro_data_sum[2] += imu_dev->data[2];
-    imu_dev->stationary_accel_data_sum[0] += imu_dev->data[3];
-    imu_dev->stationary_accel_data_sum[1] += imu_dev->data[4];
-    imu_dev->stationary_accel_data_sum[2] += imu_dev->data[5];
+    imu_dev->stationary_gyro_data_sum[0] += data[0];
+    imu_dev->stationary_gyro_data_sum[1] += data[1];
+    imu_dev->stationary_gyro_data_sum[2] += data[2];
+    imu_dev->stationary_accel_data_sum[0] += data[3];
+    imu_dev->stationary_accel_data_sum[1] += data[4];
+    imu_dev->stationary_accel_data_sum[2] += data[5];
 
     // Exit if we don't have enough samples yet.
     if (imu_dev->stationary_sample_count < LSM6DS3TR_INITIAL_DATA_RATE) {
@@ -302,7 +367,7 @@ static void pbdrv_imu_lsm6ds3tr_c_stm32_update_stationary_status(pbdrv_imu_dev_t
     imu_dev->stationary_now = true;
 
     // The actual sampling rate is slightly different from the configured rate, so measure it.
-    imu_dev->config.sample_time = (pbdrv_clock_get_us() - imu_dev->stationary_time_start) / 1000000.0f / imu_dev->stationary_sample_count;
+    imu_dev->config.sample_time = (time - imu_dev->stationary_time_start) / 1000000.0f / imu_dev->stationary_sample_count;
 
     // Process the data recorded while stationary.
     if (imu_dev->handle_stationary_data) {
@@ -310,15 +375,169 @@ static void pbdrv_imu_lsm6ds3tr_c_stm32_update_stationary_status(pbdrv_imu_dev_t
     }
 
     // Reset counter and gyro sum data so we can start over.
-    pbdrv_imu_lsm6ds3tr_c_stm32_reset_stationary_buffer(imu_dev);
+    pbdrv_imu_lsm6ds3tr_c_stm32_reset_stationary_buffer(imu_dev, time);
+}
+
+/**
+ * Processes consecutive frames of data that were just read.
+ *
+ * @param [in]  imu_dev     The IMU device instance.
+ * @param [in]  num_frames  Number of frames in the data buffer.
+ * @param [in]  time        Time at which the last frame was sampled (us).
+ */
+static void pbdrv_imu_lsm6ds3tr_c_stm32_process_frames(pbdrv_imu_dev_t *imu_dev, uint32_t num_frames, uint32_t time) {
+
+    for (uint32_t n = 0; n < num_frames; n++) {
+        int16_t *frame = &imu_dev->data[n * 6];
+
+        // Account for mounting orientation in hub. Any other tranformations
+        // are applied at the higher level in pbio.
+        frame[0] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_X;
+        frame[1] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_Y;
+        frame[2] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_Z;
+        frame[3] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_X;
+        frame[4] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_Y;
+        frame[5] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_Z;
+
+        // Older frames in the batch were sampled earlier.
+        uint32_t frame_time = time - (uint32_t)((num_frames - 1 - n) * imu_dev->config.sample_time * 1000000.0f);
+        pbdrv_imu_lsm6ds3tr_c_stm32_update_stationary_status(imu_dev, frame, frame_time);
+    }
+
+    if (imu_dev->handle_frame_data) {
+        imu_dev->handle_frame_data(imu_dev->data, num_frames, time);
+    }
+}
+
+/**
+ * Reads the temperature sensor.
+ *
+ * This should only be started while no other I2C transfer is in progress.
+ */
+static PT_THREAD(pbdrv_imu_lsm6ds3tr_c_stm32_read_temperature(struct pt *pt, pbdrv_imu_dev_t *imu_dev)) {
+
+    static int16_t temperature;
+
+    PT_BEGIN(pt);
+
+    imu_dev->ctx.read_write_done = false;
+    pbdrv_imu_lsm6ds3tr_c_stm32_read_reg(NULL, LSM6DS3TR_C_OUT_TEMP_L, (uint8_t *)&temperature, sizeof(temperature));
+    PT_WAIT_UNTIL(pt, imu_dev->ctx.read_write_done);
+
+    imu_dev->temperature_time = pbdrv_clock_get_ms();
+
+    if (pbdrv_imu_lsm6ds3tr_c_stm32_transfer_failed(imu_dev)) {
+        pbdrv_imu_lsm6ds3tr_c_stm32_i2c_reset(&imu_dev->hi2c);
+        PT_EXIT(pt);
+    }
+
+    imu_dev->temperature = lsm6ds3tr_c_from_lsb_to_celsius(temperature);
+
+    PT_END(pt);
+}
+
+static bool pbdrv_imu_lsm6ds3tr_c_stm32_temperature_expired(pbdrv_imu_dev_t *imu_dev) {
+    return pbdrv_clock_get_ms() - imu_dev->temperature_time >= LSM6DS3TR_TEMPERATURE_INTERVAL;
+}
+
+#if PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_FIFO_FRAMES
+
+PROCESS_THREAD(pbdrv_imu_lsm6ds3tr_c_stm32_process, ev, data) {
+    pbdrv_imu_dev_t *imu_dev = &global_imu_dev;
+    I2C_HandleTypeDef *hi2c = &imu_dev->hi2c;
+
+    static struct pt child;
+    static uint8_t status[4];
+    static uint32_t num_words;
+    static uint32_t num_frames;
+    static uint32_t num_skip;
+    static uint32_t time;
+
+    PROCESS_BEGIN();
+
+    PROCESS_PT_SPAWN(&child, pbdrv_imu_lsm6ds3tr_c_stm32_init(&child));
+
+    pbdrv_init_busy_down();
+
+    if (imu_dev->init_state != IMU_INIT_STATE_COMPLETE) {
+        // The IMU is not essential. It just won't be available if init fails.
+        PROCESS_EXIT();
+    }
+
+    // Instead of one transfer per sample, the sensor collects samples in its
+    // FIFO and raises INT1 when there are enough of them. Then the status and
+    // all available frames are read with one transfer each.
+
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL(atomic_exchange(&imu_dev->int1, false));
+
+        // INT1 stays high while the FIFO is at or above the watermark, so it
+        // won't trigger again. Keep reading until it is below the watermark,
+        // including samples that arrived while reading.
+        for (;;) {
+            // Read the number of unread words and the position of the next
+            // word in the gyro/accel pattern.
+            imu_dev->ctx.read_write_done = false;
+            pbdrv_imu_lsm6ds3tr_c_stm32_read_reg(NULL, LSM6DS3TR_C_FIFO_STATUS1, status, sizeof(status));
+            PROCESS_WAIT_UNTIL(imu_dev->ctx.read_write_done);
+
+            if (pbdrv_imu_lsm6ds3tr_c_stm32_transfer_failed(imu_dev)) {
+                pbdrv_imu_lsm6ds3tr_c_stm32_i2c_reset(hi2c);
+                continue;
+            }
+            time = pbdrv_clock_get_us();
+
+            num_words = status[0] | (status[1] & 0x07) << 8;
+            if (num_words < LSM6DS3TR_FIFO_WATERMARK) {
+                break;
+            }
+
+            // If the previous read ended partway through a frame, such as
+            // after an overrun, skip to the start of the next frame.
+            uint32_t pattern = status[2] | (status[3] & 0x03) << 8;
+            num_skip = pattern ? 6 - pattern : 0;
+            num_frames = (num_words - num_skip) / 6;
+            if (num_skip + num_frames * 6 > LSM6DS3TR_MAX_FRAMES * 6) {
+                num_frames = (LSM6DS3TR_MAX_FRAMES * 6 - num_skip) / 6;
+            }
+
+            // Read all frames at once. The register address wraps around to
+            // the start of the FIFO output register after each word. Skipped
+            // words are read into the start of the buffer and then discarded.
+            imu_dev->ctx.read_write_done = false;
+            pbdrv_imu_lsm6ds3tr_c_stm32_read_reg(NULL, LSM6DS3TR_C_FIFO_DATA_OUT_L, (uint8_t *)imu_dev->data, (num_skip + num_frames * 6) * sizeof(int16_t));
+            PROCESS_WAIT_UNTIL(imu_dev->ctx.read_write_done);
+
+            if (pbdrv_imu_lsm6ds3tr_c_stm32_transfer_failed(imu_dev)) {
+                pbdrv_imu_lsm6ds3tr_c_stm32_i2c_reset(hi2c);
+                continue;
+            }
+
+            if (num_skip) {
+                memmove(imu_dev->data, &imu_dev->data[num_skip], num_frames * NUM_FRAME_BYTES);
+            }
+
+            pbdrv_imu_lsm6ds3tr_c_stm32_process_frames(imu_dev, num_frames, time);
+
+            // Temperature changes slowly, so it is read only once in a while.
+            if (pbdrv_imu_lsm6ds3tr_c_stm32_temperature_expired(imu_dev)) {
+                PROCESS_PT_SPAWN(&child, pbdrv_imu_lsm6ds3tr_c_stm32_read_temperature(&child, imu_dev));
+            }
+        }
+    }
+
+    PROCESS_END();
 }
 
+#else // PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_FIFO_FRAMES
+
 PROCESS_THREAD(pbdrv_imu_lsm6ds3tr_c_stm32_process, ev, data) {
     pbdrv_imu_dev_t *imu_dev = &global_imu_dev;
     I2C_HandleTypeDef *hi2c = &imu_dev->hi2c;
 
     static struct pt child;
-    static uint8_t buf[NUM_DATA_BYTES];
+    static uint8_t buf[NUM_FRAME_BYTES];
+    static bool last;
 
     PROCESS_BEGIN();
 
@@ -332,6 +551,12 @@ PROCESS_THREAD(pbdrv_imu_lsm6ds3tr_c_stm32_process, ev, data) {
     }
 
 retry:
+    // Temperature changes slowly, so it is read only once in a while, in
+    // between the sequential data reads.
+    if (pbdrv_imu_lsm6ds3tr_c_stm32_temperature_expired(imu_dev)) {
+        PROCESS_PT_SPAWN(&child, pbdrv_imu_lsm6ds3tr_c_stm32_read_temperature(&child, imu_dev));
+    }
+
     // Write the register address of the start of the gyro and accel data.
     buf[0] = LSM6DS3TR_C_OUTX_L_G;
     imu_dev->ctx.read_write_done = false;
@@ -359,9 +584,13 @@ retry:
     for (;;) {
         PROCESS_WAIT_EVENT_UNTIL(atomic_exchange(&imu_dev->int1, false));
 
+        // End the sequence when it is time to read the temperature, so the
+        // bus is released for another transfer.
+        last = pbdrv_imu_lsm6ds3tr_c_stm32_temperature_expired(imu_dev);
+
         imu_dev->ctx.read_write_done = false;
         ret = HAL_I2C_Master_Seq_Receive_IT(
-            &imu_dev->hi2c, LSM6DS3TR_C_I2C_ADD_L, buf, NUM_DATA_BYTES, I2C_NEXT_FRAME);
+            &imu_dev->hi2c, LSM6DS3TR_C_I2C_ADD_L, buf, NUM_FRAME_BYTES, last ? I2C_LAST_FRAME : I2C_NEXT_FRAME);
 
         if (ret != HAL_OK) {
             pbdrv_imu_lsm6ds3tr_c_stm32_i2c_reset(hi2c);
@@ -375,26 +604,20 @@ retry:
             goto retry;
         }
 
-        memcpy(&imu_dev->data[0], buf, NUM_DATA_BYTES);
+        memcpy(&imu_dev->data[0], buf, NUM_FRAME_BYTES);
 
-        // Account for mounting orientation in hub. Any other tranformations
-        // are applied at the higher level in pbio.
-        imu_dev->data[0] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_X;
-        imu_dev->data[1] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_Y;
-        imu_dev->data[2] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_Z;
-        imu_dev->data[3] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_X;
-        imu_dev->data[4] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_Y;
-        imu_dev->data[5] *= PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_SIGN_Z;
-
-        pbdrv_imu_lsm6ds3tr_c_stm32_update_stationary_status(imu_dev);
-        if (imu_dev->handle_frame_data) {
-            imu_dev->handle_frame_data(imu_dev->data);
+        pbdrv_imu_lsm6ds3tr_c_stm32_process_frames(imu_dev, 1, pbdrv_clock_get_us());
+
+        if (last) {
+            goto retry;
         }
     }
 
     PROCESS_END();
 }
 
+#endif // PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32_FIFO_FRAMES
+
 // internal driver interface implementation
 
 void pbdrv_imu_init(void) {
@@ -428,4 +651,8 @@ bool pbdrv_imu_is_stationary(pbdrv_imu_dev_t *imu_dev) {
     return imu_dev->stationary_now;
 }
 
+float pbdrv_imu_get_temperature(pbdrv_imu_dev_t *imu_dev) {
+    return imu_dev->temperature;
+}
+
 #endif // PBDRV_CONFIG_IMU_LSM6S3TR_C_STM32
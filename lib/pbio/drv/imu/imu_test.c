@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_IMU_TEST
+
+// IMU implementation for tests. Instead of reading a sensor, tests replay
+// data frames so that the full pbio processing can be checked repeatably.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <pbdrv/clock.h>
+#include <pbdrv/imu.h>
+#include <pbio/error.h>
+
+#include "imu_test.h"
+
+struct _pbdrv_imu_dev_t {
+    /** IMU configuration, matching the scale of the replayed data. */
+    pbdrv_imu_config_t config;
+    /** Callback to process one frame of unfiltered gyro and accelerometer data. */
+    pbdrv_imu_handle_frame_data_func_t handle_frame_data;
+    /** Callback to process multiple frames of stationary data. */
+    pbdrv_imu_handle_stationary_data_func_t handle_stationary_data;
+    /** Whether the test reports the IMU as stationary. */
+    bool stationary;
+    /** Temperature reported by the test in degrees Celsius. */
+    float temperature;
+    /** Whether the test makes initialization fail. */
+    bool init_failed;
+};
+
+static pbdrv_imu_dev_t global_imu_dev = {
+    .config = {
+        .sample_time = 1.0f / 833,
+        .gyro_scale = 0.07f,
+        .accel_scale = 0.244f * 9806.65f / 1000,
+        .gyro_stationary_threshold = 50,
+        .accel_stationary_threshold = 100,
+    },
+    .temperature = 25.0f,
+};
+
+void pbdrv_imu_init(void) {
+}
+
+pbio_error_t pbdrv_imu_get_imu(pbdrv_imu_dev_t **imu_dev, pbdrv_imu_config_t **config) {
+    *imu_dev = &global_imu_dev;
+    *config = &global_imu_dev.config;
+    return global_imu_dev.init_failed ? PBIO_ERROR_FAILED : PBIO_SUCCESS;
+}
+
+bool pbdrv_imu_is_stationary(pbdrv_imu_dev_t *imu_dev) {
+    return imu_dev->stationary;
+}
+
+float pbdrv_imu_get_temperature(pbdrv_imu_dev_t *imu_dev) {
+    return imu_dev->temperature;
+}
+
+void pbdrv_imu_set_data_handlers(pbdrv_imu_dev_t *imu_dev, pbdrv_imu_handle_frame_data_func_t frame_data_func, pbdrv_imu_handle_stationary_data_func_t stationary_data_func) {
+    imu_dev->handle_frame_data = frame_data_func;
+    imu_dev->handle_stationary_data = stationary_data_func;
+}
+
+/**
+ * Processes frames of raw data as if they came from the sensor, with the
+ * last frame sampled at the current time.
+ *
+ * @param [in]  data        Raw gyro (xyz) and accelerometer (xyz) values, six per frame.
+ * @param [in]  num_frames  Number of frames.
+ */
+void pbdrv_imu_test_replay_frames(int16_t *data, uint32_t num_frames) {
+    if (global_imu_dev.handle_frame_data) {
+        global_imu_dev.handle_frame_data(data, num_frames, pbdrv_clock_get_us());
+    }
+}
+
+/**
+ * Processes stationary data as if it came from the sensor.
+ *
+ * @param [in]  gyro_data_sum   Sums of raw gyro samples.
+ * @param [in]  accel_data_sum  Sums of raw accelerometer samples.
+ * @param [in]  num_samples     Number of samples summed.
+ */
+void pbdrv_imu_test_replay_stationary(const int32_t *gyro_data_sum, const int32_t *accel_data_sum, uint32_t num_samples) {
+    if (global_imu_dev.handle_stationary_data) {
+        global_imu_dev.handle_stationary_data(gyro_data_sum, accel_data_sum, num_samples);
+    }
+}
+
+/**
+ * Sets the temperature reported by the IMU.
+ *
+ * @param [in]  temperature Temperature in degrees Celsius.
+ */
+void pbdrv_imu_test_set_temperature(float temperature) {
+    global_imu_dev.temperature = temperature;
+}
+
+/**
+ * Sets whether the IMU is reported as stationary.
+ *
+ * @param [in]  stationary  @c true for stationary, @c false for moving.
+ */
+void pbdrv_imu_test_set_stationary(bool stationary) {
+    global_imu_dev.stationary = stationary;
+}
+
+/**
+ * Sets whether initialization of the IMU fails.
+ *
+ * @param [in]  failed      @c true to make pbdrv_imu_get_imu() fail.
+ */
+void pbdrv_imu_test_set_init_failed(bool failed) {
+    global_imu_dev.init_failed = failed;
+}
+
+#endif // PBDRV_CONFIG_IMU_TEST
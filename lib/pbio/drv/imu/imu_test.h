@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#ifndef _INTERNAL_PBDRV_IMU_TEST_H_
+#define _INTERNAL_PBDRV_IMU_TEST_H_
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_IMU_TEST
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// extra imu functions just for tests
+void pbdrv_imu_test_replay_frames(int16_t *data, uint32_t num_frames);
+void pbdrv_imu_test_replay_stationary(const int32_t *gyro_data_sum, const int32_t *accel_data_sum, uint32_t num_samples);
+void pbdrv_imu_test_set_temperature(float temperature);
+void pbdrv_imu_test_set_stationary(bool stationary);
+void pbdrv_imu_test_set_init_failed(bool failed);
+
+#endif // PBDRV_CONFIG_IMU_TEST
+
+#endif // _INTERNAL_PBDRV_IMU_TEST_H_
@@ -90,6 +90,14 @@ pbio_error_t pbdrv_legodev_set_mode_with_data(pbdrv_legodev_dev_t *legodev, uint
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+pbio_error_t pbdrv_legodev_get_sample_info(pbdrv_legodev_dev_t *legodev, pbdrv_legodev_sample_info_t **info) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
+pbio_error_t pbdrv_legodev_set_mode_combi(pbdrv_legodev_dev_t *legodev, const uint8_t *items, uint8_t num_items) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 pbio_error_t pbdrv_legodev_get_data(pbdrv_legodev_dev_t *legodev, uint8_t mode, void **data) {
     *data = NULL;
     return PBIO_ERROR_NOT_SUPPORTED;
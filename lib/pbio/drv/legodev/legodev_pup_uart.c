@@ -132,6 +132,22 @@ typedef enum {
     PBDRV_LEGODEV_PUP_UART_STATUS_DATA,
 } pbdrv_legodev_pup_uart_status_t;
 
+#if PBDRV_CONFIG_LEGODEV_MODE_INFO
+/**
+ * Indicates the state of the requested mode combination.
+ */
+typedef enum {
+    /** No mode combination requested. */
+    PBDRV_LEGODEV_PUP_UART_COMBI_NONE,
+    /** Combination sent to the device, waiting for it to be sent back. */
+    PBDRV_LEGODEV_PUP_UART_COMBI_REQUESTED,
+    /** Combination acknowledged by the device. */
+    PBDRV_LEGODEV_PUP_UART_COMBI_ACKED,
+    /** Receiving data for the combination. */
+    PBDRV_LEGODEV_PUP_UART_COMBI_ACTIVE,
+} pbdrv_legodev_pup_uart_combi_state_t;
+#endif // PBDRV_CONFIG_LEGODEV_MODE_INFO
+
 typedef struct {
     /** The mode to be set. */
     uint8_t desired_mode;
@@ -158,8 +174,6 @@ typedef struct {
 struct _pbdrv_legodev_pup_uart_dev_t {
     /** Main protothread, first used for synchronization thread and then for data send thread. */
     struct pt pt;
-    /** Protothread for receiving sensor data, running in parallel to the data send thread. */
-    struct pt recv_pt;
     /** Child protothread of the main protothread used for writing data */
     struct pt write_pt;
     /** Timer for sending keepalive messages and other delays. */
@@ -195,6 +209,14 @@ struct _pbdrv_legodev_pup_uart_dev_t {
     uint8_t *rx_msg;
     /** Size of the current message being received. */
     uint8_t rx_msg_size;
+    /** Number of bytes in rx_msg not yet consumed by the streaming data parser. */
+    uint8_t rx_msg_pos;
+    /** Flag that indicates that the data parser is dropping bytes to get back in sync. */
+    bool rx_resyncing;
+    /** Arrival statistics of data messages for the requested mode. */
+    pbdrv_legodev_sample_info_t sample_info;
+    /** Time of the most recent data message for the requested mode, in microseconds. */
+    uint32_t sample_time_us;
     /** Total number of errors that have occurred. */
     uint32_t err_count;
     /** Number of bad reads when receiving DATA ludev->msgs. */
@@ -212,6 +234,14 @@ struct _pbdrv_legodev_pup_uart_dev_t {
     uint8_t new_mode;
     /** Flags indicating what information has already been read from the data. */
     uint32_t info_flags;
+    /** Values in the requested mode combination, see ::PBDRV_LEGODEV_COMBI_ITEM. */
+    uint8_t combi_items[PBDRV_LEGODEV_MAX_COMBI_ITEMS];
+    /** Number of values in the requested mode combination. */
+    uint8_t combi_num_items;
+    /** Payload size of data messages for the requested mode combination. */
+    uint8_t combi_msg_size;
+    /** State of the requested mode combination. */
+    pbdrv_legodev_pup_uart_combi_state_t combi_state;
     #endif // #define PBDRV_CONFIG_LEGODEV_MODE_INFO
 };
 
@@ -251,9 +281,30 @@ static void pbdrv_legodev_request_mode(pbdrv_legodev_pup_uart_dev_t *ludev, uint
     ludev->mode_switch.desired_mode = mode;
     ludev->mode_switch.time = pbdrv_clock_get_ms();
     ludev->mode_switch.requested = true;
+    #if PBDRV_CONFIG_LEGODEV_MODE_INFO
+    ludev->combi_state = mode == PBDRV_LEGODEV_MODE_COMBI ?
+        PBDRV_LEGODEV_PUP_UART_COMBI_REQUESTED : PBDRV_LEGODEV_PUP_UART_COMBI_NONE;
+    #endif
     pbdrv_legodev_pup_uart_process_poll();
 }
 
+/**
+ * Gets the mode of the data that is currently being received.
+ *
+ * @param [in]  ludev       The LEGO UART device instance.
+ * @return                  ::PBDRV_LEGODEV_MODE_COMBI if receiving data for a
+ *                          mode combination, otherwise the mode reported by
+ *                          the device.
+ */
+static uint8_t pbdrv_legodev_pup_uart_get_data_mode(pbdrv_legodev_pup_uart_dev_t *ludev) {
+    #if PBDRV_CONFIG_LEGODEV_MODE_INFO
+    if (ludev->combi_state == PBDRV_LEGODEV_PUP_UART_COMBI_ACTIVE) {
+        return PBDRV_LEGODEV_MODE_COMBI;
+    }
+    #endif
+    return ludev->device_info.mode;
+}
+
 static void pbdrv_legodev_request_data_set(pbdrv_legodev_pup_uart_dev_t *ludev, uint8_t mode, const uint8_t *data, uint8_t size) {
     ludev->data_set->size = size;
     ludev->data_set->desired_mode = mode;
@@ -284,6 +335,21 @@ static uint8_t ev3_uart_get_msg_size(uint8_t header) {
     return size;
 }
 
+static bool ev3_uart_checksum_is_valid(const uint8_t *msg, uint8_t size) {
+    uint8_t checksum = 0xFF;
+    for (int i = 0; i < size - 1; i++) {
+        checksum ^= msg[i];
+    }
+    return checksum == msg[size - 1];
+}
+
+static bool pbdrv_legodev_pup_uart_ignore_bad_checksum(pbdrv_legodev_pup_uart_dev_t *ludev) {
+    // The LEGO EV3 color sensor sends bad checksums
+    // for RGB-RAW data (mode 4). The check here could be
+    // improved if someone can find a pattern.
+    return ludev->device_info.type_id == PBDRV_LEGODEV_TYPE_ID_EV3_COLOR_SENSOR
+           && ludev->rx_msg[0] == (LUMP_MSG_TYPE_DATA | LUMP_MSG_SIZE_8 | 4);
+}
 
 static void pbdrv_legodev_pup_uart_parse_msg(pbdrv_legodev_pup_uart_dev_t *ludev) {
     uint32_t speed;
@@ -307,21 +373,12 @@ static void pbdrv_legodev_pup_uart_parse_msg(pbdrv_legodev_pup_uart_dev_t *ludev
     }
 
     if (msg_size > 1) {
-        uint8_t checksum = 0xFF;
-        for (int i = 0; i < msg_size - 1; i++) {
-            checksum ^= ludev->rx_msg[i];
-        }
-        if (checksum != ludev->rx_msg[msg_size - 1]) {
+        if (!ev3_uart_checksum_is_valid(ludev->rx_msg, msg_size)) {
             DBG_ERR(ludev->last_err = "Bad checksum");
             // if INFO messages are done and we are now receiving data, it is
             // OK to occasionally have a bad checksum
             if (ludev->status == PBDRV_LEGODEV_PUP_UART_STATUS_DATA) {
-
-                // The LEGO EV3 color sensor sends bad checksums
-                // for RGB-RAW data (mode 4). The check here could be
-                // improved if someone can find a pattern.
-                if (ludev->device_info.type_id != PBDRV_LEGODEV_TYPE_ID_EV3_COLOR_SENSOR
-                    || ludev->rx_msg[0] != (LUMP_MSG_TYPE_DATA | LUMP_MSG_SIZE_8 | 4)) {
+                if (!pbdrv_legodev_pup_uart_ignore_bad_checksum(ludev)) {
                     return;
                 }
             } else {
@@ -398,6 +455,17 @@ static void pbdrv_legodev_pup_uart_parse_msg(pbdrv_legodev_pup_uart_dev_t *ludev
                     break;
                 case LUMP_CMD_WRITE:
                     #if PBDRV_CONFIG_LEGODEV_MODE_INFO
+                    if (ludev->status == PBDRV_LEGODEV_PUP_UART_STATUS_DATA) {
+                        // The device acknowledges a mode combination by
+                        // sending it back.
+                        if (ludev->combi_state == PBDRV_LEGODEV_PUP_UART_COMBI_REQUESTED &&
+                            ludev->rx_msg[1] == (LUMP_WRITE_COMBI_SET | 0) &&
+                            msg_size - 3 >= ludev->combi_num_items &&
+                            !memcmp(ludev->rx_msg + 2, ludev->combi_items, ludev->combi_num_items)) {
+                            ludev->combi_state = PBDRV_LEGODEV_PUP_UART_COMBI_ACKED;
+                        }
+                        break;
+                    }
                     if (cmd2 & 0x20) {
                         // TODO: write_cmd_size = cmd2 & 0x3;
                         if (ludev->info_flags & PBDRV_LEGODEV_CAPABILITY_FLAG_HAS_MOTOR_REL_POS) {
@@ -528,8 +596,10 @@ static void pbdrv_legodev_pup_uart_parse_msg(pbdrv_legodev_pup_uart_dev_t *ludev
                         goto err;
                     }
 
-                    // REVISIT: this is potentially an array of combos
-                    debug_pr("mode combos: %04x\n", ludev->rx_msg[3] << 8 | ludev->rx_msg[2]);
+                    // REVISIT: this is potentially an array of combos. Only
+                    // the first one is used for now.
+                    ludev->device_info.mode_combos = pbio_get_uint16_le(ludev->rx_msg + 2);
+                    debug_pr("mode combos: %04x\n", ludev->device_info.mode_combos);
 
                     break;
                 case LUMP_INFO_UNK9:
@@ -603,16 +673,44 @@ static void pbdrv_legodev_pup_uart_parse_msg(pbdrv_legodev_pup_uart_dev_t *ludev
                 DBG_ERR(ludev->last_err = "Invalid mode received");
                 goto err;
             }
+
+            #endif
+
+            uint8_t data_mode = mode;
+            uint8_t prev_data_mode = pbdrv_legodev_pup_uart_get_data_mode(ludev);
+
+            #if PBDRV_CONFIG_LEGODEV_MODE_INFO
+            // Combined data is sent with the mode of the first value. It is
+            // told apart from data for just that mode by its size, and only
+            // accepted once the device has acknowledged the combination.
+            if (ludev->combi_state != PBDRV_LEGODEV_PUP_UART_COMBI_NONE &&
+                ludev->combi_state != PBDRV_LEGODEV_PUP_UART_COMBI_REQUESTED) {
+                bool is_combi = mode == ludev->combi_items[0] >> 4 && msg_size - 2 == ludev->combi_msg_size;
+                ludev->combi_state = is_combi ?
+                    PBDRV_LEGODEV_PUP_UART_COMBI_ACTIVE : PBDRV_LEGODEV_PUP_UART_COMBI_ACKED;
+                if (is_combi) {
+                    data_mode = PBDRV_LEGODEV_MODE_COMBI;
+                }
+            }
             #endif
 
             // Data is for requested mode.
-            if (mode == ludev->mode_switch.desired_mode) {
+            if (data_mode == ludev->mode_switch.desired_mode) {
                 memcpy(ludev->bin_data, ludev->rx_msg + 1, msg_size - 2);
 
-                if (ludev->device_info.mode != mode) {
+                if (prev_data_mode != data_mode) {
                     // First time getting data in this mode, so register time.
                     ludev->mode_switch.time = pbdrv_clock_get_ms();
+                    ludev->sample_info.interval = 0;
+                } else {
+                    // Smooth the interval between samples in the same mode.
+                    int32_t interval = pbdrv_clock_get_us() - ludev->sample_time_us;
+                    int32_t average = ludev->sample_info.interval;
+                    ludev->sample_info.interval = average ? average + (interval - average) / 8 : interval;
                 }
+                ludev->sample_time_us = pbdrv_clock_get_us();
+                ludev->sample_info.time = pbdrv_clock_get_ms();
+                ludev->sample_info.count++;
             }
             ludev->device_info.mode = mode;
 
@@ -694,6 +792,17 @@ static void pbdrv_legodev_pup_uart_reset(pbdrv_legodev_pup_uart_dev_t *ludev) {
     }
 }
 
+/**
+ * Drops bytes from the start of the receive buffer.
+ *
+ * @param [in]  ludev       The LEGO UART device instance.
+ * @param [in]  size        Number of bytes to drop.
+ */
+static void pbdrv_legodev_pup_uart_drop_rx_bytes(pbdrv_legodev_pup_uart_dev_t *ludev, uint8_t size) {
+    ludev->rx_msg_pos -= size;
+    memmove(ludev->rx_msg, ludev->rx_msg + size, ludev->rx_msg_pos);
+}
+
 static PT_THREAD(pbdrv_legodev_pup_uart_send_prepared_msg(pbdrv_legodev_pup_uart_dev_t * ludev, pbio_error_t * err)) {
     PT_BEGIN(&ludev->write_pt);
     ludev->tx_start_time = pbdrv_clock_get_ms();
@@ -722,6 +831,7 @@ static PT_THREAD(pbdrv_legodev_pup_uart_synchronize_thread(pbdrv_legodev_pup_uar
     ludev->ext_mode = 0;
     #if PBDRV_CONFIG_LEGODEV_MODE_INFO
     ludev->device_info.flags = PBDRV_LEGODEV_CAPABILITY_FLAG_NONE;
+    ludev->combi_state = PBDRV_LEGODEV_PUP_UART_COMBI_NONE;
     #endif
     ludev->status = PBDRV_LEGODEV_PUP_UART_STATUS_SYNCING;
 
@@ -815,11 +925,15 @@ sync:
     ludev->device_info.type_id = ludev->rx_msg[1];
     ludev->data_rec = false;
     ludev->num_data_err = 0;
+    ludev->sample_info.count = 0;
+    ludev->sample_info.num_missed = 0;
+    ludev->sample_info.interval = 0;
     ludev->status = PBDRV_LEGODEV_PUP_UART_STATUS_INFO;
     #if PBDRV_CONFIG_LEGODEV_MODE_INFO
     ludev->device_info.flags = PBDRV_LEGODEV_CAPABILITY_FLAG_NONE;
     ludev->info_flags = EV3_UART_INFO_FLAG_CMD_TYPE;
     ludev->device_info.num_modes = 1;
+    ludev->device_info.mode_combos = 0;
     #endif
     debug_pr("type id: %d\n", ludev->device_info.type_id);
 
@@ -912,6 +1026,24 @@ sync:
     PT_END(&ludev->pt);
 }
 
+#if PBDRV_CONFIG_LEGODEV_MODE_INFO
+
+/**
+ * Prepares the message that sets up the requested mode combination.
+ *
+ * @param [in]  ludev       The LEGO UART device instance.
+ */
+static void pbdrv_legodev_pup_uart_prepare_combi_msg(pbdrv_legodev_pup_uart_dev_t *ludev) {
+    uint8_t payload[PBDRV_LEGODEV_MAX_COMBI_ITEMS + 1];
+
+    // Always uses the first combination slot.
+    payload[0] = LUMP_WRITE_COMBI_SET | 0;
+    memcpy(payload + 1, ludev->combi_items, ludev->combi_num_items);
+    ev3_uart_prepare_tx_msg(ludev, LUMP_MSG_TYPE_CMD, LUMP_CMD_WRITE, payload, ludev->combi_num_items + 1);
+}
+
+#endif // PBDRV_CONFIG_LEGODEV_MODE_INFO
+
 /**
  * The send thread for the LEGO UART device.
  *
@@ -950,7 +1082,7 @@ static PT_THREAD(pbdrv_legodev_pup_uart_send_thread(pbdrv_legodev_pup_uart_dev_t
             etimer_reset_with_new_interval(&ludev->timer, EV3_UART_DATA_KEEP_ALIVE_TIMEOUT);
 
             // Retry mode switch if it hasn't been handled or failed.
-            if (ludev->device_info.mode != ludev->mode_switch.desired_mode && pbdrv_clock_get_ms() - ludev->mode_switch.time > EV3_UART_IO_TIMEOUT) {
+            if (pbdrv_legodev_pup_uart_get_data_mode(ludev) != ludev->mode_switch.desired_mode && pbdrv_clock_get_ms() - ludev->mode_switch.time > EV3_UART_IO_TIMEOUT) {
                 ludev->mode_switch.requested = true;
             }
         }
@@ -958,7 +1090,21 @@ static PT_THREAD(pbdrv_legodev_pup_uart_send_thread(pbdrv_legodev_pup_uart_dev_t
         // Handle requested mode change
         if (ludev->mode_switch.requested) {
             ludev->mode_switch.requested = false;
-            ev3_uart_prepare_tx_msg(ludev, LUMP_MSG_TYPE_CMD, LUMP_CMD_SELECT, &ludev->mode_switch.desired_mode, 1);
+            #if PBDRV_CONFIG_LEGODEV_MODE_INFO
+            if (ludev->mode_switch.desired_mode == PBDRV_LEGODEV_MODE_COMBI) {
+                // Select the mode of the first value, then set the combination.
+                ev3_uart_prepare_tx_msg(ludev, LUMP_MSG_TYPE_CMD, LUMP_CMD_SELECT, (uint8_t []) { ludev->combi_items[0] >> 4 }, 1);
+                PT_SPAWN(&ludev->pt, &ludev->write_pt, pbdrv_legodev_pup_uart_send_prepared_msg(ludev, &ludev->err));
+                if (ludev->err != PBIO_SUCCESS) {
+                    DBG_ERR(ludev->last_err = "Setting requested mode failed.");
+                    PT_EXIT(&ludev->pt);
+                }
+                pbdrv_legodev_pup_uart_prepare_combi_msg(ludev);
+            } else
+            #endif
+            {
+                ev3_uart_prepare_tx_msg(ludev, LUMP_MSG_TYPE_CMD, LUMP_CMD_SELECT, &ludev->mode_switch.desired_mode, 1);
+            }
             PT_SPAWN(&ludev->pt, &ludev->write_pt, pbdrv_legodev_pup_uart_send_prepared_msg(ludev, &ludev->err));
             if (ludev->err != PBIO_SUCCESS) {
                 DBG_ERR(ludev->last_err = "Setting requested mode failed.");
@@ -994,64 +1140,87 @@ static PT_THREAD(pbdrv_legodev_pup_uart_send_thread(pbdrv_legodev_pup_uart_dev_t
 }
 
 /**
- * The receive thread for the LEGO UART device.
+ * Drops one byte from the start of the receive buffer to get back in sync.
  *
  * @param [in]  ludev       The LEGO UART device instance.
  */
-static PT_THREAD(pbdrv_legodev_pup_uart_receive_data_thread(pbdrv_legodev_pup_uart_dev_t * ludev)) {
-
-    // REVISIT: This is not the greatest. We can easily get a buffer overrun and
-    // loose data. For now, the retry after bad message size helps get back into
-    // sync with the data stream.
-
-    pbio_error_t err;
-
-    PT_BEGIN(&ludev->recv_pt);
+static void pbdrv_legodev_pup_uart_drop_rx_byte_to_resync(pbdrv_legodev_pup_uart_dev_t *ludev) {
+    // Dropping bytes means that at least one message was lost. Count it
+    // only once until we are back in sync.
+    if (!ludev->rx_resyncing) {
+        ludev->rx_resyncing = true;
+        ludev->sample_info.num_missed++;
+    }
+    pbdrv_legodev_pup_uart_drop_rx_bytes(ludev, 1);
+}
 
-    while (true) {
-        PBIO_PT_WAIT_READY(&ludev->recv_pt,
-            err = pbdrv_uart_read_begin(ludev->uart, ludev->rx_msg, 1, EV3_UART_IO_TIMEOUT));
-        if (err != PBIO_SUCCESS) {
-            DBG_ERR(ludev->last_err = "UART Rx data header begin error");
-            break;
-        }
-        PBIO_PT_WAIT_READY(&ludev->recv_pt, err = pbdrv_uart_read_end(ludev->uart));
-        if (err != PBIO_SUCCESS) {
-            DBG_ERR(ludev->last_err = "UART Rx data header end error");
-            break;
-        }
+/**
+ * Parses all complete data messages at the start of the receive buffer.
+ *
+ * Bytes that cannot start a valid data message and messages with a bad
+ * checksum are dropped one byte at a time, so that the parser gets back
+ * in sync with the data stream at the next valid message.
+ *
+ * @param [in]  ludev       The LEGO UART device instance.
+ */
+static void pbdrv_legodev_pup_uart_parse_rx_bytes(pbdrv_legodev_pup_uart_dev_t *ludev) {
+    while (ludev->rx_msg_pos) {
+        uint8_t header = ludev->rx_msg[0];
+        uint8_t msg_type = header & LUMP_MSG_TYPE_MASK;
+        uint8_t cmd = header & LUMP_MSG_CMD_MASK;
 
-        ludev->rx_msg_size = ev3_uart_get_msg_size(ludev->rx_msg[0]);
+        ludev->rx_msg_size = ev3_uart_get_msg_size(header);
         if (ludev->rx_msg_size < 3 || ludev->rx_msg_size > EV3_UART_MAX_MESSAGE_SIZE) {
             DBG_ERR(ludev->last_err = "Bad data message size");
+            pbdrv_legodev_pup_uart_drop_rx_byte_to_resync(ludev);
             continue;
         }
 
-        uint8_t msg_type = ludev->rx_msg[0] & LUMP_MSG_TYPE_MASK;
-        uint8_t cmd = ludev->rx_msg[0] & LUMP_MSG_CMD_MASK;
         if (msg_type != LUMP_MSG_TYPE_DATA && (msg_type != LUMP_MSG_TYPE_CMD ||
                                                (cmd != LUMP_CMD_WRITE && cmd != LUMP_CMD_EXT_MODE))) {
             DBG_ERR(ludev->last_err = "Bad msg type");
+            pbdrv_legodev_pup_uart_drop_rx_byte_to_resync(ludev);
             continue;
         }
 
-        PBIO_PT_WAIT_READY(&ludev->recv_pt,
-            err = pbdrv_uart_read_begin(ludev->uart, ludev->rx_msg + 1, ludev->rx_msg_size - 1, EV3_UART_IO_TIMEOUT));
-        if (err != PBIO_SUCCESS) {
-            DBG_ERR(ludev->last_err = "UART Rx data begin error");
-            break;
+        // Wait for the rest of the message.
+        if (ludev->rx_msg_pos < ludev->rx_msg_size) {
+            return;
         }
-        PBIO_PT_WAIT_READY(&ludev->recv_pt, err = pbdrv_uart_read_end(ludev->uart));
-        if (err != PBIO_SUCCESS) {
-            DBG_ERR(ludev->last_err = "UART Rx data end error");
-            break;
+
+        // A bad checksum most likely means that we started on a byte that
+        // only looked like a header, so try again from the next byte.
+        if (!ev3_uart_checksum_is_valid(ludev->rx_msg, ludev->rx_msg_size) &&
+            !pbdrv_legodev_pup_uart_ignore_bad_checksum(ludev)) {
+            DBG_ERR(ludev->last_err = "Bad checksum");
+            pbdrv_legodev_pup_uart_drop_rx_byte_to_resync(ludev);
+            continue;
         }
 
         // at this point, we have a full ludev->msg that can be parsed
+        ludev->rx_resyncing = false;
         pbdrv_legodev_pup_uart_parse_msg(ludev);
+        pbdrv_legodev_pup_uart_drop_rx_bytes(ludev, ludev->rx_msg_size);
     }
+}
 
-    PT_END(&ludev->recv_pt);
+/**
+ * Receives and parses all data that the UART has received so far.
+ *
+ * The UART keeps receiving in the background, so bytes are consumed in bulk
+ * as they become available instead of one read transaction per message.
+ *
+ * @param [in]  ludev       The LEGO UART device instance.
+ */
+static void pbdrv_legodev_pup_uart_receive_data(pbdrv_legodev_pup_uart_dev_t *ludev) {
+    uint32_t size;
+
+    // Never read more than what fits after the pending partial message.
+    while ((size = pbdrv_uart_read_available(ludev->uart, ludev->rx_msg + ludev->rx_msg_pos,
+        EV3_UART_MAX_MESSAGE_SIZE - ludev->rx_msg_pos))) {
+        ludev->rx_msg_pos += size;
+        pbdrv_legodev_pup_uart_parse_rx_bytes(ludev);
+    }
 }
 
 /**
@@ -1074,12 +1243,13 @@ PT_THREAD(pbdrv_legodev_pup_uart_thread(struct pt *pt, pbdrv_legodev_pup_uart_de
         PT_EXIT(pt);
     }
 
-    // The sensor is now ready for use. Now run the send and receive threads in
-    // parallel until the send thread ends or exits.
+    // The sensor is now ready for use. Now run the send thread and receive
+    // incoming data in parallel until the send thread ends or exits.
     PT_INIT(&ludev->pt);
-    PT_INIT(&ludev->recv_pt);
+    ludev->rx_msg_pos = 0;
+    ludev->rx_resyncing = false;
     while (PT_SCHEDULE(pbdrv_legodev_pup_uart_send_thread(ludev))) {
-        pbdrv_legodev_pup_uart_receive_data_thread(ludev);
+        pbdrv_legodev_pup_uart_receive_data(ludev);
         PT_YIELD(pt);
     }
     pbdrv_legodev_pup_uart_reset(ludev);
@@ -1127,7 +1297,7 @@ pbio_error_t pbdrv_legodev_is_ready(pbdrv_legodev_dev_t *legodev) {
     uint32_t time = pbdrv_clock_get_ms();
 
     // Not ready if waiting for mode change
-    if (ludev->device_info.mode != ludev->mode_switch.desired_mode) {
+    if (pbdrv_legodev_pup_uart_get_data_mode(ludev) != ludev->mode_switch.desired_mode) {
         return PBIO_ERROR_AGAIN;
     }
 
@@ -1163,7 +1333,7 @@ pbio_error_t pbdrv_legodev_set_mode(pbdrv_legodev_dev_t *legodev, uint8_t mode)
     }
 
     // Mode already set or being set, so return success.
-    if (ludev->mode_switch.desired_mode == mode || ludev->device_info.mode == mode) {
+    if (ludev->mode_switch.desired_mode == mode || pbdrv_legodev_pup_uart_get_data_mode(ludev) == mode) {
         return PBIO_SUCCESS;
     }
 
@@ -1186,6 +1356,83 @@ pbio_error_t pbdrv_legodev_set_mode(pbdrv_legodev_dev_t *legodev, uint8_t mode)
     return PBIO_SUCCESS;
 }
 
+/**
+ * Starts setting a mode combination on a LEGO UART device.
+ *
+ * @param [in]  legodev     The legodev instance.
+ * @param [in]  items       The values to combine, see ::PBDRV_LEGODEV_COMBI_ITEM.
+ * @param [in]  num_items   The number of values.
+ * @return                  ::PBIO_SUCCESS on success or if already set.
+ *                          ::PBIO_ERROR_NO_DEV if the port does not have a device attached.
+ *                          ::PBIO_ERROR_NOT_SUPPORTED if the modes cannot be combined.
+ *                          ::PBIO_ERROR_INVALID_ARG if the values are not valid.
+ *                          ::PBIO_ERROR_AGAIN if the device is not ready for this operation.
+ */
+pbio_error_t pbdrv_legodev_set_mode_combi(pbdrv_legodev_dev_t *legodev, const uint8_t *items, uint8_t num_items) {
+
+    pbdrv_legodev_pup_uart_dev_t *ludev = pbdrv_legodev_get_uart_dev(legodev);
+    if (!ludev) {
+        return PBIO_ERROR_NO_DEV;
+    }
+
+    #if PBDRV_CONFIG_LEGODEV_MODE_INFO
+
+    if (num_items == 0 || num_items > PBDRV_LEGODEV_MAX_COMBI_ITEMS) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Combination already set or being set, so return success.
+    bool is_set = ludev->mode_switch.desired_mode == PBDRV_LEGODEV_MODE_COMBI;
+    if (is_set && num_items == ludev->combi_num_items && !memcmp(items, ludev->combi_items, num_items)) {
+        return PBIO_SUCCESS;
+    }
+
+    // We can only initiate a mode switch if currently idle (receiving data).
+    pbio_error_t err = pbdrv_legodev_is_ready(legodev);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    // Each value must come from a mode that can be combined.
+    uint8_t size = 0;
+    for (uint8_t i = 0; i < num_items; i++) {
+        uint8_t mode = items[i] >> 4;
+        uint8_t dataset = items[i] & 0x0F;
+        if (mode >= ludev->device_info.num_modes) {
+            return PBIO_ERROR_INVALID_ARG;
+        }
+        if (!(ludev->device_info.mode_combos & (1 << mode))) {
+            return PBIO_ERROR_NOT_SUPPORTED;
+        }
+        const pbdrv_legodev_mode_info_t *mode_info = &ludev->device_info.mode_info[mode];
+        if (dataset >= mode_info->num_values) {
+            return PBIO_ERROR_INVALID_ARG;
+        }
+        size += pbdrv_legodev_size_of(mode_info->data_type);
+    }
+    if (size > PBDRV_LEGODEV_MAX_DATA_SIZE) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    memcpy(ludev->combi_items, items, num_items);
+    ludev->combi_num_items = num_items;
+
+    // Data messages are padded to the nearest supported size.
+    ludev->combi_msg_size = 1;
+    while (ludev->combi_msg_size < size) {
+        ludev->combi_msg_size <<= 1;
+    }
+
+    // Request mode switch.
+    pbdrv_legodev_request_mode(ludev, PBDRV_LEGODEV_MODE_COMBI);
+
+    return PBIO_SUCCESS;
+
+    #else
+    return PBIO_ERROR_NOT_SUPPORTED;
+    #endif // PBDRV_CONFIG_LEGODEV_MODE_INFO
+}
+
 /**
  * Atomic operation for asserting the mode/id and getting the data of a LEGO UART device.
  *
@@ -1205,7 +1452,7 @@ pbio_error_t pbdrv_legodev_get_data(pbdrv_legodev_dev_t *legodev, uint8_t mode,
     }
 
     // Can only request data for mode that is set.
-    if (mode != ludev->device_info.mode) {
+    if (mode != pbdrv_legodev_pup_uart_get_data_mode(ludev)) {
         return PBIO_ERROR_INVALID_OP;
     }
 
@@ -1249,6 +1496,24 @@ pbio_error_t pbdrv_legodev_set_mode_with_data(pbdrv_legodev_dev_t *legodev, uint
     return PBIO_SUCCESS;
 }
 
+/**
+ * Gets arrival statistics of the data for the current mode.
+ *
+ * @param [in]  legodev     The legodev instance.
+ * @param [out] info        The sample statistics.
+ * @return                  ::PBIO_SUCCESS on success.
+ *                          ::PBIO_ERROR_NO_DEV if the port does not have a device attached.
+ */
+pbio_error_t pbdrv_legodev_get_sample_info(pbdrv_legodev_dev_t *legodev, pbdrv_legodev_sample_info_t **info) {
+
+    pbdrv_legodev_pup_uart_dev_t *ludev = pbdrv_legodev_get_uart_dev(legodev);
+    if (!ludev || ludev->status == PBDRV_LEGODEV_PUP_UART_STATUS_ERR) {
+        return PBIO_ERROR_NO_DEV;
+    }
+    *info = &ludev->sample_info;
+    return PBIO_SUCCESS;
+}
+
 pbio_error_t pbdrv_legodev_get_info(pbdrv_legodev_dev_t *legodev, pbdrv_legodev_info_t **info) {
 
     pbdrv_legodev_pup_uart_dev_t *ludev = pbdrv_legodev_get_uart_dev(legodev);
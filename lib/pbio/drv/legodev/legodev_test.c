@@ -37,7 +37,8 @@ PROCESS(pbio_legodev_test_process, "legodev_test");
 
 static PT_THREAD(pbdrv_legodev_test_thread(pbdrv_legodev_dev_t * dev)) {
     PT_BEGIN(&dev->pt);
-    if (!dev->is_motor) {
+    // Like on the real hub, sync again when the device is lost.
+    while (!dev->is_motor) {
         PT_SPAWN(&dev->pt, &dev->uart_dev_pt, pbdrv_legodev_pup_uart_thread(&dev->uart_dev_pt, dev->uart_dev));
     }
     PT_END(&dev->pt);
@@ -96,6 +96,7 @@ PROCESS_THREAD(pbdrv_motor_driver_virtual_simulation_process, ev, data) {
     static struct timer frame_timer;
 
     static uint32_t dev_index;
+    static clock_time_t sim_time;
     static pbdrv_motor_driver_dev_t *driver;
 
     PROCESS_BEGIN();
@@ -134,6 +135,7 @@ PROCESS_THREAD(pbdrv_motor_driver_virtual_simulation_process, ev, data) {
 
     etimer_set(&tick_timer, 1);
     timer_set(&frame_timer, 40);
+    sim_time = clock_time();
 
     for (;;) {
         PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER && etimer_expired(&tick_timer));
@@ -163,60 +165,64 @@ PROCESS_THREAD(pbdrv_motor_driver_virtual_simulation_process, ev, data) {
             }
         }
 
-        for (dev_index = 0; dev_index < PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV; dev_index++) {
-            driver = &motor_driver_devs[dev_index];
-
-            // Skip simulating if there is no model.
-            if (!driver->model) {
-                continue;
-            }
-
-            // Shorthand notation for frequent local references to model.
-            const pbio_simulation_model_t *m = driver->model;
-
-            // Modified coulomb friction with transition linear in speed through origin.
-            const double limit = 2000;
-            double friction;
-            if (driver->speed > limit) {
-                friction = m->torque_friction;
-            } else if (driver->speed < -limit) {
-                friction = -m->torque_friction;
-            } else {
-                friction = m->torque_friction * driver->speed / limit;
-            }
+        // The model is discretized at 1 ms. Catch up if the timer event was
+        // handled late, so simulated time keeps up with the clock.
+        for (; sim_time != clock_time(); sim_time++) {
+            for (dev_index = 0; dev_index < PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV; dev_index++) {
+                driver = &motor_driver_devs[dev_index];
 
-            // Stall obstacle torque
-            double external_torque = 0;
-            if (driver->angle > driver->pdata->endstop_angle_positive) {
-                external_torque = (driver->angle - driver->pdata->endstop_angle_positive) * 500 + driver->speed * 5;
-            } else if (driver->angle < driver->pdata->endstop_angle_negative) {
-                external_torque = (driver->angle - driver->pdata->endstop_angle_negative) * 500 + driver->speed * 5;
+                // Skip simulating if there is no model.
+                if (!driver->model) {
+                    continue;
+                }
+
+                // Shorthand notation for frequent local references to model.
+                const pbio_simulation_model_t *m = driver->model;
+
+                // Modified coulomb friction with transition linear in speed through origin.
+                const double limit = 2000;
+                double friction;
+                if (driver->speed > limit) {
+                    friction = m->torque_friction;
+                } else if (driver->speed < -limit) {
+                    friction = -m->torque_friction;
+                } else {
+                    friction = m->torque_friction * driver->speed / limit;
+                }
+
+                // Stall obstacle torque
+                double external_torque = 0;
+                if (driver->angle > driver->pdata->endstop_angle_positive) {
+                    external_torque = (driver->angle - driver->pdata->endstop_angle_positive) * 500 + driver->speed * 5;
+                } else if (driver->angle < driver->pdata->endstop_angle_negative) {
+                    external_torque = (driver->angle - driver->pdata->endstop_angle_negative) * 500 + driver->speed * 5;
+                }
+
+                double voltage = driver->voltage;
+                double torque = friction + external_torque;
+
+                // Get next state based on current state and input: x(k+1) = Ax(k) + Bu(k)
+                double angle_next = driver->angle +
+                    driver->speed * m->d_angle_d_speed +
+                    driver->current * m->d_angle_d_current +
+                    voltage * m->d_angle_d_voltage +
+                    torque * m->d_angle_d_torque;
+                double speed_next = 0 +
+                    driver->speed * m->d_speed_d_speed +
+                    driver->current * m->d_speed_d_current +
+                    voltage * m->d_speed_d_voltage +
+                    torque * m->d_speed_d_torque;
+                double current_next = 0 +
+                    driver->speed * m->d_current_d_speed +
+                    driver->current * m->d_current_d_current +
+                    voltage * m->d_current_d_voltage +
+                    torque * m->d_current_d_torque;
+
+                // Save new state.
+                driver->angle = angle_next;
+                driver->speed = speed_next;
+                driver->current = current_next;
             }
-
-            double voltage = driver->voltage;
-            double torque = friction + external_torque;
-
-            // Get next state based on current state and input: x(k+1) = Ax(k) + Bu(k)
-            double angle_next = driver->angle +
-                driver->speed * m->d_angle_d_speed +
-                driver->current * m->d_angle_d_current +
-                voltage * m->d_angle_d_voltage +
-                torque * m->d_angle_d_torque;
-            double speed_next = 0 +
-                driver->speed * m->d_speed_d_speed +
-                driver->current * m->d_speed_d_current +
-                voltage * m->d_speed_d_voltage +
-                torque * m->d_speed_d_torque;
-            double current_next = 0 +
-                driver->speed * m->d_current_d_speed +
-                driver->current * m->d_current_d_current +
-                voltage * m->d_current_d_voltage +
-                torque * m->d_current_d_torque;
-
-            // Save new state.
-            driver->angle = angle_next;
-            driver->speed = speed_next;
-            driver->current = current_next;
         }
 
         etimer_reset(&tick_timer);
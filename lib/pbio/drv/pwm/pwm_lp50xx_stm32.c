@@ -105,6 +105,10 @@ static pbio_error_t pbdrv_pwm_lp50xx_stm32_set_duty(pbdrv_pwm_dev_t *dev, uint32
 
     // Currently all LED PWMs use 16-bit value. This chip only has 8-bit PWM
     // (the data sheet says 12-bit PWM but the I2C registers are only 8-bit).
+    if (priv->values[ch] == value >> 8) {
+        return PBIO_SUCCESS;
+    }
+
     priv->values[ch] = value >> 8;
     priv->changed = true;
     process_poll(&pwm_lp50xx_stm32);
@@ -34,6 +34,8 @@
 #include <nxos/interrupts.h>
 #include <nxos/nxt.h>
 
+#include <pbdrv/sound.h>
+
 // We have two possible types of PDM encoding for use when playing PCM
 // data. The first is based on the LEGO firmware and encodes each 8 bit
 // value to a 256-bit PDM value by using a lookup table. The second uses
@@ -87,6 +89,10 @@ static struct {
     uint8_t buf_id;
     // Size of the sample in 32 bit words
     uint8_t len;
+    // Buffer being refilled while it plays, if playing a stream
+    uint16_t *stream;
+    // Called to refill each half of the stream once it has been encoded
+    pbdrv_sound_stream_callback_t callback;
 } sample;
 
 #if (PDM_ENCODE == PDM_LOOKUP)
@@ -238,10 +244,24 @@ static void sound_fill_sample_buffer(void) {
 
 #endif // (PDM_ENCODE == PDM_LOOKUP)
 
+// Pybricks: requests new data for the part of a stream that was just encoded.
+static void sound_fill_stream(uint32_t out_index_before) {
+    if (!sample.callback) {
+        return;
+    }
+
+    uint32_t half = sample.in_index / 2;
+    if (out_index_before < half && sample.out_index >= half) {
+        sample.callback(sample.stream, half);
+    } else if (sample.out_index == sample.in_index && out_index_before != sample.in_index) {
+        sample.callback(sample.stream + half, sample.in_index - half);
+    }
+}
+
 static void sound_isr(void) {
     // Pybricks: for now, driver expects sound to always repeat
     if (sample.count <= 0) {
-        sample.count = sample.out_index;
+        sample.count = (sample.in_index + SAMPLE_PER_BUF - 1) / SAMPLE_PER_BUF;
         sample.out_index = 0;
     }
 
@@ -253,7 +273,9 @@ static void sound_isr(void) {
         //     sample.count--;
         // }
 
+        uint32_t out_index_before = sample.out_index;
         sound_fill_sample_buffer();
+        sound_fill_stream(out_index_before);
         *AT91C_SSC_TNPR = (unsigned int)sample.buf[sample.buf_id];
         *AT91C_SSC_TNCR = sample.len;
         sample.count--;
@@ -316,6 +338,8 @@ void pbdrv_sound_start(const uint16_t *data, uint32_t length, uint32_t sample_ra
     sample.in_index = length;
     sample.ptr = data;
     sample.len = PDM_BUFFER_LENGTH;
+    sample.stream = NULL;
+    sample.callback = NULL;
 
     // Calculate the clock divisor based upon the recorded sample frequency
     *AT91C_SSC_CMR = (OSC / (2 * SAMPLE_BITS) + sample_rate / 2) / sample_rate;
@@ -326,9 +350,16 @@ void pbdrv_sound_start(const uint16_t *data, uint32_t length, uint32_t sample_ra
     *AT91C_SSC_PTCR = AT91C_PDC_TXTEN;
 }
 
+void pbdrv_sound_start_stream(uint16_t *data, uint32_t length, uint32_t sample_rate, pbdrv_sound_stream_callback_t callback) {
+    pbdrv_sound_start(data, length, sample_rate);
+    sample.stream = data;
+    sample.callback = callback;
+}
+
 void pbdrv_sound_stop(void) {
     sound_disable();
     sound_interrupt_disable();
+    sample.callback = NULL;
 }
 
 #endif // PBDRV_CONFIG_SOUND_NXT
@@ -7,8 +7,11 @@
 
 #if PBDRV_CONFIG_SOUND_STM32_HAL_DAC
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <pbdrv/sound.h>
+
 #include "sound_stm32_hal_dac.h"
 
 #include STM32_HAL_H
@@ -17,6 +20,11 @@ static DMA_HandleTypeDef pbdrv_sound_hdma;
 static DAC_HandleTypeDef pbdrv_sound_hdac;
 static TIM_HandleTypeDef pbdrv_sound_htim;
 
+// Buffer and callback of the active stream, if any.
+static uint16_t *pbdrv_sound_stream_data;
+static uint32_t pbdrv_sound_stream_length;
+static pbdrv_sound_stream_callback_t pbdrv_sound_stream_callback;
+
 void pbdrv_sound_init(void) {
     const pbdrv_sound_stm32_hal_dac_platform_data_t *pdata = &pbdrv_sound_stm32_hal_dac_platform_data;
 
@@ -74,17 +82,52 @@ void pbdrv_sound_init(void) {
 void pbdrv_sound_start(const uint16_t *data, uint32_t length, uint32_t sample_rate) {
     const pbdrv_sound_stm32_hal_dac_platform_data_t *pdata = &pbdrv_sound_stm32_hal_dac_platform_data;
 
+    // Stop any previous sound so the callback can be updated safely.
+    HAL_DAC_Stop_DMA(&pbdrv_sound_hdac, pdata->dac_ch);
+    pbdrv_sound_stream_callback = NULL;
+
     HAL_GPIO_WritePin(pdata->enable_gpio_bank, pdata->enable_gpio_pin, GPIO_PIN_SET);
     pbdrv_sound_htim.Init.Period = pdata->tim_clock_rate / sample_rate - 1;
     HAL_TIM_Base_Init(&pbdrv_sound_htim);
     HAL_DAC_Start_DMA(&pbdrv_sound_hdac, pdata->dac_ch, (uint32_t *)data, length, DAC_ALIGN_12B_L);
 }
 
+void pbdrv_sound_start_stream(uint16_t *data, uint32_t length, uint32_t sample_rate, pbdrv_sound_stream_callback_t callback) {
+    pbdrv_sound_start(data, length, sample_rate);
+    pbdrv_sound_stream_data = data;
+    pbdrv_sound_stream_length = length;
+    pbdrv_sound_stream_callback = callback;
+}
+
 void pbdrv_sound_stop(void) {
     const pbdrv_sound_stm32_hal_dac_platform_data_t *pdata = &pbdrv_sound_stm32_hal_dac_platform_data;
 
     HAL_GPIO_WritePin(pdata->enable_gpio_bank, pdata->enable_gpio_pin, GPIO_PIN_RESET);
     HAL_DAC_Stop_DMA(&pbdrv_sound_hdac, pdata->dac_ch);
+    pbdrv_sound_stream_callback = NULL;
+}
+
+static void pbdrv_sound_stream_fill(uint32_t half) {
+    if (pbdrv_sound_stream_callback) {
+        uint32_t size = pbdrv_sound_stream_length / 2;
+        pbdrv_sound_stream_callback(pbdrv_sound_stream_data + half * size, size);
+    }
+}
+
+void HAL_DAC_ConvHalfCpltCallbackCh1(DAC_HandleTypeDef *hdac) {
+    pbdrv_sound_stream_fill(0);
+}
+
+void HAL_DAC_ConvCpltCallbackCh1(DAC_HandleTypeDef *hdac) {
+    pbdrv_sound_stream_fill(1);
+}
+
+void HAL_DACEx_ConvHalfCpltCallbackCh2(DAC_HandleTypeDef *hdac) {
+    pbdrv_sound_stream_fill(0);
+}
+
+void HAL_DACEx_ConvCpltCallbackCh2(DAC_HandleTypeDef *hdac) {
+    pbdrv_sound_stream_fill(1);
 }
 
 void pbdrv_sound_stm32_hal_dac_handle_dma_irq(void) {
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+// Software sound implementation for checking sound output in tests
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_SOUND_TEST
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <pbdrv/sound.h>
+
+static const uint16_t *test_sound_data;
+static uint32_t test_sound_length;
+static uint32_t test_sound_sample_rate;
+static pbdrv_sound_stream_callback_t test_sound_callback;
+
+// Half of the buffer that plays next.
+static uint32_t test_sound_half;
+
+void pbdrv_sound_init(void) {
+}
+
+void pbdrv_sound_start(const uint16_t *data, uint32_t length, uint32_t sample_rate) {
+    test_sound_data = data;
+    test_sound_length = length;
+    test_sound_sample_rate = sample_rate;
+    test_sound_callback = NULL;
+    test_sound_half = 0;
+}
+
+void pbdrv_sound_start_stream(uint16_t *data, uint32_t length, uint32_t sample_rate, pbdrv_sound_stream_callback_t callback) {
+    pbdrv_sound_start(data, length, sample_rate);
+    test_sound_callback = callback;
+}
+
+void pbdrv_sound_stop(void) {
+    test_sound_data = NULL;
+    test_sound_length = 0;
+    test_sound_callback = NULL;
+}
+
+/**
+ * Plays the next half of the sound buffer, like the DMA would.
+ *
+ * @param [out] data        Buffer that receives the samples that were played.
+ * @param [out] sample_rate The sample rate of the played samples.
+ * @return                  Number of samples played, or 0 if nothing is playing.
+ */
+uint32_t pbio_test_sound_play(uint16_t *data, uint32_t *sample_rate) {
+    if (!test_sound_data) {
+        return 0;
+    }
+
+    uint32_t size = test_sound_length / 2;
+    uint16_t *half = (uint16_t *)test_sound_data + test_sound_half * size;
+    memcpy(data, half, size * sizeof(uint16_t));
+    *sample_rate = test_sound_sample_rate;
+
+    if (test_sound_callback) {
+        test_sound_callback(half, size);
+    }
+    test_sound_half ^= 1;
+
+    return size;
+}
+
+#endif // PBDRV_CONFIG_SOUND_TEST
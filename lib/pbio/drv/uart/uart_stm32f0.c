@@ -35,6 +35,7 @@ typedef struct {
     uint8_t rx_ring_buf[UART_RING_BUF_SIZE];
     volatile uint8_t rx_ring_buf_head;
     uint8_t rx_ring_buf_tail;
+    uint8_t rx_ring_buf_notified;
     uint8_t *rx_buf;
     uint8_t rx_buf_size;
     uint8_t rx_buf_index;
@@ -116,6 +117,23 @@ void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart_dev) {
     uart->rx_result = PBIO_ERROR_CANCELED;
 }
 
+uint32_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart_dev, uint8_t *buf, uint32_t length) {
+    pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
+
+    if (uart->rx_buf) {
+        // Don't steal bytes from a pending read.
+        return 0;
+    }
+
+    uint32_t size = 0;
+    while (size < length && uart->rx_ring_buf_head != uart->rx_ring_buf_tail) {
+        buf[size++] = uart->rx_ring_buf[uart->rx_ring_buf_tail];
+        uart->rx_ring_buf_tail = (uart->rx_ring_buf_tail + 1) & (UART_RING_BUF_SIZE - 1);
+    }
+
+    return size;
+}
+
 pbio_error_t pbdrv_uart_write_begin(pbdrv_uart_dev_t *uart_dev, uint8_t *msg, uint8_t length, uint32_t timeout) {
     pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
 
@@ -178,6 +196,7 @@ void pbdrv_uart_flush(pbdrv_uart_dev_t *uart_dev) {
     uart->rx_buf = NULL;
     uart->rx_ring_buf_head = 0;
     uart->rx_ring_buf_tail = 0;
+    uart->rx_ring_buf_notified = 0;
     uart->rx_buf_size = 0;
     uart->rx_buf_index = 0;
 }
@@ -231,6 +250,13 @@ static void handle_poll(void) {
             }
         }
 
+        // notify once when new bytes are waiting for pbdrv_uart_read_available()
+        uint8_t head = uart->rx_ring_buf_head;
+        if (!uart->rx_buf && head != uart->rx_ring_buf_tail && head != uart->rx_ring_buf_notified) {
+            uart->rx_ring_buf_notified = head;
+            process_post(PROCESS_BROADCAST, PROCESS_EVENT_COM, NULL);
+        }
+
         if (uart->tx_buf && uart->tx_buf_index == uart->tx_buf_size) {
             // TODO: this should only be sent once per write_begin
             process_post(PROCESS_BROADCAST, PROCESS_EVENT_COM, NULL);
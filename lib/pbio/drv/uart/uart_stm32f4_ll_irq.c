@@ -34,6 +34,8 @@ typedef struct {
     const pbdrv_uart_stm32f4_ll_irq_platform_data_t *pdata;
     /** Circular buffer for caching received bytes. */
     struct ringbuf rx_buf;
+    /** Ring buffer put position when new bytes were last announced. */
+    uint8_t rx_notified_pos;
     /** Timer for read timeout. */
     struct etimer read_timer;
     /** Timer for write timeout. */
@@ -110,6 +112,26 @@ void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart_dev) {
     // TODO
 }
 
+uint32_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart_dev, uint8_t *buf, uint32_t length) {
+    pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
+
+    if (uart->read_buf) {
+        // Don't steal bytes from a pending read.
+        return 0;
+    }
+
+    uint32_t size = 0;
+    while (size < length) {
+        int c = ringbuf_get(&uart->rx_buf);
+        if (c == -1) {
+            break;
+        }
+        buf[size++] = c;
+    }
+
+    return size;
+}
+
 pbio_error_t pbdrv_uart_write_begin(pbdrv_uart_dev_t *uart_dev, uint8_t *msg, uint8_t length, uint32_t timeout) {
     pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
 
@@ -231,6 +253,13 @@ static void handle_poll(void) {
             process_post(PROCESS_BROADCAST, PROCESS_EVENT_COM, NULL);
         }
 
+        // broadcast once when new bytes are waiting for pbdrv_uart_read_available()
+        uint8_t put_pos = uart->rx_buf.put_ptr;
+        if (!uart->read_buf && ringbuf_elements(&uart->rx_buf) && put_pos != uart->rx_notified_pos) {
+            uart->rx_notified_pos = put_pos;
+            process_post(PROCESS_BROADCAST, PROCESS_EVENT_COM, NULL);
+        }
+
         // broadcast when write_buf is drained
         if (uart->write_buf && uart->write_pos == uart->write_length) {
             // clearing write_buf to prevent multiple broadcasts
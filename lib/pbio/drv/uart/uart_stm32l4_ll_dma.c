@@ -36,7 +36,10 @@ typedef struct {
     struct etimer rx_timer;
     struct etimer tx_timer;
     volatile uint8_t *rx_data;
-    uint8_t rx_tail;
+    /** Number of times the receive DMA wrapped around rx_data. */
+    volatile uint32_t rx_laps;
+    /** Total number of received bytes that have been read. */
+    uint32_t rx_tail;
     uint8_t *read_buf;
     uint8_t read_length;
 } pbdrv_uart_t;
@@ -202,15 +205,58 @@ static bool dma_is_ht(DMA_TypeDef *DMAx, uint32_t channel) {
     }
 }
 
+// Gets the total number of bytes received by the DMA, so that we can tell
+// when it has wrapped around past bytes that have not been read yet.
+static uint32_t get_rx_head(pbdrv_uart_t *uart) {
+    const pbdrv_uart_stm32l4_ll_dma_platform_data_t *pdata = uart->pdata;
+
+    uint32_t irq = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t laps = uart->rx_laps;
+    uint32_t pos = RX_DATA_SIZE - LL_DMA_GetDataLength(pdata->rx_dma, pdata->rx_dma_ch);
+
+    // The DMA may have wrapped around before the interrupt was handled.
+    if (dma_is_tc(pdata->rx_dma, pdata->rx_dma_ch) && pos < RX_DATA_SIZE / 2) {
+        laps++;
+    }
+
+    __set_PRIMASK(irq);
+
+    return laps * RX_DATA_SIZE + pos;
+}
+
+// Copies received bytes from the DMA ring buffer, starting at the tail.
+static void copy_rx_data(pbdrv_uart_t *uart, uint8_t *buf, uint32_t size) {
+    uint32_t tail = uart->rx_tail & (RX_DATA_SIZE - 1);
+
+    if (tail + size > RX_DATA_SIZE) {
+        uint32_t partial_size = RX_DATA_SIZE - tail;
+        volatile_copy(&uart->rx_data[tail], &buf[0], partial_size);
+        volatile_copy(&uart->rx_data[0], &buf[partial_size], size - partial_size);
+    } else {
+        volatile_copy(&uart->rx_data[tail], &buf[0], size);
+    }
+
+    uart->rx_tail += size;
+}
+
 pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart_dev) {
     pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
-    const pbdrv_uart_stm32l4_ll_dma_platform_data_t *pdata = uart->pdata;
-    uint32_t rx_head;
 
-    // head is the last position that DMA wrote to
-    rx_head = RX_DATA_SIZE - LL_DMA_GetDataLength(pdata->rx_dma, pdata->rx_dma_ch);
+    uint32_t rx_head = get_rx_head(uart);
+    uint32_t available = rx_head - uart->rx_tail;
+
+    // If the DMA overwrote bytes that were not read yet, drop everything
+    // received so far and let the caller resync.
+    if (available > RX_DATA_SIZE) {
+        uart->rx_tail = rx_head;
+        uart->read_buf = NULL;
+        uart->read_length = 0;
+        etimer_stop(&uart->rx_timer);
+        return PBIO_ERROR_IO;
+    }
 
-    uint32_t available = (rx_head - uart->rx_tail) & (RX_DATA_SIZE - 1);
     if (available < uart->read_length) {
         if (etimer_expired(&uart->rx_timer)) {
             uart->read_buf = NULL;
@@ -220,15 +266,7 @@ pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart_dev) {
         return PBIO_ERROR_AGAIN;
     }
 
-    if (uart->rx_tail + uart->read_length > RX_DATA_SIZE) {
-        uint32_t partial_size = RX_DATA_SIZE - uart->rx_tail;
-        volatile_copy(&uart->rx_data[uart->rx_tail], &uart->read_buf[0], partial_size);
-        volatile_copy(&uart->rx_data[0], &uart->read_buf[partial_size], uart->read_length - partial_size);
-    } else {
-        volatile_copy(&uart->rx_data[uart->rx_tail], &uart->read_buf[0], uart->read_length);
-    }
-
-    uart->rx_tail = (uart->rx_tail + uart->read_length) & (RX_DATA_SIZE - 1);
+    copy_rx_data(uart, uart->read_buf, uart->read_length);
     uart->read_buf = NULL;
     uart->read_length = 0;
 
@@ -241,6 +279,36 @@ void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart_dev) {
     // TODO
 }
 
+uint32_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart_dev, uint8_t *buf, uint32_t length) {
+    pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
+
+    if (uart->read_buf) {
+        // Don't steal bytes from a pending read.
+        return 0;
+    }
+
+    // Circular DMA keeps writing into rx_data, so everything between our tail
+    // and the DMA head can be copied out in at most two chunks.
+    uint32_t rx_head = get_rx_head(uart);
+    uint32_t size = rx_head - uart->rx_tail;
+
+    // If the DMA overwrote bytes that were not read yet, skip ahead to the
+    // oldest byte that is still intact. The caller drops the partial message
+    // and resyncs.
+    if (size > RX_DATA_SIZE) {
+        uart->rx_tail = rx_head - RX_DATA_SIZE / 2;
+        size = RX_DATA_SIZE / 2;
+    }
+
+    if (size > length) {
+        size = length;
+    }
+
+    copy_rx_data(uart, buf, size);
+
+    return size;
+}
+
 pbio_error_t pbdrv_uart_write_begin(pbdrv_uart_dev_t *uart_dev, uint8_t *msg, uint8_t length, uint32_t timeout) {
     pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
     const pbdrv_uart_stm32l4_ll_dma_platform_data_t *pdata = uart->pdata;
@@ -347,6 +415,7 @@ void pbdrv_uart_stm32l4_ll_dma_handle_rx_dma_irq(uint8_t id) {
 
     if (LL_DMA_IsEnabledIT_TC(pdata->rx_dma, pdata->rx_dma_ch) && dma_is_tc(pdata->rx_dma, pdata->rx_dma_ch)) {
         dma_clear_tc(pdata->rx_dma, pdata->rx_dma_ch);
+        pbdrv_uart[id].rx_laps++;
         process_poll(&pbdrv_uart_process);
     }
 }
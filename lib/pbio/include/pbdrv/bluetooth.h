@@ -207,6 +207,18 @@ typedef void (*pbdrv_bluetooth_start_observing_callback_t)(pbdrv_bluetooth_ad_ty
 #define PBDRV_BLUETOOTH_MAX_MTU_SIZE 23
 #endif
 
+/** Broadcast data update statistics. */
+typedef struct {
+    /**
+     * Number of times the Bluetooth chip accepted new advertising data, i.e.
+     * the set advertising data command completed. This is not the number of
+     * advertisements sent over the air.
+     */
+    uint32_t submitted;
+    /** Number of updates that were replaced by newer data before they were sent. */
+    uint32_t replaced;
+} pbdrv_bluetooth_broadcast_stats_t;
+
 #if PBDRV_CONFIG_BLUETOOTH
 
 /**
@@ -269,6 +281,19 @@ void pbdrv_bluetooth_stop_advertising(void);
  */
 bool pbdrv_bluetooth_is_connected(pbdrv_bluetooth_connection_t connection);
 
+/**
+ * Gets the negotiated ATT MTU of a connection.
+ *
+ * The usable size of a characteristic value or notification is 3 bytes less
+ * than the MTU.
+ *
+ * @param [in]  connection  ::PBDRV_BLUETOOTH_CONNECTION_PYBRICKS or
+ *                          ::PBDRV_BLUETOOTH_CONNECTION_PERIPHERAL.
+ * @return                  The MTU or 23 (the minimum MTU) if there is no
+ *                          such connection or it has not been negotiated.
+ */
+uint16_t pbdrv_bluetooth_get_mtu(pbdrv_bluetooth_connection_t connection);
+
 /**
  * Registers a callback that is called when Bluetooth event occurs.
  *
@@ -373,6 +398,48 @@ void pbdrv_bluetooth_start_broadcasting(pbio_task_t *task, pbdrv_bluetooth_value
  */
 void pbdrv_bluetooth_stop_broadcasting(pbio_task_t *task);
 
+/**
+ * Replaces the advertising data while broadcasting, without restarting it.
+ *
+ * This returns right away. The data is copied and sent to the Bluetooth chip
+ * as soon as it is free. If this is called again before that, the previous
+ * data is replaced by the new data, so the most recent data is always sent
+ * first.
+ *
+ * @param [in]  value   The advertising data.
+ * @return              ::PBIO_SUCCESS if the data will be sent,
+ *                      ::PBIO_ERROR_INVALID_OP if not broadcasting, in which
+ *                      case pbdrv_bluetooth_start_broadcasting() must be used,
+ *                      or ::PBIO_ERROR_INVALID_ARG if the data is too long.
+ */
+pbio_error_t pbdrv_bluetooth_update_broadcasting(const pbdrv_bluetooth_value_t *value);
+
+/** Shortest supported broadcast interval in milliseconds. */
+#define PBDRV_BLUETOOTH_BROADCAST_INTERVAL_MIN (20)
+
+/** Longest supported broadcast interval in milliseconds. */
+#define PBDRV_BLUETOOTH_BROADCAST_INTERVAL_MAX (10240)
+
+/**
+ * Sets the advertising interval used for broadcasting.
+ *
+ * This takes effect the next time broadcasting is started.
+ *
+ * @param [in]  interval    The interval in milliseconds, or 0 for the default.
+ * @return                  ::PBIO_SUCCESS on success,
+ *                          ::PBIO_ERROR_INVALID_ARG if the interval is out of
+ *                          range or ::PBIO_ERROR_NOT_SUPPORTED if the
+ *                          Bluetooth chip does not support setting it.
+ */
+pbio_error_t pbdrv_bluetooth_set_broadcast_interval(uint32_t interval);
+
+/**
+ * Gets the broadcast data update statistics since broadcasting was started.
+ *
+ * @param [out] stats   The statistics.
+ */
+void pbdrv_bluetooth_get_broadcast_stats(pbdrv_bluetooth_broadcast_stats_t *stats);
+
 /**
  * Starts observing, non-connectable, non-scannable advertisements.
  *
@@ -421,6 +488,10 @@ static inline bool pbdrv_bluetooth_is_connected(pbdrv_bluetooth_connection_t con
     return false;
 }
 
+static inline uint16_t pbdrv_bluetooth_get_mtu(pbdrv_bluetooth_connection_t connection) {
+    return 23;
+}
+
 static inline void pbdrv_bluetooth_send(pbdrv_bluetooth_send_context_t *context) {
     if (context->done) {
         context->done();
@@ -469,6 +540,19 @@ static inline void pbdrv_bluetooth_stop_broadcasting(pbio_task_t *task) {
     task->status = PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline pbio_error_t pbdrv_bluetooth_update_broadcasting(const pbdrv_bluetooth_value_t *value) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
+static inline pbio_error_t pbdrv_bluetooth_set_broadcast_interval(uint32_t interval) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
+static inline void pbdrv_bluetooth_get_broadcast_stats(pbdrv_bluetooth_broadcast_stats_t *stats) {
+    stats->sent = 0;
+    stats->replaced = 0;
+}
+
 static inline void pbdrv_bluetooth_start_observing(pbio_task_t *task, pbdrv_bluetooth_start_observing_callback_t callback) {
     task->status = PBIO_ERROR_NOT_SUPPORTED;
 }
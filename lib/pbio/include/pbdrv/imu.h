@@ -58,11 +58,24 @@ pbio_error_t pbdrv_imu_get_imu(pbdrv_imu_dev_t **imu_dev, pbdrv_imu_config_t **c
 bool pbdrv_imu_is_stationary(pbdrv_imu_dev_t *imu_dev);
 
 /**
- * Callback to process one frame of unfiltered gyro and accelerometer data.
+ * Gets the most recent temperature of the IMU.
  *
- * @param [in]  data        Array with unscaled gyro (xyz) and acceleration (xyz) samples to process.
+ * This is updated about once per second.
+ *
+ * @param [in]  imu_dev     The IMU device instance.
+ * @return                  Temperature in degrees Celsius.
+ */
+float pbdrv_imu_get_temperature(pbdrv_imu_dev_t *imu_dev);
+
+/**
+ * Callback to process consecutive frames of unfiltered gyro and accelerometer data.
+ *
+ * @param [in]  data        Array with unscaled gyro (xyz) and acceleration (xyz) samples to process,
+ *                          six values per frame.
+ * @param [in]  num_frames  Number of frames in @p data, oldest first.
+ * @param [in]  time        Time at which the last frame was sampled (us).
  */
-typedef void (*pbdrv_imu_handle_frame_data_func_t)(int16_t *data);
+typedef void (*pbdrv_imu_handle_frame_data_func_t)(int16_t *data, uint32_t num_frames, uint32_t time);
 
 /**
  * Callback to process @p num_samples unfiltered gyro and accelerometer data
@@ -78,7 +91,7 @@ typedef void (*pbdrv_imu_handle_stationary_data_func_t)(const int32_t *gyro_data
  * Sets the data handlers for processing new data.
  *
  * @param [in]  imu_dev                The IMU device instance.
- * @param [in]  frame_data_func        Callback that handles one data frame.
+ * @param [in]  frame_data_func        Callback that handles a batch of data frames.
  * @param [in]  stationary_data_func   Callback that handles multiple stationary data frames.
  */
 void pbdrv_imu_set_data_handlers(pbdrv_imu_dev_t *imu_dev, pbdrv_imu_handle_frame_data_func_t frame_data_func, pbdrv_imu_handle_stationary_data_func_t stationary_data_func);
@@ -93,6 +106,10 @@ static inline bool pbdrv_imu_is_stationary(pbdrv_imu_dev_t *imu_dev) {
     return false;
 }
 
+static inline float pbdrv_imu_get_temperature(pbdrv_imu_dev_t *imu_dev) {
+    return 0.0f;
+}
+
 #endif // PBDRV_CONFIG_IMU
 
 #endif // PBDRV_IMU_H
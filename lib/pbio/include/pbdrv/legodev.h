@@ -413,6 +413,25 @@ typedef enum {
  */
 #define PBDRV_LEGODEV_MAX_DATA_SIZE    LUMP_MAX_MSG_SIZE
 
+/**
+ * Max number of values in a mode combination.
+ */
+#define PBDRV_LEGODEV_MAX_COMBI_ITEMS  LUMP_MAX_COMBI_ITEMS
+
+/**
+ * Mode used to get the data of a mode combination. It is set with
+ * ::pbdrv_legodev_set_mode_combi instead of ::pbdrv_legodev_set_mode.
+ */
+#define PBDRV_LEGODEV_MODE_COMBI       (0xFF)
+
+/**
+ * Selects one value in a mode combination.
+ *
+ * @param [in]  mode        The mode that provides the value.
+ * @param [in]  dataset     The index of the value within that mode.
+ */
+#define PBDRV_LEGODEV_COMBI_ITEM(mode, dataset) ((uint8_t)(((mode) << 4) | (dataset)))
+
 /**
  * I/O device capability flags.
  */
@@ -481,9 +500,25 @@ typedef struct {
     uint8_t num_modes;
     /**< Information about the current mode. */
     pbdrv_legodev_mode_info_t mode_info[PBDRV_LEGODEV_MAX_NUM_MODES];
+    /**< Bit mask of modes that may be used together in a mode combination. */
+    uint16_t mode_combos;
     #endif
 } pbdrv_legodev_info_t;
 
+/**
+ * Arrival statistics of data received from a legodev device.
+ */
+typedef struct {
+    /** Time when the most recent sample arrived, in milliseconds. */
+    uint32_t time;
+    /** Number of samples received since the device was connected. */
+    uint32_t count;
+    /** Number of times that one or more messages were lost due to transmission errors. */
+    uint32_t num_missed;
+    /** Average time between samples in the current mode, in microseconds, or 0 if not yet known. */
+    uint32_t interval;
+} pbdrv_legodev_sample_info_t;
+
 #if PBDRV_CONFIG_LEGODEV
 
 /**
@@ -508,6 +543,20 @@ pbio_error_t pbdrv_legodev_get_device(pbio_port_id_t port_id, pbdrv_legodev_type
  */
 pbio_error_t pbdrv_legodev_get_info(pbdrv_legodev_dev_t *legodev, pbdrv_legodev_info_t **info);
 
+/**
+ * Gets arrival statistics of the data received from the legodev device.
+ *
+ * The sample count increments each time new data arrives for the requested
+ * mode, so it can be used to tell if the data has been updated.
+ *
+ * @param [in]  legodev   The legodev device instance.
+ * @param [out] info      The sample statistics.
+ * @return                ::PBIO_SUCCESS on success.
+ *                        ::PBIO_ERROR_NO_DEV if no device is attached.
+ *                        ::PBIO_ERROR_NOT_SUPPORTED if the device does not support it.
+ */
+pbio_error_t pbdrv_legodev_get_sample_info(pbdrv_legodev_dev_t *legodev, pbdrv_legodev_sample_info_t **info);
+
 /**
  * Checks if the legodev device is ready for reading or writing data.
  *
@@ -539,6 +588,22 @@ pbio_error_t pbdrv_legodev_set_mode(pbdrv_legodev_dev_t *legodev, uint8_t mode);
  */
 pbio_error_t pbdrv_legodev_set_mode_with_data(pbdrv_legodev_dev_t *legodev, uint8_t mode, const void *data, uint8_t size);
 
+/**
+ * Starts setting a mode combination, so that values from several modes are
+ * received together in one message. The data is read using
+ * ::PBDRV_LEGODEV_MODE_COMBI as the mode, with the values in the given order.
+ *
+ * @param [in]  legodev   The legodev device instance.
+ * @param [in]  items     The values to combine, see ::PBDRV_LEGODEV_COMBI_ITEM.
+ * @param [in]  num_items The number of values.
+ * @return                ::PBIO_SUCCESS on success or if already set.
+ *                        ::PBIO_ERROR_NO_DEV if no device is attached.
+ *                        ::PBIO_ERROR_NOT_SUPPORTED if the device does not support these mode combinations.
+ *                        ::PBIO_ERROR_INVALID_ARG if the values are not valid.
+ *                        ::PBIO_ERROR_AGAIN if the device is not ready for this operation.
+ */
+pbio_error_t pbdrv_legodev_set_mode_combi(pbdrv_legodev_dev_t *legodev, const uint8_t *items, uint8_t num_items);
+
 /**
  * Gets data from the legodev device.
  *
@@ -618,6 +683,10 @@ static inline pbio_error_t pbdrv_legodev_get_info(pbdrv_legodev_dev_t *legodev,
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline pbio_error_t pbdrv_legodev_get_sample_info(pbdrv_legodev_dev_t *legodev, pbdrv_legodev_sample_info_t **info) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 static inline pbio_error_t pbdrv_legodev_is_ready(pbdrv_legodev_dev_t *legodev) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
@@ -630,6 +699,10 @@ static inline pbio_error_t pbdrv_legodev_set_mode_with_data(pbdrv_legodev_dev_t
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline pbio_error_t pbdrv_legodev_set_mode_combi(pbdrv_legodev_dev_t *legodev, const uint8_t *items, uint8_t num_items) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 static inline pbio_error_t pbdrv_legodev_get_data(pbdrv_legodev_dev_t *legodev, uint8_t mode, void **data) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
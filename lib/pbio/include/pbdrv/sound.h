@@ -15,6 +15,16 @@
 #include <pbio/error.h>
 
 
+/**
+ * Callback that provides new data for a sound stream.
+ *
+ * This is called from the sound interrupt, so it must be fast.
+ *
+ * @param [out] data        The part of the stream buffer to fill.
+ * @param [in]  length      The number of samples in @p data.
+ */
+typedef void (*pbdrv_sound_stream_callback_t)(uint16_t *data, uint32_t length);
+
 #if PBDRV_CONFIG_SOUND
 
 /**
@@ -26,6 +36,20 @@
  */
 void pbdrv_sound_start(const uint16_t *data, uint32_t length, uint32_t sample_rate);
 
+/**
+ * Starts playing a sound stream until pbdrv_sound_stop() is called.
+ *
+ * The buffer is played repeatedly, just like with pbdrv_sound_start(). Each
+ * time one half of the buffer has been played, @p callback is called to fill
+ * that half with new data while the other half is playing.
+ *
+ * @param [in]  data        Buffer with the initial data of the stream.
+ * @param [in]  length      The number of samples in @p data. Must be even.
+ * @param [in]  sample_rate The sample rate of @p data in Hz.
+ * @param [in]  callback    Function that fills one half of @p data.
+ */
+void pbdrv_sound_start_stream(uint16_t *data, uint32_t length, uint32_t sample_rate, pbdrv_sound_stream_callback_t callback);
+
 /**
  * Stops any currently playing sound.
  */
@@ -37,6 +61,9 @@ void pbdrv_sound_stop(void);
 static inline void pbdrv_sound_start(const uint16_t *data, uint32_t length, uint32_t sample_rate) {
 }
 
+static inline void pbdrv_sound_start_stream(uint16_t *data, uint32_t length, uint32_t sample_rate, pbdrv_sound_stream_callback_t callback) {
+}
+
 static inline void pbdrv_sound_stop(void) {
 }
 
@@ -33,6 +33,21 @@ void pbdrv_uart_set_baud_rate(pbdrv_uart_dev_t *uart, uint32_t baud);
 pbio_error_t pbdrv_uart_read_begin(pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint32_t timeout);
 pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart);
 void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart);
+
+/**
+ * Copies bytes that have already been received, without waiting.
+ *
+ * Reception runs continuously in the background, so bytes that arrive between
+ * calls are kept in the driver ring buffer until they are read. Drivers
+ * broadcast ::PROCESS_EVENT_COM when new bytes are available. Must not be
+ * mixed with a pending pbdrv_uart_read_begin() on the same UART.
+ *
+ * @param [in]  uart    The UART device
+ * @param [out] buf     Buffer to store the received bytes
+ * @param [in]  length  Size of @p buf in bytes
+ * @return              Number of bytes copied to @p buf
+ */
+uint32_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart, uint8_t *buf, uint32_t length);
 pbio_error_t pbdrv_uart_write_begin(pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint32_t timeout);
 pbio_error_t pbdrv_uart_write_end(pbdrv_uart_dev_t *uart);
 void pbdrv_uart_write_cancel(pbdrv_uart_dev_t *uart);
@@ -54,6 +69,9 @@ static inline pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart) {
 }
 static inline void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart) {
 }
+static inline uint32_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart, uint8_t *buf, uint32_t length) {
+    return 0;
+}
 static inline pbio_error_t pbdrv_uart_write_begin(pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint32_t timeout) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
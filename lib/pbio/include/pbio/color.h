@@ -11,8 +11,11 @@
 #ifndef _PBIO_COLOR_H_
 #define _PBIO_COLOR_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <pbio/error.h>
+
 /** @cond INTERNAL */
 
 /**
@@ -112,6 +115,61 @@ typedef struct __attribute__((__packed__)) {
     int8_t v;
 } pbio_color_compressed_hsv_t;
 
+/**
+ * HSV color mapped into the chroma-lightness bicone, so that colors can be
+ * compared without computing the sine and cosine of the hue each time.
+ */
+typedef struct {
+    /** Chroma times the cosine of the hue, scaled by 10000. */
+    int32_t x;
+    /** Chroma times the sine of the hue, scaled by 10000. */
+    int32_t y;
+    /** Lightness. */
+    int32_t z;
+} pbio_color_bicone_t;
+
+/**
+ * Raw color reading of a sensor, in the units of that sensor.
+ */
+typedef union {
+    struct {
+        /** The red component. */
+        int32_t r;
+        /** The green component. */
+        int32_t g;
+        /** The blue component. */
+        int32_t b;
+    };
+    /** The red, green, and blue components as an array. */
+    int32_t values[3];
+} pbio_color_raw_t;
+
+/**
+ * Gains of ::pbio_color_calibration_t are scaled by this value.
+ */
+#define PBIO_COLOR_CALIBRATION_GAIN_SCALE (1024)
+
+/**
+ * Smallest difference between the raw black and white reference readings
+ * of a channel, in raw units.
+ */
+#define PBIO_COLOR_CALIBRATION_SPAN_MIN (8)
+
+/**
+ * Calibration that maps raw readings of a color sensor to RGB values.
+ */
+typedef struct _pbio_color_calibration_t {
+    /**
+     * Raw reading of a black surface, subtracted from each raw reading.
+     */
+    int16_t offset[3];
+    /**
+     * Color correction matrix from raw readings with the offset removed to
+     * RGB values from 0 to 255, scaled by ::PBIO_COLOR_CALIBRATION_GAIN_SCALE.
+     */
+    int16_t gain[3][3];
+} pbio_color_calibration_t;
+
 void pbio_color_rgb_to_hsv(const pbio_color_rgb_t *rgb, pbio_color_hsv_t *hsv);
 void pbio_color_hsv_to_rgb(const pbio_color_hsv_t *hsv, pbio_color_rgb_t *rgb);
 void pbio_color_to_hsv(pbio_color_t color, pbio_color_hsv_t *hsv);
@@ -119,6 +177,13 @@ void pbio_color_to_rgb(pbio_color_t color, pbio_color_rgb_t *rgb);
 void pbio_color_hsv_compress(const pbio_color_hsv_t *hsv, pbio_color_compressed_hsv_t *compressed);
 void pbio_color_hsv_expand(const pbio_color_compressed_hsv_t *compressed, pbio_color_hsv_t *hsv);
 int32_t pbio_color_get_bicone_squared_distance(const pbio_color_hsv_t *hsv_a, const pbio_color_hsv_t *hsv_b);
+void pbio_color_hsv_to_bicone(const pbio_color_hsv_t *hsv, pbio_color_bicone_t *bicone);
+int32_t pbio_color_bicone_get_squared_distance(const pbio_color_bicone_t *bicone_a, const pbio_color_bicone_t *bicone_b);
+size_t pbio_color_bicone_get_nearest(const pbio_color_bicone_t *bicones, size_t num_bicones, const pbio_color_hsv_t *hsv);
+void pbio_color_calibration_set_defaults(pbio_color_calibration_t *calibration, int32_t full_scale);
+pbio_error_t pbio_color_calibration_set_reference(pbio_color_calibration_t *calibration, pbio_color_t color, const pbio_color_raw_t *raw);
+void pbio_color_calibration_get_rgb(const pbio_color_calibration_t *calibration, const pbio_color_raw_t *raw, const pbio_color_raw_t *ambient, pbio_color_rgb_t *rgb);
+void pbio_color_calibration_get_hsv(const pbio_color_calibration_t *calibration, const pbio_color_raw_t *raw, const pbio_color_raw_t *ambient, pbio_color_hsv_t *hsv);
 
 #endif // _PBIO_COLOR_H_
 
@@ -30,4 +30,33 @@
 
 #define PBIO_CONFIG_NUM_DRIVEBASES (PBIO_CONFIG_SERVO_NUM_DEV / 2)
 
+#ifndef PBIO_CONFIG_NUM_MOTION_GROUPS
+#define PBIO_CONFIG_NUM_MOTION_GROUPS (0)
+#endif
+
+// Integrate the gyro rate with the trapezoidal rule instead of the rectangle
+// rule for more accurate heading and rotation during fast turns.
+#ifndef PBIO_CONFIG_IMU_HEADING_TRAPEZOIDAL
+#define PBIO_CONFIG_IMU_HEADING_TRAPEZOIDAL (0)
+#endif
+
+#ifndef PBIO_CONFIG_NUM_REFLEXES
+#define PBIO_CONFIG_NUM_REFLEXES (0)
+#endif
+
+// Largest supported light matrix size, which sets the size of its frame buffers.
+// Frame indexes are int8_t, so this can be at most 11.
+#ifndef PBIO_CONFIG_LIGHT_MATRIX_MAX_SIZE
+#define PBIO_CONFIG_LIGHT_MATRIX_MAX_SIZE (5)
+#endif
+
+#ifndef PBIO_CONFIG_SOUND
+#define PBIO_CONFIG_SOUND (0)
+#endif
+
+// Number of sound synthesizer voices that can play at the same time.
+#ifndef PBIO_CONFIG_SOUND_NUM_VOICES
+#define PBIO_CONFIG_SOUND_NUM_VOICES (4)
+#endif
+
 #endif // _PBIO_CONFIG_H_
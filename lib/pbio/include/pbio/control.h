@@ -26,7 +26,7 @@
 #include <pbio/logger.h>
 
 // Number of values per row when control data logger is active.
-#define PBIO_CONTROL_LOGGER_NUM_COLS (12)
+#define PBIO_CONTROL_LOGGER_NUM_COLS (15)
 
 /**
  * Actions to be taken when a control command completes.
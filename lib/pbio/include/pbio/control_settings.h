@@ -10,6 +10,7 @@
 #include <stdint.h>
 
 #include <pbio/angle.h>
+#include <pbio/config.h>
 #include <pbio/error.h>
 #include <pbio/trajectory.h>
 
@@ -20,6 +21,37 @@
  * @{
  */
 
+#if PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+
+/**
+ * Maximum number of points in a gain schedule.
+ */
+#define PBIO_CONTROL_GAIN_SCHEDULE_SIZE_MAX (4)
+
+/**
+ * Point in a gain schedule. Gains are linearly interpolated between points.
+ */
+typedef struct _pbio_control_gain_schedule_point_t {
+    /**
+     * Absolute commanded speed at which these gains apply.
+     */
+    int32_t speed;
+    /**
+     * Position error feedback constant at this speed.
+     */
+    int32_t pid_kp;
+    /**
+     * Accumulated position error feedback constant at this speed.
+     */
+    int32_t pid_ki;
+    /**
+     * Speed error feedback constant at this speed.
+     */
+    int32_t pid_kd;
+} pbio_control_gain_schedule_point_t;
+
+#endif // PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+
 /**
  * Control settings.
  */
@@ -122,6 +154,17 @@ typedef struct _pbio_control_settings_t {
      * brake and smart coast.
      */
     uint32_t smart_passive_hold_time;
+    #if PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+    /**
+     * Optional gain schedule by commanded speed, sorted by increasing speed.
+     * If used, this replaces pid_kp, pid_ki, and pid_kd.
+     */
+    pbio_control_gain_schedule_point_t gain_schedule[PBIO_CONTROL_GAIN_SCHEDULE_SIZE_MAX];
+    /**
+     * Number of points in the gain schedule. Zero means no schedule is used.
+     */
+    uint8_t gain_schedule_size;
+    #endif
 } pbio_control_settings_t;
 
 // Unit conversion functions:
@@ -151,6 +194,11 @@ int32_t pbio_control_settings_get_actuation_limit(const pbio_control_settings_t
 pbio_error_t pbio_control_settings_set_actuation_limit(pbio_control_settings_t *s, int32_t limit);
 void pbio_control_settings_get_pid(const pbio_control_settings_t *s, int32_t *pid_kp, int32_t *pid_ki, int32_t *pid_kd, int32_t *integral_deadzone, int32_t *integral_change_max);
 pbio_error_t pbio_control_settings_set_pid(pbio_control_settings_t *s, int32_t pid_kp, int32_t pid_ki, int32_t pid_kd, int32_t integral_deadzone, int32_t integral_change_max);
+void pbio_control_settings_get_pid_at_speed(const pbio_control_settings_t *s, int32_t abs_speed, int32_t *pid_kp, int32_t *pid_ki, int32_t *pid_kd);
+#if PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+uint8_t pbio_control_settings_get_gain_schedule(const pbio_control_settings_t *s, pbio_control_gain_schedule_point_t *points);
+pbio_error_t pbio_control_settings_set_gain_schedule(pbio_control_settings_t *s, const pbio_control_gain_schedule_point_t *points, uint8_t size);
+#endif
 void pbio_control_settings_get_target_tolerances(const pbio_control_settings_t *s, int32_t *speed, int32_t *position);
 pbio_error_t pbio_control_settings_set_target_tolerances(pbio_control_settings_t *s, int32_t speed, int32_t position);
 void pbio_control_settings_get_stall_tolerances(const pbio_control_settings_t *s, int32_t *speed, uint32_t *time);
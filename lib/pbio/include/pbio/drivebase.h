@@ -18,6 +18,99 @@
 
 #if PBIO_CONFIG_NUM_DRIVEBASES > 0
 
+#if PBIO_CONFIG_DRIVEBASE_PATH
+
+/**
+ * Maximum number of segments in one path.
+ */
+#define PBIO_DRIVEBASE_PATH_NUM_SEGMENTS_MAX (16)
+
+/**
+ * One segment of a path, relative to the end of the previous segment.
+ */
+typedef struct _pbio_drivebase_path_segment_t {
+    /**
+     * Distance to drive along the segment in mm. Negative is reverse.
+     */
+    int32_t distance;
+    /**
+     * Change in heading along the segment in degrees. Zero is a straight line.
+     */
+    int32_t angle;
+    /**
+     * If false, the heading changes at a constant rate, giving a circular arc.
+     * If true, it follows a cubic that starts and ends without turning, so
+     * the curvature ramps up and down instead of jumping at the ends.
+     */
+    bool smooth;
+} pbio_drivebase_path_segment_t;
+
+/**
+ * Path being followed by a drivebase, in control units.
+ */
+typedef struct _pbio_drivebase_path_t {
+    /**
+     * True while the heading reference is generated from the path.
+     */
+    bool active;
+    /**
+     * Number of segments in the path.
+     */
+    uint8_t num_segments;
+    /**
+     * Distance reference at the start of the path.
+     */
+    pbio_angle_t distance_start;
+    /**
+     * Heading reference at the start of the path.
+     */
+    pbio_angle_t heading_start;
+    /**
+     * Distance from the path start to the end of each segment.
+     */
+    int32_t distance_end[PBIO_DRIVEBASE_PATH_NUM_SEGMENTS_MAX];
+    /**
+     * Heading relative to the path start at the end of each segment.
+     */
+    int32_t heading_end[PBIO_DRIVEBASE_PATH_NUM_SEGMENTS_MAX];
+    /**
+     * Whether each segment uses a smooth heading profile.
+     */
+    bool smooth[PBIO_DRIVEBASE_PATH_NUM_SEGMENTS_MAX];
+} pbio_drivebase_path_t;
+
+#endif // PBIO_CONFIG_DRIVEBASE_PATH
+
+#if PBIO_CONFIG_DRIVEBASE_POSE
+
+/**
+ * Estimated position and orientation of a drivebase on the ground plane.
+ *
+ * The x axis points forward and the y axis points to the right of the robot
+ * at the time of reset, so that a positive (clockwise) heading turns from x
+ * towards y, matching the sign of the drivebase angle.
+ */
+typedef struct _pbio_drivebase_pose_t {
+    /**
+     * Position along the x axis in mm.
+     */
+    float x;
+    /**
+     * Position along the y axis in mm.
+     */
+    float y;
+    /**
+     * Heading at the last update in degrees.
+     */
+    float heading;
+    /**
+     * Distance at the last update, in control units.
+     */
+    pbio_angle_t distance;
+} pbio_drivebase_pose_t;
+
+#endif // PBIO_CONFIG_DRIVEBASE_POSE
+
 typedef struct _pbio_drivebase_t {
     /**
      * True if a gyro or compass is used for heading control, else false.
@@ -47,6 +140,19 @@ typedef struct _pbio_drivebase_t {
      * Distance controller.
      */
     pbio_control_t control_distance;
+    #if PBIO_CONFIG_DRIVEBASE_PATH
+    /**
+     * Path follower state. The heading reference follows the distance
+     * reference along the path while it is active.
+     */
+    pbio_drivebase_path_t path;
+    #endif
+    #if PBIO_CONFIG_DRIVEBASE_POSE
+    /**
+     * Pose estimate, integrated on every control loop.
+     */
+    pbio_drivebase_pose_t pose;
+    #endif
 } pbio_drivebase_t;
 
 pbio_error_t pbio_drivebase_get_drivebase(pbio_drivebase_t **db_address, pbio_servo_t *left, pbio_servo_t *right, int32_t wheel_diameter, int32_t axle_track);
@@ -65,6 +171,12 @@ pbio_error_t pbio_drivebase_drive_straight(pbio_drivebase_t *db, int32_t distanc
 pbio_error_t pbio_drivebase_drive_curve(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion);
 pbio_error_t pbio_drivebase_drive_arc_angle(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion);
 pbio_error_t pbio_drivebase_drive_arc_distance(pbio_drivebase_t *db, int32_t radius, int32_t distance, pbio_control_on_completion_t on_completion);
+#if PBIO_CONFIG_DRIVEBASE_PATH
+pbio_error_t pbio_drivebase_drive_path(pbio_drivebase_t *db, const pbio_drivebase_path_segment_t *segments, uint8_t num_segments, pbio_control_on_completion_t on_completion);
+#endif
+#if PBIO_CONFIG_DRIVEBASE_POSE
+pbio_error_t pbio_drivebase_drive_to(pbio_drivebase_t *db, int32_t x, int32_t y, pbio_control_on_completion_t on_completion);
+#endif
 
 // Infinite driving:
 
@@ -77,6 +189,10 @@ pbio_error_t pbio_drivebase_stop(pbio_drivebase_t *db, pbio_control_on_completio
 pbio_error_t pbio_drivebase_get_state_user(pbio_drivebase_t *db, int32_t *distance, int32_t *drive_speed, int32_t *angle, int32_t *turn_rate);
 pbio_error_t pbio_drivebase_get_state_user_angle(pbio_drivebase_t *db, float *angle);
 pbio_error_t pbio_drivebase_reset(pbio_drivebase_t *db, int32_t distance, int32_t angle);
+#if PBIO_CONFIG_DRIVEBASE_POSE
+pbio_error_t pbio_drivebase_get_pose(pbio_drivebase_t *db, float *x, float *y, float *angle);
+pbio_error_t pbio_drivebase_reset_pose(pbio_drivebase_t *db, int32_t x, int32_t y, int32_t angle);
+#endif
 pbio_error_t pbio_drivebase_get_drive_settings(const pbio_drivebase_t *db, int32_t *drive_speed, int32_t *drive_acceleration, int32_t *drive_deceleration, int32_t *turn_rate, int32_t *turn_acceleration, int32_t *turn_deceleration);
 pbio_error_t pbio_drivebase_set_drive_settings(pbio_drivebase_t *db, int32_t drive_speed, int32_t drive_acceleration, int32_t drive_deceleration, int32_t turn_rate, int32_t turn_acceleration, int32_t turn_deceleration);
 pbio_error_t pbio_drivebase_set_use_gyro(pbio_drivebase_t *db, bool use_gyro);
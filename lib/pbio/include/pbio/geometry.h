@@ -16,6 +16,16 @@
 
 #include <pbio/error.h>
 
+/**
+ * Number of radians per degree.
+ */
+#define PBIO_GEOMETRY_RADIANS_PER_DEGREE (0.017453292519943f)
+
+/**
+ * Number of degrees per radian.
+ */
+#define PBIO_GEOMETRY_DEGREES_PER_RADIAN (57.295779513082f)
+
 /**
  * Identifier for one side of a rectangle (e.g. screen) or box (e.g. a hub).
  */
@@ -62,6 +72,21 @@ typedef struct _pbio_geometry_matrix_3x3_t {
     };
 } pbio_geometry_matrix_3x3_t;
 
+/**
+ * Quaternion orientation or its time derivative.
+ */
+typedef struct _pbio_geometry_quaternion_t {
+    union {
+        struct {
+            float q1; /**< q1 coordinate (i) */
+            float q2; /**< q2 coordinate (j) */
+            float q3; /**< q3 coordinate (k) */
+            float q4; /**< q4 coordinate (scalar) */
+        };
+        float values[4];
+    };
+} pbio_geometry_quaternion_t;
+
 void pbio_geometry_side_get_axis(pbio_geometry_side_t side, uint8_t *index, int8_t *sign);
 
 void pbio_geometry_get_complementary_axis(uint8_t *index, int8_t *sign);
@@ -78,6 +103,16 @@ void pbio_geometry_vector_map(pbio_geometry_matrix_3x3_t *map, pbio_geometry_xyz
 
 pbio_error_t pbio_geometry_map_from_base_axes(pbio_geometry_xyz_t *x_axis, pbio_geometry_xyz_t *z_axis, pbio_geometry_matrix_3x3_t *rotation);
 
+void pbio_geometry_matrix_multiply_transpose(pbio_geometry_matrix_3x3_t *a, pbio_geometry_matrix_3x3_t *b, pbio_geometry_matrix_3x3_t *output);
+
+void pbio_geometry_quaternion_to_rotation_matrix(pbio_geometry_quaternion_t *q, pbio_geometry_matrix_3x3_t *R);
+
+void pbio_geometry_quaternion_from_gravity_unit_vector(pbio_geometry_xyz_t *g, pbio_geometry_quaternion_t *q);
+
+void pbio_geometry_quaternion_get_rate_of_change(pbio_geometry_quaternion_t *q, pbio_geometry_xyz_t *w, pbio_geometry_quaternion_t *dq);
+
+void pbio_geometry_quaternion_normalize(pbio_geometry_quaternion_t *q);
+
 #endif // _PBIO_GEOMETRY_H_
 
 /** @} */
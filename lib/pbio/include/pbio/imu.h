@@ -18,6 +18,28 @@
 #include <pbio/error.h>
 #include <pbio/geometry.h>
 
+/**
+ * Calibration of the IMU that is kept across reboots.
+ *
+ * The gyro bias is modeled as a linear function of temperature. It is fitted
+ * to the bias measured each time the hub is stationary, using running
+ * statistics that are updated with a fixed weight.
+ */
+typedef struct _pbio_imu_calibration_t {
+    /** Mean gyro bias of the stationary samples in deg/s. */
+    pbio_geometry_xyz_t gyro_bias;
+    /** Change of gyro bias per degree Celsius. */
+    pbio_geometry_xyz_t gyro_bias_slope;
+    /** Covariance of the gyro bias and temperature samples. */
+    pbio_geometry_xyz_t gyro_bias_covariance;
+    /** Mean temperature of the stationary samples in degrees Celsius. */
+    float temperature;
+    /** Variance of the temperature samples. */
+    float temperature_variance;
+    /** Number of stationary samples that contributed so far. */
+    uint32_t num_samples;
+} pbio_imu_calibration_t;
+
 #if PBIO_CONFIG_IMU
 
 void pbio_imu_init(void);
@@ -32,6 +54,18 @@ void pbio_imu_get_settings(float *angular_velocity, float *acceleration, float *
 
 pbio_error_t pbio_imu_set_settings(float angular_velocity, float acceleration, float heading_correction);
 
+void pbio_imu_calibration_set_defaults(pbio_imu_calibration_t *calibration);
+
+void pbio_imu_get_calibration(pbio_imu_calibration_t *calibration);
+
+pbio_error_t pbio_imu_set_calibration(const pbio_imu_calibration_t *calibration);
+
+bool pbio_imu_calibration_changed(const pbio_imu_calibration_t *previous);
+
+void pbio_imu_get_gyro_bias(pbio_geometry_xyz_t *bias);
+
+float pbio_imu_get_temperature(void);
+
 void pbio_imu_get_angular_velocity(pbio_geometry_xyz_t *values);
 
 void pbio_imu_get_acceleration(pbio_geometry_xyz_t *values);
@@ -40,6 +74,10 @@ pbio_error_t pbio_imu_get_single_axis_rotation(pbio_geometry_xyz_t *axis, float
 
 pbio_geometry_side_t pbio_imu_get_up_side(void);
 
+void pbio_imu_get_tilt_vector(pbio_geometry_xyz_t *values);
+
+void pbio_imu_get_orientation(pbio_geometry_matrix_3x3_t *rotation);
+
 float pbio_imu_get_heading(void);
 
 void pbio_imu_set_heading(float desired_heading);
@@ -66,6 +104,27 @@ static inline pbio_error_t pbio_imu_set_settings(float angular_velocity, float a
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline void pbio_imu_calibration_set_defaults(pbio_imu_calibration_t *calibration) {
+}
+
+static inline void pbio_imu_get_calibration(pbio_imu_calibration_t *calibration) {
+}
+
+static inline pbio_error_t pbio_imu_set_calibration(const pbio_imu_calibration_t *calibration) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
+static inline bool pbio_imu_calibration_changed(const pbio_imu_calibration_t *previous) {
+    return false;
+}
+
+static inline void pbio_imu_get_gyro_bias(pbio_geometry_xyz_t *bias) {
+}
+
+static inline float pbio_imu_get_temperature(void) {
+    return 0.0f;
+}
+
 static inline void pbio_imu_get_angular_velocity(pbio_geometry_xyz_t *values) {
 }
 
@@ -76,6 +135,12 @@ static inline pbio_geometry_side_t pbio_imu_get_up_side(void) {
     return PBIO_GEOMETRY_SIDE_TOP;
 }
 
+static inline void pbio_imu_get_tilt_vector(pbio_geometry_xyz_t *values) {
+}
+
+static inline void pbio_imu_get_orientation(pbio_geometry_matrix_3x3_t *rotation) {
+}
+
 static inline float pbio_imu_get_heading(void) {
     return 0.0f;
 }
@@ -3,6 +3,13 @@
 
 /**
  * @addtogroup LightMatrix pbio/light_matrix: Light matrix functions
+ *
+ * Drawing functions update an off-screen frame. The frame is shown with
+ * pbio_light_matrix_flush(), which only sends pixels that have changed to the
+ * driver. Functions like pbio_light_matrix_set_image() draw and flush in one
+ * go, while pbio_light_matrix_blit() and pbio_light_matrix_scroll() can be
+ * combined to compose a frame before it is shown.
+ *
  * @{
  */
 
@@ -18,6 +25,16 @@
 /** A light matrix instance. */
 typedef struct _pbio_light_matrix_t pbio_light_matrix_t;
 
+/** How an image is combined with the frame it is drawn on. */
+typedef enum {
+    /** The image replaces the frame. */
+    PBIO_LIGHT_MATRIX_BLEND_REPLACE,
+    /** Pixels that are on replace the frame. Pixels that are off are transparent. */
+    PBIO_LIGHT_MATRIX_BLEND_OVER,
+    /** Each pixel is set to the brightest of the image and the frame. */
+    PBIO_LIGHT_MATRIX_BLEND_MAX,
+} pbio_light_matrix_blend_t;
+
 #if PBIO_CONFIG_LIGHT_MATRIX
 
 uint8_t pbio_light_matrix_get_size(pbio_light_matrix_t *light_matrix);
@@ -26,6 +43,10 @@ pbio_error_t pbio_light_matrix_clear(pbio_light_matrix_t *light_matrix);
 pbio_error_t pbio_light_matrix_set_rows(pbio_light_matrix_t *light_matrix, const uint8_t *rows);
 pbio_error_t pbio_light_matrix_set_pixel(pbio_light_matrix_t *light_matrix, uint8_t row, uint8_t col, uint8_t brightness);
 pbio_error_t pbio_light_matrix_set_image(pbio_light_matrix_t *light_matrix, const uint8_t *image);
+pbio_error_t pbio_light_matrix_fill(pbio_light_matrix_t *light_matrix, uint8_t brightness);
+void pbio_light_matrix_blit(pbio_light_matrix_t *light_matrix, const uint8_t *image, uint8_t height, uint8_t width, int16_t row, int16_t col, pbio_light_matrix_blend_t blend);
+void pbio_light_matrix_scroll(pbio_light_matrix_t *light_matrix, int16_t rows, int16_t cols);
+pbio_error_t pbio_light_matrix_flush(pbio_light_matrix_t *light_matrix);
 void pbio_light_matrix_start_animation(pbio_light_matrix_t *light_matrix, const uint8_t *cells, uint8_t num_cells, uint16_t interval);
 void pbio_light_matrix_stop_animation(pbio_light_matrix_t *light_matrix);
 
@@ -54,6 +75,20 @@ static inline pbio_error_t pbio_light_matrix_set_image(pbio_light_matrix_t *ligh
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline pbio_error_t pbio_light_matrix_fill(pbio_light_matrix_t *light_matrix, uint8_t brightness) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
+static inline void pbio_light_matrix_blit(pbio_light_matrix_t *light_matrix, const uint8_t *image, uint8_t height, uint8_t width, int16_t row, int16_t col, pbio_light_matrix_blend_t blend) {
+}
+
+static inline void pbio_light_matrix_scroll(pbio_light_matrix_t *light_matrix, int16_t rows, int16_t cols) {
+}
+
+static inline pbio_error_t pbio_light_matrix_flush(pbio_light_matrix_t *light_matrix) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 static inline void pbio_light_matrix_start_animation(pbio_light_matrix_t *light_matrix, const uint8_t *cells, uint8_t num_cells, uint16_t interval) {
 }
 
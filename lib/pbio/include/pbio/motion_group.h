@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+/**
+ * @addtogroup MotionGroup pbio/motion_group: Coordinated multi-axis motion
+ *
+ * Moves several servos together such that all axes start and finish at the
+ * same time, for mechanisms like plotters and gantries.
+ * @{
+ */
+
+#ifndef _PBIO_MOTION_GROUP_H_
+#define _PBIO_MOTION_GROUP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <pbio/config.h>
+#include <pbio/control.h>
+#include <pbio/error.h>
+#include <pbio/servo.h>
+
+#if PBIO_CONFIG_NUM_MOTION_GROUPS > 0
+
+/**
+ * Maximum number of servos in one motion group.
+ */
+#define PBIO_MOTION_GROUP_NUM_AXES_MAX (4)
+
+/**
+ * Group of servos that move as one.
+ */
+typedef struct _pbio_motion_group_t {
+    /**
+     * Number of axes in use.
+     */
+    uint8_t num_axes;
+    /**
+     * Synchronization state to indicate that one or more controllers are paused.
+     */
+    bool control_paused;
+    /**
+     * Servos driving each axis.
+     */
+    pbio_servo_t *servos[PBIO_MOTION_GROUP_NUM_AXES_MAX];
+    /**
+     * Position controllers for each axis, in the same units as the servos.
+     */
+    pbio_control_t control[PBIO_MOTION_GROUP_NUM_AXES_MAX];
+} pbio_motion_group_t;
+
+pbio_error_t pbio_motion_group_get_motion_group(pbio_motion_group_t **group_address, pbio_servo_t **servos, uint8_t num_axes);
+
+// Motion group status:
+
+void pbio_motion_group_update_all(void);
+bool pbio_motion_group_update_loop_is_running(pbio_motion_group_t *group);
+bool pbio_motion_group_is_done(const pbio_motion_group_t *group);
+pbio_error_t pbio_motion_group_is_stalled(pbio_motion_group_t *group, bool *stalled, uint32_t *stall_duration);
+
+// Coordinated point to point control:
+
+pbio_error_t pbio_motion_group_move_to(pbio_motion_group_t *group, const int32_t *positions, int32_t speed, pbio_control_on_completion_t on_completion);
+pbio_error_t pbio_motion_group_move_by(pbio_motion_group_t *group, const int32_t *distances, int32_t speed, pbio_control_on_completion_t on_completion);
+pbio_error_t pbio_motion_group_stop(pbio_motion_group_t *group, pbio_control_on_completion_t on_completion);
+
+#endif // PBIO_CONFIG_NUM_MOTION_GROUPS > 0
+
+#endif // _PBIO_MOTION_GROUP_H_
+
+/** @} */
@@ -16,9 +16,11 @@
 
 #include <stdint.h>
 
+#include <pbio/config.h>
 #include <pbio/control_settings.h>
 #include <pbio/dcmotor.h>
 #include <pbio/differentiator.h>
+#include <pbio/error.h>
 #include <pbio/angle.h>
 
 /**
@@ -129,6 +131,70 @@ typedef struct _pbio_observer_t {
     pbio_observer_settings_t settings;
 } pbio_observer_t;
 
+#if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
+/**
+ * Recursive least squares estimator that identifies the mechanical load on a
+ * motor relative to the nominal model for its type.
+ *
+ * The electrical properties of a motor do not change when it is built into a
+ * mechanism, but the inertia and friction do. This estimates the ratio of the
+ * actual inertia to the nominal inertia, and the Coulomb friction torque.
+ */
+typedef struct _pbio_observer_identification_t {
+    /**
+     * Whether an identification run is ongoing.
+     */
+    bool active;
+    /**
+     * Estimated parameters: inverse inertia ratio and friction torque (mNm)
+     * divided by the inertia ratio.
+     */
+    float theta[2];
+    /**
+     * Covariance of the parameter estimate.
+     */
+    float covariance[2][2];
+    /**
+     * Running sum of the regressors of each sample.
+     */
+    float regressor_sum[2];
+    /**
+     * Running sum of regressor_sum across the current block.
+     */
+    float regressor_block[2];
+    /**
+     * Block average of regressor_sum across the previous block.
+     */
+    float regressor_block_prev[2];
+    /**
+     * Average speed across the previous block in millidegrees/second.
+     */
+    int32_t block_speed_prev;
+    /**
+     * Measured angle at the start of the current block.
+     */
+    pbio_angle_t block_start;
+    /**
+     * Number of samples processed so far.
+     */
+    uint32_t samples;
+    /**
+     * Number of samples after which the identification run is done.
+     */
+    uint32_t samples_total;
+    /**
+     * Amplitude of the excitation voltage in mV.
+     */
+    int32_t voltage;
+    /**
+     * State of the pseudo random binary sequence generator.
+     */
+    uint8_t prbs;
+} pbio_observer_identification_t;
+
+#endif // PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
 // Observer state functions:
 
 void pbio_observer_reset(pbio_observer_t *obs, const pbio_angle_t *angle);
@@ -144,6 +210,17 @@ int32_t pbio_observer_get_feedforward_torque(const pbio_observer_model_t *model,
 int32_t pbio_observer_torque_to_voltage(const pbio_observer_model_t *model, int32_t desired_torque);
 int32_t pbio_observer_voltage_to_torque(const pbio_observer_model_t *model, int32_t voltage);
 
+#if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
+// Model identification functions:
+
+void pbio_observer_identification_start(pbio_observer_identification_t *ident, const pbio_observer_t *obs, const pbio_angle_t *angle, int32_t voltage, uint32_t duration);
+int32_t pbio_observer_identification_get_excitation(const pbio_observer_identification_t *ident);
+void pbio_observer_identification_update(pbio_observer_identification_t *ident, const pbio_observer_t *obs, const pbio_angle_t *angle, int32_t voltage);
+pbio_error_t pbio_observer_identification_get_model(const pbio_observer_identification_t *ident, const pbio_observer_model_t *nominal, pbio_observer_model_t *model, int32_t *inertia_ratio, int32_t *friction);
+
+#endif // PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
 #endif // _PBIO_OBSERVER_H_
 
 /** @} */
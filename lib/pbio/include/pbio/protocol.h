@@ -12,6 +12,7 @@
 #ifndef _PBIO_PROTOCOL_H_
 #define _PBIO_PROTOCOL_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <pbio/error.h>
@@ -408,6 +409,57 @@ extern const uint8_t pbio_nus_service_uuid[];
 extern const uint8_t pbio_nus_rx_char_uuid[];
 extern const uint8_t pbio_nus_tx_char_uuid[];
 
+/**
+ * Size of the user data in one broadcast advertisement, after the length,
+ * type, company identifier and channel.
+ */
+#define PBIO_BROADCAST_DATA_MAX_SIZE (26)
+
+/**
+ * Data type code in the upper three bits of the first byte of a broadcast
+ * that indicates a fragment of a longer message.
+ */
+#define PBIO_BROADCAST_FRAGMENT_TYPE (7)
+
+/**
+ * Size of the header of a broadcast fragment: the type and fragment index,
+ * the sequence number of the message, and the number of fragments.
+ */
+#define PBIO_BROADCAST_FRAGMENT_HEADER_SIZE (3)
+
+/** Size of the message data in each fragment. */
+#define PBIO_BROADCAST_FRAGMENT_DATA_SIZE (PBIO_BROADCAST_DATA_MAX_SIZE - PBIO_BROADCAST_FRAGMENT_HEADER_SIZE)
+
+/** Largest number of fragments of one broadcast message. */
+#define PBIO_BROADCAST_FRAGMENT_MAX_NUM (8)
+
+/** Largest size of a broadcast message that is sent as fragments. */
+#define PBIO_BROADCAST_MESSAGE_MAX_SIZE (PBIO_BROADCAST_FRAGMENT_DATA_SIZE * PBIO_BROADCAST_FRAGMENT_MAX_NUM)
+
+/**
+ * State of reassembling a broadcast message from its fragments.
+ */
+typedef struct _pbio_broadcast_reassembly_t {
+    /** The message being reassembled. */
+    uint8_t data[PBIO_BROADCAST_MESSAGE_MAX_SIZE];
+    /** Size of the message, known once the last fragment is received. */
+    uint8_t size;
+    /** Sequence number of the message being reassembled. */
+    uint8_t sequence;
+    /** Number of fragments of the message, or 0 if none received yet. */
+    uint8_t num_fragments;
+    /** Bit mask of fragments received so far. */
+    uint8_t received;
+} pbio_broadcast_reassembly_t;
+
+uint8_t pbio_broadcast_get_num_fragments(uint32_t size);
+
+uint8_t pbio_broadcast_get_fragment(uint8_t *buf, const uint8_t *message, uint32_t size, uint8_t sequence, uint8_t index);
+
+void pbio_broadcast_reassembly_reset(pbio_broadcast_reassembly_t *reassembly);
+
+bool pbio_broadcast_reassemble(pbio_broadcast_reassembly_t *reassembly, const uint8_t *fragment, uint8_t size);
+
 /** USB bDeviceClass for Pybricks hubs */
 #define PBIO_PYBRICKS_USB_DEVICE_CLASS 0xFF
 /** USB bDeviceSubClass for Pybricks hubs */
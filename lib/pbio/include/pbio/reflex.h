@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+/**
+ * @addtogroup Reflex pbio/reflex: Sensor to motor control loops
+ *
+ * Runs a PID controller from a sensor value to a motor or drive base within
+ * the motor process. The output is updated as soon as a new sample is
+ * available, without a round trip through the user program.
+ * @{
+ */
+
+#ifndef _PBIO_REFLEX_H_
+#define _PBIO_REFLEX_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <pbdrv/legodev.h>
+
+#include <pbio/config.h>
+#include <pbio/drivebase.h>
+#include <pbio/error.h>
+#include <pbio/geometry.h>
+#include <pbio/servo.h>
+
+#if PBIO_CONFIG_NUM_REFLEXES > 0
+
+/**
+ * Gains are given in output units per this many input units.
+ */
+#define PBIO_REFLEX_GAIN_SCALE (1000)
+
+/**
+ * Maximum absolute value of each gain.
+ */
+#define PBIO_REFLEX_GAIN_MAX (1000 * PBIO_REFLEX_GAIN_SCALE)
+
+/**
+ * Source of the value that a reflex controls.
+ */
+typedef enum {
+    /**
+     * One value of a sensor mode, read with ::pbdrv_legodev_get_data.
+     */
+    PBIO_REFLEX_INPUT_SENSOR,
+    /**
+     * Angular velocity of the hub around an axis, in deg/s.
+     */
+    PBIO_REFLEX_INPUT_IMU,
+    /**
+     * Angle of a servo in its user units.
+     */
+    PBIO_REFLEX_INPUT_SERVO,
+} pbio_reflex_input_type_t;
+
+/**
+ * Input of a reflex.
+ */
+typedef struct _pbio_reflex_input_t {
+    /**
+     * Which kind of input this is.
+     */
+    pbio_reflex_input_type_t type;
+    union {
+        /**
+         * Sensor value, for ::PBIO_REFLEX_INPUT_SENSOR.
+         */
+        struct {
+            /** Sensor device. */
+            pbdrv_legodev_dev_t *legodev;
+            /** Sensor mode. */
+            uint8_t mode;
+            /** Index of the value within the mode. */
+            uint8_t index;
+        } sensor;
+        /**
+         * Rotation axis in the hub frame, for ::PBIO_REFLEX_INPUT_IMU.
+         */
+        pbio_geometry_xyz_t axis;
+        /**
+         * Servo to read the angle of, for ::PBIO_REFLEX_INPUT_SERVO.
+         */
+        pbio_servo_t *servo;
+    };
+} pbio_reflex_input_t;
+
+/**
+ * PID settings of a reflex. The output is:
+ *
+ *     kp * e + ki * integral(e) + kd * de/dt
+ *
+ * where e = target - input, time is in seconds, and the gains are scaled by
+ * ::PBIO_REFLEX_GAIN_SCALE.
+ */
+typedef struct _pbio_reflex_settings_t {
+    /**
+     * Desired input value.
+     */
+    int32_t target;
+    /**
+     * Proportional gain.
+     */
+    int32_t kp;
+    /**
+     * Integral gain.
+     */
+    int32_t ki;
+    /**
+     * Derivative gain.
+     */
+    int32_t kd;
+    /**
+     * Maximum absolute output. For a servo, this is the duty cycle in
+     * percent, up to 100. For a drive base, this is the turn rate in deg/s.
+     */
+    int32_t limit;
+} pbio_reflex_settings_t;
+
+/**
+ * Control loop from one input to one servo or drive base.
+ */
+typedef struct _pbio_reflex_t {
+    /**
+     * Incremented each time this instance is started, so that a previous
+     * user of the instance can tell that it is no longer theirs.
+     */
+    uint32_t generation;
+    /**
+     * Whether the reflex is currently driving its output.
+     */
+    bool active;
+    /**
+     * Whether error_prev and time_prev hold a previous sample.
+     */
+    bool has_prev;
+    /**
+     * Input of the controller.
+     */
+    pbio_reflex_input_t input;
+    /**
+     * Settings of the controller.
+     */
+    pbio_reflex_settings_t settings;
+    /**
+     * Servo that is driven at a duty cycle, or NULL.
+     */
+    pbio_servo_t *servo;
+    /**
+     * Drive base that is driven with a turn rate, or NULL.
+     */
+    pbio_drivebase_t *drivebase;
+    /**
+     * Drive speed of the drive base in mm/s.
+     */
+    int32_t drive_speed;
+    /**
+     * Sample count of the sensor at the last update.
+     */
+    uint32_t sample_count;
+    /**
+     * Time of the most recent new input sample in ms, or the start time.
+     */
+    uint32_t time_sample;
+    /**
+     * Time of the previous update in ms.
+     */
+    uint32_t time_prev;
+    /**
+     * Error of the previous update.
+     */
+    int32_t error_prev;
+    /**
+     * Integrated error in input units times milliseconds.
+     */
+    int32_t error_integral;
+    /**
+     * Most recent input value.
+     */
+    int32_t value;
+    /**
+     * Most recent output value.
+     */
+    int32_t output;
+} pbio_reflex_t;
+
+pbio_error_t pbio_reflex_start_servo(pbio_reflex_t **reflex_address, const pbio_reflex_input_t *input, const pbio_reflex_settings_t *settings, pbio_servo_t *srv);
+pbio_error_t pbio_reflex_start_drivebase(pbio_reflex_t **reflex_address, const pbio_reflex_input_t *input, const pbio_reflex_settings_t *settings, pbio_drivebase_t *db, int32_t drive_speed);
+pbio_error_t pbio_reflex_stop(pbio_reflex_t *reflex);
+void pbio_reflex_release_drivebase(pbio_drivebase_t *db);
+
+void pbio_reflex_update_all(void);
+bool pbio_reflex_is_active(const pbio_reflex_t *reflex);
+void pbio_reflex_get_state(const pbio_reflex_t *reflex, int32_t *value, int32_t *output);
+
+#endif // PBIO_CONFIG_NUM_REFLEXES > 0
+
+#endif // _PBIO_REFLEX_H_
+
+/** @} */
@@ -71,6 +71,21 @@ typedef struct _pbio_servo_t {
      * Luenberger state observer to estimate motor speed.
      */
     pbio_observer_t observer;
+    #if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+    /**
+     * Estimator used to identify the load on this servo.
+     */
+    pbio_observer_identification_t identification;
+    /**
+     * Default model for this type of motor.
+     */
+    const pbio_observer_model_t *model_default;
+    /**
+     * Model identified for this servo. Used by the observer instead of the
+     * default model after successful identification.
+     */
+    pbio_observer_model_t model_custom;
+    #endif
     /**
      * Structure with data log settings and pointer to data buffer if active.
      */
@@ -168,6 +183,16 @@ pbio_error_t pbio_servo_run_target(pbio_servo_t *srv, int32_t speed, int32_t tar
 pbio_error_t pbio_servo_track_target(pbio_servo_t *srv, int32_t target);
 /**@}*/
 
+#if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+/** @name Model Identification Functions */
+/**@{*/
+pbio_error_t pbio_servo_identify_model(pbio_servo_t *srv, int32_t voltage, uint32_t duration);
+bool pbio_servo_identify_model_is_done(pbio_servo_t *srv);
+pbio_error_t pbio_servo_identify_model_get_result(pbio_servo_t *srv, int32_t *inertia_ratio, int32_t *friction);
+pbio_error_t pbio_servo_reset_model(pbio_servo_t *srv);
+/**@}*/
+#endif // PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
 #endif // PBIO_CONFIG_SERVO
 
 #endif // _PBIO_SERVO_H_
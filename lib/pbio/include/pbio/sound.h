@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+/**
+ * @addtogroup Sound pbio/sound: Sound synthesizer
+ *
+ * Plays tones on several voices at once. Each voice has its own waveform,
+ * volume and envelope, and can play a sequence of notes in the background.
+ * Sampled sounds stored as IMA ADPCM data can be played alongside the voices.
+ * The voices are mixed into a stream that is played by the sound driver.
+ *
+ * @{
+ */
+
+#ifndef _PBIO_SOUND_H_
+#define _PBIO_SOUND_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <pbdrv/sound.h>
+
+#include <pbio/config.h>
+#include <pbio/error.h>
+
+/** Sample rate of the sound output in Hz. */
+#define PBIO_SOUND_SAMPLE_RATE (16000)
+
+/** Highest frequency that can be played, in Hz. */
+#define PBIO_SOUND_FREQUENCY_MAX (PBIO_SOUND_SAMPLE_RATE / 2)
+
+/** Waveform of a voice. */
+typedef enum {
+    /** Square wave, like a classic beep. */
+    PBIO_SOUND_WAVE_SQUARE,
+    /** Triangle wave, a softer sound. */
+    PBIO_SOUND_WAVE_TRIANGLE,
+    /** Sine wave, a pure tone. */
+    PBIO_SOUND_WAVE_SINE,
+    /** Noise that changes value at twice the note frequency. */
+    PBIO_SOUND_WAVE_NOISE,
+} pbio_sound_wave_t;
+
+/**
+ * Envelope of a voice, which shapes the volume of each note.
+ *
+ * When a note starts, the volume goes from zero to full in the attack time,
+ * and then to the sustain level in the decay time. When the note is released,
+ * the volume goes to zero in the release time. Times are given in ms. A time
+ * of zero makes the volume change instantly.
+ */
+typedef struct _pbio_sound_envelope_t {
+    /** Time to go from zero to full volume. */
+    uint16_t attack;
+    /** Time to go from full volume to the sustain level. */
+    uint16_t decay;
+    /** Volume while the note is held, as a percentage of full volume. */
+    uint8_t sustain;
+    /** Time to go from full volume to zero after the note is released. */
+    uint16_t release;
+} pbio_sound_envelope_t;
+
+/** A note in a sequence that plays in the background. */
+typedef struct _pbio_sound_note_t {
+    /** Frequency in Hz, or 0 for a rest. */
+    uint16_t frequency;
+    /** Total duration of the note in ms. */
+    uint16_t duration;
+    /**
+     * Time in ms after which the note is released. If it is equal to the
+     * duration, the note continues into the next note without starting again.
+     */
+    uint16_t gate;
+} pbio_sound_note_t;
+
+/** Size of the header of IMA ADPCM data, as made by tools/adpcm.py. */
+#define PBIO_SOUND_ADPCM_HEADER_SIZE (16)
+
+/** State of an IMA ADPCM decoder. */
+typedef struct _pbio_sound_adpcm_t {
+    /** Encoded samples, two per byte, first sample in the low bits. */
+    const uint8_t *data;
+    /** Total number of samples. */
+    uint32_t num_samples;
+    /** Index of the next sample to decode. */
+    uint32_t index;
+    /** Sample rate in Hz. */
+    uint16_t sample_rate;
+    /** Last decoded sample. */
+    int32_t predictor;
+    /** Index in the step size table. */
+    uint8_t step_index;
+} pbio_sound_adpcm_t;
+
+#if PBIO_CONFIG_SOUND
+
+pbio_error_t pbio_sound_voice_set_wave(uint8_t voice, pbio_sound_wave_t wave, uint16_t amplitude);
+pbio_error_t pbio_sound_voice_set_envelope(uint8_t voice, const pbio_sound_envelope_t *envelope);
+pbio_error_t pbio_sound_voice_note_on(uint8_t voice, uint16_t frequency);
+pbio_error_t pbio_sound_voice_note_off(uint8_t voice);
+pbio_error_t pbio_sound_voice_play(uint8_t voice, const pbio_sound_note_t *notes, uint32_t num_notes);
+bool pbio_sound_voice_is_busy(uint8_t voice);
+pbio_error_t pbio_sound_adpcm_init(pbio_sound_adpcm_t *decoder, const uint8_t *data, uint32_t size);
+uint32_t pbio_sound_adpcm_decode(pbio_sound_adpcm_t *decoder, int16_t *samples, uint32_t count);
+pbio_error_t pbio_sound_play_adpcm(const uint8_t *data, uint32_t size, uint16_t amplitude);
+bool pbio_sound_adpcm_is_busy(void);
+void pbio_sound_stop(void);
+void pbio_sound_mix(uint16_t *data, uint32_t length);
+
+#else // PBIO_CONFIG_SOUND
+
+static inline pbio_error_t pbio_sound_voice_set_wave(uint8_t voice, pbio_sound_wave_t wave, uint16_t amplitude) {
+    return PBIO_SUCCESS;
+}
+
+static inline pbio_error_t pbio_sound_voice_set_envelope(uint8_t voice, const pbio_sound_envelope_t *envelope) {
+    return PBIO_SUCCESS;
+}
+
+static inline pbio_error_t pbio_sound_voice_note_on(uint8_t voice, uint16_t frequency) {
+    return PBIO_SUCCESS;
+}
+
+static inline pbio_error_t pbio_sound_voice_note_off(uint8_t voice) {
+    return PBIO_SUCCESS;
+}
+
+static inline pbio_error_t pbio_sound_voice_play(uint8_t voice, const pbio_sound_note_t *notes, uint32_t num_notes) {
+    return PBIO_SUCCESS;
+}
+
+static inline bool pbio_sound_voice_is_busy(uint8_t voice) {
+    return false;
+}
+
+static inline pbio_error_t pbio_sound_adpcm_init(pbio_sound_adpcm_t *decoder, const uint8_t *data, uint32_t size) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
+static inline uint32_t pbio_sound_adpcm_decode(pbio_sound_adpcm_t *decoder, int16_t *samples, uint32_t count) {
+    return 0;
+}
+
+static inline pbio_error_t pbio_sound_play_adpcm(const uint8_t *data, uint32_t size, uint16_t amplitude) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
+static inline bool pbio_sound_adpcm_is_busy(void) {
+    return false;
+}
+
+static inline void pbio_sound_stop(void) {
+    pbdrv_sound_stop();
+}
+
+static inline void pbio_sound_mix(uint16_t *data, uint32_t length) {
+}
+
+#endif // PBIO_CONFIG_SOUND
+
+#endif // _PBIO_SOUND_H_
+
+/** @} */
@@ -18,6 +18,11 @@
     + PBSYS_CONFIG_FEATURE_PROGRAM_FORMAT_MULTI_MPY_V6_1_NATIVE * PBIO_PYBRICKS_FEATURE_FLAG_USER_PROG_FORMAT_MULTI_MPY_V6_1_NATIVE \
     )
 
+// Number of ports for which a color sensor calibration is stored
+#ifndef PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS
+#define PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS (0)
+#endif
+
 // When set to (1) PBSYS_CONFIG_STATUS_LIGHT indicates that a hub has a hub status light
 #ifndef PBSYS_CONFIG_STATUS_LIGHT
 #error "Must define PBSYS_CONFIG_STATUS_LIGHT in pbsysconfig.h"
@@ -15,7 +15,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include <pbio/color.h>
 #include <pbio/error.h>
+#include <pbio/imu.h>
+#include <pbio/port.h>
 
 #include <pbio/config.h>
 #include <pbsys/config.h>
@@ -47,6 +50,22 @@ typedef struct _pbsys_storage_settings_t {
      * affected.
      */
     float heading_correction;
+    /**
+     * Temperature compensated gyro bias calibration, learned while the hub
+     * is stationary.
+     */
+    pbio_imu_calibration_t imu_calibration;
+    #endif
+    #if PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS
+    /**
+     * Device type for which the color calibration on each port was made,
+     * or 0 if there is none.
+     */
+    uint8_t color_calibration_type_id[PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS];
+    /**
+     * Color sensor calibration for each port, starting at port A.
+     */
+    pbio_color_calibration_t color_calibration[PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS];
     #endif
 } pbsys_storage_settings_t;
 
@@ -62,6 +81,12 @@ void pbsys_storage_settings_bluetooth_enabled_request_toggle(void);
 
 void pbsys_storage_settings_save_imu_settings(void);
 
+void pbsys_storage_settings_save_imu_calibration(void);
+
+bool pbsys_storage_settings_get_color_calibration(pbio_port_id_t port, uint8_t type_id, pbio_color_calibration_t *calibration);
+
+void pbsys_storage_settings_save_color_calibration(pbio_port_id_t port, uint8_t type_id, const pbio_color_calibration_t *calibration);
+
 #else
 
 static inline void pbsys_storage_settings_set_defaults(pbsys_storage_settings_t *settings) {
@@ -77,6 +102,16 @@ static inline void pbsys_storage_settings_bluetooth_enabled_request_toggle(void)
 static inline void pbsys_storage_settings_save_imu_settings(void) {
 }
 
+static inline void pbsys_storage_settings_save_imu_calibration(void) {
+}
+
+static inline bool pbsys_storage_settings_get_color_calibration(pbio_port_id_t port, uint8_t type_id, pbio_color_calibration_t *calibration) {
+    return false;
+}
+
+static inline void pbsys_storage_settings_save_color_calibration(pbio_port_id_t port, uint8_t type_id, const pbio_color_calibration_t *calibration) {
+}
+
 #endif // PBSYS_CONFIG_STORAGE
 
 #endif // _PBSYS_STORAGE_SETTINGS_H_
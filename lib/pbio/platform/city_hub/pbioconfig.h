@@ -5,11 +5,14 @@
 #define PBIO_CONFIG_DCMOTOR                 (1)
 #define PBIO_CONFIG_DCMOTOR_NUM_DEV         (2)
 #define PBIO_CONFIG_DRIVEBASE_SPIKE         (0)
+#define PBIO_CONFIG_DRIVEBASE_PATH          (0)
+#define PBIO_CONFIG_DRIVEBASE_POSE          (0)
 #define PBIO_CONFIG_IMU                     (0)
 #define PBIO_CONFIG_LIGHT                   (1)
 #define PBIO_CONFIG_LOGGER                  (1)
 
 #define PBIO_CONFIG_MOTOR_PROCESS           (1)
+#define PBIO_CONFIG_CONTROL_GAIN_SCHEDULE   (1)
 #define PBIO_CONFIG_SERVO                   (1)
 #define PBIO_CONFIG_SERVO_NUM_DEV           (2)
 #define PBIO_CONFIG_SERVO_EV3_NXT           (0)
@@ -13,6 +13,7 @@
 #define PBSYS_CONFIG_MAIN                           (1)
 #define PBSYS_CONFIG_STORAGE                        (1)
 #define PBSYS_CONFIG_STORAGE_NUM_SLOTS              (1)
+#define PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS (2)
 #define PBSYS_CONFIG_STORAGE_RAM_SIZE               (258 * 1024)
 #define PBSYS_CONFIG_STORAGE_ROM_SIZE               (PBDRV_CONFIG_BLOCK_DEVICE_W25QXX_STM32_SIZE)
 #define PBSYS_CONFIG_STORAGE_OVERLAPS_BOOTLOADER_CHECKSUM (0)
@@ -5,12 +5,17 @@
 #define PBIO_CONFIG_DCMOTOR                 (1)
 #define PBIO_CONFIG_DCMOTOR_NUM_DEV         (4)
 #define PBIO_CONFIG_DRIVEBASE_SPIKE         (0)
+#define PBIO_CONFIG_DRIVEBASE_PATH          (1)
+#define PBIO_CONFIG_DRIVEBASE_POSE          (1)
 #define PBIO_CONFIG_IMU                     (0)
 #define PBIO_CONFIG_LIGHT                   (0)
 #define PBIO_CONFIG_LOGGER                  (1)
 #define PBIO_CONFIG_MOTOR_PROCESS           (1)
+#define PBIO_CONFIG_CONTROL_GAIN_SCHEDULE   (1)
 #define PBIO_CONFIG_SERVO                   (1)
 #define PBIO_CONFIG_SERVO_NUM_DEV           (4)
+#define PBIO_CONFIG_NUM_MOTION_GROUPS       (1)
+#define PBIO_CONFIG_NUM_REFLEXES            (2)
 #define PBIO_CONFIG_SERVO_EV3_NXT           (1)
 #define PBIO_CONFIG_SERVO_PUP               (0)
 #define PBIO_CONFIG_SERVO_PUP_MOVE_HUB      (0)
@@ -15,6 +15,7 @@
 #define PBSYS_CONFIG_MAIN                           (1)
 #define PBSYS_CONFIG_STORAGE                        (1)
 #define PBSYS_CONFIG_STORAGE_NUM_SLOTS              (1)
+#define PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS (4)
 #define PBSYS_CONFIG_STORAGE_OVERLAPS_BOOTLOADER_CHECKSUM (1)
 #define PBSYS_CONFIG_STORAGE_RAM_SIZE               (32 * 1024)
 #define PBSYS_CONFIG_STORAGE_ROM_SIZE               (PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32_SIZE)
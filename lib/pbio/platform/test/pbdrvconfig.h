@@ -10,10 +10,14 @@
 #define PBDRV_CONFIG_BLUETOOTH                      (1)
 #define PBDRV_CONFIG_BLUETOOTH_BTSTACK              (1)
 #define PBDRV_CONFIG_BLUETOOTH_BTSTACK_HUB_KIND     0xff
+#define PBDRV_CONFIG_BLUETOOTH_MAX_MTU_SIZE         515
 
 #define PBDRV_CONFIG_CLOCK                          (1)
 #define PBDRV_CONFIG_CLOCK_TEST                     (1)
 
+#define PBDRV_CONFIG_IMU                            (1)
+#define PBDRV_CONFIG_IMU_TEST                       (1)
+
 #define PBDRV_CONFIG_LED                            (1)
 #define PBDRV_CONFIG_LED_NUM_DEV                    (0)
 
@@ -36,6 +40,9 @@
 #define PBDRV_CONFIG_PWM_NUM_DEV                    (1)
 #define PBDRV_CONFIG_PWM_TEST                       (1)
 
+#define PBDRV_CONFIG_SOUND                          (1)
+#define PBDRV_CONFIG_SOUND_TEST                     (1)
+
 #define PBDRV_CONFIG_UART                           (1)
 
 #define PBDRV_CONFIG_HAS_PORT_A                     (1)
@@ -3,7 +3,10 @@
 #define PBIO_CONFIG_DCMOTOR                 (1)
 #define PBIO_CONFIG_DCMOTOR_NUM_DEV         (6)
 #define PBIO_CONFIG_DRIVEBASE_SPIKE         (0)
-#define PBIO_CONFIG_IMU                     (0)
+#define PBIO_CONFIG_DRIVEBASE_PATH          (1)
+#define PBIO_CONFIG_DRIVEBASE_POSE          (1)
+#define PBIO_CONFIG_IMU                     (1)
+#define PBIO_CONFIG_IMU_HEADING_TRAPEZOIDAL (1)
 
 #define PBIO_CONFIG_LIGHT                   (1)
 #define PBIO_CONFIG_LOGGER                  (1)
@@ -11,11 +14,16 @@
 
 #define PBIO_CONFIG_MOTOR_PROCESS           (1)
 #define PBIO_CONFIG_MOTOR_PROCESS_AUTO_START (0)
+#define PBIO_CONFIG_OBSERVER_IDENTIFICATION (1)
+#define PBIO_CONFIG_CONTROL_GAIN_SCHEDULE   (1)
 #define PBIO_CONFIG_SERVO                   (1)
 #define PBIO_CONFIG_SERVO_NUM_DEV           (6)
+#define PBIO_CONFIG_NUM_MOTION_GROUPS       (2)
+#define PBIO_CONFIG_NUM_REFLEXES            (2)
 #define PBIO_CONFIG_SERVO_EV3_NXT           (1)
 #define PBIO_CONFIG_SERVO_PUP               (1)
 #define PBIO_CONFIG_SERVO_PUP_MOVE_HUB      (1)
+#define PBIO_CONFIG_SOUND                   (1)
 #define PBIO_CONFIG_TACHO                   (1)
 
 #define PBIO_CONFIG_UARTDEV                 (1)
@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <stdint.h>
+#include <string.h>
+
+#include <pbio/color.h>
+#include <pbio/error.h>
+
+/**
+ * Gets the gain that maps a raw span to the full RGB range.
+ *
+ * @param [in]  span        Raw span, at least ::PBIO_COLOR_CALIBRATION_SPAN_MIN.
+ * @returns                 The gain, scaled by ::PBIO_COLOR_CALIBRATION_GAIN_SCALE.
+ */
+static int16_t pbio_color_calibration_get_gain(int32_t span) {
+    return (255 * PBIO_COLOR_CALIBRATION_GAIN_SCALE + span / 2) / span;
+}
+
+/**
+ * Sets the gain matrix to a diagonal matrix with the given gains.
+ *
+ * @param [in]  calibration The calibration to update.
+ * @param [in]  gains       The gain of each channel.
+ */
+static void pbio_color_calibration_set_diagonal(pbio_color_calibration_t *calibration, const int16_t *gains) {
+    memset(calibration->gain, 0, sizeof(calibration->gain));
+    for (uint8_t i = 0; i < 3; i++) {
+        calibration->gain[i][i] = gains[i];
+    }
+}
+
+/**
+ * Sets the default calibration, which scales each channel from zero to the
+ * given full scale value to the full RGB range.
+ *
+ * @param [out] calibration The calibration to set.
+ * @param [in]  full_scale  Raw reading of a white surface, in the same units
+ *                          as the raw readings.
+ */
+void pbio_color_calibration_set_defaults(pbio_color_calibration_t *calibration, int32_t full_scale) {
+    if (full_scale < PBIO_COLOR_CALIBRATION_SPAN_MIN) {
+        full_scale = PBIO_COLOR_CALIBRATION_SPAN_MIN;
+    }
+    int16_t gain = pbio_color_calibration_get_gain(full_scale);
+    const int16_t gains[] = { gain, gain, gain };
+    memset(calibration->offset, 0, sizeof(calibration->offset));
+    pbio_color_calibration_set_diagonal(calibration, gains);
+}
+
+/**
+ * Updates the calibration using the raw reading of a reference surface.
+ *
+ * A black reference sets the offset of each channel. A white reference sets
+ * the gain of each channel such that white maps to the full RGB range. The
+ * references can be given in any order, and the result is the same as long
+ * as the last black and white references are the same. Any cross-channel
+ * gains are cleared.
+ *
+ * @param [in]  calibration The calibration to update.
+ * @param [in]  color       ::PBIO_COLOR_BLACK or ::PBIO_COLOR_WHITE.
+ * @param [in]  raw         Raw reading of the reference surface.
+ * @returns                 ::PBIO_ERROR_INVALID_ARG if the color is not
+ *                          supported or if black and white would be too
+ *                          close together, otherwise ::PBIO_SUCCESS.
+ */
+pbio_error_t pbio_color_calibration_set_reference(pbio_color_calibration_t *calibration, pbio_color_t color, const pbio_color_raw_t *raw) {
+
+    int16_t offsets[3];
+    int16_t gains[3];
+
+    for (uint8_t i = 0; i < 3; i++) {
+        if (raw->values[i] < 0 || raw->values[i] > INT16_MAX) {
+            return PBIO_ERROR_INVALID_ARG;
+        }
+
+        int32_t span;
+        if (color == PBIO_COLOR_BLACK) {
+            // Keep the raw white level that follows from the existing gain.
+            int32_t gain = calibration->gain[i][i];
+            if (gain <= 0) {
+                return PBIO_ERROR_INVALID_ARG;
+            }
+            int32_t white = calibration->offset[i] + (255 * PBIO_COLOR_CALIBRATION_GAIN_SCALE + gain / 2) / gain;
+            offsets[i] = raw->values[i];
+            span = white - raw->values[i];
+        } else if (color == PBIO_COLOR_WHITE) {
+            offsets[i] = calibration->offset[i];
+            span = raw->values[i] - calibration->offset[i];
+        } else {
+            return PBIO_ERROR_INVALID_ARG;
+        }
+
+        if (span < PBIO_COLOR_CALIBRATION_SPAN_MIN) {
+            return PBIO_ERROR_INVALID_ARG;
+        }
+        gains[i] = pbio_color_calibration_get_gain(span);
+    }
+
+    // All channels are valid, so apply the result.
+    memcpy(calibration->offset, offsets, sizeof(calibration->offset));
+    pbio_color_calibration_set_diagonal(calibration, gains);
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Applies a gamma-like tone curve to an RGB color, preserving its hue.
+ *
+ * The brightest channel is mapped as v * (2 - v) and the ratio between the
+ * dimmest and the brightest channel is squared. In HSV terms, this maps both
+ * the value and the saturation as x * (2 - x), which makes typical colors
+ * measured by LEGO color sensors span the full range.
+ *
+ * @param [in, out] rgb     The color to update.
+ */
+static void pbio_color_rgb_apply_gamma(pbio_color_rgb_t *rgb) {
+    int32_t max = rgb->r > rgb->g ? rgb->r : rgb->g;
+    max = rgb->b > max ? rgb->b : max;
+    int32_t min = rgb->r < rgb->g ? rgb->r : rgb->g;
+    min = rgb->b < min ? rgb->b : min;
+
+    if (max == 0) {
+        return;
+    }
+
+    int32_t max_new = max * (510 - max) / 255;
+    if (max == min) {
+        rgb->r = rgb->g = rgb->b = max_new;
+        return;
+    }
+
+    // Stretch the other channels linearly between the new extremes.
+    int32_t min_new = max_new * min * min / (max * max);
+    rgb->r = min_new + (rgb->r - min) * (max_new - min_new) / (max - min);
+    rgb->g = min_new + (rgb->g - min) * (max_new - min_new) / (max - min);
+    rgb->b = min_new + (rgb->b - min) * (max_new - min_new) / (max - min);
+}
+
+/**
+ * Converts a raw reading to a calibrated RGB color.
+ *
+ * The ambient reading and the calibration offset are subtracted from the raw
+ * reading, after which the calibration gains map it to RGB. Finally, a
+ * gamma-like tone curve is applied.
+ *
+ * @param [in]  calibration The calibration of the sensor.
+ * @param [in]  raw         Raw reading of the sensor.
+ * @param [in]  ambient     Raw reading without the sensor light, or NULL to
+ *                          only subtract the calibration offset.
+ * @param [out] rgb         The calibrated RGB color.
+ */
+void pbio_color_calibration_get_rgb(const pbio_color_calibration_t *calibration, const pbio_color_raw_t *raw, const pbio_color_raw_t *ambient, pbio_color_rgb_t *rgb) {
+
+    // Remove offset and ambient light.
+    int32_t corrected[3];
+    for (uint8_t i = 0; i < 3; i++) {
+        int32_t value = raw->values[i] - calibration->offset[i] - (ambient ? ambient->values[i] : 0);
+        corrected[i] = value < 0 ? 0 : (value > INT16_MAX ? INT16_MAX : value);
+    }
+
+    // Apply the color correction matrix and clamp to the RGB range.
+    uint8_t result[3];
+    for (uint8_t i = 0; i < 3; i++) {
+        int64_t sum = 0;
+        for (uint8_t j = 0; j < 3; j++) {
+            sum += (int32_t)calibration->gain[i][j] * corrected[j];
+        }
+        sum /= PBIO_COLOR_CALIBRATION_GAIN_SCALE;
+        result[i] = sum < 0 ? 0 : (sum > 255 ? 255 : sum);
+    }
+    rgb->r = result[0];
+    rgb->g = result[1];
+    rgb->b = result[2];
+
+    pbio_color_rgb_apply_gamma(rgb);
+}
+
+/**
+ * Converts a raw reading to a calibrated HSV color.
+ *
+ * See ::pbio_color_calibration_get_rgb for details.
+ *
+ * @param [in]  calibration The calibration of the sensor.
+ * @param [in]  raw         Raw reading of the sensor.
+ * @param [in]  ambient     Raw reading without the sensor light, or NULL.
+ * @param [out] hsv         The calibrated HSV color.
+ */
+void pbio_color_calibration_get_hsv(const pbio_color_calibration_t *calibration, const pbio_color_raw_t *raw, const pbio_color_raw_t *ambient, pbio_color_hsv_t *hsv) {
+    pbio_color_rgb_t rgb;
+    pbio_color_calibration_get_rgb(calibration, raw, ambient, &rgb);
+    pbio_color_rgb_to_hsv(&rgb, hsv);
+}
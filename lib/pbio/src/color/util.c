@@ -36,3 +36,66 @@ int32_t pbio_color_get_bicone_squared_distance(const pbio_color_hsv_t *hsv_a, co
     // Squared Euclidean distance (0, 400000000)
     return delta_x * delta_x + delta_y * delta_y + delta_z * delta_z;
 }
+
+/**
+ * Maps an HSV color into the chroma-lightness-bicone.
+ *
+ * @param [in]  hsv      The HSV color.
+ * @param [out] bicone   The coordinates in the bicone.
+ */
+void pbio_color_hsv_to_bicone(const pbio_color_hsv_t *hsv, pbio_color_bicone_t *bicone) {
+
+    // Chroma (= radial coordinate in bicone) (0-10000).
+    int32_t radius = pbio_color_hsv_get_v(hsv) * hsv->s;
+
+    // x and y are not yet scaled down, so that distances are rounded
+    // exactly as in pbio_color_get_bicone_squared_distance.
+    bicone->x = radius * pbio_int_math_cos_deg(hsv->h);
+    bicone->y = radius * pbio_int_math_sin_deg(hsv->h);
+
+    // Lightness (= z-coordinate in bicone) (0-20000).
+    bicone->z = (200 - hsv->s) * hsv->v;
+}
+
+/**
+ * Gets squared Euclidean distance between colors in the bicone. This gives
+ * the same result as ::pbio_color_get_bicone_squared_distance for the
+ * original HSV colors.
+ *
+ * @param [in]  bicone_a The first color.
+ * @param [in]  bicone_b The second color.
+ * @returns              Squared distance (0 to 400000000).
+ */
+int32_t pbio_color_bicone_get_squared_distance(const pbio_color_bicone_t *bicone_a, const pbio_color_bicone_t *bicone_b) {
+    int32_t delta_x = (bicone_b->x - bicone_a->x) / 10000;
+    int32_t delta_y = (bicone_b->y - bicone_a->y) / 10000;
+    int32_t delta_z = bicone_b->z - bicone_a->z;
+    return delta_x * delta_x + delta_y * delta_y + delta_z * delta_z;
+}
+
+/**
+ * Finds the color nearest to the given HSV color.
+ *
+ * @param [in]  bicones     The candidate colors, mapped into the bicone.
+ * @param [in]  num_bicones Number of candidates.
+ * @param [in]  hsv         The HSV color to match.
+ * @returns                 Index of the first nearest candidate, or
+ *                          @p num_bicones if there are no candidates.
+ */
+size_t pbio_color_bicone_get_nearest(const pbio_color_bicone_t *bicones, size_t num_bicones, const pbio_color_hsv_t *hsv) {
+
+    pbio_color_bicone_t bicone;
+    pbio_color_hsv_to_bicone(hsv, &bicone);
+
+    size_t match = num_bicones;
+    int32_t cost_min = INT32_MAX;
+
+    for (size_t i = 0; i < num_bicones; i++) {
+        int32_t cost_now = pbio_color_bicone_get_squared_distance(&bicone, &bicones[i]);
+        if (cost_now < cost_min) {
+            cost_min = cost_now;
+            match = i;
+        }
+    }
+    return match;
+}
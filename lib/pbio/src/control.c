@@ -172,12 +172,12 @@ void pbio_control_get_reference(pbio_control_t *ctl, uint32_t time_now, const pb
     }
 }
 
-static int32_t pbio_control_get_pid_kp(const pbio_control_settings_t *settings, int32_t position_error, int32_t target_error, int32_t abs_command_speed) {
+static int32_t pbio_control_get_pid_kp(const pbio_control_settings_t *settings, int32_t pid_kp, int32_t position_error, int32_t target_error, int32_t abs_command_speed) {
 
     // Reduced kp values are only needed for some motors under slow speed
     // conditions. For everything else, use the default kp value.
     if (abs_command_speed >= settings->pid_kp_low_speed_threshold || position_error == 0) {
-        return settings->pid_kp;
+        return pid_kp;
     }
 
     // We only need a positive kp value, so work with absolute values
@@ -186,7 +186,7 @@ static int32_t pbio_control_get_pid_kp(const pbio_control_settings_t *settings,
     target_error = pbio_int_math_abs(target_error);
 
     // Lowest kp value, used when steadily turning at slow speed.
-    const int32_t kp_low = settings->pid_kp * settings->pid_kp_low_pct / 100;
+    const int32_t kp_low = pid_kp * settings->pid_kp_low_pct / 100;
 
     // Get equivalent kp value to produce a piece-wise affine (pwa) feedback in the
     // position error. It grows slower at first, and then at the configured rate.
@@ -194,11 +194,11 @@ static int32_t pbio_control_get_pid_kp(const pbio_control_settings_t *settings,
         // For small errors, feedback is linear in low kp value.
         kp_low :
         // Above the threshold, feedback grows with the default gain.
-        settings->pid_kp - settings->pid_kp_low_error_threshold * (settings->pid_kp - kp_low) / position_error;
+        pid_kp - settings->pid_kp_low_error_threshold * (pid_kp - kp_low) / position_error;
 
     // Proportional control saturates where the error leads to maximum actuation.
     // For errors any smaller than that,
-    const int32_t saturation_lower = pbio_control_settings_div_by_gain(settings->actuation_max, settings->pid_kp);
+    const int32_t saturation_lower = pbio_control_settings_div_by_gain(settings->actuation_max, pid_kp);
 
     // Further away from the target, we can use the reduced value and still
     // guarantee maximum actuation, to avoid getting stuck.
@@ -208,13 +208,13 @@ static int32_t pbio_control_get_pid_kp(const pbio_control_settings_t *settings,
     // close to the target to guarantee that we can always get there.
     int32_t kp_target;
     if (target_error < saturation_lower) {
-        kp_target = settings->pid_kp;
+        kp_target = pid_kp;
     } else if (target_error > saturation_upper) {
         kp_target = kp_low;
     } else {
         // In between, we gradually shift towards the higher value as we get
         // closer to the final target to avoid a sudden transition.
-        kp_target = kp_low + settings->pid_kp *
+        kp_target = kp_low + pid_kp *
             (100 - settings->pid_kp_low_pct) * (saturation_upper - target_error) /
             (saturation_upper - saturation_lower) / 100;
     }
@@ -276,11 +276,16 @@ void pbio_control_update(
         target_error = INT32_MAX;
     }
 
+    // Get PID gains, which may be scheduled by the commanded speed.
+    int32_t abs_command_speed = pbio_trajectory_get_abs_command_speed(&ctl->trajectory);
+    int32_t pid_kp_nominal, pid_ki, pid_kd;
+    pbio_control_settings_get_pid_at_speed(&ctl->settings, abs_command_speed, &pid_kp_nominal, &pid_ki, &pid_kd);
+
     // Corresponding PID control signal
-    int32_t pid_kp = pbio_control_get_pid_kp(&ctl->settings, position_error, target_error, pbio_trajectory_get_abs_command_speed(&ctl->trajectory));
+    int32_t pid_kp = pbio_control_get_pid_kp(&ctl->settings, pid_kp_nominal, position_error, target_error, abs_command_speed);
     int32_t torque_proportional = pbio_control_settings_mul_by_gain(position_error_used, pid_kp);
-    int32_t torque_derivative = pbio_control_settings_mul_by_gain(speed_error, ctl->settings.pid_kd);
-    int32_t torque_integral = pbio_control_settings_mul_by_gain(integral_error, ctl->settings.pid_ki);
+    int32_t torque_derivative = pbio_control_settings_mul_by_gain(speed_error, pid_kd);
+    int32_t torque_integral = pbio_control_settings_mul_by_gain(integral_error, pid_ki);
 
     // Total torque signal, capped by the actuation limit
     int32_t torque = pbio_int_math_clamp(torque_proportional + torque_integral + torque_derivative, ctl->settings.actuation_max_temporary);
@@ -292,7 +297,7 @@ void pbio_control_update(
     // if we get at this limit. We wait a little longer though, to make sure it does not fall back to below the limit
     // within one sample, which we can predict using the current rate times the loop time, with a factor two tolerance.
     int32_t windup_margin = pbio_control_settings_mul_by_loop_time(pbio_int_math_abs(state->speed)) * 2;
-    int32_t max_windup_torque = ctl->settings.actuation_max_temporary + pbio_control_settings_mul_by_gain(windup_margin, ctl->settings.pid_kp);
+    int32_t max_windup_torque = ctl->settings.actuation_max_temporary + pbio_control_settings_mul_by_gain(windup_margin, pid_kp_nominal);
 
     // Speed value that is rounded to zero if small. This is used for a
     // direction error check below to avoid false reverses near zero.
@@ -405,10 +410,16 @@ void pbio_control_update(
             pbio_control_settings_ctl_to_app(&ctl->settings, state->speed_estimate),
             // Column 10: P term of PID control in (uNm).
             torque_proportional,
-            // Column 12: I term of PID control in (uNm).
+            // Column 11: I term of PID control in (uNm).
             torque_integral,
-            // Column 13: D term of PID control in (uNm).
+            // Column 12: D term of PID control in (uNm).
             torque_derivative,
+            // Column 13: Active proportional gain (control units).
+            pid_kp,
+            // Column 14: Active integral gain (control units).
+            pid_ki,
+            // Column 15: Active derivative gain (control units).
+            pid_kd,
         };
         pbio_logger_add_row(&ctl->log, log_data);
     }
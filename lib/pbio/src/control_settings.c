@@ -316,6 +316,118 @@ pbio_error_t pbio_control_settings_set_pid(pbio_control_settings_t *s, int32_t p
     return PBIO_SUCCESS;
 }
 
+/**
+ * Gets the PID gains to use at the given commanded speed.
+ *
+ * If a gain schedule is configured, the gains are linearly interpolated
+ * between the two nearest points, and held constant beyond the first and
+ * last points. Otherwise, the fixed gains are used.
+ *
+ * @param [in]  s                    Control settings structure from which to read.
+ * @param [in]  abs_speed            Absolute commanded speed (control units).
+ * @param [out] pid_kp               Position error feedback constant.
+ * @param [out] pid_ki               Accumulated error feedback constant.
+ * @param [out] pid_kd               Speed error feedback constant.
+ */
+void pbio_control_settings_get_pid_at_speed(const pbio_control_settings_t *s, int32_t abs_speed, int32_t *pid_kp, int32_t *pid_ki, int32_t *pid_kd) {
+
+    #if PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+    if (s->gain_schedule_size > 0) {
+        // Find the first point at or above the given speed.
+        uint8_t i = 0;
+        while (i < s->gain_schedule_size && s->gain_schedule[i].speed < abs_speed) {
+            i++;
+        }
+
+        // Hold gains constant outside of the scheduled speed range.
+        if (i == 0 || i == s->gain_schedule_size) {
+            const pbio_control_gain_schedule_point_t *p = &s->gain_schedule[i == 0 ? 0 : i - 1];
+            *pid_kp = p->pid_kp;
+            *pid_ki = p->pid_ki;
+            *pid_kd = p->pid_kd;
+            return;
+        }
+
+        // Otherwise interpolate between the two surrounding points.
+        const pbio_control_gain_schedule_point_t *a = &s->gain_schedule[i - 1];
+        const pbio_control_gain_schedule_point_t *b = &s->gain_schedule[i];
+        // Scaled down to keep the product within range. Points are at least
+        // this far apart, so the divisor is nonzero.
+        int32_t ds = (abs_speed - a->speed) / 100;
+        int32_t dt = (b->speed - a->speed) / 100;
+        *pid_kp = a->pid_kp + pbio_int_math_mult_then_div(b->pid_kp - a->pid_kp, ds, dt);
+        *pid_ki = a->pid_ki + pbio_int_math_mult_then_div(b->pid_ki - a->pid_ki, ds, dt);
+        *pid_kd = a->pid_kd + pbio_int_math_mult_then_div(b->pid_kd - a->pid_kd, ds, dt);
+        return;
+    }
+    #endif // PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+
+    *pid_kp = s->pid_kp;
+    *pid_ki = s->pid_ki;
+    *pid_kd = s->pid_kd;
+}
+
+#if PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+
+/**
+ * Gets the gain schedule.
+ *
+ * Speeds are given in application units. Gains are given in control units.
+ *
+ * @param [in]  s                    Control settings structure from which to read.
+ * @param [out] points               Schedule points. Must have room for ::PBIO_CONTROL_GAIN_SCHEDULE_SIZE_MAX points.
+ * @return                           Number of points in the schedule.
+ */
+uint8_t pbio_control_settings_get_gain_schedule(const pbio_control_settings_t *s, pbio_control_gain_schedule_point_t *points) {
+    for (uint8_t i = 0; i < s->gain_schedule_size; i++) {
+        points[i] = s->gain_schedule[i];
+        points[i].speed = pbio_control_settings_ctl_to_app(s, s->gain_schedule[i].speed);
+    }
+    return s->gain_schedule_size;
+}
+
+/**
+ * Sets the gain schedule.
+ *
+ * Speeds should be given in application units. Gains should be given in
+ * control units.
+ *
+ * @param [in] s                    Control settings structure to write to.
+ * @param [in] points               Schedule points, sorted by increasing speed.
+ * @param [in] size                 Number of points. Zero disables the schedule.
+ * @return                          ::PBIO_SUCCESS on success
+ *                                  ::PBIO_ERROR_INVALID_ARG if there are too many points,
+ *                                  if speeds are not increasing, or if any value is negative.
+ */
+pbio_error_t pbio_control_settings_set_gain_schedule(pbio_control_settings_t *s, const pbio_control_gain_schedule_point_t *points, uint8_t size) {
+    if (size > PBIO_CONTROL_GAIN_SCHEDULE_SIZE_MAX) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    for (uint8_t i = 0; i < size; i++) {
+        // Zero speed is allowed, for gains used when holding still.
+        if (points[i].speed != 0) {
+            pbio_error_t err = pbio_trajectory_validate_speed_limit(s->ctl_steps_per_app_step, points[i].speed);
+            if (err != PBIO_SUCCESS) {
+                return err;
+            }
+        }
+        if ((i > 0 && pbio_control_settings_app_to_ctl(s, points[i].speed - points[i - 1].speed) < 100) ||
+            points[i].speed < 0 || points[i].pid_kp < 0 || points[i].pid_ki < 0 || points[i].pid_kd < 0) {
+            return PBIO_ERROR_INVALID_ARG;
+        }
+    }
+
+    for (uint8_t i = 0; i < size; i++) {
+        s->gain_schedule[i] = points[i];
+        s->gain_schedule[i].speed = pbio_control_settings_app_to_ctl(s, points[i].speed);
+    }
+    s->gain_schedule_size = size;
+    return PBIO_SUCCESS;
+}
+
+#endif // PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+
 /**
  * Gets the tolerances associated with reaching a position target.
  * @param [in]  s           Control settings structure from which to read.
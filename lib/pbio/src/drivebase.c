@@ -4,11 +4,13 @@
 // SPDX-License-Identifier: BSD-3-Clause
 // Copyright (c) 2020-2023 LEGO System A/S
 
+#include <math.h>
 #include <stdlib.h>
 
 #include <pbdrv/clock.h>
 #include <pbio/error.h>
 #include <pbio/drivebase.h>
+#include <pbio/geometry.h>
 #include <pbio/int_math.h>
 #include <pbio/imu.h>
 #include <pbio/servo.h>
@@ -189,6 +191,62 @@ static pbio_error_t pbio_drivebase_get_state_control(pbio_drivebase_t *db, pbio_
     return PBIO_SUCCESS;
 }
 
+#if PBIO_CONFIG_DRIVEBASE_POSE
+
+/**
+ * Synchronizes the pose estimate with the current drivebase state without
+ * changing the position. This is needed when the distance or heading
+ * offsets change, so that the offset change is not counted as motion.
+ *
+ * @param [in]  db              The drivebase instance
+ * @return                      Error code.
+ */
+static pbio_error_t pbio_drivebase_pose_sync(pbio_drivebase_t *db) {
+
+    pbio_control_state_t state_distance;
+    pbio_control_state_t state_heading;
+    pbio_error_t err = pbio_drivebase_get_state_control(db, &state_distance, &state_heading);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    db->pose.distance = state_distance.position;
+    db->pose.heading = pbio_control_settings_ctl_to_app_long_float(&db->control_heading.settings, &state_heading.position);
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Updates the pose estimate with the motion since the previous update.
+ *
+ * The distance comes from the wheel encoders. The heading comes from the same
+ * source as heading control, so it uses the gyro if the drivebase does.
+ *
+ * @param [in]  db              The drivebase instance
+ */
+static void pbio_drivebase_update_pose(pbio_drivebase_t *db) {
+
+    pbio_control_state_t state_distance;
+    pbio_control_state_t state_heading;
+    if (pbio_drivebase_get_state_control(db, &state_distance, &state_heading) != PBIO_SUCCESS) {
+        return;
+    }
+
+    float heading = pbio_control_settings_ctl_to_app_long_float(&db->control_heading.settings, &state_heading.position);
+    float distance = (float)pbio_angle_diff_mdeg(&state_distance.position, &db->pose.distance) /
+        db->control_distance.settings.ctl_steps_per_app_step;
+
+    // Integrate along the average heading during this interval, which is
+    // exact for a constant turn rate up to second order in the heading change.
+    float heading_mid = (heading + db->pose.heading) / 2 * PBIO_GEOMETRY_RADIANS_PER_DEGREE;
+    db->pose.x += distance * cosf(heading_mid);
+    db->pose.y += distance * sinf(heading_mid);
+
+    db->pose.distance = state_distance.position;
+    db->pose.heading = heading;
+}
+
+#endif // PBIO_CONFIG_DRIVEBASE_POSE
+
 /**
  * Stop the drivebase from updating its controllers.
  *
@@ -201,6 +259,9 @@ static void pbio_drivebase_stop_drivebase_control(pbio_drivebase_t *db) {
     pbio_control_stop(&db->control_distance);
     pbio_control_stop(&db->control_heading);
     db->control_paused = false;
+    #if PBIO_CONFIG_DRIVEBASE_PATH
+    db->path.active = false;
+    #endif
 }
 
 /**
@@ -367,7 +428,14 @@ pbio_error_t pbio_drivebase_get_drivebase(pbio_drivebase_t **db_address, pbio_se
     // By default, don't use gyro for steering control.
     db->use_gyro = false;
 
+    #if PBIO_CONFIG_DRIVEBASE_POSE
+    // Start tracking the pose from the origin.
+    db->pose.x = 0;
+    db->pose.y = 0;
+    return pbio_drivebase_pose_sync(db);
+    #else
     return PBIO_SUCCESS;
+    #endif
 }
 
 /**
@@ -394,7 +462,13 @@ pbio_error_t pbio_drivebase_set_use_gyro(pbio_drivebase_t *db, bool use_gyro) {
     }
 
     db->use_gyro = use_gyro;
+
+    #if PBIO_CONFIG_DRIVEBASE_POSE
+    // The heading source changed, so the pose continues from the new source.
+    return pbio_drivebase_pose_sync(db);
+    #else
     return PBIO_SUCCESS;
+    #endif
 }
 
 /**
@@ -442,6 +516,103 @@ bool pbio_drivebase_is_done(const pbio_drivebase_t *db) {
     return pbio_control_is_done(&db->control_distance) && pbio_control_is_done(&db->control_heading);
 }
 
+#if PBIO_CONFIG_DRIVEBASE_PATH
+
+/**
+ * Sets the heading reference to a given point on the path.
+ *
+ * The heading controller runs as a timed controller during path following.
+ * Its trajectory is replaced by a constant rate segment through the given
+ * point in every control loop, so it is evaluated exactly at that point.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  time_now        The wall time (ticks).
+ * @param [in]  heading         Heading relative to the start of the path (control units).
+ * @param [in]  speed           Rate of change of the heading (control units).
+ */
+static void pbio_drivebase_path_set_heading_reference(pbio_drivebase_t *db, uint32_t time_now, int32_t heading, int32_t speed) {
+
+    pbio_control_settings_t *sh = &db->control_heading.settings;
+
+    pbio_trajectory_command_t command = {
+        .time_start = time_now,
+        .position_start = db->path.heading_start,
+        .speed_start = pbio_int_math_clamp(speed, sh->speed_max),
+        .speed_target = pbio_int_math_clamp(speed, sh->speed_max),
+        .continue_running = true,
+    };
+    pbio_angle_add_mdeg(&command.position_start, heading);
+    pbio_trajectory_make_constant(&db->control_heading.trajectory, &command);
+}
+
+/**
+ * Updates the heading reference of a drivebase that follows a path.
+ *
+ * The heading reference is a function of the distance reference, so the
+ * robot follows the same path regardless of the speed or any pauses.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  time_now        The wall time (ticks).
+ * @param [in]  state_heading   Current heading state (control units).
+ * @param [in]  ref_distance    Current distance reference (control units).
+ * @return                      Error code.
+ */
+static pbio_error_t pbio_drivebase_path_update_heading(pbio_drivebase_t *db, uint32_t time_now, const pbio_control_state_t *state_heading, const pbio_trajectory_reference_t *ref_distance) {
+
+    pbio_drivebase_path_t *path = &db->path;
+
+    // Once the distance reference reaches the end of the path, hand heading
+    // control over to regular position control at the final heading. This
+    // way the drivebase completes just like it does for any other maneuver.
+    pbio_trajectory_reference_t ref_end;
+    pbio_trajectory_get_endpoint(&db->control_distance.trajectory, &ref_end);
+    if (pbio_control_settings_time_is_later(ref_distance->time, ref_end.time)) {
+        path->active = false;
+        pbio_drivebase_path_set_heading_reference(db, time_now, path->heading_end[path->num_segments - 1], 0);
+
+        // Hold the heading when the robot keeps driving after the path.
+        pbio_control_on_completion_t on_completion = db->control_distance.on_completion;
+        if (on_completion == PBIO_CONTROL_ON_COMPLETION_CONTINUE) {
+            on_completion = PBIO_CONTROL_ON_COMPLETION_HOLD;
+        }
+        return pbio_control_start_position_control_relative(&db->control_heading, time_now, state_heading, 0, 0, on_completion, false);
+    }
+
+    // Find the segment that contains the distance reference. All segments go
+    // in the same direction, so we can compare by magnitude.
+    int32_t distance = pbio_angle_diff_mdeg(&ref_distance->position, &path->distance_start);
+    uint8_t index = 0;
+    while (index < path->num_segments - 1 && pbio_int_math_abs(distance) > pbio_int_math_abs(path->distance_end[index])) {
+        index++;
+    }
+    int32_t distance_start = index == 0 ? 0 : path->distance_end[index - 1];
+    int32_t heading_start = index == 0 ? 0 : path->heading_end[index - 1];
+    float length = path->distance_end[index] - distance_start;
+    float angle = path->heading_end[index] - heading_start;
+
+    // Fraction of the segment completed so far.
+    float u = (distance - distance_start) / length;
+    u = u < 0.0f ? 0.0f : (u > 1.0f ? 1.0f : u);
+
+    // Heading profile along the segment and its derivative. Arcs turn at a
+    // constant rate. Smooth segments use 3u^2 - 2u^3, which starts and ends
+    // with zero turn rate so that consecutive segments join without a jump.
+    float profile = u;
+    float profile_derivative = 1.0f;
+    if (path->smooth[index]) {
+        profile = u * u * (3.0f - 2.0f * u);
+        profile_derivative = 6.0f * u * (1.0f - u);
+    }
+
+    // The turn rate is the change in heading per distance times drive speed.
+    int32_t heading = heading_start + (int32_t)(angle * profile);
+    int32_t speed = (int32_t)(angle * profile_derivative / length * ref_distance->speed);
+    pbio_drivebase_path_set_heading_reference(db, time_now, heading, speed);
+    return PBIO_SUCCESS;
+}
+
+#endif // PBIO_CONFIG_DRIVEBASE_PATH
+
 /**
  * Updates one drivebase in the control loop.
  *
@@ -476,6 +647,17 @@ static pbio_error_t pbio_drivebase_update(pbio_drivebase_t *db) {
     bool distance_external_pause = db->control_paused;
     pbio_control_update(&db->control_distance, time_now, &state_distance, &ref_distance, &distance_actuation, &distance_torque, &distance_external_pause);
 
+    #if PBIO_CONFIG_DRIVEBASE_PATH
+    // When following a path, the heading reference is derived from the
+    // distance reference, so it must be set before updating heading control.
+    if (db->path.active) {
+        err = pbio_drivebase_path_update_heading(db, time_now, &state_heading, &ref_distance);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+    }
+    #endif
+
     // Get reference and torque signals for heading control.
     pbio_trajectory_reference_t ref_heading;
     int32_t heading_torque;
@@ -534,6 +716,9 @@ void pbio_drivebase_update_all(void) {
 
         // If it's registered for updates, run its update loop
         if (pbio_drivebase_update_loop_is_running(db)) {
+            #if PBIO_CONFIG_DRIVEBASE_POSE
+            pbio_drivebase_update_pose(db);
+            #endif
             pbio_drivebase_update(db);
         }
     }
@@ -560,6 +745,11 @@ static pbio_error_t pbio_drivebase_drive_relative(pbio_drivebase_t *db, int32_t
     // Stop servo control in case it was running.
     pbio_drivebase_stop_servo_control(db);
 
+    #if PBIO_CONFIG_DRIVEBASE_PATH
+    // A new command ends path following.
+    db->path.active = false;
+    #endif
+
     // Get current time
     uint32_t time_now = pbio_control_get_time_ticks();
 
@@ -717,6 +907,173 @@ pbio_error_t pbio_drivebase_drive_arc_distance(pbio_drivebase_t *db, int32_t rad
     return pbio_drivebase_drive_relative(db, distance, 0, angle, 0, on_completion);
 }
 
+#if PBIO_CONFIG_DRIVEBASE_PATH
+
+/**
+ * Starts the drivebase controllers to follow a path made of segments.
+ *
+ * The distance controller drives along the full length of the path in one
+ * maneuver, so the robot does not stop between segments. The heading
+ * reference is generated from the distance reference on every control loop.
+ * If the drivebase uses the gyro, heading control uses it as usual.
+ *
+ * This will use the default speed.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  segments        Segments of the path. All distances must be nonzero and have the same sign.
+ * @param [in]  num_segments    Number of segments.
+ * @param [in]  on_completion   What to do when reaching the end of the path.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_drivebase_drive_path(pbio_drivebase_t *db, const pbio_drivebase_path_segment_t *segments, uint8_t num_segments, pbio_control_on_completion_t on_completion) {
+
+    // Don't allow new user command if update loop not registered.
+    if (!pbio_drivebase_update_loop_is_running(db)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    if (num_segments == 0 || num_segments > PBIO_DRIVEBASE_PATH_NUM_SEGMENTS_MAX) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    pbio_control_settings_t *sd = &db->control_distance.settings;
+    pbio_control_settings_t *sh = &db->control_heading.settings;
+    pbio_drivebase_path_t *path = &db->path;
+
+    // Validate the segments and convert the cumulative distance and heading
+    // at the end of each segment to control units. The totals must stay
+    // within the range of a single maneuver.
+    int32_t distance_total = 0;
+    int32_t heading_total = 0;
+    for (uint8_t i = 0; i < num_segments; i++) {
+
+        // The robot can't reverse halfway along a single maneuver.
+        if (segments[i].distance == 0 || (segments[i].distance > 0) != (segments[0].distance > 0)) {
+            return PBIO_ERROR_INVALID_ARG;
+        }
+        if (pbio_int_math_abs(segments[i].distance) > INT32_MAX / sd->ctl_steps_per_app_step ||
+            pbio_int_math_abs(segments[i].angle) > INT32_MAX / sh->ctl_steps_per_app_step) {
+            return PBIO_ERROR_INVALID_ARG;
+        }
+        distance_total += segments[i].distance;
+        heading_total += segments[i].angle;
+        if (pbio_int_math_abs(distance_total) > INT32_MAX / sd->ctl_steps_per_app_step ||
+            pbio_int_math_abs(heading_total) > INT32_MAX / sh->ctl_steps_per_app_step) {
+            return PBIO_ERROR_INVALID_ARG;
+        }
+        path->distance_end[i] = pbio_control_settings_app_to_ctl(sd, distance_total);
+        path->heading_end[i] = pbio_control_settings_app_to_ctl(sh, heading_total);
+        path->smooth[i] = segments[i].smooth;
+    }
+    path->num_segments = num_segments;
+
+    // Stop servo control in case it was running.
+    pbio_drivebase_stop_servo_control(db);
+
+    // Get current time
+    uint32_t time_now = pbio_control_get_time_ticks();
+
+    // Get drive base state
+    pbio_control_state_t state_distance;
+    pbio_control_state_t state_heading;
+    pbio_error_t err = pbio_drivebase_get_state_control(db, &state_distance, &state_heading);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    // Start the path from the current heading reference if there is one, so
+    // we continue seamlessly from an ongoing maneuver.
+    if (pbio_control_is_active(&db->control_heading)) {
+        pbio_trajectory_reference_t ref_heading;
+        pbio_control_get_reference(&db->control_heading, time_now, &state_heading, &ref_heading);
+        path->heading_start = ref_heading.position;
+    } else {
+        path->heading_start = state_heading.position;
+    }
+
+    // Drive the full length of the path as one maneuver.
+    err = pbio_control_start_position_control_relative(&db->control_distance, time_now, &state_distance, distance_total, 0, on_completion, false);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    // The path is anchored to the distance target, which need not be the
+    // current position if the previous maneuver ended with smart coast.
+    pbio_trajectory_reference_t ref_end;
+    pbio_trajectory_get_endpoint(&db->control_distance.trajectory, &ref_end);
+    path->distance_start = ref_end.position;
+    pbio_angle_add_mdeg(&path->distance_start, -path->distance_end[num_segments - 1]);
+
+    // Heading runs as an endless timed maneuver until the end of the path.
+    // It is stopped first so that its integrator starts from zero.
+    pbio_control_stop(&db->control_heading);
+    err = pbio_control_start_timed_control(&db->control_heading, time_now, &state_heading, PBIO_TRAJECTORY_DURATION_FOREVER_MS, 0, PBIO_CONTROL_ON_COMPLETION_CONTINUE);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+    pbio_drivebase_path_set_heading_reference(db, time_now, 0, 0);
+    path->active = true;
+
+    return PBIO_SUCCESS;
+}
+
+#endif // PBIO_CONFIG_DRIVEBASE_PATH
+
+#if PBIO_CONFIG_DRIVEBASE_POSE
+
+/**
+ * Starts the drivebase controllers to drive to a point on the ground.
+ *
+ * The robot drives along the circular arc that starts in its current
+ * direction and ends at the target. If the target is behind the robot,
+ * it drives there in reverse. The heading at the end of the arc is turned
+ * by twice the initial bearing of the target.
+ *
+ * This will use the default speed.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  x               Target position along the x axis in mm.
+ * @param [in]  y               Target position along the y axis in mm.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_drivebase_drive_to(pbio_drivebase_t *db, int32_t x, int32_t y, pbio_control_on_completion_t on_completion) {
+
+    // Don't allow new user command if update loop not registered.
+    if (!pbio_drivebase_update_loop_is_running(db)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    // Target relative to the robot, in the direction of travel and to its right.
+    float dx = x - db->pose.x;
+    float dy = y - db->pose.y;
+    float heading = db->pose.heading * PBIO_GEOMETRY_RADIANS_PER_DEGREE;
+    float forward = dx * cosf(heading) + dy * sinf(heading);
+    float right = -dx * sinf(heading) + dy * cosf(heading);
+
+    // Drive in reverse if the target is behind us. Then the bearing is taken
+    // with respect to the backward direction, which turns the same way.
+    float direction = 1.0f;
+    if (forward < 0) {
+        direction = -1.0f;
+        forward = -forward;
+        right = -right;
+    }
+    float bearing = atan2f(right, forward);
+
+    // An arc tangent to the direction of travel through the target turns by
+    // twice the bearing. Its length follows from the chord length.
+    float chord = sqrtf(dx * dx + dy * dy);
+    float length = fabsf(bearing) < 1e-4f ? chord : chord * bearing / sinf(bearing);
+
+    return pbio_drivebase_drive_relative(db,
+        (int32_t)(direction * length), 0,
+        (int32_t)(2 * bearing * PBIO_GEOMETRY_DEGREES_PER_RADIAN), 0,
+        on_completion);
+}
+
+#endif // PBIO_CONFIG_DRIVEBASE_POSE
+
 /**
  * Starts the drivebase controllers to run for a given duration.
  *
@@ -737,6 +1094,11 @@ static pbio_error_t pbio_drivebase_drive_time_common(pbio_drivebase_t *db, int32
     // Stop servo control in case it was running.
     pbio_drivebase_stop_servo_control(db);
 
+    #if PBIO_CONFIG_DRIVEBASE_PATH
+    // A new command ends path following.
+    db->path.active = false;
+    #endif
+
     // Get current time
     uint32_t time_now = pbio_control_get_time_ticks();
 
@@ -823,16 +1185,18 @@ pbio_error_t pbio_drivebase_get_state_user_angle(pbio_drivebase_t *db, float *an
 }
 
 /**
- * Stops the drivebase and resets the accumulated drivebase state in user units.
+ * Stops the drivebase and resets the accumulated heading and optionally the
+ * distance in user units.
  *
  * If the gyro is being used for control, it will be reset to the same angle.
  *
- * @param [in]  db          The drivebase instance.
- * @param [in] distance     Distance traveled in mm.
- * @param [in] angle        Angle turned in degrees.
- * @return                  Error code.
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  reset_distance  Whether to reset the distance or keep it as is.
+ * @param [in]  distance        Distance traveled in mm.
+ * @param [in]  angle           Angle turned in degrees.
+ * @return                      Error code.
  */
-pbio_error_t pbio_drivebase_reset(pbio_drivebase_t *db, int32_t distance, int32_t angle) {
+static pbio_error_t pbio_drivebase_reset_state(pbio_drivebase_t *db, bool reset_distance, int32_t distance, int32_t angle) {
 
     // Physically stops motors and stops the ongoing controllers, simplifying
     // the state reset since we won't need to restart ongoing motion.
@@ -853,8 +1217,10 @@ pbio_error_t pbio_drivebase_reset(pbio_drivebase_t *db, int32_t distance, int32_
     // So we can do:     offset_new = measured - reported_new
     pbio_angle_t reported_new;
 
-    pbio_angle_from_low_res(&reported_new, distance, db->control_distance.settings.ctl_steps_per_app_step);
-    pbio_angle_diff(&measured_distance.position, &reported_new, &db->distance_offset);
+    if (reset_distance) {
+        pbio_angle_from_low_res(&reported_new, distance, db->control_distance.settings.ctl_steps_per_app_step);
+        pbio_angle_diff(&measured_distance.position, &reported_new, &db->distance_offset);
+    }
 
     pbio_angle_from_low_res(&reported_new, angle, db->control_heading.settings.ctl_steps_per_app_step);
     pbio_angle_diff(&measured_heading.position, &reported_new, &db->heading_offset);
@@ -864,9 +1230,79 @@ pbio_error_t pbio_drivebase_reset(pbio_drivebase_t *db, int32_t distance, int32_
         pbio_imu_set_heading(angle);
     }
 
+    #if PBIO_CONFIG_DRIVEBASE_POSE
+    // The robot did not move, so keep the position but take the new angle.
+    return pbio_drivebase_pose_sync(db);
+    #else
     return PBIO_SUCCESS;
+    #endif
 }
 
+/**
+ * Stops the drivebase and resets the accumulated drivebase state in user units.
+ *
+ * If the gyro is being used for control, it will be reset to the same angle.
+ *
+ * @param [in]  db          The drivebase instance.
+ * @param [in] distance     Distance traveled in mm.
+ * @param [in] angle        Angle turned in degrees.
+ * @return                  Error code.
+ */
+pbio_error_t pbio_drivebase_reset(pbio_drivebase_t *db, int32_t distance, int32_t angle) {
+    return pbio_drivebase_reset_state(db, true, distance, angle);
+}
+
+#if PBIO_CONFIG_DRIVEBASE_POSE
+
+/**
+ * Gets the estimated pose of the drivebase.
+ *
+ * @param [in]  db          The drivebase instance.
+ * @param [out] x           Position along the x axis in mm.
+ * @param [out] y           Position along the y axis in mm.
+ * @param [out] angle       Heading in degrees, same as the drivebase angle.
+ * @return                  Error code.
+ */
+pbio_error_t pbio_drivebase_get_pose(pbio_drivebase_t *db, float *x, float *y, float *angle) {
+
+    // Don't allow access if update loop not registered.
+    if (!pbio_drivebase_update_loop_is_running(db)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    *x = db->pose.x;
+    *y = db->pose.y;
+    *angle = db->pose.heading;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Stops the drivebase and resets the estimated pose.
+ *
+ * The drivebase angle is reset to the same angle. The distance is unchanged.
+ *
+ * @param [in]  db          The drivebase instance.
+ * @param [in]  x           Position along the x axis in mm.
+ * @param [in]  y           Position along the y axis in mm.
+ * @param [in]  angle       Heading in degrees.
+ * @return                  Error code.
+ */
+pbio_error_t pbio_drivebase_reset_pose(pbio_drivebase_t *db, int32_t x, int32_t y, int32_t angle) {
+
+    // Keep the distance offset as is, instead of resetting it to the current
+    // distance in user units, which would accumulate round off errors.
+    pbio_error_t err = pbio_drivebase_reset_state(db, false, 0, angle);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    db->pose.x = x;
+    db->pose.y = y;
+    return PBIO_SUCCESS;
+}
+
+#endif // PBIO_CONFIG_DRIVEBASE_POSE
+
 /**
  * Tests if any drive base is currently actively using the gyro.
  *
@@ -216,3 +216,97 @@ pbio_error_t pbio_geometry_map_from_base_axes(pbio_geometry_xyz_t *x_axis, pbio_
 
     return PBIO_SUCCESS;
 }
+
+/**
+ * Multiplies a matrix by the transpose of another: output = a * b^T
+ *
+ * @param [in]  a       The first matrix.
+ * @param [in]  b       The second matrix, which is used transposed.
+ * @param [out] output  The result. Must not be the same as a or b.
+ */
+void pbio_geometry_matrix_multiply_transpose(pbio_geometry_matrix_3x3_t *a, pbio_geometry_matrix_3x3_t *b, pbio_geometry_matrix_3x3_t *output) {
+    for (uint8_t r = 0; r < 3; r++) {
+        for (uint8_t c = 0; c < 3; c++) {
+            output->values[r * 3 + c] =
+                a->values[r * 3 + 0] * b->values[c * 3 + 0] +
+                a->values[r * 3 + 1] * b->values[c * 3 + 1] +
+                a->values[r * 3 + 2] * b->values[c * 3 + 2];
+        }
+    }
+}
+
+/**
+ * Computes the rotation matrix of a unit quaternion.
+ *
+ * The matrix maps vectors in the body frame to the inertial frame.
+ *
+ * @param [in]  q       The unit quaternion.
+ * @param [out] R       The rotation matrix.
+ */
+void pbio_geometry_quaternion_to_rotation_matrix(pbio_geometry_quaternion_t *q, pbio_geometry_matrix_3x3_t *R) {
+    R->m11 = 1 - 2 * (q->q2 * q->q2 + q->q3 * q->q3);
+    R->m12 = 2 * (q->q1 * q->q2 - q->q3 * q->q4);
+    R->m13 = 2 * (q->q1 * q->q3 + q->q2 * q->q4);
+    R->m21 = 2 * (q->q1 * q->q2 + q->q3 * q->q4);
+    R->m22 = 1 - 2 * (q->q1 * q->q1 + q->q3 * q->q3);
+    R->m23 = 2 * (q->q2 * q->q3 - q->q1 * q->q4);
+    R->m31 = 2 * (q->q1 * q->q3 - q->q2 * q->q4);
+    R->m32 = 2 * (q->q2 * q->q3 + q->q1 * q->q4);
+    R->m33 = 1 - 2 * (q->q1 * q->q1 + q->q2 * q->q2);
+}
+
+/**
+ * Computes a quaternion that rotates the given upward vector to the Z axis.
+ *
+ * Of all rotations that do so, this is the one without rotation around Z.
+ *
+ * @param [in]  g       The upward unit vector in the body frame, such as
+ *                      the normalized accelerometer reading at rest.
+ * @param [out] q       The resulting unit quaternion.
+ */
+void pbio_geometry_quaternion_from_gravity_unit_vector(pbio_geometry_xyz_t *g, pbio_geometry_quaternion_t *q) {
+
+    // Upside down, so rotate half a turn around X.
+    if (g->z < -0.9999f) {
+        *q = (pbio_geometry_quaternion_t) {
+            .q1 = 1.0f, .q2 = 0.0f, .q3 = 0.0f, .q4 = 0.0f,
+        };
+        return;
+    }
+
+    // Rotate around g x Z by the angle between g and Z.
+    float q4 = sqrtf((1.0f + g->z) / 2.0f);
+    q->q1 = g->y / (2.0f * q4);
+    q->q2 = -g->x / (2.0f * q4);
+    q->q3 = 0.0f;
+    q->q4 = q4;
+}
+
+/**
+ * Computes the rate of change of a quaternion for a given angular velocity.
+ *
+ * @param [in]  q       The unit quaternion.
+ * @param [in]  w       The angular velocity in the body frame in rad/s.
+ * @param [out] dq      The rate of change of the quaternion.
+ */
+void pbio_geometry_quaternion_get_rate_of_change(pbio_geometry_quaternion_t *q, pbio_geometry_xyz_t *w, pbio_geometry_quaternion_t *dq) {
+    dq->q1 = 0.5f * (w->x * q->q4 - w->y * q->q3 + w->z * q->q2);
+    dq->q2 = 0.5f * (w->x * q->q3 + w->y * q->q4 - w->z * q->q1);
+    dq->q3 = 0.5f * (-w->x * q->q2 + w->y * q->q1 + w->z * q->q4);
+    dq->q4 = 0.5f * (-w->x * q->q1 - w->y * q->q2 - w->z * q->q3);
+}
+
+/**
+ * Normalizes a quaternion so it has unit length.
+ *
+ * @param [in, out]  q  The quaternion to normalize.
+ */
+void pbio_geometry_quaternion_normalize(pbio_geometry_quaternion_t *q) {
+    float norm = sqrtf(q->q1 * q->q1 + q->q2 * q->q2 + q->q3 * q->q3 + q->q4 * q->q4);
+    if (norm == 0.0f) {
+        return;
+    }
+    for (uint8_t i = 0; i < 4; i++) {
+        q->values[i] /= norm;
+    }
+}
@@ -22,16 +22,194 @@
 static pbdrv_imu_dev_t *imu_dev;
 static pbdrv_imu_config_t *imu_config;
 
+// Whether the IMU driver was initialized successfully.
+static bool imu_dev_ok;
+
 // Cached sensor values that can be read at any time without polling again.
 static pbio_geometry_xyz_t angular_velocity; // deg/s, in hub frame, already adjusted for bias.
 static pbio_geometry_xyz_t acceleration; // mm/s^2, in hub frame
-static pbio_geometry_xyz_t gyro_bias;
+static pbio_geometry_xyz_t gyro_bias; // deg/s, at the current temperature.
 static pbio_geometry_xyz_t single_axis_rotation; // deg, in hub frame
 
-// Called by driver to process one frame of unfiltered gyro and accelerometer data.
-static void pbio_imu_handle_frame_data_func(int16_t *data) {
+// Minimum variance of temperature samples (degrees squared) to fit the slope
+// of the gyro bias. Below this, the previous slope is kept.
+#define PBIO_IMU_TEMPERATURE_VARIANCE_MIN (0.25f)
+
+// Bias slopes are limited to this many deg/s per degree Celsius, well beyond
+// typical values, to reject bad fits.
+#define PBIO_IMU_GYRO_BIAS_SLOPE_MAX (0.1f)
+
+// Number of stationary samples after which a stored calibration is trusted
+// so the IMU can be used without waiting for it to be stationary first.
+#define PBIO_IMU_CALIBRATION_SAMPLES_READY (10)
+
+// A learned calibration is only saved again if the bias it gives at the
+// current temperature differs by more than this many deg/s from the stored
+// one, so that the flash is not written on every shutdown.
+#define PBIO_IMU_CALIBRATION_SAVE_BIAS_CHANGE (0.05f)
+
+static pbio_imu_calibration_t imu_calibration;
+
+/**
+ * Gets the gyro bias given by a calibration at the given temperature.
+ *
+ * @param [in]  calibration  The calibration.
+ * @param [in]  temperature  Temperature in degrees Celsius.
+ * @param [out] bias         The bias in deg/s.
+ */
+static void pbio_imu_calibration_get_bias(const pbio_imu_calibration_t *calibration, float temperature, pbio_geometry_xyz_t *bias) {
+    float delta = temperature - calibration->temperature;
+    for (uint8_t i = 0; i < PBIO_ARRAY_SIZE(bias->values); i++) {
+        bias->values[i] = calibration->gyro_bias.values[i] + calibration->gyro_bias_slope.values[i] * delta;
+    }
+}
+
+/**
+ * Updates the gyro bias for the current temperature.
+ */
+static void pbio_imu_update_gyro_bias(void) {
+    pbio_imu_calibration_get_bias(&imu_calibration, pbio_imu_get_temperature(), &gyro_bias);
+}
+
+/**
+ * Standard gravity in mm/s^2.
+ */
+#define PBIO_IMU_GRAVITY (9806.65f)
+
+/**
+ * How fast the attitude estimate follows the accelerometer, in rad/s per unit
+ * of error. Low values make the estimate less sensitive to acceleration of
+ * the robot, while the gyro keeps it accurate in the short term.
+ */
+#define PBIO_IMU_GRAVITY_CORRECTION_GAIN (0.5f)
+
+/**
+ * The accelerometer is used for correction only while the total acceleration
+ * is within this fraction of gravity, so that shocks are ignored.
+ */
+#define PBIO_IMU_GRAVITY_CORRECTION_RANGE (0.2f)
+
+// Estimated 3D attitude of the hub. The rotation matrix maps vectors in the
+// hub frame to the inertial frame, in which Z points up.
+static pbio_geometry_quaternion_t attitude_quaternion = {
+    .q1 = 0.0f, .q2 = 0.0f, .q3 = 0.0f, .q4 = 1.0f,
+};
+static pbio_geometry_matrix_3x3_t attitude_rotation = {
+    .m11 = 1.0f, .m12 = 0.0f, .m13 = 0.0f,
+    .m21 = 0.0f, .m22 = 1.0f, .m23 = 0.0f,
+    .m31 = 0.0f, .m32 = 0.0f, .m33 = 1.0f,
+};
+static bool attitude_initialized;
+
+// Rotation around the vertical axis of the inertial frame, in degrees.
+static float heading_rotation;
+
+// Rate of rotation around the vertical axis at the most recent frame, in deg/s.
+static float heading_rotation_rate;
+
+// Time at which the most recent frame was sampled (us).
+static uint32_t frame_time_last;
+static bool frame_time_valid;
+
+/**
+ * Time between frames is measured from the frame timestamps, unless it
+ * deviates from the expected sample time by more than this factor, as it
+ * does on the first batch or after the driver recovers from an error.
+ */
+#define PBIO_IMU_FRAME_TIME_TOLERANCE (2.0f)
+
+/**
+ * The heading is extrapolated to the current time for at most this long
+ * since the most recent frame (us).
+ */
+#define PBIO_IMU_HEADING_EXTRAPOLATION_MAX (10000)
+
+/**
+ * Gets the estimated upward unit vector in the hub frame.
+ *
+ * This is the bottom row of the attitude rotation matrix.
+ *
+ * @param [out] up      The upward unit vector.
+ */
+static void pbio_imu_get_up_vector_hub(pbio_geometry_xyz_t *up) {
+    up->x = attitude_rotation.m31;
+    up->y = attitude_rotation.m32;
+    up->z = attitude_rotation.m33;
+}
+
+/**
+ * Updates the attitude estimate with one sample, using a complementary
+ * filter that integrates the gyro and slowly corrects the estimated direction
+ * of gravity towards the accelerometer reading.
+ *
+ * @param [in]  dt      Time since the previous sample in seconds.
+ */
+static void pbio_imu_update_attitude(float dt) {
+
+    float accel_norm = sqrtf(
+        acceleration.x * acceleration.x +
+        acceleration.y * acceleration.y +
+        acceleration.z * acceleration.z);
+
+    pbio_geometry_xyz_t accel_unit;
+    bool accel_valid = pbio_geometry_vector_normalize(&acceleration, &accel_unit) == PBIO_SUCCESS &&
+        fabsf(accel_norm - PBIO_IMU_GRAVITY) < PBIO_IMU_GRAVITY_CORRECTION_RANGE * PBIO_IMU_GRAVITY;
+
+    // Start from the gravity vector so that the hub may be mounted at any
+    // orientation. Wait for a valid sample to get started.
+    if (!attitude_initialized) {
+        if (accel_valid) {
+            pbio_geometry_quaternion_from_gravity_unit_vector(&accel_unit, &attitude_quaternion);
+            pbio_geometry_quaternion_to_rotation_matrix(&attitude_quaternion, &attitude_rotation);
+            attitude_initialized = true;
+        }
+        return;
+    }
+
+    pbio_geometry_xyz_t up;
+    pbio_imu_get_up_vector_hub(&up);
+
+    // Rotation around the vertical, which does not depend on hub mounting or
+    // on the robot being level.
+    float rate_now = up.x * angular_velocity.x + up.y * angular_velocity.y + up.z * angular_velocity.z;
+    #if PBIO_CONFIG_IMU_HEADING_TRAPEZOIDAL
+    heading_rotation += (heading_rotation_rate + rate_now) / 2 * dt;
+    #else
+    heading_rotation += rate_now * dt;
+    #endif
+    heading_rotation_rate = rate_now;
+
+    // Angular velocity in rad/s.
+    pbio_geometry_xyz_t rate;
+    for (uint8_t i = 0; i < PBIO_ARRAY_SIZE(rate.values); i++) {
+        rate.values[i] = angular_velocity.values[i] * PBIO_GEOMETRY_RADIANS_PER_DEGREE;
+    }
+
+    // Rotate the estimate towards the measured gravity direction.
+    if (accel_valid) {
+        pbio_geometry_xyz_t correction;
+        pbio_geometry_vector_cross_product(&accel_unit, &up, &correction);
+        for (uint8_t i = 0; i < PBIO_ARRAY_SIZE(rate.values); i++) {
+            rate.values[i] += PBIO_IMU_GRAVITY_CORRECTION_GAIN * correction.values[i];
+        }
+    }
+
+    // Integrate the quaternion and keep it normalized.
+    pbio_geometry_quaternion_t dq;
+    pbio_geometry_quaternion_get_rate_of_change(&attitude_quaternion, &rate, &dq);
+    for (uint8_t i = 0; i < PBIO_ARRAY_SIZE(dq.values); i++) {
+        attitude_quaternion.values[i] += dq.values[i] * dt;
+    }
+    pbio_geometry_quaternion_normalize(&attitude_quaternion);
+    pbio_geometry_quaternion_to_rotation_matrix(&attitude_quaternion, &attitude_rotation);
+}
+
+// Processes one frame of unfiltered gyro and accelerometer data, sampled dt
+// seconds after the previous frame.
+static void pbio_imu_handle_frame(int16_t *data, float dt) {
     for (uint8_t i = 0; i < PBIO_ARRAY_SIZE(angular_velocity.values); i++) {
         // Update angular velocity and acceleration cache so user can read them.
+        float rate_prev = angular_velocity.values[i];
         angular_velocity.values[i] = data[i] * imu_config->gyro_scale - gyro_bias.values[i];
         acceleration.values[i] = data[i + 3] * imu_config->accel_scale;
 
@@ -40,7 +218,53 @@ static void pbio_imu_handle_frame_data_func(int16_t *data) {
         // the hub mounted at an arbitrary orientation. Such a 1D heading
         // is numerically more accurate, which is useful in drive base
         // applications so long as the vehicle drives on a flat surface.
-        single_axis_rotation.values[i] += angular_velocity.values[i] * imu_config->sample_time;
+        #if PBIO_CONFIG_IMU_HEADING_TRAPEZOIDAL
+        single_axis_rotation.values[i] += (rate_prev + angular_velocity.values[i]) / 2 * dt;
+        #else
+        (void)rate_prev;
+        single_axis_rotation.values[i] += angular_velocity.values[i] * dt;
+        #endif
+    }
+
+    // Update the 3D attitude at the full sample rate.
+    pbio_imu_update_attitude(dt);
+}
+
+/**
+ * Gets the time between frames in a batch.
+ *
+ * @param [in]  num_frames  Number of frames in the batch.
+ * @param [in]  time        Time at which the last frame was sampled (us).
+ * @return                  Time between frames in seconds.
+ */
+static float pbio_imu_get_frame_time(uint32_t num_frames, uint32_t time) {
+
+    float dt = imu_config->sample_time;
+
+    // Spread the time since the previous batch over the new frames, so that
+    // the integrated angles follow the clock instead of the nominal rate.
+    if (frame_time_valid) {
+        float measured = (time - frame_time_last) / 1000000.0f / num_frames;
+        if (measured > dt / PBIO_IMU_FRAME_TIME_TOLERANCE && measured < dt * PBIO_IMU_FRAME_TIME_TOLERANCE) {
+            dt = measured;
+        }
+    }
+
+    frame_time_last = time;
+    frame_time_valid = true;
+    return dt;
+}
+
+// Called by driver to process a batch of unfiltered gyro and accelerometer data.
+static void pbio_imu_handle_frame_data_func(int16_t *data, uint32_t num_frames, uint32_t time) {
+
+    // Temperature changes slowly, so this is done only once for each batch.
+    pbio_imu_update_gyro_bias();
+
+    float dt = pbio_imu_get_frame_time(num_frames, time);
+
+    for (uint32_t n = 0; n < num_frames; n++) {
+        pbio_imu_handle_frame(&data[n * 6], dt);
     }
 }
 
@@ -52,9 +276,18 @@ static uint32_t stationary_time_last;
 /*
  * Tests if the imu is ready for use in a user program.
  *
- * @return    True if it has been stationary at least once in the last 10 minutes.
+ * @return    True if the IMU works and has a trusted calibration, or if it has
+ *            been stationary at least once in the last 10 minutes.
 */
 bool pbio_imu_is_ready(void) {
+    if (!imu_dev_ok) {
+        return false;
+    }
+    // A calibration from earlier sessions can be used right away, because
+    // the bias is compensated for temperature changes since then.
+    if (imu_calibration.num_samples >= PBIO_IMU_CALIBRATION_SAMPLES_READY) {
+        return true;
+    }
     return stationary_counter > 0 && pbdrv_clock_get_ms() - stationary_time_last < 10 * 60 * 1000;
 }
 
@@ -66,33 +299,129 @@ static void pbio_imu_handle_stationary_data_func(const int32_t *gyro_data_sum, c
         return;
     }
 
-    // If the IMU calibration hasn't been updated in a long time, reset the
-    // stationary counter so that the calibration values get a large weight.
-    if (!pbio_imu_is_ready()) {
-        stationary_counter = 0;
-    }
-
     stationary_time_last = pbdrv_clock_get_ms();
     stationary_counter++;
+    imu_calibration.num_samples++;
 
     // The relative weight of the new data in order to build a long term
     // average of the data without maintaining a data buffer.
-    float weight = stationary_counter >= 20 ? 0.05f : 1.0f / stationary_counter;
+    float weight = imu_calibration.num_samples >= 20 ? 0.05f : 1.0f / imu_calibration.num_samples;
+
+    // Update running mean and variance of the temperature.
+    float temperature_delta = pbio_imu_get_temperature() - imu_calibration.temperature;
+    imu_calibration.temperature += weight * temperature_delta;
+    imu_calibration.temperature_variance = (1.0f - weight) * (imu_calibration.temperature_variance + weight * temperature_delta * temperature_delta);
 
     for (uint8_t i = 0; i < PBIO_ARRAY_SIZE(gyro_bias.values); i++) {
         // Average gyro rate while stationary, indicating current bias.
         float average_now = gyro_data_sum[i] * imu_config->gyro_scale / num_samples;
 
-        // Update bias at decreasing rate.
-        gyro_bias.values[i] = gyro_bias.values[i] * (1.0f - weight) + weight * average_now;
+        // Update mean bias and its covariance with temperature.
+        float bias_delta = average_now - imu_calibration.gyro_bias.values[i];
+        imu_calibration.gyro_bias.values[i] += weight * bias_delta;
+        imu_calibration.gyro_bias_covariance.values[i] = (1.0f - weight) * (imu_calibration.gyro_bias_covariance.values[i] + weight * temperature_delta * bias_delta);
+
+        // Fit the slope only if the samples cover a range of temperatures.
+        // Samples at the same temperature scale the covariance and variance
+        // equally, so the slope is remembered in between.
+        if (imu_calibration.temperature_variance > PBIO_IMU_TEMPERATURE_VARIANCE_MIN) {
+            float slope = imu_calibration.gyro_bias_covariance.values[i] / imu_calibration.temperature_variance;
+            imu_calibration.gyro_bias_slope.values[i] = fmaxf(-PBIO_IMU_GYRO_BIAS_SLOPE_MAX, fminf(slope, PBIO_IMU_GYRO_BIAS_SLOPE_MAX));
+        }
+    }
+
+    pbio_imu_update_gyro_bias();
+}
+
+/**
+ * Gets the default calibration, used if none was stored.
+ *
+ * @param [out] calibration  The calibration.
+ */
+void pbio_imu_calibration_set_defaults(pbio_imu_calibration_t *calibration) {
+    memset(calibration, 0, sizeof(pbio_imu_calibration_t));
+    calibration->temperature = 25.0f;
+}
+
+/**
+ * Gets the current calibration, including what was learned so far.
+ *
+ * @param [out] calibration  The calibration.
+ */
+void pbio_imu_get_calibration(pbio_imu_calibration_t *calibration) {
+    *calibration = imu_calibration;
+}
+
+/**
+ * Sets the calibration, such as one that was stored earlier.
+ *
+ * @param [in]  new_calibration  The calibration.
+ * @returns                      ::PBIO_ERROR_INVALID_ARG if the bias is not
+ *                               finite, otherwise ::PBIO_SUCCESS.
+ */
+pbio_error_t pbio_imu_set_calibration(const pbio_imu_calibration_t *new_calibration) {
+    pbio_geometry_xyz_t bias;
+    pbio_imu_calibration_get_bias(new_calibration, pbio_imu_get_temperature(), &bias);
+    for (uint8_t i = 0; i < PBIO_ARRAY_SIZE(bias.values); i++) {
+        if (!isfinite(bias.values[i])) {
+            return PBIO_ERROR_INVALID_ARG;
+        }
     }
+    imu_calibration = *new_calibration;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Tests if the current calibration differs meaningfully from an earlier one,
+ * such as the one in storage, so that it is worth saving.
+ *
+ * @param [in]  previous     The earlier calibration.
+ * @returns                  True if only one of them is ready for use, or if
+ *                           their bias at the current temperature differs.
+ */
+bool pbio_imu_calibration_changed(const pbio_imu_calibration_t *previous) {
+    if ((previous->num_samples >= PBIO_IMU_CALIBRATION_SAMPLES_READY) !=
+        (imu_calibration.num_samples >= PBIO_IMU_CALIBRATION_SAMPLES_READY)) {
+        return true;
+    }
+    pbio_geometry_xyz_t bias_previous;
+    pbio_imu_calibration_get_bias(previous, pbio_imu_get_temperature(), &bias_previous);
+    for (uint8_t i = 0; i < PBIO_ARRAY_SIZE(gyro_bias.values); i++) {
+        if (!(fabsf(gyro_bias.values[i] - bias_previous.values[i]) <= PBIO_IMU_CALIBRATION_SAVE_BIAS_CHANGE)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Gets the gyro bias at the current temperature.
+ *
+ * @param [out] bias    The bias in deg/s, in the hub frame.
+ */
+void pbio_imu_get_gyro_bias(pbio_geometry_xyz_t *bias) {
+    *bias = gyro_bias;
+}
+
+/**
+ * Gets the temperature of the IMU.
+ *
+ * @return              Temperature in degrees Celsius.
+ */
+float pbio_imu_get_temperature(void) {
+    return pbdrv_imu_get_temperature(imu_dev);
 }
 
 /**
  * Initializes global imu module.
  */
 void pbio_imu_init(void) {
+    pbio_imu_calibration_set_defaults(&imu_calibration);
+    stationary_counter = 0;
+    frame_time_valid = false;
+
     pbio_error_t err = pbdrv_imu_get_imu(&imu_dev, &imu_config);
+    imu_dev_ok = err == PBIO_SUCCESS;
     if (err != PBIO_SUCCESS) {
         return;
     }
@@ -233,9 +562,36 @@ pbio_error_t pbio_imu_get_single_axis_rotation(pbio_geometry_xyz_t *axis, float
 pbio_geometry_side_t pbio_imu_get_up_side(void) {
     // Up is which side of a unit box intersects the +Z vector first.
     // So read +Z vector of the inertial frame, in the body frame.
-    // For now, this is the gravity vector. In the future, we can make this
-    // slightly more accurate by using the full IMU orientation.
-    return pbio_geometry_side_from_vector(&acceleration);
+    pbio_geometry_xyz_t up;
+    pbio_imu_get_up_vector_hub(&up);
+    return pbio_geometry_side_from_vector(&up);
+}
+
+/**
+ * Gets the estimated upward unit vector in the robot frame.
+ *
+ * Unlike the acceleration, this is not affected by motion of the robot.
+ *
+ * @param [out] values      The upward unit vector.
+ */
+void pbio_imu_get_tilt_vector(pbio_geometry_xyz_t *values) {
+    pbio_geometry_xyz_t up;
+    pbio_imu_get_up_vector_hub(&up);
+    pbio_geometry_vector_map(&pbio_orientation_base_orientation, &up, values);
+}
+
+/**
+ * Gets the estimated 3D orientation of the robot.
+ *
+ * The columns of the rotation matrix are the axes of the robot frame,
+ * expressed in the inertial frame, where Z points up.
+ *
+ * @param [out] rotation    The rotation matrix.
+ */
+void pbio_imu_get_orientation(pbio_geometry_matrix_3x3_t *rotation) {
+    // The base orientation maps the hub frame to the robot frame, so its
+    // transpose maps back before rotating into the inertial frame.
+    pbio_geometry_matrix_multiply_transpose(&attitude_rotation, &pbio_orientation_base_orientation, rotation);
 }
 
 static float heading_offset = 0;
@@ -249,12 +605,9 @@ static float heading_offset = 0;
  * @return                  Heading angle in the base frame.
  */
 float pbio_imu_get_heading(void) {
-
-    pbio_geometry_xyz_t heading_mapped;
-
-    pbio_geometry_vector_map(&pbio_orientation_base_orientation, &single_axis_rotation, &heading_mapped);
-
-    return -heading_mapped.z * 360.0f / heading_degrees_per_rotation - heading_offset;
+    // Heading is the rotation around the vertical, so it does not depend on
+    // how the hub is mounted or whether the robot is level.
+    return -heading_rotation * 360.0f / heading_degrees_per_rotation - heading_offset;
 }
 
 /**
@@ -276,7 +629,8 @@ void pbio_imu_set_heading(float desired_heading) {
  * drivebase, which measures heading as the half the difference of the two
  * motor positions in millidegrees.
  *
- * Heading is defined as clockwise positive.
+ * Heading is defined as clockwise positive. It is extrapolated from the most
+ * recent sample to the current time.
  *
  * @param [out]  heading               The heading angle in control units.
  * @param [out]  heading_rate          The heading rate in control units.
@@ -284,9 +638,20 @@ void pbio_imu_set_heading(float desired_heading) {
  */
 void pbio_imu_get_heading_scaled(pbio_angle_t *heading, int32_t *heading_rate, int32_t ctl_steps_per_degree) {
 
+    // Heading rate in degrees per second of the robot.
+    float rate = -heading_rotation_rate * 360.0f / heading_degrees_per_rotation;
+
     // Heading in degrees of the robot.
     float heading_degrees = pbio_imu_get_heading();
 
+    // Frames may be several milliseconds old by the time the controller runs,
+    // especially when they are read in batches. Extrapolate to the current
+    // time using the most recent rate, so the controller sees no extra delay.
+    uint32_t age = pbdrv_clock_get_us() - frame_time_last;
+    if (frame_time_valid && age < PBIO_IMU_HEADING_EXTRAPOLATION_MAX) {
+        heading_degrees += rate * age / 1000000.0f;
+    }
+
     // Number of whole rotations in control units (in terms of wheels, not robot).
     heading->rotations = (int32_t)(heading_degrees / (360000.0f / ctl_steps_per_degree));
 
@@ -296,9 +661,7 @@ void pbio_imu_get_heading_scaled(pbio_angle_t *heading, int32_t *heading_rate, i
     heading->millidegrees = (int32_t)(truncated * ctl_steps_per_degree);
 
     // The heading rate can be obtained by a simple scale because it always fits.
-    pbio_geometry_xyz_t angular_rate;
-    pbio_imu_get_angular_velocity(&angular_rate);
-    *heading_rate = (int32_t)(-angular_rate.z * ctl_steps_per_degree);
+    *heading_rate = (int32_t)(rate * ctl_steps_per_degree);
 }
 
 #endif // PBIO_CONFIG_IMU
@@ -5,7 +5,9 @@
 
 #if PBIO_CONFIG_LIGHT_MATRIX
 
+#include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include <pbio/error.h>
 #include <pbio/light_matrix.h>
@@ -14,48 +16,35 @@
 #include "animation.h"
 #include "light_matrix.h"
 
+_Static_assert(PBIO_CONFIG_LIGHT_MATRIX_MAX_SIZE * PBIO_CONFIG_LIGHT_MATRIX_MAX_SIZE <= INT8_MAX + 1,
+    "frame indexes and steps must fit in int8_t");
+
 /**
- * Sets the pixel to a given brightness.
+ * Gets the index in the frame of a pixel, applying the orientation.
+ *
+ * @param [in]  light_matrix  The light matrix instance
+ * @param [in]  row         Row index (0 to size-1)
+ * @param [in]  col         Column index (0 to size-1)
+ * @return                  Index in the frame.
+ */
+static inline uint8_t pbio_light_matrix_get_index(pbio_light_matrix_t *light_matrix, uint8_t row, uint8_t col) {
+    return light_matrix->origin + row * light_matrix->row_step + col * light_matrix->col_step;
+}
+
+/**
+ * Sets a pixel in the frame to a given brightness, without showing it.
  *
  * @param [in]  light_matrix  The light matrix instance
  * @param [in]  row         Row index (0 to size-1)
  * @param [in]  col         Column index (0 to size-1)
  * @param [in]  brightness  Brightness (0 to 100)
- * @return                  ::PBIO_SUCCESS on success or an
- *                          implementation-specific error on failure.
  */
-static pbio_error_t _pbio_light_matrix_set_pixel(pbio_light_matrix_t *light_matrix, uint8_t row, uint8_t col, uint8_t brightness) {
+static void _pbio_light_matrix_set_pixel(pbio_light_matrix_t *light_matrix, uint8_t row, uint8_t col, uint8_t brightness) {
     uint8_t size = light_matrix->size;
     if (row >= size || col >= size) {
-        return PBIO_SUCCESS;
+        return;
     }
-
-    // Rotate user input based on screen orientation
-    switch (light_matrix->up_side) {
-        case PBIO_GEOMETRY_SIDE_TOP:
-        case PBIO_GEOMETRY_SIDE_FRONT:
-            break;
-        case PBIO_GEOMETRY_SIDE_LEFT: {
-            uint8_t _col = col;
-            col = row;
-            row = size - 1 - _col;
-            break;
-        }
-        case PBIO_GEOMETRY_SIDE_BOTTOM:
-        case PBIO_GEOMETRY_SIDE_BACK:
-            col = size - 1 - col;
-            row = size - 1 - row;
-            break;
-        case PBIO_GEOMETRY_SIDE_RIGHT: {
-            uint8_t _col = col;
-            col = size - 1 - row;
-            row = _col;
-            break;
-        }
-    }
-
-    // Set the pixel brightness
-    return light_matrix->funcs->set_pixel(light_matrix, row, col, brightness);
+    light_matrix->frame[pbio_light_matrix_get_index(light_matrix, row, col)] = brightness;
 }
 
 /**
@@ -68,9 +57,24 @@ static pbio_error_t _pbio_light_matrix_set_pixel(pbio_light_matrix_t *light_matr
  * @param [in]  funcs       The instance-specific callback functions.
  */
 void pbio_light_matrix_init(pbio_light_matrix_t *light_matrix, uint8_t size, const pbio_light_matrix_funcs_t *funcs) {
+    assert(size <= PBIO_CONFIG_LIGHT_MATRIX_MAX_SIZE);
     light_matrix->size = size;
     light_matrix->funcs = funcs;
     pbio_light_animation_init(&light_matrix->animation, NULL);
+    pbio_light_matrix_set_orientation(light_matrix, light_matrix->up_side);
+    memset(light_matrix->frame, 0, sizeof(light_matrix->frame));
+    pbio_light_matrix_invalidate(light_matrix);
+}
+
+/**
+ * Makes the next flush send all pixels to the driver.
+ *
+ * This must be called if the lights were changed without using the frame.
+ *
+ * @param [in]  light_matrix  The light matrix instance.
+ */
+void pbio_light_matrix_invalidate(pbio_light_matrix_t *light_matrix) {
+    light_matrix->shown_valid = false;
 }
 
 /**
@@ -85,6 +89,32 @@ void pbio_light_matrix_init(pbio_light_matrix_t *light_matrix, uint8_t size, con
  */
 void pbio_light_matrix_set_orientation(pbio_light_matrix_t *light_matrix, pbio_geometry_side_t up_side) {
     light_matrix->up_side = up_side;
+
+    // Work out where the pixels go once, so that drawing is just adding steps.
+    int8_t size = light_matrix->size;
+    switch (up_side) {
+        case PBIO_GEOMETRY_SIDE_LEFT:
+            light_matrix->origin = (size - 1) * size;
+            light_matrix->row_step = 1;
+            light_matrix->col_step = -size;
+            break;
+        case PBIO_GEOMETRY_SIDE_BOTTOM:
+        case PBIO_GEOMETRY_SIDE_BACK:
+            light_matrix->origin = size * size - 1;
+            light_matrix->row_step = -size;
+            light_matrix->col_step = -1;
+            break;
+        case PBIO_GEOMETRY_SIDE_RIGHT:
+            light_matrix->origin = size - 1;
+            light_matrix->row_step = -1;
+            light_matrix->col_step = size;
+            break;
+        default:
+            light_matrix->origin = 0;
+            light_matrix->row_step = size;
+            light_matrix->col_step = 1;
+            break;
+    }
 }
 
 /**
@@ -110,16 +140,23 @@ uint8_t pbio_light_matrix_get_size(pbio_light_matrix_t *light_matrix) {
  *                          error on failure.
  */
 pbio_error_t pbio_light_matrix_clear(pbio_light_matrix_t *light_matrix) {
+    return pbio_light_matrix_fill(light_matrix, 0);
+}
+
+/**
+ * Sets all pixels to the same brightness.
+ *
+ * If an animation is running in the background, it will be stopped.
+ *
+ * @param [in]  light_matrix  The light matrix instance
+ * @param [in]  brightness  Brightness (0 to 100)
+ * @return                  ::PBIO_SUCCESS on success or implementation-specific
+ *                          error on failure.
+ */
+pbio_error_t pbio_light_matrix_fill(pbio_light_matrix_t *light_matrix, uint8_t brightness) {
     pbio_light_matrix_stop_animation(light_matrix);
-    for (uint8_t i = 0; i < light_matrix->size; i++) {
-        for (uint8_t j = 0; j < light_matrix->size; j++) {
-            pbio_error_t err = _pbio_light_matrix_set_pixel(light_matrix, i, j, 0);
-            if (err != PBIO_SUCCESS) {
-                return err;
-            }
-        }
-    }
-    return PBIO_SUCCESS;
+    memset(light_matrix->frame, brightness, light_matrix->size * light_matrix->size);
+    return pbio_light_matrix_flush(light_matrix);
 }
 
 /**
@@ -149,13 +186,10 @@ pbio_error_t pbio_light_matrix_set_rows(pbio_light_matrix_t *light_matrix, const
             // The pixel is on if the bit is high.
             bool on = rows[i] & (1 << (size - 1 - j));
             // Set the pixel.
-            pbio_error_t err = _pbio_light_matrix_set_pixel(light_matrix, i, j, on * 100);
-            if (err != PBIO_SUCCESS) {
-                return err;
-            }
+            _pbio_light_matrix_set_pixel(light_matrix, i, j, on * 100);
         }
     }
-    return PBIO_SUCCESS;
+    return pbio_light_matrix_flush(light_matrix);
 }
 
 /**
@@ -179,9 +213,11 @@ pbio_error_t pbio_light_matrix_set_rows(pbio_light_matrix_t *light_matrix, const
 pbio_error_t pbio_light_matrix_set_pixel(pbio_light_matrix_t *light_matrix, uint8_t row, uint8_t col, uint8_t brightness) {
 
     if (pbio_light_animation_is_started(&light_matrix->animation)) {
-        pbio_light_matrix_clear(light_matrix);
+        pbio_light_matrix_stop_animation(light_matrix);
+        memset(light_matrix->frame, 0, light_matrix->size * light_matrix->size);
     }
-    return _pbio_light_matrix_set_pixel(light_matrix, row, col, brightness);
+    _pbio_light_matrix_set_pixel(light_matrix, row, col, brightness);
+    return pbio_light_matrix_flush(light_matrix);
 }
 
 /**
@@ -203,14 +239,111 @@ pbio_error_t pbio_light_matrix_set_pixel(pbio_light_matrix_t *light_matrix, uint
 pbio_error_t pbio_light_matrix_set_image(pbio_light_matrix_t *light_matrix, const uint8_t *image) {
     pbio_light_matrix_stop_animation(light_matrix);
     uint8_t size = light_matrix->size;
-    for (uint8_t r = 0; r < size; r++) {
-        for (uint8_t c = 0; c < size; c++) {
-            pbio_error_t err = _pbio_light_matrix_set_pixel(light_matrix, r, c, image[r * size + c]);
-            if (err != PBIO_SUCCESS) {
-                return err;
+    pbio_light_matrix_blit(light_matrix, image, size, size, 0, 0, PBIO_LIGHT_MATRIX_BLEND_REPLACE);
+    return pbio_light_matrix_flush(light_matrix);
+}
+
+/**
+ * Draws an image on the frame, without showing it.
+ *
+ * The image may be of any size and may be drawn partially outside of the
+ * matrix, so that larger images can be scrolled into view or smaller images
+ * can be layered on top of each other.
+ *
+ * @p row 0 is the top row and @p col 0 is the left-most column of the matrix
+ * according to the orientation set by pbio_light_matrix_set_orientation().
+ *
+ * @param [in]  light_matrix  The light matrix instance
+ * @param [in]  image       Buffer of @p height rows of @p width brightness
+ *                          values (0 to 100).
+ * @param [in]  height      Number of rows in @p image.
+ * @param [in]  width       Number of columns in @p image.
+ * @param [in]  row         Row at which to draw the top of the image.
+ * @param [in]  col         Column at which to draw the left of the image.
+ * @param [in]  blend       How the image is combined with the frame.
+ */
+void pbio_light_matrix_blit(pbio_light_matrix_t *light_matrix, const uint8_t *image, uint8_t height, uint8_t width, int16_t row, int16_t col, pbio_light_matrix_blend_t blend) {
+    int16_t size = light_matrix->size;
+
+    // Only visit the part of the image that is on the matrix.
+    int16_t first_row = row < 0 ? -row : 0;
+    int16_t first_col = col < 0 ? -col : 0;
+    int16_t end_row = size - row < height ? size - row : height;
+    int16_t end_col = size - col < width ? size - col : width;
+
+    for (int16_t i = first_row; i < end_row; i++) {
+        for (int16_t j = first_col; j < end_col; j++) {
+            uint8_t value = image[i * width + j];
+            uint8_t *pixel = &light_matrix->frame[pbio_light_matrix_get_index(light_matrix, row + i, col + j)];
+            switch (blend) {
+                case PBIO_LIGHT_MATRIX_BLEND_OVER:
+                    if (value) {
+                        *pixel = value;
+                    }
+                    break;
+                case PBIO_LIGHT_MATRIX_BLEND_MAX:
+                    if (value > *pixel) {
+                        *pixel = value;
+                    }
+                    break;
+                default:
+                    *pixel = value;
+                    break;
             }
         }
     }
+}
+
+/**
+ * Shifts the frame, without showing it. Pixels that are shifted in are off.
+ *
+ * @param [in]  light_matrix  The light matrix instance
+ * @param [in]  rows        Number of rows to shift down, or up if negative.
+ * @param [in]  cols        Number of columns to shift right, or left if negative.
+ */
+void pbio_light_matrix_scroll(pbio_light_matrix_t *light_matrix, int16_t rows, int16_t cols) {
+    uint8_t previous[sizeof(light_matrix->frame)];
+    memcpy(previous, light_matrix->frame, sizeof(previous));
+
+    int16_t size = light_matrix->size;
+    for (int16_t r = 0; r < size; r++) {
+        for (int16_t c = 0; c < size; c++) {
+            int16_t from_row = r - rows;
+            int16_t from_col = c - cols;
+            bool inside = from_row >= 0 && from_row < size && from_col >= 0 && from_col < size;
+            light_matrix->frame[pbio_light_matrix_get_index(light_matrix, r, c)] =
+                inside ? previous[pbio_light_matrix_get_index(light_matrix, from_row, from_col)] : 0;
+        }
+    }
+}
+
+/**
+ * Shows the frame.
+ *
+ * Only pixels that differ from what was shown before are sent to the driver.
+ * This does not stop an animation that is running in the background, so it
+ * will draw over the frame when it shows its next cell.
+ *
+ * @param [in]  light_matrix  The light matrix instance
+ * @return                  ::PBIO_SUCCESS on success or implementation-specific
+ *                          error on failure.
+ */
+pbio_error_t pbio_light_matrix_flush(pbio_light_matrix_t *light_matrix) {
+    uint8_t size = light_matrix->size;
+    for (uint8_t i = 0; i < size * size; i++) {
+        uint8_t brightness = light_matrix->frame[i];
+        if (light_matrix->shown_valid && light_matrix->shown[i] == brightness) {
+            continue;
+        }
+        pbio_error_t err = light_matrix->funcs->set_pixel(light_matrix, i / size, i % size, brightness);
+        if (err != PBIO_SUCCESS) {
+            // What the driver shows is not known, so send everything next time.
+            light_matrix->shown_valid = false;
+            return err;
+        }
+        light_matrix->shown[i] = brightness;
+    }
+    light_matrix->shown_valid = true;
     return PBIO_SUCCESS;
 }
 
@@ -220,12 +353,8 @@ static uint32_t pbio_light_matrix_animation_next(pbio_light_animation_t *animati
     // display the current cell
     uint8_t size = light_matrix->size;
     const uint8_t *cell = light_matrix->animation_cells + size * size * light_matrix->current_cell;
-
-    for (uint8_t r = 0; r < size; r++) {
-        for (uint8_t c = 0; c < size; c++) {
-            _pbio_light_matrix_set_pixel(light_matrix, r, c, cell[r * size + c]);
-        }
-    }
+    pbio_light_matrix_blit(light_matrix, cell, size, size, 0, 0, PBIO_LIGHT_MATRIX_BLEND_REPLACE);
+    pbio_light_matrix_flush(light_matrix);
 
     // move to the next cell
     if (++light_matrix->current_cell >= light_matrix->num_animation_cells) {
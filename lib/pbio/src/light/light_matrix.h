@@ -1,8 +1,10 @@
 // SPDX-License-Identifier: MIT
 // Copyright (c) 2020 The Pybricks Authors
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include <pbio/config.h>
 #include <pbio/error.h>
 #include <pbio/light_matrix.h>
 
@@ -42,8 +44,22 @@ struct _pbio_light_matrix_t {
     uint8_t size;
     /** Orientation of the matrix: which side is "up". */
     pbio_geometry_side_t up_side;
+    /**
+     * Index in @p frame of the top left pixel as seen by the user, and the
+     * index change per row and per column, for the current orientation.
+     */
+    int8_t origin;
+    int8_t row_step;
+    int8_t col_step;
+    /** Off-screen frame, in the row-major order of the matrix itself. */
+    uint8_t frame[PBIO_CONFIG_LIGHT_MATRIX_MAX_SIZE * PBIO_CONFIG_LIGHT_MATRIX_MAX_SIZE];
+    /** Brightness of each pixel as last sent to the driver. */
+    uint8_t shown[PBIO_CONFIG_LIGHT_MATRIX_MAX_SIZE * PBIO_CONFIG_LIGHT_MATRIX_MAX_SIZE];
+    /** Whether @p shown is known to match the driver. */
+    bool shown_valid;
 };
 
 void pbio_light_matrix_init(pbio_light_matrix_t *light_matrix, uint8_t size, const pbio_light_matrix_funcs_t *funcs);
+void pbio_light_matrix_invalidate(pbio_light_matrix_t *light_matrix);
 
 #endif // _PBIO_LIGHT_LIGHT_MATRIX_H_
@@ -13,7 +13,6 @@
 #include <pbdrv/button.h>
 #include <pbdrv/config.h>
 #include <pbdrv/core.h>
-#include <pbdrv/sound.h>
 #include <pbio/config.h>
 #include <pbio/dcmotor.h>
 #include <pbio/imu.h>
@@ -21,6 +20,7 @@
 #include <pbio/light.h>
 #include <pbio/main.h>
 #include <pbio/motor_process.h>
+#include <pbio/sound.h>
 
 #include "light/animation.h"
 #include "processes.h"
@@ -69,7 +69,7 @@ void pbio_stop_all(bool reset) {
     }
     #endif
     pbio_dcmotor_stop_all(reset);
-    pbdrv_sound_stop();
+    pbio_sound_stop();
 }
 
 /**
@@ -0,0 +1,443 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <pbio/config.h>
+
+#if PBIO_CONFIG_NUM_MOTION_GROUPS > 0
+
+#include <stdlib.h>
+
+#include <pbio/error.h>
+#include <pbio/int_math.h>
+#include <pbio/motion_group.h>
+#include <pbio/observer.h>
+#include <pbio/servo.h>
+
+// Motion group objects
+static pbio_motion_group_t motion_groups[PBIO_CONFIG_NUM_MOTION_GROUPS];
+
+/**
+ * Gets the state of the motion group update loop.
+ *
+ * This becomes true after a successful call to
+ * pbio_motion_group_get_motion_group and becomes false when there is an error,
+ * such as when a cable is unplugged, or when one of its servos is used by
+ * another parent.
+ *
+ * @param [in]  group       The motion group instance.
+ * @return                  True if up and running, false if not.
+ */
+bool pbio_motion_group_update_loop_is_running(pbio_motion_group_t *group) {
+
+    // Motion group must have servos.
+    if (group->num_axes == 0) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+        // Motion group must be the parent of all servos, and all servo update
+        // loops must be running, since we use their observer state.
+        if (!pbio_parent_equals(&group->servos[i]->parent, group) ||
+            !pbio_servo_update_loop_is_running(group->servos[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks if all motion group controllers are active.
+ *
+ * @param [in]  group       The motion group instance.
+ * @return                  True if all axis controllers are active, else false.
+ */
+static bool pbio_motion_group_control_is_active(const pbio_motion_group_t *group) {
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+        if (!pbio_control_is_active(&group->control[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Stops the motion group from updating its controllers.
+ *
+ * This does not physically stop the motors if they are already moving.
+ *
+ * @param [in]  group       The motion group instance.
+ */
+static void pbio_motion_group_stop_group_control(pbio_motion_group_t *group) {
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+        pbio_control_stop(&group->control[i]);
+    }
+    group->control_paused = false;
+}
+
+/**
+ * Motion group stop function that can be called from a servo.
+ *
+ * When a new command is issued to a servo, the servo calls this to stop the
+ * motion group controller and to stop the other motors physically.
+ *
+ * @param [in]  motion_group  Void pointer to this motion group instance.
+ * @param [in]  clear_parent  Unused. There is currently no higher
+ *                            abstraction than a motion group.
+ * @return                    Error code.
+ */
+static pbio_error_t pbio_motion_group_stop_from_servo(void *motion_group, bool clear_parent) {
+
+    // A motion group has no parent, so clear_parent argument is not applicable.
+    (void)clear_parent;
+
+    pbio_motion_group_t *group = motion_group;
+
+    // If control is not active, there is nothing we need to do.
+    if (!pbio_motion_group_control_is_active(group)) {
+        return PBIO_SUCCESS;
+    }
+
+    // Stop the controllers so the motors don't start moving again.
+    pbio_motion_group_stop_group_control(group);
+
+    // Since we don't know which child called the parent to stop, we stop all
+    // motors. We don't stop their parents to avoid escalating the stop calls
+    // up the chain (and back here) once again.
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+        pbio_error_t err = pbio_dcmotor_coast(group->servos[i]->dcmotor);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+    }
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Gets and sets up a motion group instance from several servo instances.
+ *
+ * Each axis keeps the units, gearing, and control settings of its servo.
+ *
+ * @param [out] group_address    Motion group instance if available.
+ * @param [in]  servos           Servo instances, one for each axis.
+ * @param [in]  num_axes         Number of servos.
+ * @return                       Error code.
+ */
+pbio_error_t pbio_motion_group_get_motion_group(pbio_motion_group_t **group_address, pbio_servo_t **servos, uint8_t num_axes) {
+
+    // Need at least two axes to coordinate, and not more than we can store.
+    if (num_axes < 2 || num_axes > PBIO_MOTION_GROUP_NUM_AXES_MAX) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    for (uint8_t i = 0; i < num_axes; i++) {
+        // Each servo may be used only once.
+        for (uint8_t j = 0; j < i; j++) {
+            if (servos[i] == servos[j]) {
+                return PBIO_ERROR_INVALID_ARG;
+            }
+        }
+        // If a servo is already in use by a higher level
+        // abstraction like a drivebase, we can't re-use it.
+        if (pbio_parent_exists(&servos[i]->parent)) {
+            return PBIO_ERROR_BUSY;
+        }
+    }
+
+    // Now we know that the servos are free, so use the first motion group
+    // that isn't running.
+    uint8_t index;
+    for (index = 0; index < PBIO_CONFIG_NUM_MOTION_GROUPS; index++) {
+        if (!pbio_motion_group_update_loop_is_running(&motion_groups[index])) {
+            break;
+        }
+    }
+    if (index == PBIO_CONFIG_NUM_MOTION_GROUPS) {
+        return PBIO_ERROR_FAILED;
+    }
+
+    pbio_motion_group_t *group = &motion_groups[index];
+    *group_address = group;
+
+    // Attach servos and set this group as their parent, so they can stop it.
+    group->num_axes = num_axes;
+    for (uint8_t i = 0; i < num_axes; i++) {
+        group->servos[i] = servos[i];
+        pbio_parent_set(&servos[i]->parent, group, pbio_motion_group_stop_from_servo);
+
+        // Stop any existing controls and stop servo control.
+        pbio_control_reset(&group->control[i]);
+        pbio_control_stop(&servos[i]->control);
+
+        // Each axis is controlled just like its servo would be.
+        group->control[i].settings = servos[i]->control.settings;
+    }
+    group->control_paused = false;
+
+    // Reset all motors to a passive state.
+    return pbio_motion_group_stop(group, PBIO_CONTROL_ON_COMPLETION_COAST);
+}
+
+/**
+ * Stops a motion group.
+ *
+ * @param [in]  group            Motion group instance.
+ * @param [in]  on_completion    Which stop type to use.
+ * @return                       Error code.
+ */
+pbio_error_t pbio_motion_group_stop(pbio_motion_group_t *group, pbio_control_on_completion_t on_completion) {
+
+    // Don't allow new user command if update loop not registered.
+    if (!pbio_motion_group_update_loop_is_running(group)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    // We're asked to stop, so continuing makes no sense.
+    if (on_completion == PBIO_CONTROL_ON_COMPLETION_CONTINUE) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Holding is the same as moving all axes by 0 degrees.
+    if (on_completion == PBIO_CONTROL_ON_COMPLETION_HOLD) {
+        const int32_t zero[PBIO_MOTION_GROUP_NUM_AXES_MAX] = {0};
+        return pbio_motion_group_move_by(group, zero, 0, on_completion);
+    }
+
+    // Stop control.
+    pbio_motion_group_stop_group_control(group);
+
+    // Stop the servos and pass on requested stop type.
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+        pbio_error_t err = pbio_servo_stop(group->servos[i], on_completion);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+    }
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Checks if a motion group has completed its maneuver.
+ *
+ * @param [in]  group       The motion group instance.
+ * @return                  True if all axes are done, false if not.
+ */
+bool pbio_motion_group_is_done(const pbio_motion_group_t *group) {
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+        if (!pbio_control_is_done(&group->control[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks if any axis of a motion group is stalled.
+ *
+ * @param [in]  group           The motion group instance.
+ * @param [out] stalled         True if any axis is stalled, false if not.
+ * @param [out] stall_duration  For how long the longest stalled axis has been stalled (ms).
+ * @return                      Error code.
+ */
+pbio_error_t pbio_motion_group_is_stalled(pbio_motion_group_t *group, bool *stalled, uint32_t *stall_duration) {
+
+    *stalled = false;
+    *stall_duration = 0;
+
+    // Don't allow access if update loop not registered.
+    if (!pbio_motion_group_update_loop_is_running(group)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    bool control_active = pbio_motion_group_control_is_active(group);
+
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+        bool axis_stalled;
+        uint32_t axis_stall_duration;
+
+        // If group control is active, look at controller state. Otherwise
+        // look at the individual servos.
+        if (control_active) {
+            axis_stalled = pbio_control_is_stalled(&group->control[i], &axis_stall_duration);
+            axis_stall_duration = pbio_control_time_ticks_to_ms(axis_stall_duration);
+        } else {
+            pbio_error_t err = pbio_servo_is_stalled(group->servos[i], &axis_stalled, &axis_stall_duration);
+            if (err != PBIO_SUCCESS) {
+                return err;
+            }
+        }
+
+        // We are stalled if at least one axis is stalled.
+        *stalled |= axis_stalled;
+        *stall_duration = pbio_int_math_max(*stall_duration, axis_stall_duration);
+    }
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Updates one motion group in the control loop.
+ *
+ * @param [in]  group       The motion group instance.
+ * @return                  Error code.
+ */
+static pbio_error_t pbio_motion_group_update(pbio_motion_group_t *group) {
+
+    // If passive, no need to update.
+    if (!pbio_motion_group_control_is_active(group)) {
+        return PBIO_SUCCESS;
+    }
+
+    // All axes are evaluated at the same time.
+    uint32_t time_now = pbio_control_get_time_ticks();
+
+    pbio_trajectory_reference_t ref[PBIO_MOTION_GROUP_NUM_AXES_MAX];
+    int32_t torque[PBIO_MOTION_GROUP_NUM_AXES_MAX];
+    pbio_dcmotor_actuation_t actuation = PBIO_DCMOTOR_ACTUATION_TORQUE;
+    bool paused = false;
+
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+
+        pbio_control_state_t state;
+        pbio_error_t err = pbio_servo_get_state_control(group->servos[i], &state);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+
+        // Every axis pauses if any of them was paused on the previous update.
+        pbio_dcmotor_actuation_t axis_actuation;
+        bool external_pause = group->control_paused;
+        pbio_control_update(&group->control[i], time_now, &state, &ref[i], &axis_actuation, &torque[i], &external_pause);
+        paused |= external_pause;
+
+        // Any passive actuation applies to all axes, with coast taking priority.
+        if (axis_actuation == PBIO_DCMOTOR_ACTUATION_COAST ||
+            (axis_actuation == PBIO_DCMOTOR_ACTUATION_BRAKE && actuation != PBIO_DCMOTOR_ACTUATION_COAST)) {
+            actuation = axis_actuation;
+        }
+    }
+
+    group->control_paused = paused;
+
+    // If any controller coasts or brakes, do the same for all, thereby also
+    // stopping control.
+    if (actuation == PBIO_DCMOTOR_ACTUATION_COAST) {
+        return pbio_motion_group_stop(group, PBIO_CONTROL_ON_COMPLETION_COAST);
+    }
+    if (actuation == PBIO_DCMOTOR_ACTUATION_BRAKE) {
+        return pbio_motion_group_stop(group, PBIO_CONTROL_ON_COMPLETION_BRAKE);
+    }
+
+    // Otherwise apply feedback and feedforward torque to each axis.
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+        pbio_servo_t *srv = group->servos[i];
+        int32_t feed_forward = pbio_observer_get_feedforward_torque(srv->observer.model, ref[i].speed, ref[i].acceleration);
+        pbio_error_t err = pbio_servo_actuate(srv, PBIO_DCMOTOR_ACTUATION_TORQUE, torque[i] + feed_forward);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+    }
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Updates all currently active (previously set up) motion groups.
+ */
+void pbio_motion_group_update_all(void) {
+    for (uint8_t i = 0; i < PBIO_CONFIG_NUM_MOTION_GROUPS; i++) {
+        pbio_motion_group_t *group = &motion_groups[i];
+        if (pbio_motion_group_update_loop_is_running(group)) {
+            pbio_motion_group_update(group);
+        }
+    }
+}
+
+/**
+ * Starts all axes towards a target such that they finish at the same time.
+ *
+ * Each axis first gets its own trajectory. The axis that takes the longest
+ * leads, and all other trajectories are stretched to end at the same time.
+ *
+ * @param [in]  group           The motion group instance.
+ * @param [in]  targets         Target (or distance) for each axis, in units of its servo.
+ * @param [in]  speed           Top speed of each axis. The slowest axis sets the pace. If zero, default speeds are used.
+ * @param [in]  relative        Whether the targets are relative to the current position.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+static pbio_error_t pbio_motion_group_move(pbio_motion_group_t *group, const int32_t *targets, int32_t speed, bool relative, pbio_control_on_completion_t on_completion) {
+
+    // Don't allow new user command if update loop not registered.
+    if (!pbio_motion_group_update_loop_is_running(group)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    // All axes start from their measured state at the same time, so that
+    // their trajectories share the same time base for stretching below.
+    pbio_motion_group_stop_group_control(group);
+
+    uint32_t time_now = pbio_control_get_time_ticks();
+
+    uint8_t leader = 0;
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+
+        // Stop servo control in case it was running.
+        pbio_control_stop(&group->servos[i]->control);
+
+        pbio_control_state_t state;
+        pbio_error_t err = pbio_servo_get_state_control(group->servos[i], &state);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+
+        err = relative ?
+            pbio_control_start_position_control_relative(&group->control[i], time_now, &state, targets[i], speed, on_completion, false) :
+            pbio_control_start_position_control(&group->control[i], time_now, &state, targets[i], speed, on_completion);
+        if (err != PBIO_SUCCESS) {
+            pbio_motion_group_stop_group_control(group);
+            return err;
+        }
+
+        // The axis that takes longest leads the others.
+        if (pbio_trajectory_get_duration(&group->control[i].trajectory) >
+            pbio_trajectory_get_duration(&group->control[leader].trajectory)) {
+            leader = i;
+        }
+    }
+
+    // Revise follower trajectories so they take as long as the leader, achieved
+    // by picking a lower speed and accelerations that makes the times match.
+    for (uint8_t i = 0; i < group->num_axes; i++) {
+        if (i != leader) {
+            pbio_trajectory_stretch(&group->control[i].trajectory, &group->control[leader].trajectory);
+        }
+    }
+
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Starts all axes towards absolute targets, finishing at the same time.
+ *
+ * @param [in]  group           The motion group instance.
+ * @param [in]  positions       Target position for each axis, in units of its servo.
+ * @param [in]  speed           Top speed of each axis. The slowest axis sets the pace. If zero, default speeds are used.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_motion_group_move_to(pbio_motion_group_t *group, const int32_t *positions, int32_t speed, pbio_control_on_completion_t on_completion) {
+    return pbio_motion_group_move(group, positions, speed, false, on_completion);
+}
+
+/**
+ * Starts all axes to move by given distances, finishing at the same time.
+ *
+ * @param [in]  group           The motion group instance.
+ * @param [in]  distances       Distance for each axis, in units of its servo.
+ * @param [in]  speed           Top speed of each axis. The slowest axis sets the pace. If zero, default speeds are used.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_motion_group_move_by(pbio_motion_group_t *group, const int32_t *distances, int32_t speed, pbio_control_on_completion_t on_completion) {
+    return pbio_motion_group_move(group, distances, speed, true, on_completion);
+}
+
+#endif // PBIO_CONFIG_NUM_MOTION_GROUPS > 0
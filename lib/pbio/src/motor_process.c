@@ -4,6 +4,8 @@
 #include <pbio/battery.h>
 #include <pbio/control.h>
 #include <pbio/drivebase.h>
+#include <pbio/motion_group.h>
+#include <pbio/reflex.h>
 #include <pbio/servo.h>
 
 #include <contiki.h>
@@ -31,9 +33,20 @@ PROCESS_THREAD(pbio_motor_process, ev, data) {
         // Update battery voltage.
         pbio_battery_update();
 
+        #if PBIO_CONFIG_NUM_REFLEXES > 0
+        // Update reflexes first, so new sensor samples reach the motors in
+        // this control loop.
+        pbio_reflex_update_all();
+        #endif
+
         // Update drivebase
         pbio_drivebase_update_all();
 
+        #if PBIO_CONFIG_NUM_MOTION_GROUPS > 0
+        // Update motion groups
+        pbio_motion_group_update_all();
+        #endif
+
         // Update servos
         pbio_servo_update_all();
 
@@ -278,3 +278,242 @@ int32_t pbio_observer_torque_to_voltage(const pbio_observer_model_t *model, int3
 int32_t pbio_observer_voltage_to_torque(const pbio_observer_model_t *model, int32_t voltage) {
     return PRESCALE_VOLTAGE * pbio_int_math_clamp(voltage, MAX_NUM_VOLTAGE) / model->d_torque_d_voltage;
 }
+
+#if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
+// Number of samples across which the measured speed is averaged. Averaging
+// over a few samples reduces the effect of encoder quantization.
+#define IDENTIFICATION_BLOCK_SIZE (10)
+
+// Number of samples for which the excitation holds before it may switch sign.
+#define IDENTIFICATION_HOLD_SIZE (10)
+
+// Bounds on the identified ratio of actual inertia to nominal inertia.
+#define IDENTIFICATION_INERTIA_RATIO_MIN (0.5f)
+#define IDENTIFICATION_INERTIA_RATIO_MAX (50.0f)
+
+/**
+ * Starts identifying the load on a motor.
+ *
+ * The caller is responsible for applying the excitation voltage and calling
+ * the update function on every control loop iteration.
+ *
+ * @param [in]  ident          The identification instance.
+ * @param [in]  obs            The observer instance with the nominal model.
+ * @param [in]  angle          Current measured angle.
+ * @param [in]  voltage        Amplitude of the excitation voltage in mV.
+ * @param [in]  duration       Duration of the identification run in ms.
+ */
+void pbio_observer_identification_start(pbio_observer_identification_t *ident, const pbio_observer_t *obs, const pbio_angle_t *angle, int32_t voltage, uint32_t duration) {
+
+    // Initial guess is the nominal model, with unit inertia ratio.
+    ident->theta[0] = 1.0f;
+    ident->theta[1] = obs->model->torque_friction / 1000.0f;
+
+    // Initial covariance is large since the initial guess can be far off.
+    ident->covariance[0][0] = 10.0f;
+    ident->covariance[0][1] = 0.0f;
+    ident->covariance[1][0] = 0.0f;
+    ident->covariance[1][1] = 1000.0f;
+
+    // Reset regressor and speed history.
+    for (uint8_t i = 0; i < 2; i++) {
+        ident->regressor_sum[i] = 0.0f;
+        ident->regressor_block[i] = 0.0f;
+        ident->regressor_block_prev[i] = 0.0f;
+    }
+    ident->block_speed_prev = 0;
+    ident->block_start = *angle;
+
+    ident->samples = 0;
+    ident->samples_total = duration / PBIO_CONFIG_CONTROL_LOOP_TIME_MS;
+    ident->voltage = pbio_int_math_clamp(voltage, MAX_NUM_VOLTAGE);
+    ident->prbs = 1;
+    ident->active = true;
+}
+
+/**
+ * Gets the excitation voltage to apply during identification.
+ *
+ * @param [in]  ident          The identification instance.
+ * @return                     Excitation voltage in mV.
+ */
+int32_t pbio_observer_identification_get_excitation(const pbio_observer_identification_t *ident) {
+    return (ident->prbs & 1) ? ident->voltage : -ident->voltage;
+}
+
+/**
+ * Gets the regressors of the load estimate for one sample. These are the
+ * effects of all terms that scale inversely with inertia, and the effects of
+ * one mNm of friction in the direction of motion.
+ *
+ * @param [in]  obs            The observer instance with the nominal model.
+ * @param [in]  voltage        Applied voltage in mV.
+ * @param [out] phi            Effects on the speed change in mdeg/s.
+ * @param [out] psi            Effects on the angle change, divided by the sample time, in mdeg/s.
+ */
+static void pbio_observer_identification_get_regressors(const pbio_observer_t *obs, int32_t voltage, float *phi, float *psi) {
+    const pbio_observer_model_t *m = obs->model;
+    const float dt = PBIO_CONFIG_CONTROL_LOOP_TIME_MS / 1000.0f;
+
+    // All speed terms except friction are accelerations.
+    phi[0] = (float)PRESCALE_SPEED * obs->speed / m->d_speed_d_speed - obs->speed +
+        (float)PRESCALE_CURRENT * obs->current / m->d_speed_d_current +
+        (float)PRESCALE_VOLTAGE * voltage / m->d_speed_d_voltage;
+    phi[1] = (float)PRESCALE_TORQUE * 1000 * pbio_int_math_sign(obs->speed) / m->d_speed_d_torque;
+
+    // Same for angle terms except pure integration of speed.
+    psi[0] = ((float)PRESCALE_SPEED * obs->speed / m->d_angle_d_speed - dt * obs->speed +
+        (float)PRESCALE_CURRENT * obs->current / m->d_angle_d_current +
+        (float)PRESCALE_VOLTAGE * voltage / m->d_angle_d_voltage) / dt;
+    psi[1] = (float)PRESCALE_TORQUE * 1000 * pbio_int_math_sign(obs->speed) / m->d_angle_d_torque / dt;
+}
+
+/**
+ * Updates the load estimate with a new measurement.
+ *
+ * The speed is measured as the average speed across blocks of samples. The
+ * change in speed between two blocks is a weighted sum of the per-sample
+ * changes, so the regressors are summed the same way.
+ *
+ * @param [in]  ident          The identification instance.
+ * @param [in]  obs            The observer instance with the nominal model.
+ * @param [in]  angle          Measured angle.
+ * @param [in]  voltage        Voltage applied in mV from now until the next sample.
+ */
+void pbio_observer_identification_update(pbio_observer_identification_t *ident, const pbio_observer_t *obs, const pbio_angle_t *angle, int32_t voltage) {
+
+    if (!ident->active) {
+        return;
+    }
+
+    // At the end of each block, get average speed and update the estimate.
+    if (ident->samples > 0 && ident->samples % IDENTIFICATION_BLOCK_SIZE == 0) {
+
+        int32_t block_speed = pbio_angle_diff_mdeg(angle, &ident->block_start) * (1000 / PBIO_CONFIG_CONTROL_LOOP_TIME_MS) / IDENTIFICATION_BLOCK_SIZE;
+
+        // Regressor matching the speed change since previous block.
+        float x[2];
+        for (uint8_t i = 0; i < 2; i++) {
+            float regressor_block = ident->regressor_block[i] / IDENTIFICATION_BLOCK_SIZE;
+            x[i] = regressor_block - ident->regressor_block_prev[i];
+            ident->regressor_block_prev[i] = regressor_block;
+            ident->regressor_block[i] = 0.0f;
+        }
+
+        // Skip the first block since there is no previous speed to compare to.
+        if (ident->samples > IDENTIFICATION_BLOCK_SIZE) {
+
+            // Recursive least squares update of theta and covariance P.
+            float (*P)[2] = ident->covariance;
+            float Px[2] = {
+                P[0][0] * x[0] + P[0][1] * x[1],
+                P[1][0] * x[0] + P[1][1] * x[1],
+            };
+            float denominator = 1.0f + x[0] * Px[0] + x[1] * Px[1];
+            float error = (block_speed - ident->block_speed_prev) - (x[0] * ident->theta[0] + x[1] * ident->theta[1]);
+
+            for (uint8_t i = 0; i < 2; i++) {
+                ident->theta[i] += Px[i] / denominator * error;
+                for (uint8_t j = 0; j < 2; j++) {
+                    P[i][j] -= Px[i] * Px[j] / denominator;
+                }
+            }
+        }
+
+        ident->block_speed_prev = block_speed;
+        ident->block_start = *angle;
+    }
+
+    // The speed at each sample depends on the speed regressors of all
+    // previous samples. The angle change from this sample to the next also
+    // depends on the angle regressor of this sample.
+    float phi[2];
+    float psi[2];
+    pbio_observer_identification_get_regressors(obs, voltage, phi, psi);
+    for (uint8_t i = 0; i < 2; i++) {
+        ident->regressor_block[i] += ident->regressor_sum[i] + psi[i];
+        ident->regressor_sum[i] += phi[i];
+    }
+
+    ident->samples++;
+
+    // Advance pseudo random binary sequence generator (x^7 + x^6 + 1).
+    if (ident->samples % IDENTIFICATION_HOLD_SIZE == 0) {
+        uint8_t bit = ((ident->prbs >> 6) ^ (ident->prbs >> 5)) & 1;
+        ident->prbs = ((ident->prbs << 1) | bit) & 0x7f;
+    }
+
+    // Stop when done.
+    if (ident->samples >= ident->samples_total) {
+        ident->active = false;
+    }
+}
+
+/**
+ * Gets the identified model, derived from the nominal model and the estimate.
+ *
+ * Electrical parameters are unchanged. All terms that represent acceleration
+ * are scaled by the inertia ratio, and the friction is replaced.
+ *
+ * @param [in]  ident          The identification instance.
+ * @param [in]  nominal        The nominal model used during identification.
+ * @param [out] model          The identified model.
+ * @param [out] inertia_ratio  Identified ratio of actual inertia to nominal inertia, in percent.
+ * @param [out] friction       Identified friction torque in uNm.
+ * @return                     ::PBIO_SUCCESS on success, ::PBIO_ERROR_AGAIN if
+ *                             still running, ::PBIO_ERROR_FAILED if the
+ *                             run was cancelled or the estimate is not
+ *                             physically meaningful.
+ */
+pbio_error_t pbio_observer_identification_get_model(const pbio_observer_identification_t *ident, const pbio_observer_model_t *nominal, pbio_observer_model_t *model, int32_t *inertia_ratio, int32_t *friction) {
+
+    if (ident->active) {
+        return PBIO_ERROR_AGAIN;
+    }
+
+    // Require a completed run and a sensible inertia estimate.
+    if (ident->samples < ident->samples_total ||
+        ident->samples < IDENTIFICATION_BLOCK_SIZE * 4 ||
+        ident->theta[0] < 1.0f / IDENTIFICATION_INERTIA_RATIO_MAX ||
+        ident->theta[0] > 1.0f / IDENTIFICATION_INERTIA_RATIO_MIN) {
+        return PBIO_ERROR_FAILED;
+    }
+
+    float ratio = 1.0f / ident->theta[0];
+    // Friction is nonnegative. A negative estimate means it is negligible.
+    float torque_friction = ident->theta[1] * ratio * 1000;
+    if (torque_friction < 0.0f) {
+        torque_friction = 0.0f;
+    } else if (torque_friction > MAX_NUM_TORQUE) {
+        return PBIO_ERROR_FAILED;
+    }
+
+    *model = *nominal;
+
+    // Angle and speed respond to speed through their deviation from pure
+    // integration, which is caused by torques.
+    const float dt = PBIO_CONFIG_CONTROL_LOOP_TIME_MS / 1000.0f;
+    float a_angle_speed = (float)PRESCALE_SPEED / nominal->d_angle_d_speed;
+    float a_speed_speed = (float)PRESCALE_SPEED / nominal->d_speed_d_speed;
+    model->d_angle_d_speed = PRESCALE_SPEED / (dt + (a_angle_speed - dt) / ratio);
+    model->d_speed_d_speed = PRESCALE_SPEED / (1.0f + (a_speed_speed - 1.0f) / ratio);
+
+    // Direct effects of current, voltage, and torque are all accelerations.
+    model->d_angle_d_current = nominal->d_angle_d_current * ratio;
+    model->d_speed_d_current = nominal->d_speed_d_current * ratio;
+    model->d_angle_d_voltage = nominal->d_angle_d_voltage * ratio;
+    model->d_speed_d_voltage = nominal->d_speed_d_voltage * ratio;
+    model->d_angle_d_torque = nominal->d_angle_d_torque * ratio;
+    model->d_speed_d_torque = nominal->d_speed_d_torque * ratio;
+
+    // More inertia needs more torque to accelerate.
+    model->d_torque_d_acceleration = nominal->d_torque_d_acceleration / ratio;
+    model->torque_friction = torque_friction;
+
+    *inertia_ratio = ratio * 100;
+    *friction = torque_friction;
+    return PBIO_SUCCESS;
+}
+
+#endif // PBIO_CONFIG_OBSERVER_IDENTIFICATION
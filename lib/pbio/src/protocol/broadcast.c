@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+// Splitting broadcast messages that do not fit in one advertisement into
+// fragments, and reassembling them on the observing side.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <pbio/protocol.h>
+
+_Static_assert(PBIO_BROADCAST_FRAGMENT_MAX_NUM <= sizeof(((pbio_broadcast_reassembly_t *)0)->received) * 8,
+    "not enough bits to keep track of received fragments");
+
+/**
+ * Gets the number of fragments needed to broadcast a message.
+ *
+ * @param [in]  size        Size of the message in bytes.
+ * @return                  The number of fragments.
+ */
+uint8_t pbio_broadcast_get_num_fragments(uint32_t size) {
+    return (size + PBIO_BROADCAST_FRAGMENT_DATA_SIZE - 1) / PBIO_BROADCAST_FRAGMENT_DATA_SIZE;
+}
+
+/**
+ * Writes one fragment of a message, including its header, to @p buf.
+ *
+ * @param [in]  buf         Buffer of at least ::PBIO_BROADCAST_DATA_MAX_SIZE bytes.
+ * @param [in]  message     The message.
+ * @param [in]  size        Size of @p message in bytes.
+ * @param [in]  sequence    Sequence number of the message.
+ * @param [in]  index       Index of the fragment.
+ * @return                  The number of bytes written to @p buf.
+ */
+uint8_t pbio_broadcast_get_fragment(uint8_t *buf, const uint8_t *message, uint32_t size, uint8_t sequence, uint8_t index) {
+    uint32_t offset = index * PBIO_BROADCAST_FRAGMENT_DATA_SIZE;
+    uint32_t fragment_size = size - offset;
+    if (fragment_size > PBIO_BROADCAST_FRAGMENT_DATA_SIZE) {
+        fragment_size = PBIO_BROADCAST_FRAGMENT_DATA_SIZE;
+    }
+
+    buf[0] = PBIO_BROADCAST_FRAGMENT_TYPE << 5 | index;
+    buf[1] = sequence;
+    buf[2] = pbio_broadcast_get_num_fragments(size);
+    memcpy(&buf[PBIO_BROADCAST_FRAGMENT_HEADER_SIZE], &message[offset], fragment_size);
+    return PBIO_BROADCAST_FRAGMENT_HEADER_SIZE + fragment_size;
+}
+
+/**
+ * Discards any partially reassembled message.
+ *
+ * @param [in]  reassembly  The reassembly state.
+ */
+void pbio_broadcast_reassembly_reset(pbio_broadcast_reassembly_t *reassembly) {
+    reassembly->num_fragments = 0;
+    reassembly->received = 0;
+}
+
+/**
+ * Adds a received fragment to the message being reassembled.
+ *
+ * Fragments may be received in any order, and more than once, because the
+ * broadcaster keeps cycling through them. A fragment of a message with
+ * another sequence number starts a new message.
+ *
+ * @param [in]  reassembly  The reassembly state.
+ * @param [in]  fragment    The fragment, starting with its header.
+ * @param [in]  size        Size of @p fragment in bytes.
+ * @return                  True if this fragment completed the message, which
+ *                          is then in @p reassembly, otherwise false.
+ */
+bool pbio_broadcast_reassemble(pbio_broadcast_reassembly_t *reassembly, const uint8_t *fragment, uint8_t size) {
+    if (size < PBIO_BROADCAST_FRAGMENT_HEADER_SIZE || fragment[0] >> 5 != PBIO_BROADCAST_FRAGMENT_TYPE) {
+        return false;
+    }
+
+    uint8_t index = fragment[0] & 0x1F;
+    uint8_t sequence = fragment[1];
+    uint8_t num_fragments = fragment[2];
+    uint8_t data_size = size - PBIO_BROADCAST_FRAGMENT_HEADER_SIZE;
+
+    // Ignore invalid fragments. All but the last fragment are full.
+    if (num_fragments < 2 || num_fragments > PBIO_BROADCAST_FRAGMENT_MAX_NUM || index >= num_fragments ||
+        data_size > PBIO_BROADCAST_FRAGMENT_DATA_SIZE ||
+        (index < num_fragments - 1 && data_size != PBIO_BROADCAST_FRAGMENT_DATA_SIZE)) {
+        return false;
+    }
+
+    // Start over if this is a new message.
+    if (sequence != reassembly->sequence || num_fragments != reassembly->num_fragments) {
+        reassembly->sequence = sequence;
+        reassembly->num_fragments = num_fragments;
+        reassembly->received = 0;
+    }
+
+    // Repeated fragments add nothing, so the message is completed only once.
+    uint8_t all = (1 << num_fragments) - 1;
+    if (reassembly->received == all || reassembly->received & (1 << index)) {
+        return false;
+    }
+
+    memcpy(&reassembly->data[index * PBIO_BROADCAST_FRAGMENT_DATA_SIZE], &fragment[PBIO_BROADCAST_FRAGMENT_HEADER_SIZE], data_size);
+    reassembly->received |= 1 << index;
+    if (index == num_fragments - 1) {
+        reassembly->size = index * PBIO_BROADCAST_FRAGMENT_DATA_SIZE + data_size;
+    }
+
+    return reassembly->received == all;
+}
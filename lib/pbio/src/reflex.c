@@ -0,0 +1,526 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <pbio/config.h>
+
+#if PBIO_CONFIG_NUM_REFLEXES > 0
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <pbdrv/config.h>
+#include <pbdrv/legodev.h>
+
+#include <pbio/battery.h>
+#include <pbio/control.h>
+#include <pbio/error.h>
+#include <pbio/imu.h>
+#include <pbio/int_math.h>
+#include <pbio/reflex.h>
+#include <pbio/util.h>
+
+/**
+ * Longest time step used for the integral, in ms. This avoids a jump in the
+ * output when samples stop arriving for a while.
+ */
+#define PBIO_REFLEX_INTEGRAL_STEP_MAX (100)
+
+/**
+ * Maximum absolute value of the integrated error.
+ */
+#define PBIO_REFLEX_INTEGRAL_MAX (1000000000)
+
+/**
+ * The reflex stops if the input gives no new sample for this long, in ms.
+ * This happens if the sensor is lost or switched to another mode.
+ */
+#define PBIO_REFLEX_INPUT_TIMEOUT (500)
+
+/**
+ * Maximum absolute duty cycle of a servo output, in percent.
+ */
+#define PBIO_REFLEX_SERVO_LIMIT_MAX (100)
+
+// Reflex objects
+static pbio_reflex_t reflexes[PBIO_CONFIG_NUM_REFLEXES];
+
+/**
+ * Checks if the reflex is still in control of its output.
+ *
+ * A servo output is released when the servo gets a new command, which clears
+ * the reflex as its parent. A drive base output is released when the drive
+ * base is stopped or given a command that is not timed.
+ *
+ * @param [in]  reflex      The reflex instance.
+ * @return                  True if the output is still used by this reflex.
+ */
+static bool pbio_reflex_output_is_owned(const pbio_reflex_t *reflex) {
+    if (reflex->servo) {
+        return pbio_parent_equals(&reflex->servo->parent, reflex) &&
+               pbio_servo_update_loop_is_running(reflex->servo);
+    }
+    return pbio_drivebase_update_loop_is_running(reflex->drivebase) &&
+           pbio_control_is_active(&reflex->drivebase->control_distance) &&
+           pbio_control_type_is_time(&reflex->drivebase->control_distance);
+}
+
+/**
+ * Reflex stop function that can be called from a servo.
+ *
+ * When a new command is issued to the servo, the reflex stops and releases
+ * the servo so that it can be used by something else.
+ *
+ * @param [in]  reflex_void   Void pointer to this reflex instance.
+ * @param [in]  clear_parent  Unused. The reflex always releases the servo.
+ * @return                    Error code.
+ */
+static pbio_error_t pbio_reflex_stop_from_servo(void *reflex_void, bool clear_parent) {
+
+    (void)clear_parent;
+
+    pbio_reflex_t *reflex = reflex_void;
+    reflex->active = false;
+
+    // Release the servo. The caller takes it from here, so we only coast.
+    pbio_parent_set(&reflex->servo->parent, NULL, NULL);
+    return pbio_dcmotor_coast(reflex->servo->dcmotor);
+}
+
+/**
+ * Reads the input of the reflex.
+ *
+ * @param [in]  reflex      The reflex instance.
+ * @param [out] value       The input value.
+ * @param [out] fresh       Whether this is a new sample since the last call.
+ * @return                  Error code.
+ */
+static pbio_error_t pbio_reflex_get_input(pbio_reflex_t *reflex, int32_t *value, bool *fresh) {
+
+    *fresh = true;
+
+    switch (reflex->input.type) {
+        case PBIO_REFLEX_INPUT_IMU: {
+            #if PBIO_CONFIG_IMU
+            pbio_geometry_xyz_t angular_velocity;
+            pbio_imu_get_angular_velocity(&angular_velocity);
+            float projection;
+            pbio_error_t err = pbio_geometry_vector_project(&reflex->input.axis, &angular_velocity, &projection);
+            *value = (int32_t)projection;
+            return err;
+            #else
+            return PBIO_ERROR_NOT_SUPPORTED;
+            #endif
+        }
+        case PBIO_REFLEX_INPUT_SERVO: {
+            int32_t speed;
+            return pbio_servo_get_state_user(reflex->input.servo, value, &speed);
+        }
+        case PBIO_REFLEX_INPUT_SENSOR: {
+            #if PBDRV_CONFIG_LEGODEV_MODE_INFO
+            pbdrv_legodev_dev_t *legodev = reflex->input.sensor.legodev;
+            uint8_t mode = reflex->input.sensor.mode;
+
+            // The info is valid even if the sensor is busy.
+            pbdrv_legodev_info_t *info;
+            pbio_error_t err = pbdrv_legodev_get_info(legodev, &info);
+            if (err != PBIO_SUCCESS && err != PBIO_ERROR_AGAIN) {
+                return err;
+            }
+
+            // Wait for the sensor to switch to our mode.
+            if (info->mode != mode) {
+                *fresh = false;
+                return PBIO_SUCCESS;
+            }
+
+            // Wait while the sensor is busy, such as during a mode switch,
+            // or if it was set to a mode combination.
+            uint8_t *data;
+            err = pbdrv_legodev_get_data(legodev, mode, (void **)&data);
+            if (err == PBIO_ERROR_AGAIN || err == PBIO_ERROR_INVALID_OP) {
+                *fresh = false;
+                return PBIO_SUCCESS;
+            }
+            if (err != PBIO_SUCCESS) {
+                return err;
+            }
+
+            // Only evaluate new samples, if the device can tell us.
+            pbdrv_legodev_sample_info_t *sample_info;
+            err = pbdrv_legodev_get_sample_info(legodev, &sample_info);
+            if (err == PBIO_SUCCESS) {
+                *fresh = sample_info->count != reflex->sample_count;
+                reflex->sample_count = sample_info->count;
+            } else if (err != PBIO_ERROR_NOT_SUPPORTED) {
+                return err;
+            }
+
+            uint8_t index = reflex->input.sensor.index;
+            switch (info->mode_info[mode].data_type) {
+                case PBDRV_LEGODEV_DATA_TYPE_INT8:
+                    *value = (int8_t)data[index];
+                    break;
+                case PBDRV_LEGODEV_DATA_TYPE_INT16:
+                    *value = (int16_t)pbio_get_uint16_le(&data[index * 2]);
+                    break;
+                case PBDRV_LEGODEV_DATA_TYPE_INT32:
+                    *value = (int32_t)pbio_get_uint32_le(&data[index * 4]);
+                    break;
+                case PBDRV_LEGODEV_DATA_TYPE_FLOAT: {
+                    float f;
+                    memcpy(&f, &data[index * 4], sizeof(f));
+                    *value = (int32_t)f;
+                    break;
+                }
+                default:
+                    return PBIO_ERROR_IO;
+            }
+            return PBIO_SUCCESS;
+            #else
+            return PBIO_ERROR_NOT_SUPPORTED;
+            #endif
+        }
+        default:
+            return PBIO_ERROR_INVALID_ARG;
+    }
+}
+
+/**
+ * Computes the PID output for a new input value.
+ *
+ * @param [in]  reflex      The reflex instance.
+ * @param [in]  value       The new input value.
+ * @param [in]  time_now    Time of the new value in ms.
+ * @return                  The output, bounded by the limit.
+ */
+static int32_t pbio_reflex_get_output(pbio_reflex_t *reflex, int32_t value, uint32_t time_now) {
+
+    const pbio_reflex_settings_t *settings = &reflex->settings;
+    int32_t error = settings->target - value;
+
+    // The first sample has no history, so only the proportional part applies.
+    int64_t derivative = 0;
+    int64_t integral = reflex->error_integral;
+    int32_t time_step = reflex->has_prev ? time_now - reflex->time_prev : 0;
+    if (time_step > 0) {
+        derivative = ((int64_t)error - reflex->error_prev) * 1000 / time_step;
+        integral += (int64_t)error * pbio_int_math_min(time_step, PBIO_REFLEX_INTEGRAL_STEP_MAX);
+        if (integral > PBIO_REFLEX_INTEGRAL_MAX) {
+            integral = PBIO_REFLEX_INTEGRAL_MAX;
+        } else if (integral < -PBIO_REFLEX_INTEGRAL_MAX) {
+            integral = -PBIO_REFLEX_INTEGRAL_MAX;
+        }
+    }
+
+    int64_t output_p = (int64_t)settings->kp * error;
+    int64_t output_d = (int64_t)settings->kd * derivative;
+    int64_t output_i = (int64_t)settings->ki * integral / 1000;
+    int64_t output = (output_p + output_i + output_d) / PBIO_REFLEX_GAIN_SCALE;
+
+    // Only keep the new integral if the output isn't saturated further, so
+    // that it doesn't wind up.
+    int64_t limit = settings->limit;
+    if ((output < limit && output > -limit) || llabs(integral) < pbio_int_math_abs(reflex->error_integral)) {
+        reflex->error_integral = integral;
+    }
+
+    reflex->error_prev = error;
+    reflex->time_prev = time_now;
+    reflex->has_prev = true;
+
+    return output > limit ? limit : (output < -limit ? -limit : output);
+}
+
+/**
+ * Updates one reflex in the control loop.
+ *
+ * @param [in]  reflex      The reflex instance.
+ * @return                  Error code.
+ */
+static pbio_error_t pbio_reflex_update(pbio_reflex_t *reflex) {
+
+    // Stop if something else has taken over the output.
+    if (!pbio_reflex_output_is_owned(reflex)) {
+        reflex->active = false;
+        return PBIO_SUCCESS;
+    }
+
+    int32_t value;
+    bool fresh;
+    pbio_error_t err = pbio_reflex_get_input(reflex, &value, &fresh);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    // Nothing to do until there is a new sample, unless it takes too long.
+    uint32_t time_now = pbio_control_time_ticks_to_ms(pbio_control_get_time_ticks());
+    if (!fresh) {
+        return time_now - reflex->time_sample > PBIO_REFLEX_INPUT_TIMEOUT ? PBIO_ERROR_TIMEDOUT : PBIO_SUCCESS;
+    }
+    reflex->time_sample = time_now;
+    reflex->value = value;
+    reflex->output = pbio_reflex_get_output(reflex, value, time_now);
+
+    if (reflex->servo) {
+        return pbio_servo_actuate(reflex->servo, PBIO_DCMOTOR_ACTUATION_VOLTAGE,
+            pbio_battery_get_voltage_from_duty_pct(reflex->output));
+    }
+    return pbio_drivebase_drive_forever(reflex->drivebase, reflex->drive_speed, reflex->output);
+}
+
+/**
+ * Updates all active reflexes.
+ *
+ * This is called from the motor process before the servos and drive bases
+ * are updated, so a new sample reaches the motors in the same control loop.
+ */
+void pbio_reflex_update_all(void) {
+    for (uint8_t i = 0; i < PBIO_CONFIG_NUM_REFLEXES; i++) {
+        pbio_reflex_t *reflex = &reflexes[i];
+        if (reflex->active && pbio_reflex_update(reflex) != PBIO_SUCCESS) {
+            // Don't keep driving the output if the input is lost or stale.
+            pbio_reflex_stop(reflex);
+        }
+    }
+}
+
+/**
+ * Gets a free reflex instance and sets up its input and settings.
+ *
+ * @param [out] reflex_address  Reflex instance if available.
+ * @param [in]  input           Input of the reflex.
+ * @param [in]  settings        Settings of the controller.
+ * @return                      Error code.
+ */
+static pbio_error_t pbio_reflex_get_reflex(pbio_reflex_t **reflex_address, const pbio_reflex_input_t *input, const pbio_reflex_settings_t *settings) {
+
+    if (pbio_int_math_abs(settings->kp) > PBIO_REFLEX_GAIN_MAX ||
+        pbio_int_math_abs(settings->ki) > PBIO_REFLEX_GAIN_MAX ||
+        pbio_int_math_abs(settings->kd) > PBIO_REFLEX_GAIN_MAX ||
+        settings->limit < 0) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    switch (input->type) {
+        case PBIO_REFLEX_INPUT_IMU: {
+            #if PBIO_CONFIG_IMU
+            // The axis must have a direction.
+            pbio_geometry_xyz_t axis = input->axis;
+            pbio_geometry_xyz_t unit_axis;
+            pbio_error_t err = pbio_geometry_vector_normalize(&axis, &unit_axis);
+            if (err != PBIO_SUCCESS) {
+                return err;
+            }
+            break;
+            #else
+            return PBIO_ERROR_NOT_SUPPORTED;
+            #endif
+        }
+        case PBIO_REFLEX_INPUT_SERVO:
+            if (!pbio_servo_update_loop_is_running(input->servo)) {
+                return PBIO_ERROR_INVALID_OP;
+            }
+            break;
+        case PBIO_REFLEX_INPUT_SENSOR: {
+            #if PBDRV_CONFIG_LEGODEV_MODE_INFO
+            pbdrv_legodev_info_t *info;
+            pbio_error_t err = pbdrv_legodev_get_info(input->sensor.legodev, &info);
+            if (err != PBIO_SUCCESS) {
+                return err;
+            }
+            if (input->sensor.mode >= info->num_modes ||
+                input->sensor.index >= info->mode_info[input->sensor.mode].num_values) {
+                return PBIO_ERROR_INVALID_ARG;
+            }
+            // The mode switch completes in the background.
+            err = pbdrv_legodev_set_mode(input->sensor.legodev, input->sensor.mode);
+            if (err != PBIO_SUCCESS) {
+                return err;
+            }
+            break;
+            #else
+            return PBIO_ERROR_NOT_SUPPORTED;
+            #endif
+        }
+        default:
+            return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Use the first reflex that isn't running.
+    uint8_t index;
+    for (index = 0; index < PBIO_CONFIG_NUM_REFLEXES; index++) {
+        if (!reflexes[index].active) {
+            break;
+        }
+    }
+    if (index == PBIO_CONFIG_NUM_REFLEXES) {
+        return PBIO_ERROR_BUSY;
+    }
+
+    pbio_reflex_t *reflex = &reflexes[index];
+    uint32_t generation = reflex->generation + 1;
+    memset(reflex, 0, sizeof(pbio_reflex_t));
+    reflex->generation = generation;
+    reflex->input = *input;
+    reflex->settings = *settings;
+    reflex->time_sample = pbio_control_time_ticks_to_ms(pbio_control_get_time_ticks());
+
+    // Skip samples that arrived before starting.
+    if (input->type == PBIO_REFLEX_INPUT_SENSOR) {
+        pbdrv_legodev_sample_info_t *sample_info;
+        if (pbdrv_legodev_get_sample_info(input->sensor.legodev, &sample_info) == PBIO_SUCCESS) {
+            reflex->sample_count = sample_info->count;
+        }
+    }
+
+    *reflex_address = reflex;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Starts a reflex that drives a servo at a duty cycle.
+ *
+ * The reflex becomes the parent of the servo, so giving the servo any other
+ * command stops the reflex.
+ *
+ * @param [out] reflex_address  Reflex instance if available.
+ * @param [in]  input           Input of the reflex.
+ * @param [in]  settings        Settings of the controller. The output is the duty cycle in %.
+ * @param [in]  srv             The servo to drive.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_reflex_start_servo(pbio_reflex_t **reflex_address, const pbio_reflex_input_t *input, const pbio_reflex_settings_t *settings, pbio_servo_t *srv) {
+
+    // Don't allow new user command if update loop not registered.
+    if (!pbio_servo_update_loop_is_running(srv)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    // Can't use servos that are already used by a drive base, for example.
+    if (pbio_parent_exists(&srv->parent)) {
+        return PBIO_ERROR_BUSY;
+    }
+
+    pbio_reflex_t *reflex;
+    pbio_error_t err = pbio_reflex_get_reflex(&reflex, input, settings);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    // Stop ongoing control so the servo is passive until the first sample.
+    err = pbio_servo_stop(srv, PBIO_CONTROL_ON_COMPLETION_COAST);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    pbio_parent_set(&srv->parent, reflex, pbio_reflex_stop_from_servo);
+    reflex->settings.limit = pbio_int_math_min(settings->limit, PBIO_REFLEX_SERVO_LIMIT_MAX);
+    reflex->servo = srv;
+    reflex->active = true;
+    *reflex_address = reflex;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Starts a reflex that steers a drive base.
+ *
+ * The drive base drives forever at the given speed while the reflex sets the
+ * turn rate. Giving the drive base a maneuver with a target stops the reflex.
+ * Users that stop the drive base or make it drive must release it with
+ * ::pbio_reflex_release_drivebase first.
+ *
+ * @param [out] reflex_address  Reflex instance if available.
+ * @param [in]  input           Input of the reflex.
+ * @param [in]  settings        Settings of the controller. The output is the turn rate in deg/s.
+ * @param [in]  db              The drive base to steer.
+ * @param [in]  drive_speed     Drive speed in mm/s.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_reflex_start_drivebase(pbio_reflex_t **reflex_address, const pbio_reflex_input_t *input, const pbio_reflex_settings_t *settings, pbio_drivebase_t *db, int32_t drive_speed) {
+
+    // Each drive base can be steered by one reflex at a time.
+    for (uint8_t i = 0; i < PBIO_CONFIG_NUM_REFLEXES; i++) {
+        if (reflexes[i].active && reflexes[i].drivebase == db) {
+            return PBIO_ERROR_BUSY;
+        }
+    }
+
+    pbio_reflex_t *reflex;
+    pbio_error_t err = pbio_reflex_get_reflex(&reflex, input, settings);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    // Start driving straight until the first sample.
+    err = pbio_drivebase_drive_forever(db, drive_speed, 0);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    reflex->drivebase = db;
+    reflex->drive_speed = drive_speed;
+    reflex->active = true;
+    *reflex_address = reflex;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Stops a reflex and coasts its output.
+ *
+ * @param [in]  reflex      The reflex instance.
+ * @return                  Error code.
+ */
+pbio_error_t pbio_reflex_stop(pbio_reflex_t *reflex) {
+
+    // Nothing to do if already stopped.
+    if (!reflex->active || !pbio_reflex_output_is_owned(reflex)) {
+        reflex->active = false;
+        return PBIO_SUCCESS;
+    }
+    reflex->active = false;
+
+    if (reflex->servo) {
+        // Release the servo first, so stopping it won't call back here.
+        pbio_parent_set(&reflex->servo->parent, NULL, NULL);
+        return pbio_servo_stop(reflex->servo, PBIO_CONTROL_ON_COMPLETION_COAST);
+    }
+    return pbio_drivebase_stop(reflex->drivebase, PBIO_CONTROL_ON_COMPLETION_COAST);
+}
+
+/**
+ * Stops any reflex that steers the given drive base, without stopping the
+ * drive base. This is used before giving the drive base a new command.
+ *
+ * @param [in]  db          The drive base.
+ */
+void pbio_reflex_release_drivebase(pbio_drivebase_t *db) {
+    for (uint8_t i = 0; i < PBIO_CONFIG_NUM_REFLEXES; i++) {
+        if (reflexes[i].drivebase == db) {
+            reflexes[i].active = false;
+        }
+    }
+}
+
+/**
+ * Checks if a reflex is still driving its output.
+ *
+ * @param [in]  reflex      The reflex instance.
+ * @return                  True if active, false if stopped.
+ */
+bool pbio_reflex_is_active(const pbio_reflex_t *reflex) {
+    return reflex->active;
+}
+
+/**
+ * Gets the most recent input and output of a reflex.
+ *
+ * @param [in]  reflex      The reflex instance.
+ * @param [out] value       The most recent input value.
+ * @param [out] output      The most recent output value.
+ */
+void pbio_reflex_get_state(const pbio_reflex_t *reflex, int32_t *value, int32_t *output) {
+    *value = reflex->value;
+    *output = reflex->output;
+}
+
+#endif // PBIO_CONFIG_NUM_REFLEXES > 0
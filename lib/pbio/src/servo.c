@@ -73,6 +73,37 @@ bool pbio_servo_update_loop_is_running(pbio_servo_t *srv) {
     return srv->run_update_loop;
 }
 
+#if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
+/**
+ * Sets the model used by the servo observer and updates the observer
+ * settings that depend on it.
+ *
+ * @param [in]  srv         The servo instance.
+ * @param [in]  model       The model to use.
+ */
+static void pbio_servo_set_model(pbio_servo_t *srv, const pbio_observer_model_t *model) {
+    srv->observer.model = model;
+    srv->observer.settings.feedback_voltage_negligible = pbio_observer_torque_to_voltage(model, model->torque_friction) * 5 / 2;
+}
+
+/**
+ * Installs the identified model if identification was successful.
+ *
+ * @param [in]  srv         The servo instance.
+ */
+static void pbio_servo_identify_model_complete(pbio_servo_t *srv) {
+    int32_t inertia_ratio;
+    int32_t friction;
+    pbio_observer_model_t model;
+    if (pbio_observer_identification_get_model(&srv->identification, srv->model_default, &model, &inertia_ratio, &friction) == PBIO_SUCCESS) {
+        srv->model_custom = model;
+        pbio_servo_set_model(srv, &srv->model_custom);
+    }
+}
+
+#endif // PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
 static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
 
     // Get current time
@@ -117,6 +148,22 @@ static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
             return err;
         }
     }
+
+    #if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+    // Apply the excitation if the model is being identified. Starting any
+    // controlled maneuver cancels the identification.
+    if (srv->identification.active) {
+        if (pbio_control_is_active(&srv->control)) {
+            srv->identification.active = false;
+        } else {
+            err = pbio_dcmotor_set_voltage(srv->dcmotor, pbio_observer_identification_get_excitation(&srv->identification));
+            if (err != PBIO_SUCCESS) {
+                return err;
+            }
+        }
+    }
+    #endif // PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
     // Whether or not there is control, get the ongoing actuation state so we can log it and update observer.
     pbio_dcmotor_actuation_t applied_actuation;
     int32_t voltage;
@@ -156,6 +203,23 @@ static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
         pbio_logger_add_row(&srv->log, log_data);
     }
 
+    #if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+    // Update the load estimate using the applied voltage and the observer
+    // state before it is updated.
+    if (srv->identification.active) {
+        pbio_observer_identification_update(&srv->identification, &srv->observer, &state.position, voltage);
+
+        // Install the new model and stop when done.
+        if (!srv->identification.active) {
+            pbio_servo_identify_model_complete(srv);
+            err = pbio_dcmotor_coast(srv->dcmotor);
+            if (err != PBIO_SUCCESS) {
+                return err;
+            }
+        }
+    }
+    #endif // PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
     // Update the state observer
     pbio_observer_update(&srv->observer, time_now, &state.position, applied_actuation, voltage);
 
@@ -201,6 +265,11 @@ static pbio_error_t pbio_servo_stop_from_dcmotor(void *servo, bool clear_parent)
     // Specify pointer type.
     pbio_servo_t *srv = servo;
 
+    #if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+    // Direct use of the dc motor cancels model identification.
+    srv->identification.active = false;
+    #endif
+
     // This external stop is triggered by a lower level peripheral,
     // i.e. the dc motor. So it has already has been stopped or changed state
     // electrically. All we have to do here is stop the control loop,
@@ -257,6 +326,10 @@ static pbio_error_t pbio_servo_initialize_settings(pbio_servo_t *srv, pbdrv_lego
 
     // Save reference to motor model.
     srv->observer.model = settings_reduced->model;
+    #if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+    srv->model_default = settings_reduced->model;
+    srv->identification.active = false;
+    #endif
 
     // Initialize maximum torque as the stall torque for maximum voltage.
     // In practice, the nominal voltage is a bit lower than the 9V values.
@@ -552,6 +625,11 @@ pbio_error_t pbio_servo_stop(pbio_servo_t *srv, pbio_control_on_completion_t on_
         return err;
     }
 
+    #if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+    // Stop model identification, if any.
+    srv->identification.active = false;
+    #endif
+
     // Handle HOLD case. Also enforce hold if the stop type was CONTINUE since
     // this function needs to make it stop in all cases.
     if (on_completion == PBIO_CONTROL_ON_COMPLETION_HOLD ||
@@ -897,4 +975,96 @@ pbio_error_t pbio_servo_get_load(pbio_servo_t *srv, int32_t *load) {
     return PBIO_SUCCESS;
 }
 
+#if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
+/**
+ * Starts identifying the load on the servo. This applies a pseudo random
+ * sequence of positive and negative voltages and estimates the inertia and
+ * friction of the mechanism from the resulting motion. When done, the
+ * identified model is installed and the servo coasts.
+ *
+ * The mechanism must be able to rotate freely in both directions for the
+ * given duration.
+ *
+ * @param [in]  srv         The servo instance.
+ * @param [in]  voltage     Amplitude of the excitation voltage (mV).
+ * @param [in]  duration    Duration of the identification (ms).
+ * @return                  Error code.
+ */
+pbio_error_t pbio_servo_identify_model(pbio_servo_t *srv, int32_t voltage, uint32_t duration) {
+
+    // Validate arguments before stopping anything.
+    if (voltage <= 0 || voltage > srv->dcmotor->max_voltage || duration == 0) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Stop ongoing maneuvers and parent objects, if any.
+    pbio_error_t err = pbio_servo_stop(srv, PBIO_CONTROL_ON_COMPLETION_COAST);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    pbio_angle_t angle;
+    err = pbio_tacho_get_angle(srv->tacho, &angle);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    // Identify relative to the default model, so the observer keeps
+    // tracking the motor even if a previous identification went wrong.
+    pbio_servo_set_model(srv, srv->model_default);
+    pbio_observer_identification_start(&srv->identification, &srv->observer, &angle, voltage, duration);
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Checks whether model identification has completed or was cancelled.
+ *
+ * @param [in]  srv         The servo instance.
+ * @return                  True if not identifying, false if ongoing.
+ */
+bool pbio_servo_identify_model_is_done(pbio_servo_t *srv) {
+    return !srv->identification.active;
+}
+
+/**
+ * Gets the result of the most recent model identification.
+ *
+ * @param [in]  srv            The servo instance.
+ * @param [out] inertia_ratio  Ratio of actual inertia to nominal motor inertia, in percent.
+ * @param [out] friction       Friction torque (mNm).
+ * @return                     ::PBIO_SUCCESS on success, ::PBIO_ERROR_AGAIN if
+ *                             still running, ::PBIO_ERROR_FAILED if it was
+ *                             cancelled or not successful.
+ */
+pbio_error_t pbio_servo_identify_model_get_result(pbio_servo_t *srv, int32_t *inertia_ratio, int32_t *friction) {
+    pbio_observer_model_t model;
+    pbio_error_t err = pbio_observer_identification_get_model(&srv->identification, srv->model_default, &model, inertia_ratio, friction);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+    *friction = pbio_control_settings_actuation_ctl_to_app(*friction);
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Restores the default model for this type of motor.
+ *
+ * @param [in]  srv         The servo instance.
+ * @return                  Error code.
+ */
+pbio_error_t pbio_servo_reset_model(pbio_servo_t *srv) {
+
+    // Don't allow new user command if update loop not registered.
+    if (!pbio_servo_update_loop_is_running(srv)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    srv->identification.active = false;
+    pbio_servo_set_model(srv, srv->model_default);
+    return PBIO_SUCCESS;
+}
+
+#endif // PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
 #endif // PBIO_CONFIG_SERVO
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+// IMA ADPCM decoder. This must produce exactly the same samples as the
+// decoder in tools/adpcm.py, which is also used to encode the data.
+
+#include <pbio/config.h>
+
+#if PBIO_CONFIG_SOUND
+
+#include <stdint.h>
+#include <string.h>
+
+#include <pbio/error.h>
+#include <pbio/sound.h>
+#include <pbio/util.h>
+
+/** Step index change for each nibble value, without the sign bit. */
+static const int8_t pbio_sound_adpcm_index_table[] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+};
+
+/** Quantizer step size for each step index. */
+static const int16_t pbio_sound_adpcm_step_table[] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+/**
+ * Initializes a decoder for IMA ADPCM data, including its header.
+ *
+ * The data is not copied, so it must remain valid while decoding.
+ *
+ * @param [out] decoder     The decoder.
+ * @param [in]  data        The data, starting with the header.
+ * @param [in]  size        Size of @p data in bytes.
+ * @return                  ::PBIO_SUCCESS or ::PBIO_ERROR_INVALID_ARG if the
+ *                          data is not valid IMA ADPCM data or its sample
+ *                          rate is not supported.
+ */
+pbio_error_t pbio_sound_adpcm_init(pbio_sound_adpcm_t *decoder, const uint8_t *data, uint32_t size) {
+    if (size < PBIO_SOUND_ADPCM_HEADER_SIZE || memcmp(data, "IMAD", 4) != 0) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    uint32_t num_samples = pbio_get_uint32_le(&data[4]);
+    uint16_t sample_rate = pbio_get_uint16_le(&data[8]);
+    int16_t predictor = (int16_t)pbio_get_uint16_le(&data[10]);
+    uint8_t step_index = data[12];
+
+    if (num_samples > (size - PBIO_SOUND_ADPCM_HEADER_SIZE) * 2 ||
+        sample_rate == 0 || sample_rate > PBIO_SOUND_SAMPLE_RATE ||
+        step_index >= PBIO_ARRAY_SIZE(pbio_sound_adpcm_step_table)) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    decoder->data = &data[PBIO_SOUND_ADPCM_HEADER_SIZE];
+    decoder->num_samples = num_samples;
+    decoder->index = 0;
+    decoder->sample_rate = sample_rate;
+    decoder->predictor = predictor;
+    decoder->step_index = step_index;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Decodes the next samples.
+ *
+ * @param [in]  decoder     The decoder.
+ * @param [out] samples     Buffer for the decoded samples.
+ * @param [in]  count       Maximum number of samples to decode.
+ * @return                  Number of samples decoded, which is less than
+ *                          @p count at the end of the data.
+ */
+uint32_t pbio_sound_adpcm_decode(pbio_sound_adpcm_t *decoder, int16_t *samples, uint32_t count) {
+    uint32_t remaining = decoder->num_samples - decoder->index;
+    if (count > remaining) {
+        count = remaining;
+    }
+
+    // Work on local copies so the loop stays in registers.
+    int32_t predictor = decoder->predictor;
+    int32_t step_index = decoder->step_index;
+    uint32_t index = decoder->index;
+
+    for (uint32_t i = 0; i < count; i++, index++) {
+        uint8_t byte = decoder->data[index / 2];
+        uint8_t nibble = index % 2 ? byte >> 4 : byte & 0x0f;
+
+        int32_t step = pbio_sound_adpcm_step_table[step_index];
+        int32_t diff = step >> 3;
+        if (nibble & 4) {
+            diff += step;
+        }
+        if (nibble & 2) {
+            diff += step >> 1;
+        }
+        if (nibble & 1) {
+            diff += step >> 2;
+        }
+        predictor += nibble & 8 ? -diff : diff;
+        if (predictor > INT16_MAX) {
+            predictor = INT16_MAX;
+        } else if (predictor < INT16_MIN) {
+            predictor = INT16_MIN;
+        }
+
+        step_index += pbio_sound_adpcm_index_table[nibble & 7];
+        if (step_index < 0) {
+            step_index = 0;
+        } else if (step_index >= (int32_t)PBIO_ARRAY_SIZE(pbio_sound_adpcm_step_table)) {
+            step_index = PBIO_ARRAY_SIZE(pbio_sound_adpcm_step_table) - 1;
+        }
+
+        samples[i] = predictor;
+    }
+
+    decoder->predictor = predictor;
+    decoder->step_index = step_index;
+    decoder->index = index;
+    return count;
+}
+
+#endif // PBIO_CONFIG_SOUND
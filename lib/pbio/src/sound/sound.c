@@ -0,0 +1,574 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <pbio/config.h>
+
+#if PBIO_CONFIG_SOUND
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <pbdrv/sound.h>
+
+#include <pbio/error.h>
+#include <pbio/sound.h>
+#include <pbio/util.h>
+
+/**
+ * Number of samples in the output buffer. One half is mixed while the other
+ * half plays, so each half lasts 8 ms.
+ */
+#define PBIO_SOUND_BUFFER_SIZE (256)
+
+/** Number of samples per ms. */
+#define PBIO_SOUND_SAMPLES_PER_MS (PBIO_SOUND_SAMPLE_RATE / 1000)
+
+/** Envelope level at full volume. */
+#define PBIO_SOUND_LEVEL_MAX (1 << 23)
+
+/** Shift that maps the envelope level to the 0..32768 range. */
+#define PBIO_SOUND_LEVEL_SHIFT (8)
+
+/** Quarter period of a sine wave, from 0 to INT16_MAX. */
+static const int16_t pbio_sound_sine_table[] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+    6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767,
+};
+
+typedef enum {
+    PBIO_SOUND_STAGE_IDLE,
+    PBIO_SOUND_STAGE_ATTACK,
+    PBIO_SOUND_STAGE_DECAY,
+    PBIO_SOUND_STAGE_SUSTAIN,
+    PBIO_SOUND_STAGE_RELEASE,
+} pbio_sound_stage_t;
+
+typedef struct {
+    /**
+     * Whether the mixer may use this voice. This is cleared while the voice
+     * is being changed by the user, so the mixer never sees a partial update.
+     */
+    volatile bool active;
+    pbio_sound_wave_t wave;
+    /** Amplitude at full volume, 0..INT16_MAX. */
+    uint16_t amplitude;
+    /** Phase of the waveform, where 2^32 is one period. */
+    uint32_t phase;
+    /** Phase increment per sample. */
+    uint32_t phase_step;
+    /** State of the noise generator and its current output. */
+    uint32_t noise_state;
+    int32_t noise;
+    /** Envelope state. Steps are level changes per sample. */
+    pbio_sound_stage_t stage;
+    int32_t level;
+    int32_t attack_step;
+    int32_t decay_step;
+    int32_t sustain_level;
+    int32_t release_step;
+    /** Note sequence, or NULL if not playing one. */
+    const pbio_sound_note_t *notes;
+    uint32_t num_notes;
+    uint32_t note_index;
+    /** Samples until the current note is released and until it ends. */
+    uint32_t gate_samples;
+    uint32_t note_samples;
+} pbio_sound_voice_t;
+
+static pbio_sound_voice_t voices[PBIO_CONFIG_SOUND_NUM_VOICES];
+
+/** Player for sampled sounds. */
+typedef struct {
+    /** Whether the mixer may use the player, like for voices. */
+    volatile bool active;
+    /** Amplitude of a full scale sample, 0..INT16_MAX. */
+    uint16_t amplitude;
+    pbio_sound_adpcm_t decoder;
+    /** Samples decoded ahead of playback. */
+    int16_t decoded[32];
+    uint32_t decoded_count;
+    uint32_t decoded_index;
+    /**
+     * Position between the previous and current sample, where 2^16 is one
+     * sample, and its increment per output sample.
+     */
+    uint32_t position;
+    uint32_t position_step;
+    /** Samples to interpolate between. */
+    int32_t previous;
+    int32_t current;
+    /** Number of output samples left to play. */
+    uint32_t remaining;
+} pbio_sound_player_t;
+
+static pbio_sound_player_t player;
+
+static uint16_t pbio_sound_buffer[PBIO_SOUND_BUFFER_SIZE];
+
+static bool pbio_sound_is_running;
+
+/**
+ * Gets the level change per sample to go through the full level range in
+ * the given time.
+ *
+ * @param [in]  time        Time in ms.
+ * @return                  The level step, at least 1.
+ */
+static int32_t pbio_sound_get_level_step(uint16_t time) {
+    int32_t samples = time * PBIO_SOUND_SAMPLES_PER_MS;
+    if (samples == 0) {
+        return PBIO_SOUND_LEVEL_MAX;
+    }
+    int32_t step = PBIO_SOUND_LEVEL_MAX / samples;
+    return step > 0 ? step : 1;
+}
+
+static void pbio_sound_voice_apply_envelope(pbio_sound_voice_t *voice, const pbio_sound_envelope_t *envelope) {
+    voice->attack_step = pbio_sound_get_level_step(envelope->attack);
+    voice->decay_step = pbio_sound_get_level_step(envelope->decay);
+    voice->release_step = pbio_sound_get_level_step(envelope->release);
+    voice->sustain_level = envelope->sustain == 100 ? PBIO_SOUND_LEVEL_MAX : PBIO_SOUND_LEVEL_MAX / 100 * envelope->sustain;
+}
+
+/**
+ * Gets a voice, setting it up with a full volume square wave and an envelope
+ * without attack and release if it was not used before.
+ */
+static pbio_error_t pbio_sound_get_voice(uint8_t index, pbio_sound_voice_t **voice) {
+    if (index >= PBIO_ARRAY_SIZE(voices)) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+    pbio_sound_voice_t *v = &voices[index];
+    if (v->attack_step == 0) {
+        const pbio_sound_envelope_t envelope = { .sustain = 100 };
+        pbio_sound_voice_apply_envelope(v, &envelope);
+        v->wave = PBIO_SOUND_WAVE_SQUARE;
+        v->amplitude = INT16_MAX;
+        v->noise_state = 0x2545f491 + index;
+    }
+    *voice = v;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Starts the output stream if it is not already running.
+ */
+static void pbio_sound_start(void) {
+    if (pbio_sound_is_running) {
+        return;
+    }
+    pbio_sound_mix(pbio_sound_buffer, PBIO_ARRAY_SIZE(pbio_sound_buffer));
+    pbdrv_sound_start_stream(pbio_sound_buffer, PBIO_ARRAY_SIZE(pbio_sound_buffer), PBIO_SOUND_SAMPLE_RATE, pbio_sound_mix);
+    pbio_sound_is_running = true;
+}
+
+/**
+ * Sets the frequency of a voice and starts the attack, unless the previous
+ * note is still held and @p retrigger is false.
+ */
+static void pbio_sound_voice_start_note(pbio_sound_voice_t *voice, uint16_t frequency, bool retrigger) {
+    if (frequency > PBIO_SOUND_FREQUENCY_MAX) {
+        frequency = PBIO_SOUND_FREQUENCY_MAX;
+    }
+    voice->phase_step = (uint32_t)(((uint64_t)frequency << 32) / PBIO_SOUND_SAMPLE_RATE);
+
+    if (frequency == 0) {
+        // A rest releases the previous note.
+        if (voice->stage != PBIO_SOUND_STAGE_IDLE) {
+            voice->stage = PBIO_SOUND_STAGE_RELEASE;
+        }
+        return;
+    }
+
+    // Start each sound at the same phase, so it starts the same way.
+    if (voice->stage == PBIO_SOUND_STAGE_IDLE) {
+        voice->phase = 0;
+    }
+
+    if (retrigger || voice->stage == PBIO_SOUND_STAGE_IDLE || voice->stage == PBIO_SOUND_STAGE_RELEASE) {
+        voice->stage = PBIO_SOUND_STAGE_ATTACK;
+    }
+}
+
+/**
+ * Starts the next note in the sequence of a voice, if any.
+ */
+static void pbio_sound_voice_next_note(pbio_sound_voice_t *voice) {
+    if (voice->note_index >= voice->num_notes) {
+        voice->notes = NULL;
+        if (voice->stage != PBIO_SOUND_STAGE_IDLE) {
+            voice->stage = PBIO_SOUND_STAGE_RELEASE;
+        }
+        return;
+    }
+
+    const pbio_sound_note_t *note = &voice->notes[voice->note_index++];
+    pbio_sound_voice_start_note(voice, note->frequency, false);
+    voice->note_samples = note->duration * PBIO_SOUND_SAMPLES_PER_MS;
+    voice->gate_samples = note->gate < note->duration ? note->gate * PBIO_SOUND_SAMPLES_PER_MS : UINT32_MAX;
+}
+
+/**
+ * Advances the envelope of a voice by one sample.
+ */
+static void pbio_sound_voice_update_envelope(pbio_sound_voice_t *voice) {
+    switch (voice->stage) {
+        case PBIO_SOUND_STAGE_ATTACK:
+            voice->level += voice->attack_step;
+            if (voice->level >= PBIO_SOUND_LEVEL_MAX) {
+                voice->level = PBIO_SOUND_LEVEL_MAX;
+                voice->stage = PBIO_SOUND_STAGE_DECAY;
+            }
+            break;
+        case PBIO_SOUND_STAGE_DECAY:
+            voice->level -= voice->decay_step;
+            if (voice->level <= voice->sustain_level) {
+                voice->level = voice->sustain_level;
+                voice->stage = PBIO_SOUND_STAGE_SUSTAIN;
+            }
+            break;
+        case PBIO_SOUND_STAGE_RELEASE:
+            voice->level -= voice->release_step;
+            if (voice->level <= 0) {
+                voice->level = 0;
+                voice->stage = PBIO_SOUND_STAGE_IDLE;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Gets the next waveform sample of a voice, in the -INT16_MAX..INT16_MAX range.
+ */
+static int32_t pbio_sound_voice_get_wave(pbio_sound_voice_t *voice) {
+    uint32_t phase = voice->phase;
+    voice->phase += voice->phase_step;
+
+    switch (voice->wave) {
+        case PBIO_SOUND_WAVE_SQUARE:
+            return phase < 0x80000000 ? -INT16_MAX : INT16_MAX;
+        case PBIO_SOUND_WAVE_TRIANGLE: {
+            int32_t ramp = phase >> 16;
+            return (ramp < 0x8000 ? ramp : 0xffff - ramp) * 2 - INT16_MAX;
+        }
+        case PBIO_SOUND_WAVE_SINE: {
+            uint32_t index = phase >> 24;
+            uint32_t quadrant = index >> 6;
+            index &= 0x3f;
+            int32_t value = pbio_sound_sine_table[quadrant & 1 ? 64 - index : index];
+            return quadrant & 2 ? -value : value;
+        }
+        case PBIO_SOUND_WAVE_NOISE:
+            // Pick a new random value every half period.
+            if ((phase ^ voice->phase) & 0x80000000) {
+                // xorshift32 random number generator.
+                uint32_t x = voice->noise_state;
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                voice->noise_state = x;
+                voice->noise = (int16_t)(x >> 16);
+                if (voice->noise < -INT16_MAX) {
+                    voice->noise = -INT16_MAX;
+                }
+            }
+            return voice->noise;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Gets the next output sample of the sample player, in the
+ * -INT16_MAX..INT16_MAX range.
+ *
+ * Samples are decoded a chunk at a time and converted to the output sample
+ * rate with linear interpolation.
+ */
+static int32_t pbio_sound_player_get_sample(void) {
+    while (player.position >= 0x10000) {
+        player.position -= 0x10000;
+        player.previous = player.current;
+        if (player.decoded_index == player.decoded_count) {
+            player.decoded_count = pbio_sound_adpcm_decode(&player.decoder, player.decoded, PBIO_ARRAY_SIZE(player.decoded));
+            player.decoded_index = 0;
+        }
+        // At the end of the data, the last sample is held until done.
+        if (player.decoded_index < player.decoded_count) {
+            player.current = player.decoded[player.decoded_index++];
+        }
+    }
+
+    int32_t sample = player.previous + (((player.current - player.previous) * (int32_t)(player.position >> 1)) >> 15);
+    player.position += player.position_step;
+    player.remaining--;
+    return sample * player.amplitude >> 15;
+}
+
+/**
+ * Mixes all voices into the output buffer.
+ *
+ * This is called from the sound driver interrupt to fill one half of the
+ * buffer while the other half plays. It advances the envelopes and note
+ * sequences of all voices, and decodes the sampled sound that is playing.
+ *
+ * @param [out] data        Buffer to fill with unsigned samples.
+ * @param [in]  length      Number of samples in @p data.
+ */
+void pbio_sound_mix(uint16_t *data, uint32_t length) {
+    int32_t mix[32];
+
+    while (length > 0) {
+        // Mix one chunk at a time, one voice at a time.
+        uint32_t size = length < PBIO_ARRAY_SIZE(mix) ? length : PBIO_ARRAY_SIZE(mix);
+        for (uint32_t i = 0; i < size; i++) {
+            mix[i] = 0;
+        }
+
+        for (uint8_t v = 0; v < PBIO_ARRAY_SIZE(voices); v++) {
+            pbio_sound_voice_t *voice = &voices[v];
+            if (!voice->active || (voice->stage == PBIO_SOUND_STAGE_IDLE && !voice->notes)) {
+                continue;
+            }
+
+            for (uint32_t i = 0; i < size; i++) {
+                // Advance the note sequence, skipping notes without duration.
+                while (voice->notes && voice->note_samples == 0) {
+                    pbio_sound_voice_next_note(voice);
+                }
+                if (voice->notes) {
+                    if (voice->gate_samples == 0 && voice->stage != PBIO_SOUND_STAGE_IDLE) {
+                        voice->stage = PBIO_SOUND_STAGE_RELEASE;
+                    }
+                    voice->gate_samples--;
+                    voice->note_samples--;
+                }
+
+                pbio_sound_voice_update_envelope(voice);
+                int32_t wave = pbio_sound_voice_get_wave(voice);
+                int32_t envelope = voice->level >> PBIO_SOUND_LEVEL_SHIFT;
+                mix[i] += ((wave * envelope) >> 15) * voice->amplitude >> 15;
+            }
+        }
+
+        if (player.active) {
+            for (uint32_t i = 0; i < size && player.remaining > 0; i++) {
+                mix[i] += pbio_sound_player_get_sample();
+            }
+        }
+
+        for (uint32_t i = 0; i < size; i++) {
+            int32_t sample = mix[i];
+            if (sample > INT16_MAX) {
+                sample = INT16_MAX;
+            } else if (sample < -INT16_MAX) {
+                sample = -INT16_MAX;
+            }
+            *data++ = INT16_MAX + sample;
+        }
+        length -= size;
+    }
+}
+
+/**
+ * Sets the waveform and volume of a voice.
+ *
+ * @param [in]  voice       Index of the voice.
+ * @param [in]  wave        The waveform.
+ * @param [in]  amplitude   Amplitude at full volume, up to INT16_MAX.
+ * @return                  ::PBIO_SUCCESS or ::PBIO_ERROR_INVALID_ARG if the
+ *                          voice does not exist.
+ */
+pbio_error_t pbio_sound_voice_set_wave(uint8_t voice, pbio_sound_wave_t wave, uint16_t amplitude) {
+    pbio_sound_voice_t *v;
+    pbio_error_t err = pbio_sound_get_voice(voice, &v);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    v->active = false;
+    v->wave = wave;
+    v->amplitude = amplitude > INT16_MAX ? INT16_MAX : amplitude;
+    v->active = true;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Sets the envelope of a voice. This applies from the next note onwards.
+ *
+ * @param [in]  voice       Index of the voice.
+ * @param [in]  envelope    The envelope.
+ * @return                  ::PBIO_SUCCESS or ::PBIO_ERROR_INVALID_ARG if the
+ *                          voice does not exist or the sustain level is not
+ *                          a percentage.
+ */
+pbio_error_t pbio_sound_voice_set_envelope(uint8_t voice, const pbio_sound_envelope_t *envelope) {
+    pbio_sound_voice_t *v;
+    pbio_error_t err = pbio_sound_get_voice(voice, &v);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+    if (envelope->sustain > 100) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    v->active = false;
+    pbio_sound_voice_apply_envelope(v, envelope);
+    v->active = true;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Starts playing a note on a voice until pbio_sound_voice_note_off() is
+ * called. This stops any note sequence that is playing on the voice.
+ *
+ * @param [in]  voice       Index of the voice.
+ * @param [in]  frequency   Frequency in Hz, or 0 to release the voice.
+ * @return                  ::PBIO_SUCCESS or ::PBIO_ERROR_INVALID_ARG if the
+ *                          voice does not exist.
+ */
+pbio_error_t pbio_sound_voice_note_on(uint8_t voice, uint16_t frequency) {
+    pbio_sound_voice_t *v;
+    pbio_error_t err = pbio_sound_get_voice(voice, &v);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    v->active = false;
+    v->notes = NULL;
+    pbio_sound_voice_start_note(v, frequency, true);
+    v->active = true;
+
+    pbio_sound_start();
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Releases the note playing on a voice, and stops any note sequence.
+ *
+ * @param [in]  voice       Index of the voice.
+ * @return                  ::PBIO_SUCCESS or ::PBIO_ERROR_INVALID_ARG if the
+ *                          voice does not exist.
+ */
+pbio_error_t pbio_sound_voice_note_off(uint8_t voice) {
+    return pbio_sound_voice_note_on(voice, 0);
+}
+
+/**
+ * Plays a sequence of notes on a voice in the background.
+ *
+ * The notes are not copied, so they must remain valid until the sequence is
+ * done or the voice is given another command.
+ *
+ * @param [in]  voice       Index of the voice.
+ * @param [in]  notes       The notes to play.
+ * @param [in]  num_notes   Number of notes.
+ * @return                  ::PBIO_SUCCESS or ::PBIO_ERROR_INVALID_ARG if the
+ *                          voice does not exist.
+ */
+pbio_error_t pbio_sound_voice_play(uint8_t voice, const pbio_sound_note_t *notes, uint32_t num_notes) {
+    pbio_sound_voice_t *v;
+    pbio_error_t err = pbio_sound_get_voice(voice, &v);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    v->active = false;
+    v->notes = notes;
+    v->num_notes = num_notes;
+    v->note_index = 0;
+    // Start the first note without a release from whatever played before.
+    v->stage = PBIO_SOUND_STAGE_IDLE;
+    v->level = 0;
+    pbio_sound_voice_next_note(v);
+    v->active = true;
+
+    pbio_sound_start();
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Checks if a voice is still playing a note sequence or the release of a note.
+ *
+ * @param [in]  voice       Index of the voice.
+ * @return                  True if the voice makes sound or will make sound
+ *                          without further commands, false otherwise.
+ */
+bool pbio_sound_voice_is_busy(uint8_t voice) {
+    pbio_sound_voice_t *v;
+    if (pbio_sound_get_voice(voice, &v) != PBIO_SUCCESS) {
+        return false;
+    }
+    return v->notes || v->stage != PBIO_SOUND_STAGE_IDLE;
+}
+
+/**
+ * Plays a sampled sound in the background, replacing any sampled sound that
+ * is already playing. It is mixed with the voices.
+ *
+ * The data is not copied, so it must remain valid until the sound is done
+ * or stopped.
+ *
+ * @param [in]  data        IMA ADPCM data, including the header.
+ * @param [in]  size        Size of @p data in bytes.
+ * @param [in]  amplitude   Amplitude of a full scale sample, up to INT16_MAX.
+ * @return                  ::PBIO_SUCCESS or ::PBIO_ERROR_INVALID_ARG if the
+ *                          data is not valid.
+ */
+pbio_error_t pbio_sound_play_adpcm(const uint8_t *data, uint32_t size, uint16_t amplitude) {
+    pbio_sound_adpcm_t decoder;
+    pbio_error_t err = pbio_sound_adpcm_init(&decoder, data, size);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    player.active = false;
+    player.decoder = decoder;
+    player.amplitude = amplitude > INT16_MAX ? INT16_MAX : amplitude;
+    player.decoded_count = 0;
+    player.decoded_index = 0;
+    player.position_step = ((uint32_t)decoder.sample_rate << 16) / PBIO_SOUND_SAMPLE_RATE;
+    player.remaining = (((uint64_t)decoder.num_samples << 16) + player.position_step - 1) / player.position_step;
+    // Start with the first two samples, so the first sample plays first.
+    player.position = 0x20000;
+    player.current = decoder.predictor;
+    player.active = true;
+
+    pbio_sound_start();
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Checks if a sampled sound is still playing.
+ *
+ * @return                  True if the sound is playing, false otherwise.
+ */
+bool pbio_sound_adpcm_is_busy(void) {
+    return player.active && player.remaining > 0;
+}
+
+/**
+ * Silences all voices and sampled sounds, and stops the sound output.
+ */
+void pbio_sound_stop(void) {
+    pbdrv_sound_stop();
+    pbio_sound_is_running = false;
+    player.active = false;
+    for (uint8_t i = 0; i < PBIO_ARRAY_SIZE(voices); i++) {
+        voices[i].notes = NULL;
+        voices[i].stage = PBIO_SOUND_STAGE_IDLE;
+        voices[i].level = 0;
+    }
+}
+
+#endif // PBIO_CONFIG_SOUND
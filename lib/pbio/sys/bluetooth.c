@@ -25,8 +25,9 @@
 
 #include "storage.h"
 
-// REVISIT: this can be the negotiated MTU - 3 to allow for better throughput
-#define MAX_CHAR_SIZE 20
+// Largest characteristic value that can be sent. The size actually used is
+// limited by the negotiated MTU of the connection.
+#define MAX_CHAR_SIZE (PBDRV_BLUETOOTH_MAX_MTU_SIZE - 3)
 
 // REVISIT: this needs to be moved to a common place where it can be shared with USB
 static pbsys_bluetooth_stdin_event_callback_t stdin_event_callback;
@@ -365,8 +366,11 @@ PROCESS_THREAD(pbsys_bluetooth_process, ev, data) {
 
                     if (msg == &stdout_msg) {
                         msg->payload[0] = PBIO_PYBRICKS_EVENT_WRITE_STDOUT;
-                        // REVISIT: use negotiated MTU instead of minimum safe size
-                        msg->context.size = lwrb_read(&stdout_ring_buf, &msg->payload[1], PBIO_ARRAY_SIZE(msg->payload) - 1) + 1;
+                        uint32_t max_size = pbdrv_bluetooth_get_mtu(PBDRV_BLUETOOTH_CONNECTION_PYBRICKS) - 3;
+                        if (max_size > PBIO_ARRAY_SIZE(msg->payload)) {
+                            max_size = PBIO_ARRAY_SIZE(msg->payload);
+                        }
+                        msg->context.size = lwrb_read(&stdout_ring_buf, &msg->payload[1], max_size - 1) + 1;
                         assert(msg->context.size > 1);
                     }
 
@@ -36,11 +36,13 @@ static pbio_error_t pbsys_hub_light_matrix_set_pixel(pbio_light_matrix_t *light_
     // REVISIT: currently hub light matrix is hard-coded as LED array at index 0
     // on all platforms
     pbdrv_led_array_dev_t *array;
-    if (pbdrv_led_array_get_dev(0, &array) == PBIO_SUCCESS) {
-        return pbdrv_led_array_set_brightness(array, row * light_matrix->size + col, brightness);
+    pbio_error_t err = pbdrv_led_array_get_dev(0, &array);
+    if (err != PBIO_SUCCESS) {
+        // Not ready yet, so the frame will be sent again on the next update.
+        return err;
     }
 
-    return PBIO_SUCCESS;
+    return pbdrv_led_array_set_brightness(array, row * light_matrix->size + col, brightness);
 }
 
 static const pbio_light_matrix_funcs_t pbsys_hub_light_matrix_funcs = {
@@ -50,18 +52,23 @@ static const pbio_light_matrix_funcs_t pbsys_hub_light_matrix_funcs = {
 /**
  * Displays the idle UI. Has a square stop sign and selected slot on bottom row.
  *
+ * This draws on the frame directly rather than through the orientation set
+ * by the user program, since the UI is always shown the same way.
+ *
  * @param brightness   Brightness (0--100%).
  */
 static void pbsys_hub_light_matrix_show_idle_ui(uint8_t brightness) {
-    for (uint8_t r = 0; r < pbsys_hub_light_matrix->size; r++) {
-        for (uint8_t c = 0; c < pbsys_hub_light_matrix->size; c++) {
+    uint8_t size = pbsys_hub_light_matrix->size;
+    for (uint8_t r = 0; r < size; r++) {
+        for (uint8_t c = 0; c < size; c++) {
             bool is_on = r < 3 && c > 0 && c < 4;
             #if PBSYS_CONFIG_HMI_NUM_SLOTS
             is_on |= (r == 4 && c == pbsys_hmi_get_selected_program_slot());
             #endif
-            pbsys_hub_light_matrix_set_pixel(pbsys_hub_light_matrix, r, c, is_on ? brightness : 0);
+            pbsys_hub_light_matrix->frame[r * size + c] = is_on ? brightness : 0;
         }
     }
+    pbio_light_matrix_flush(pbsys_hub_light_matrix);
 }
 
 void pbsys_hub_light_matrix_update_program_slot(void) {
@@ -106,11 +113,13 @@ void pbsys_hub_light_matrix_init(void) {
  * Clears the pixels needed for the run animation
  */
 static void pbsys_hub_light_matrix_user_program_animation_clear(void) {
+    uint8_t size = pbsys_hub_light_matrix->size;
     for (uint8_t r = 0; r < 3; r++) {
         for (uint8_t c = 1; c < 4; c++) {
-            pbsys_hub_light_matrix_set_pixel(pbsys_hub_light_matrix, r, c, 0);
+            pbsys_hub_light_matrix->frame[r * size + c] = 0;
         }
     }
+    pbio_light_matrix_flush(pbsys_hub_light_matrix);
 }
 
 // Animation frame for program running animation.
@@ -122,16 +131,17 @@ static uint32_t pbsys_hub_light_matrix_user_program_animation_next(pbio_light_an
     // which we can cycle in 256 steps.
     static uint8_t cycle = 0;
 
-    pbdrv_led_array_dev_t *array;
-    if (pbdrv_led_array_get_dev(0, &array) == PBIO_SUCCESS) {
-        for (size_t i = 0; i < PBIO_ARRAY_SIZE(indexes); i++) {
-            // The pixels are spread equally across the pattern.
-            uint8_t offset = cycle + i * (UINT8_MAX / PBIO_ARRAY_SIZE(indexes));
-            uint8_t brightness = offset > 200 ? 0 : (offset < 100 ? offset : 200 - offset);
-
-            // Set the brightness for this pixel
-            pbdrv_led_array_set_brightness(array, indexes[i], brightness);
-        }
+    for (size_t i = 0; i < PBIO_ARRAY_SIZE(indexes); i++) {
+        // The pixels are spread equally across the pattern.
+        uint8_t offset = cycle + i * (UINT8_MAX / PBIO_ARRAY_SIZE(indexes));
+        uint8_t brightness = offset > 200 ? 0 : (offset < 100 ? offset : 200 - offset);
+
+        // Set the brightness for this pixel
+        pbsys_hub_light_matrix->frame[indexes[i]] = brightness;
+    }
+
+    // Only the pixels that changed since the last frame are sent.
+    if (pbio_light_matrix_flush(pbsys_hub_light_matrix) == PBIO_SUCCESS) {
         // This increment controls the speed of the pattern
         cycle += 9;
     }
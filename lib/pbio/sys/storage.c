@@ -466,6 +466,9 @@ PROCESS_THREAD(pbsys_storage_process, ev, data) {
     // Wait for signal on signal.
     PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
 
+    // Include what the IMU learned during this session.
+    pbsys_storage_settings_save_imu_calibration();
+
     // Write data to storage if it was updated.
     if (data_map_write_on_shutdown) {
 
@@ -11,8 +11,10 @@
 
 #include <pbdrv/bluetooth.h>
 
+#include <pbio/color.h>
 #include <pbio/error.h>
 #include <pbio/imu.h>
+#include <pbio/port.h>
 #include <pbsys/status.h>
 #include <pbsys/storage_settings.h>
 
@@ -32,6 +34,7 @@ void pbsys_storage_settings_set_defaults(pbsys_storage_settings_t *settings) {
     settings->gyro_stationary_threshold = 3.0f;
     settings->accel_stationary_threshold = 2500.0f;
     settings->heading_correction = 360.0f;
+    pbio_imu_calibration_set_defaults(&settings->imu_calibration);
     #endif // PBIO_CONFIG_IMU
 }
 
@@ -48,11 +51,14 @@ void pbsys_storage_settings_apply_loaded_settings(pbsys_storage_settings_t *sett
         settings->accel_stationary_threshold,
         settings->heading_correction
         );
+    // If invalid, the IMU keeps using the defaults.
+    pbio_imu_set_calibration(&settings->imu_calibration);
     #endif // PBIO_CONFIG_IMU
 }
 
 /**
- * Copies the configured IMU settings to storage and requests them to be saved.
+ * Copies the configured IMU settings and calibration to storage and requests
+ * them to be saved.
  *
  * @param [in]  settings  Settings to populate.
  */
@@ -67,10 +73,95 @@ void pbsys_storage_settings_save_imu_settings(void) {
         &settings->accel_stationary_threshold,
         &settings->heading_correction
         );
+    pbio_imu_get_calibration(&settings->imu_calibration);
     pbsys_storage_request_write();
     #endif // PBIO_CONFIG_IMU
 }
 
+/**
+ * Copies the learned IMU calibration to storage and requests it to be saved
+ * if it has changed meaningfully, so it can be used right away on the next
+ * boot. Small changes are not saved to avoid writing to flash on every
+ * shutdown.
+ */
+void pbsys_storage_settings_save_imu_calibration(void) {
+    pbsys_storage_settings_t *settings = pbsys_storage_settings_get_settings();
+    if (!settings) {
+        return;
+    }
+    #if PBIO_CONFIG_IMU
+    if (pbio_imu_calibration_changed(&settings->imu_calibration)) {
+        pbio_imu_get_calibration(&settings->imu_calibration);
+        pbsys_storage_request_write();
+    }
+    #endif // PBIO_CONFIG_IMU
+}
+
+#if PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS
+/**
+ * Gets the index of the color calibration of a port.
+ *
+ * @param [in]  port        The port.
+ * @param [out] index       The index in the calibration arrays.
+ * @returns                 True if a calibration can be stored for this port.
+ */
+static bool pbsys_storage_settings_get_color_calibration_index(pbio_port_id_t port, uint8_t *index) {
+    if (port < PBIO_PORT_ID_A || port >= PBIO_PORT_ID_A + PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS) {
+        return false;
+    }
+    *index = port - PBIO_PORT_ID_A;
+    return true;
+}
+#endif // PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS
+
+/**
+ * Gets the stored color calibration for a sensor.
+ *
+ * @param [in]  port        The port of the sensor.
+ * @param [in]  type_id     The device type of the sensor.
+ * @param [out] calibration The stored calibration.
+ * @returns                 True if a calibration was stored for this type of
+ *                          sensor on this port, otherwise false.
+ */
+bool pbsys_storage_settings_get_color_calibration(pbio_port_id_t port, uint8_t type_id, pbio_color_calibration_t *calibration) {
+    #if PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS
+    pbsys_storage_settings_t *settings = pbsys_storage_settings_get_settings();
+    uint8_t index;
+    if (!settings || !type_id || !pbsys_storage_settings_get_color_calibration_index(port, &index)
+        || settings->color_calibration_type_id[index] != type_id) {
+        return false;
+    }
+    *calibration = settings->color_calibration[index];
+    return true;
+    #else
+    return false;
+    #endif // PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS
+}
+
+/**
+ * Copies a color calibration to storage and requests it to be saved if it
+ * has changed.
+ *
+ * @param [in]  port        The port of the sensor.
+ * @param [in]  type_id     The device type of the sensor.
+ * @param [in]  calibration The calibration to save.
+ */
+void pbsys_storage_settings_save_color_calibration(pbio_port_id_t port, uint8_t type_id, const pbio_color_calibration_t *calibration) {
+    #if PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS
+    pbsys_storage_settings_t *settings = pbsys_storage_settings_get_settings();
+    uint8_t index;
+    if (!settings || !pbsys_storage_settings_get_color_calibration_index(port, &index)) {
+        return;
+    }
+    if (settings->color_calibration_type_id[index] != type_id
+        || memcmp(calibration, &settings->color_calibration[index], sizeof(*calibration))) {
+        settings->color_calibration_type_id[index] = type_id;
+        settings->color_calibration[index] = *calibration;
+        pbsys_storage_request_write();
+    }
+    #endif // PBSYS_CONFIG_STORAGE_NUM_COLOR_CALIBRATIONS
+}
+
 bool pbsys_storage_settings_bluetooth_enabled(void) {
     #if PBSYS_CONFIG_BLUETOOTH_TOGGLE
     pbsys_storage_settings_t *settings = pbsys_storage_settings_get_settings();
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <test-pbio.h>
+
+// The BLE5-Stack headers are not on the include path since some of the names
+// clash with BTstack headers.
+#include "../../../ble5stack/central/att.h"
+#include "../../../ble5stack/central/hci_tl.h"
+
+// HCI transport double
+
+static uint16_t sent_opcode;
+static uint8_t sent_data[UINT8_MAX];
+static uint8_t sent_length;
+
+HCI_StatusCodes_t HCI_sendHCICommand(uint16_t opcode, uint8_t *pData, uint8_t dataLength) {
+    sent_opcode = opcode;
+    sent_length = dataLength;
+    memcpy(sent_data, pData, dataLength);
+
+    return bleSUCCESS;
+}
+
+static void test_att_handle_value_noti(void *env) {
+    static uint8_t value[ATT_MAX_MTU_SIZE - 3 + 1];
+    attHandleValueNoti_t noti;
+
+    for (uint32_t i = 0; i < sizeof(value); i++) {
+        value[i] = i;
+    }
+
+    // stdout is sent in notifications as large as the MTU allows, so the
+    // largest value for the largest MTU used by the cc2640 hubs must fit
+    noti.handle = 0x0123;
+    noti.len = ATT_MAX_MTU_SIZE - 3;
+    noti.pValue = value;
+
+    tt_want_uint_op(ATT_HandleValueNoti(0x0456, &noti), ==, bleSUCCESS);
+    tt_want_uint_op(sent_opcode, ==, ATT_CMD_HANDLE_VALUE_NOTI);
+    tt_want_uint_op(sent_length, ==, 5 + ATT_MAX_MTU_SIZE - 3);
+    tt_want_uint_op(sent_data[0], ==, 0x56);
+    tt_want_uint_op(sent_data[1], ==, 0x04);
+    tt_want_uint_op(sent_data[3], ==, 0x23);
+    tt_want_uint_op(sent_data[4], ==, 0x01);
+    tt_want_int_op(memcmp(&sent_data[5], value, noti.len), ==, 0);
+
+    // anything larger doesn't fit in a notification
+    sent_length = 0;
+    noti.len++;
+
+    tt_want_uint_op(ATT_HandleValueNoti(0x0456, &noti), ==, bleInvalidRange);
+    tt_want_uint_op(sent_length, ==, 0);
+}
+
+struct testcase_t pbdrv_ble5stack_tests[] = {
+    PBIO_TEST(test_att_handle_value_noti),
+    END_OF_TESTCASES
+};
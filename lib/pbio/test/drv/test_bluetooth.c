@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <btstack.h>
 #include <btstack_chipset_cc256x.h>
@@ -13,6 +14,9 @@
 #include <tinytest_macros.h>
 #include <tinytest.h>
 
+#include <pbdrv/bluetooth.h>
+#include <pbio/task.h>
+#include <pbio/util.h>
 #include <test-pbio.h>
 
 #include "../../drv/bluetooth/bluetooth_btstack_run_loop_contiki.h"
@@ -120,6 +124,14 @@ void pbio_test_bluetooth_connect(void) {
     queue_packet(buffer, length + 3);
 }
 
+// advertising state, local to tests in this file
+
+static uint16_t advertising_interval;
+static uint32_t advertising_enable_count;
+static uint32_t advertising_data_count;
+static uint8_t advertising_data[31];
+static uint8_t advertising_data_size;
+
 static void pbio_test_bluetooth_enable_notifications(uint16_t attribute_handle) {
     const uint16_t length = 5;
     uint8_t buffer[length + 9];
@@ -187,6 +199,7 @@ void pbio_test_bluetooth_enable_pybricks_service_notifications(void) {
 }
 
 static uint32_t pybricks_service_notification_count;
+static uint16_t pybricks_service_notification_size;
 
 /**
  * This count increases each time the hub sends a notification on the Pybricks
@@ -196,6 +209,33 @@ uint32_t pbio_test_bluetooth_get_pybricks_service_notification_count(void) {
     return pybricks_service_notification_count;
 }
 
+/**
+ * Gets the size of the last notification sent by the hub on the Pybricks
+ * service command characteristic.
+ */
+uint16_t pbio_test_bluetooth_get_pybricks_service_notification_size(void) {
+    return pybricks_service_notification_size;
+}
+
+/**
+ * This simulates a remote device requesting an MTU exchange.
+ */
+void pbio_test_bluetooth_exchange_mtu(uint16_t mtu) {
+    const uint16_t length = 3;
+    uint8_t buffer[length + 9];
+
+    buffer[0] = 0x02; // packet type = ACL Data
+    little_endian_store_16(buffer, 1, 0x0400); // connection handle
+    buffer[2] |= 0x02 << 4; // PB flag
+    little_endian_store_16(buffer, 3, length + 4); // total data length
+    little_endian_store_16(buffer, 5, length); // L2CAP length
+    little_endian_store_16(buffer, 7, 4); // Attribute protocol
+    buffer[9] = ATT_EXCHANGE_MTU_REQUEST;
+    little_endian_store_16(buffer, 10, mtu); // client Rx MTU
+
+    queue_packet(buffer, length + 9);
+}
+
 void pbio_test_bluetooth_send_pybricks_command(const uint8_t *data, uint32_t size) {
     // Pybricks command/event characteristic value (comes from header file generated by .gatt)
     const uint16_t attribute_handle = 0x000d;
@@ -313,11 +353,15 @@ static void handle_send(const uint8_t *buffer, uint16_t length) {
                     queue_command_complete(opcode, 0x00);
                     break;
                 case 0x2006: // LE Set Advertising Parameters
+                    advertising_interval = little_endian_read_16(buffer, 4);
                     log_debug("advertising parameters, min %d, max %d, type 0x%02x, own addr type 0x%02x, peer addr type 0x%02x, peer addr %02x:%02x:%02x:%02x:%02x:%02x, chan map 0x%02x",
                         little_endian_read_16(buffer, 4), little_endian_read_16(buffer, 6), buffer[8], buffer[9], buffer[10], buffer[11], buffer[12], buffer[13], buffer[14], buffer[15], buffer[16], buffer[17]);
                     queue_command_complete(opcode, 0x00);
                     break;
                 case 0x2008: // LE Set Advertising Data
+                    advertising_data_count++;
+                    advertising_data_size = buffer[4];
+                    memcpy(advertising_data, &buffer[5], sizeof(advertising_data));
                     log_debug("advertising data, len %d", buffer[4]);
                     queue_command_complete(opcode, 0x00);
                     break;
@@ -327,6 +371,7 @@ static void handle_send(const uint8_t *buffer, uint16_t length) {
                     break;
                 case 0x200a: // LE Set Advertise Enable
                     advertising_enabled = buffer[4];
+                    advertising_enable_count++;
                     log_debug("advertising_enabled %d", advertising_enabled);
                     queue_command_complete(opcode, 0x00);
                     break;
@@ -452,6 +497,11 @@ static void handle_send(const uint8_t *buffer, uint16_t length) {
                         }
                         break;
 
+                        case 0x03: { // ATT_EXCHANGE_MTU_RESPONSE
+                            log_debug("ATT_EXCHANGE_MTU_RESPONSE: server Rx MTU: %u", little_endian_read_16(buffer, 10));
+                        }
+                        break;
+
                         case 0x13: { // ATT_WRITE_RESPONSE
                             // REVISIT: maybe set a flag here?
                         }
@@ -466,6 +516,7 @@ static void handle_send(const uint8_t *buffer, uint16_t length) {
                             switch (attr_handle) {
                                 case 0x000d:
                                     pybricks_service_notification_count++;
+                                    pybricks_service_notification_size = size;
                                     break;
                                 case 0x0013:
                                     uart_service_notification_count++;
@@ -791,8 +842,142 @@ static PT_THREAD(test_btstack_run_loop_contiki_poll(struct pt *pt)) {
     PT_END(pt);
 }
 
+static PT_THREAD(test_btstack_broadcast(struct pt *pt)) {
+    static pbio_task_t task;
+    static uint8_t data_1[] = { 0x04, 0xff, 0x97, 0x03, 0x01 };
+    static uint8_t data_2[] = { 0x04, 0xff, 0x97, 0x03, 0x02 };
+    static uint8_t data_3[] = { 0x04, 0xff, 0x97, 0x03, 0x03 };
+    static pbdrv_bluetooth_value_t *value;
+    static uint32_t enable_count;
+    pbdrv_bluetooth_broadcast_stats_t stats;
+
+    PT_BEGIN(pt);
+
+    value = malloc(sizeof(*value) + sizeof(data_1));
+    tt_assert(value);
+
+    pbdrv_bluetooth_power_on(true);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        hci_get_state() == HCI_STATE_WORKING;
+    }));
+
+    // updating only works after broadcasting was started
+    value->size = sizeof(data_1);
+    memcpy(value->data, data_1, sizeof(data_1));
+    tt_want_uint_op(pbdrv_bluetooth_update_broadcasting(value), ==, PBIO_ERROR_INVALID_OP);
+
+    // out of range interval should be rejected
+    tt_want_uint_op(pbdrv_bluetooth_set_broadcast_interval(PBDRV_BLUETOOTH_BROADCAST_INTERVAL_MIN - 1), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want_uint_op(pbdrv_bluetooth_set_broadcast_interval(200), ==, PBIO_SUCCESS);
+
+    pbdrv_bluetooth_start_broadcasting(&task, value);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        task.status != PBIO_ERROR_AGAIN;
+    }));
+
+    tt_want_uint_op(task.status, ==, PBIO_SUCCESS);
+
+    // advertising is enabled after the data is set
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        pbio_test_bluetooth_is_advertising_enabled();
+    }));
+
+    // 200 ms in units of 0.625 ms
+    tt_want_uint_op(advertising_interval, ==, 320);
+    tt_want_uint_op(advertising_data_size, ==, sizeof(data_1));
+    tt_want_int_op(memcmp(advertising_data, data_1, sizeof(data_1)), ==, 0);
+
+    pbdrv_bluetooth_get_broadcast_stats(&stats);
+    tt_want_uint_op(stats.submitted, ==, 1);
+    tt_want_uint_op(stats.replaced, ==, 0);
+
+    // The first update is sent to the chip right away. The second one has to
+    // wait for that to complete, so the third one replaces it.
+    enable_count = advertising_enable_count;
+
+    value->size = sizeof(data_2);
+    memcpy(value->data, data_2, sizeof(data_2));
+    tt_want_uint_op(pbdrv_bluetooth_update_broadcasting(value), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbdrv_bluetooth_update_broadcasting(value), ==, PBIO_SUCCESS);
+
+    value->size = sizeof(data_3);
+    memcpy(value->data, data_3, sizeof(data_3));
+    tt_want_uint_op(pbdrv_bluetooth_update_broadcasting(value), ==, PBIO_SUCCESS);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        pbdrv_bluetooth_get_broadcast_stats(&stats);
+        stats.submitted == 3;
+    }));
+
+    tt_want_uint_op(stats.replaced, ==, 1);
+    tt_want_uint_op(advertising_data_size, ==, sizeof(data_3));
+    tt_want_int_op(memcmp(advertising_data, data_3, sizeof(data_3)), ==, 0);
+
+    // data should be swapped in place without restarting advertising
+    tt_want_uint_op(advertising_enable_count, ==, enable_count);
+    tt_want(pbio_test_bluetooth_is_advertising_enabled());
+
+    pbdrv_bluetooth_stop_broadcasting(&task);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        task.status != PBIO_ERROR_AGAIN && !pbio_test_bluetooth_is_advertising_enabled();
+    }));
+
+    tt_want_uint_op(task.status, ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbdrv_bluetooth_update_broadcasting(value), ==, PBIO_ERROR_INVALID_OP);
+
+    // advertising to connect should use its own interval again
+    pbdrv_bluetooth_start_advertising();
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        pbio_test_bluetooth_is_advertising_enabled();
+    }));
+
+    tt_want_uint_op(advertising_interval, ==, 0x30);
+
+    pbdrv_bluetooth_stop_advertising();
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        !pbio_test_bluetooth_is_advertising_enabled();
+    }));
+
+    // zero selects the default interval of 100 ms
+    tt_want_uint_op(pbdrv_bluetooth_set_broadcast_interval(0), ==, PBIO_SUCCESS);
+
+    value->size = sizeof(data_1);
+    memcpy(value->data, data_1, sizeof(data_1));
+    pbdrv_bluetooth_start_broadcasting(&task, value);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        task.status != PBIO_ERROR_AGAIN;
+    }));
+
+    tt_want_uint_op(task.status, ==, PBIO_SUCCESS);
+    tt_want_uint_op(advertising_interval, ==, 160);
+
+    pbdrv_bluetooth_get_broadcast_stats(&stats);
+    tt_want_uint_op(stats.submitted, ==, 1);
+    tt_want_uint_op(stats.replaced, ==, 0);
+
+end:
+    free(value);
+
+    PT_END(pt);
+}
+
 struct testcase_t pbdrv_bluetooth_tests[] = {
     PBIO_PT_THREAD_TEST(test_btstack_run_loop_contiki_timer),
     PBIO_PT_THREAD_TEST(test_btstack_run_loop_contiki_poll),
+    PBIO_PT_THREAD_TEST(test_btstack_broadcast),
     END_OF_TESTCASES
 };
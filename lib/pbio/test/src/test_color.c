@@ -2,8 +2,10 @@
 // Copyright (c) 2020-2021 The Pybricks Authors
 
 #include <stdio.h>
+#include <string.h>
 
 #include <pbio/color.h>
+#include <pbio/util.h>
 #include <test-pbio.h>
 
 #include <tinytest.h>
@@ -609,6 +611,168 @@ static void test_color_hsv_cost(void *env) {
     tt_want_int_op(dist, <, 410000000);
 }
 
+// Precomputed bicone coordinates should give the same matches as computing
+// the distance from HSV directly.
+static void test_color_bicone_nearest(void *env) {
+    static const pbio_color_hsv_t references[] = {
+        // Default detectable colors.
+        { .h = 0, .s = 100, .v = 100 },
+        { .h = 60, .s = 100, .v = 100 },
+        { .h = 120, .s = 100, .v = 100 },
+        { .h = 240, .s = 100, .v = 100 },
+        { .h = 0, .s = 0, .v = 100 },
+        { .h = 0, .s = 0, .v = 0 },
+        // Custom colors, including negative value for a "none" color.
+        { .h = 5, .s = 82, .v = 41 },
+        { .h = 213, .s = 67, .v = 30 },
+        { .h = 353, .s = 91, .v = 62 },
+        { .h = 180, .s = 0, .v = -40 },
+        { .h = 90, .s = 30, .v = 50 },
+        { .h = 300, .s = 60, .v = 75 },
+    };
+    const size_t n = PBIO_ARRAY_SIZE(references);
+
+    pbio_color_bicone_t bicones[PBIO_ARRAY_SIZE(references)];
+    for (size_t i = 0; i < n; i++) {
+        pbio_color_hsv_to_bicone(&references[i], &bicones[i]);
+        tt_want_int_op(pbio_color_bicone_get_squared_distance(&bicones[i], &bicones[i]), ==, 0);
+    }
+
+    for (uint16_t h = 0; h < 360; h += 3) {
+        for (uint8_t s = 0; s <= 100; s += 4) {
+            for (int8_t v = -20; v <= 100; v += 4) {
+                pbio_color_hsv_t hsv = { .h = h, .s = s, .v = v };
+
+                // Matching as done by iterating over HSV colors.
+                size_t expected = n;
+                int32_t cost_min = INT32_MAX;
+                for (size_t i = 0; i < n; i++) {
+                    int32_t cost = pbio_color_get_bicone_squared_distance(&hsv, &references[i]);
+                    if (cost < cost_min) {
+                        cost_min = cost;
+                        expected = i;
+                    }
+                }
+
+                size_t match = pbio_color_bicone_get_nearest(bicones, n, &hsv);
+                if (match != expected) {
+                    TT_FAIL(("h: %d, s: %d, v: %d, got: %d, expected: %d", h, s, v, (int)match, (int)expected));
+                    return;
+                }
+            }
+        }
+    }
+
+    // Empty map gives no match.
+    pbio_color_hsv_t hsv = { .h = 0, .s = 0, .v = 0 };
+    tt_want_int_op(pbio_color_bicone_get_nearest(bicones, 0, &hsv), ==, 0);
+}
+
+// Calibration maps raw readings to RGB, and the tone curve gives the same
+// saturation and value as the correction previously applied to HSV.
+static void test_color_calibration(void *env) {
+    pbio_color_calibration_t calibration;
+    pbio_color_rgb_t rgb;
+    pbio_color_hsv_t hsv;
+
+    // Full scale readings give full scale RGB.
+    pbio_color_calibration_set_defaults(&calibration, 1024);
+    pbio_color_raw_t raw = { .r = 1024, .g = 1024, .b = 1024 };
+    pbio_color_calibration_get_rgb(&calibration, &raw, NULL, &rgb);
+    tt_want_int_op(rgb.r, ==, 255);
+    tt_want_int_op(rgb.g, ==, 255);
+    tt_want_int_op(rgb.b, ==, 255);
+
+    // Out of range readings are clamped.
+    raw = (pbio_color_raw_t) { .r = 2000, .g = -5, .b = 0 };
+    pbio_color_calibration_get_rgb(&calibration, &raw, NULL, &rgb);
+    tt_want_int_op(rgb.r, ==, 255);
+    tt_want_int_op(rgb.g, ==, 0);
+    tt_want_int_op(rgb.b, ==, 0);
+
+    // Compare the tone curve to the same correction applied to exact HSV
+    // values. Very dark colors are skipped since their saturation is not
+    // well defined in 8-bit RGB.
+    pbio_color_calibration_set_defaults(&calibration, 255);
+    for (int32_t r = 0; r < 256; r += 5) {
+        for (int32_t g = 0; g < 256; g += 5) {
+            for (int32_t b = 0; b < 256; b += 5) {
+                int32_t max = r > g ? r : g;
+                max = b > max ? b : max;
+                int32_t min = r < g ? r : g;
+                min = b < min ? b : min;
+                if (max < 32) {
+                    continue;
+                }
+                raw = (pbio_color_raw_t) { .r = r, .g = g, .b = b };
+                pbio_color_calibration_get_hsv(&calibration, &raw, NULL, &hsv);
+
+                pbio_color_hsv_t expected;
+                rgb = (pbio_color_rgb_t) { .r = r, .g = g, .b = b };
+                pbio_color_rgb_to_hsv(&rgb, &expected);
+                float s = 100.0f * (max - min) / max;
+                float v = 100.0f * max / 255;
+                expected.s = s * (200 - s) / 100;
+                expected.v = v * (200 - v) / 100;
+
+                int32_t dh = (hsv.h - expected.h + 540) % 360 - 180;
+                if (dh < -2 || dh > 2 || hsv.s < expected.s - 2 || hsv.s > expected.s + 2 ||
+                    hsv.v < expected.v - 2 || hsv.v > expected.v + 2) {
+                    TT_FAIL(("r: %d, g: %d, b: %d, got: %d %d %d, expected: %d %d %d",
+                        (int)r, (int)g, (int)b, hsv.h, hsv.s, hsv.v, expected.h, expected.s, expected.v));
+                    return;
+                }
+            }
+        }
+    }
+
+    // White reference maps to white.
+    pbio_color_calibration_set_defaults(&calibration, 1024);
+    const pbio_color_raw_t white = { .r = 600, .g = 450, .b = 300 };
+    const pbio_color_raw_t black = { .r = 60, .g = 50, .b = 40 };
+    tt_want_int_op(pbio_color_calibration_set_reference(&calibration, PBIO_COLOR_WHITE, &white), ==, PBIO_SUCCESS);
+    pbio_color_calibration_get_hsv(&calibration, &white, NULL, &hsv);
+    tt_want_int_op(hsv.s, ==, 0);
+    tt_want_int_op(hsv.v, ==, 100);
+
+    // Black reference maps to black, while white stays white.
+    tt_want_int_op(pbio_color_calibration_set_reference(&calibration, PBIO_COLOR_BLACK, &black), ==, PBIO_SUCCESS);
+    pbio_color_calibration_get_hsv(&calibration, &black, NULL, &hsv);
+    tt_want_int_op(hsv.v, ==, 0);
+    pbio_color_calibration_get_hsv(&calibration, &white, NULL, &hsv);
+    tt_want_int_op(hsv.s, <=, 1);
+    tt_want_int_op(hsv.v, ==, 100);
+
+    // The order of the references does not matter.
+    pbio_color_calibration_t other;
+    pbio_color_calibration_set_defaults(&other, 1024);
+    tt_want_int_op(pbio_color_calibration_set_reference(&other, PBIO_COLOR_BLACK, &black), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_color_calibration_set_reference(&other, PBIO_COLOR_WHITE, &white), ==, PBIO_SUCCESS);
+    for (uint8_t i = 0; i < 3; i++) {
+        tt_want_int_op(other.offset[i], ==, calibration.offset[i]);
+        tt_want(pbio_test_int_is_close(other.gain[i][i], calibration.gain[i][i], 1));
+    }
+
+    // Ambient light is subtracted like the offset.
+    const pbio_color_raw_t ambient = { .r = 100, .g = 100, .b = 100 };
+    const pbio_color_raw_t lit = { .r = 400, .g = 300, .b = 200 };
+    const pbio_color_raw_t unlit = { .r = 300, .g = 200, .b = 100 };
+    pbio_color_rgb_t rgb_unlit;
+    pbio_color_calibration_get_rgb(&calibration, &lit, &ambient, &rgb);
+    pbio_color_calibration_get_rgb(&calibration, &unlit, NULL, &rgb_unlit);
+    tt_want_int_op(rgb.r, ==, rgb_unlit.r);
+    tt_want_int_op(rgb.g, ==, rgb_unlit.g);
+    tt_want_int_op(rgb.b, ==, rgb_unlit.b);
+
+    // Invalid references leave the calibration unchanged.
+    other = calibration;
+    const pbio_color_raw_t dark = { .r = 600, .g = 52, .b = 300 };
+    tt_want_int_op(pbio_color_calibration_set_reference(&other, PBIO_COLOR_WHITE, &dark), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want_int_op(pbio_color_calibration_set_reference(&other, PBIO_COLOR_BLACK, &white), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want_int_op(pbio_color_calibration_set_reference(&other, PBIO_COLOR_RED, &white), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want(memcmp(&other, &calibration, sizeof(other)) == 0);
+}
+
 struct testcase_t pbio_color_tests[] = {
     PBIO_TEST(test_rgb_to_hsv),
     PBIO_TEST(test_hsv_to_rgb),
@@ -616,5 +780,7 @@ struct testcase_t pbio_color_tests[] = {
     PBIO_TEST(test_color_to_rgb),
     PBIO_TEST(test_color_hsv_compression),
     PBIO_TEST(test_color_hsv_cost),
+    PBIO_TEST(test_color_bicone_nearest),
+    PBIO_TEST(test_color_calibration),
     END_OF_TESTCASES
 };
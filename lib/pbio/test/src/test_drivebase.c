@@ -183,7 +183,204 @@ end:
     PT_END(pt);
 }
 
+static PT_THREAD(test_drivebase_path(struct pt *pt)) {
+
+    static struct timer timer;
+
+    static pbio_servo_t *srv_left;
+    static pbio_servo_t *srv_right;
+    static pbdrv_legodev_dev_t *legodev_left;
+    static pbdrv_legodev_dev_t *legodev_right;
+    static pbio_drivebase_t *db;
+
+    static int32_t drive_distance;
+    static int32_t drive_speed;
+    static int32_t turn_angle;
+    static int32_t turn_rate;
+
+    // Straight, smooth right turn, left arc, and straight again.
+    static const pbio_drivebase_path_segment_t path[] = {
+        { .distance = 200, .angle = 0 },
+        { .distance = 300, .angle = 90, .smooth = true },
+        { .distance = 300, .angle = -90 },
+        { .distance = 200, .angle = 0 },
+    };
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    // Initialize the servos and the drivebase.
+    pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_A, &id, &legodev_left), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev_left, &srv_left), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv_left, id, PBIO_DIRECTION_COUNTERCLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_B, &id, &legodev_right), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev_right, &srv_right), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv_right, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_get_drivebase(&db, srv_left, srv_right, 56000, 112000), ==, PBIO_SUCCESS);
+
+    // Paths can't be empty or change direction.
+    static const pbio_drivebase_path_segment_t reverse[] = {
+        { .distance = 100, .angle = 0 },
+        { .distance = -100, .angle = 0 },
+    };
+    tt_uint_op(pbio_drivebase_drive_path(db, path, 0, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_ERROR_INVALID_ARG);
+    tt_uint_op(pbio_drivebase_drive_path(db, reverse, 2, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_ERROR_INVALID_ARG);
+
+    tt_uint_op(pbio_drivebase_drive_path(db, path, 4, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+
+    // Halfway along the smooth turn, the robot should have turned about half
+    // way, without slowing down between segments.
+    pbio_test_sleep_until(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate) == PBIO_SUCCESS && drive_distance >= 350);
+    tt_want(pbio_test_int_is_close(turn_angle, 45, 10));
+    tt_want(drive_speed > 100);
+    tt_want(turn_rate > 0);
+
+    // At the end of the turn, the robot should be facing right.
+    pbio_test_sleep_until(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate) == PBIO_SUCCESS && drive_distance >= 500);
+    tt_want(pbio_test_int_is_close(turn_angle, 90, 10));
+    tt_want(drive_speed > 100);
+
+    // Along the arc, it should be turning back at a constant rate.
+    pbio_test_sleep_until(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate) == PBIO_SUCCESS && drive_distance >= 650);
+    tt_want(pbio_test_int_is_close(turn_angle, 45, 10));
+    tt_want(turn_rate < 0);
+    tt_want(!pbio_drivebase_is_done(db));
+
+    // The maneuver completes at the end of the path like any other.
+    pbio_test_sleep_until(pbio_drivebase_is_done(db));
+    pbio_test_sleep_ms(&timer, 200);
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(drive_distance, 1000, 10));
+    tt_want(pbio_test_int_is_close(turn_angle, 0, 3));
+    tt_want(pbio_test_int_is_close(drive_speed, 0, 20));
+
+    // A new command ends path following.
+    tt_uint_op(pbio_drivebase_drive_path(db, path, 4, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_ms(&timer, 500);
+    tt_uint_op(pbio_drivebase_drive_straight(db, 0, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    tt_want(!db->path.active);
+    pbio_test_sleep_until(pbio_drivebase_is_done(db));
+
+end:
+
+    PT_END(pt);
+}
+
+static PT_THREAD(test_drivebase_pose(struct pt *pt)) {
+
+    static pbio_servo_t *srv_left;
+    static pbio_servo_t *srv_right;
+    static pbdrv_legodev_dev_t *legodev_left;
+    static pbdrv_legodev_dev_t *legodev_right;
+    static pbio_drivebase_t *db;
+
+    static float x;
+    static float y;
+    static float angle;
+
+    static int32_t drive_distance;
+    static int32_t drive_speed;
+    static int32_t turn_angle;
+    static int32_t turn_rate;
+    static int32_t reverse_distance;
+    static int32_t kept_distance;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    // Initialize the servos and the drivebase.
+    pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_A, &id, &legodev_left), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev_left, &srv_left), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv_left, id, PBIO_DIRECTION_COUNTERCLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_B, &id, &legodev_right), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev_right, &srv_right), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv_right, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_get_drivebase(&db, srv_left, srv_right, 56000, 112000), ==, PBIO_SUCCESS);
+
+    // The pose starts at the origin.
+    tt_uint_op(pbio_drivebase_get_pose(db, &x, &y, &angle), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(x, 0, 1));
+    tt_want(pbio_test_int_is_close(y, 0, 1));
+    tt_want(pbio_test_int_is_close(angle, 0, 1));
+
+    // Driving straight moves along the x axis.
+    tt_uint_op(pbio_drivebase_drive_straight(db, 500, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_drivebase_is_done(db));
+    tt_uint_op(pbio_drivebase_get_pose(db, &x, &y, &angle), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(x, 500, 5));
+    tt_want(pbio_test_int_is_close(y, 0, 5));
+
+    // Turning clockwise and driving moves along the y axis.
+    tt_uint_op(pbio_drivebase_drive_curve(db, 0, 90, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_drivebase_is_done(db));
+    tt_uint_op(pbio_drivebase_drive_straight(db, 200, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_drivebase_is_done(db));
+    tt_uint_op(pbio_drivebase_get_pose(db, &x, &y, &angle), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(x, 500, 5));
+    tt_want(pbio_test_int_is_close(y, 200, 5));
+    tt_want(pbio_test_int_is_close(angle, 90, 2));
+
+    // Arcs forward to a target ahead and to the side.
+    tt_uint_op(pbio_drivebase_drive_to(db, 300, 500, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_drivebase_is_done(db));
+    tt_uint_op(pbio_drivebase_get_pose(db, &x, &y, &angle), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(x, 300, 10));
+    tt_want(pbio_test_int_is_close(y, 500, 10));
+
+    // Drives back in reverse, since the previous point is now behind the robot.
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_drive_to(db, 500, 200, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_drivebase_is_done(db));
+    tt_uint_op(pbio_drivebase_get_state_user(db, &reverse_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_want_int_op(reverse_distance, <, drive_distance);
+    tt_uint_op(pbio_drivebase_get_pose(db, &x, &y, &angle), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(x, 500, 10));
+    tt_want(pbio_test_int_is_close(y, 200, 10));
+    tt_want(pbio_test_int_is_close(angle, turn_angle, 1));
+
+    // Resetting the pose also resets the angle but not the distance.
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_reset_pose(db, 100, -50, 30), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_get_pose(db, &x, &y, &angle), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(x, 100, 1));
+    tt_want(pbio_test_int_is_close(y, -50, 1));
+    tt_want(pbio_test_int_is_close(angle, 30, 1));
+    tt_uint_op(pbio_drivebase_get_state_user(db, &kept_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_want_int_op(turn_angle, ==, 30);
+    tt_want(pbio_test_int_is_close(kept_distance, drive_distance, 2));
+
+end:
+
+    PT_END(pt);
+}
+
 struct testcase_t pbio_drivebase_tests[] = {
     PBIO_PT_THREAD_TEST(test_drivebase_basics),
+    PBIO_PT_THREAD_TEST(test_drivebase_path),
+    PBIO_PT_THREAD_TEST(test_drivebase_pose),
     END_OF_TESTCASES
 };
@@ -0,0 +1,294 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <pbio/geometry.h>
+#include <pbio/imu.h>
+
+#include <test-pbio.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include "../drv/clock/clock_test.h"
+#include "../drv/imu/imu_test.h"
+
+// Sample rate and raw data scale of the test IMU driver.
+#define SAMPLE_RATE (833)
+#define GYRO_RAW_PER_DPS (1.0f / 0.07f)
+#define ACCEL_RAW_PER_G (1000.0f / 0.244f)
+
+// Unit vector pointing up in the hub frame, used to generate consistent
+// accelerometer data while replaying motions.
+static pbio_geometry_xyz_t up = { .x = 0.0f, .y = 0.0f, .z = 1.0f };
+
+// Frames are replayed in batches, like a driver reading from a FIFO.
+#define BATCH_SIZE (8)
+
+/**
+ * Replays IMU frames of a hub rotating at a constant rate.
+ *
+ * @param [in]  rate        Angular velocity in the hub frame in deg/s.
+ * @param [in]  duration    Duration in seconds.
+ * @param [in]  accel_g     Measured acceleration magnitude in g.
+ */
+static void replay(pbio_geometry_xyz_t *rate, float duration, float accel_g) {
+    int16_t batch[BATCH_SIZE * 6];
+    uint32_t num_frames = 0;
+
+    for (uint32_t n = 0; n < duration * SAMPLE_RATE; n++) {
+
+        // Rotating the hub rotates gravity the opposite way in the hub frame.
+        pbio_geometry_xyz_t delta;
+        pbio_geometry_vector_cross_product(&up, rate, &delta);
+        for (uint8_t i = 0; i < 3; i++) {
+            up.values[i] += delta.values[i] * PBIO_GEOMETRY_RADIANS_PER_DEGREE / SAMPLE_RATE;
+        }
+        pbio_geometry_vector_normalize(&up, &up);
+
+        int16_t *frame = &batch[num_frames * 6];
+        for (uint8_t i = 0; i < 3; i++) {
+            frame[i] = (int16_t)roundf(rate->values[i] * GYRO_RAW_PER_DPS);
+            frame[i + 3] = (int16_t)roundf(up.values[i] * accel_g * ACCEL_RAW_PER_G);
+        }
+
+        if (++num_frames == BATCH_SIZE) {
+            pbdrv_imu_test_replay_frames(batch, num_frames);
+            num_frames = 0;
+        }
+    }
+    pbdrv_imu_test_replay_frames(batch, num_frames);
+}
+
+static bool is_close(float value, float target, float tolerance) {
+    return fabsf(value - target) <= tolerance;
+}
+
+/**
+ * Test attitude estimation with tilt and heading changes.
+ */
+static void test_imu_attitude(void *env) {
+
+    pbio_imu_init();
+
+    pbio_geometry_xyz_t tilt;
+    pbio_geometry_matrix_3x3_t orientation;
+    pbio_geometry_xyz_t still = { .x = 0.0f, .y = 0.0f, .z = 0.0f };
+
+    // Start level and stationary.
+    replay(&still, 1.0f, 1.0f);
+    pbio_imu_get_tilt_vector(&tilt);
+    tt_want(is_close(tilt.z, 1.0f, 0.001f));
+    tt_want_int_op(pbio_imu_get_up_side(), ==, PBIO_GEOMETRY_SIDE_TOP);
+    tt_want(is_close(pbio_imu_get_heading(), 0.0f, 0.1f));
+
+    // Tilt by 35 degrees about the x-axis.
+    pbio_geometry_xyz_t roll = { .x = 35.0f, .y = 0.0f, .z = 0.0f };
+    replay(&roll, 1.0f, 1.0f);
+    pbio_imu_get_tilt_vector(&tilt);
+    float s = sinf(35 * PBIO_GEOMETRY_RADIANS_PER_DEGREE);
+    float c = cosf(35 * PBIO_GEOMETRY_RADIANS_PER_DEGREE);
+    tt_want(is_close(tilt.x, 0.0f, 0.01f));
+    tt_want(is_close(tilt.y, s, 0.01f));
+    tt_want(is_close(tilt.z, c, 0.01f));
+    tt_want(is_close(pbio_imu_get_heading(), 0.0f, 0.5f));
+
+    // Turn left by 90 degrees around the vertical while still tilted. The
+    // heading follows the full turn even though the hub is not level.
+    pbio_geometry_xyz_t yaw = { .x = 0.0f, .y = 45.0f * s, .z = 45.0f * c };
+    replay(&yaw, 2.0f, 1.0f);
+    tt_want(is_close(pbio_imu_get_heading(), -90.0f, 1.0f));
+    pbio_imu_get_tilt_vector(&tilt);
+    tt_want(is_close(tilt.y, s, 0.01f));
+    tt_want(is_close(tilt.z, c, 0.01f));
+
+    // The hub x-axis now points along the inertial y-axis.
+    pbio_imu_get_orientation(&orientation);
+    tt_want(is_close(orientation.m11, 0.0f, 0.02f));
+    tt_want(is_close(orientation.m21, 1.0f, 0.02f));
+    tt_want(is_close(orientation.m31, 0.0f, 0.02f));
+
+    // Large shocks are not mistaken for tilt.
+    replay(&still, 0.5f, 3.0f);
+    pbio_imu_get_tilt_vector(&tilt);
+    tt_want(is_close(tilt.y, s, 0.01f));
+    tt_want(is_close(tilt.z, c, 0.01f));
+
+    // The estimate converges to the accelerometer if the gyro was off.
+    up.y = 0.0f;
+    up.z = 1.0f;
+    replay(&still, 10.0f, 1.0f);
+    pbio_imu_get_tilt_vector(&tilt);
+    tt_want(is_close(tilt.z, 1.0f, 0.01f));
+
+    // Turn upside down.
+    pbio_geometry_xyz_t flip = { .x = 0.0f, .y = 90.0f, .z = 0.0f };
+    replay(&flip, 2.0f, 1.0f);
+    replay(&still, 1.0f, 1.0f);
+    tt_want_int_op(pbio_imu_get_up_side(), ==, PBIO_GEOMETRY_SIDE_BOTTOM);
+
+    // Tilt is given relative to the base orientation, here with the hub
+    // mounted upside down.
+    pbio_geometry_xyz_t front = { .x = 1.0f, .y = 0.0f, .z = 0.0f };
+    pbio_geometry_xyz_t top = { .x = 0.0f, .y = 0.0f, .z = -1.0f };
+    tt_want_int_op(pbio_imu_set_base_orientation(&front, &top), ==, PBIO_SUCCESS);
+    pbio_imu_get_tilt_vector(&tilt);
+    tt_want(is_close(tilt.z, 1.0f, 0.01f));
+    pbio_imu_get_orientation(&orientation);
+    tt_want(is_close(orientation.m33, 1.0f, 0.02f));
+    tt_want(is_close(pbio_imu_get_heading(), 0.0f, 0.1f));
+}
+
+/**
+ * Replays one second of stationary data with the given raw gyro bias.
+ */
+static void replay_stationary(int32_t bias_z) {
+    int32_t gyro_sum[3] = {0, 0, bias_z * SAMPLE_RATE};
+    int32_t accel_sum[3] = {0, 0, (int32_t)ACCEL_RAW_PER_G * SAMPLE_RATE};
+    pbdrv_imu_test_replay_stationary(gyro_sum, accel_sum, SAMPLE_RATE);
+}
+
+/**
+ * Test learning, storing, and restoring a temperature compensated gyro bias.
+ */
+static void test_imu_calibration(void *env) {
+
+    pbio_imu_init();
+    pbdrv_imu_test_set_stationary(true);
+
+    pbio_geometry_xyz_t bias;
+    pbio_geometry_xyz_t rate;
+    int16_t frame[6] = {0, 0, 0, 0, 0, (int16_t)ACCEL_RAW_PER_G};
+
+    // Not ready until it has been stationary.
+    tt_want(!pbio_imu_is_ready());
+
+    // Learn a bias of 1.4 deg/s at 25 degrees.
+    pbdrv_imu_test_set_temperature(25.0f);
+    for (uint32_t i = 0; i < 10; i++) {
+        replay_stationary(20);
+    }
+    tt_want(pbio_imu_is_ready());
+    pbio_imu_get_gyro_bias(&bias);
+    tt_want(is_close(bias.z, 1.4f, 0.001f));
+
+    // Learn a bias of 2.1 deg/s at 35 degrees.
+    pbdrv_imu_test_set_temperature(35.0f);
+    for (uint32_t i = 0; i < 30; i++) {
+        replay_stationary(30);
+    }
+    pbio_imu_get_gyro_bias(&bias);
+    tt_want(is_close(bias.z, 2.1f, 0.001f));
+
+    // While moving at 30 degrees, the bias is compensated by interpolation.
+    pbdrv_imu_test_set_stationary(false);
+    pbdrv_imu_test_set_temperature(30.0f);
+    frame[2] = 25;
+    pbdrv_imu_test_replay_frames(frame, 1);
+    pbio_imu_get_gyro_bias(&bias);
+    tt_want(is_close(bias.z, 1.75f, 0.001f));
+    pbio_imu_get_angular_velocity(&rate);
+    tt_want(is_close(rate.z, 0.0f, 0.001f));
+
+    // Stored calibration is ready right away after reboot.
+    pbio_imu_calibration_t calibration;
+    pbio_imu_get_calibration(&calibration);
+    pbio_imu_init();
+    tt_want(!pbio_imu_is_ready());
+    tt_want_int_op(pbio_imu_set_calibration(&calibration), ==, PBIO_SUCCESS);
+    tt_want(pbio_imu_is_ready());
+    pbdrv_imu_test_set_temperature(40.0f);
+    pbdrv_imu_test_replay_frames(frame, 1);
+    pbio_imu_get_gyro_bias(&bias);
+    tt_want(is_close(bias.z, 2.45f, 0.001f));
+
+    // Small changes are not worth saving, but a different bias is.
+    pbio_imu_calibration_t stored = calibration;
+    tt_want(!pbio_imu_calibration_changed(&stored));
+    stored.gyro_bias.z += 0.01f;
+    tt_want(!pbio_imu_calibration_changed(&stored));
+    stored.gyro_bias.z += 0.1f;
+    tt_want(pbio_imu_calibration_changed(&stored));
+
+    // So is a calibration that is now ready but wasn't before.
+    stored = calibration;
+    stored.num_samples = 0;
+    tt_want(pbio_imu_calibration_changed(&stored));
+
+    // Corrupt calibrations are rejected.
+    calibration.gyro_bias.z = NAN;
+    tt_want_int_op(pbio_imu_set_calibration(&calibration), ==, PBIO_ERROR_INVALID_ARG);
+    pbio_imu_get_gyro_bias(&bias);
+    tt_want(is_close(bias.z, 2.45f, 0.001f));
+
+    // A stored calibration doesn't make a broken IMU ready.
+    pbio_imu_get_calibration(&calibration);
+    pbdrv_imu_test_set_init_failed(true);
+    pbio_imu_init();
+    tt_want_int_op(pbio_imu_set_calibration(&calibration), ==, PBIO_SUCCESS);
+    tt_want(!pbio_imu_is_ready());
+    pbdrv_imu_test_set_init_failed(false);
+}
+
+/**
+ * Replays batches of frames of the hub turning at 100 deg/s around the
+ * vertical, advancing the clock by the given time for each batch.
+ */
+static void replay_turn(uint32_t num_batches, uint32_t num_frames, uint32_t batch_time) {
+    int16_t batch[5 * 6];
+    for (uint32_t n = 0; n < num_frames; n++) {
+        int16_t frame[6] = {0, 0, (int16_t)roundf(100.0f * GYRO_RAW_PER_DPS), 0, 0, (int16_t)ACCEL_RAW_PER_G};
+        memcpy(&batch[n * 6], frame, sizeof(frame));
+    }
+    for (uint32_t i = 0; i < num_batches; i++) {
+        pbio_test_clock_tick(batch_time);
+        pbdrv_imu_test_replay_frames(batch, num_frames);
+    }
+}
+
+/**
+ * Test that the heading follows the frame timestamps and is extrapolated to
+ * the current time for the drive base controller.
+ */
+static void test_imu_heading_timing(void *env) {
+
+    pbio_imu_init();
+
+    pbio_angle_t heading;
+    pbio_angle_t heading_start;
+    int32_t heading_rate;
+
+    // Frames at the nominal rate, one batch of 5 frames every 6 ms.
+    replay_turn(1, 5, 6);
+    pbio_imu_set_heading(0.0f);
+    replay_turn(100, 5, 6);
+    tt_want(is_close(pbio_imu_get_heading(), -60.0f, 0.1f));
+
+    // The actual time between frames is used, here 1.5 ms per frame.
+    replay_turn(100, 4, 6);
+    tt_want(is_close(pbio_imu_get_heading(), -120.0f, 0.1f));
+
+    // In control units of millidegrees, the heading is extrapolated to the
+    // current time using the most recent rate.
+    pbio_imu_get_heading_scaled(&heading_start, &heading_rate, 1000);
+    tt_want(pbio_test_int_is_close(heading_rate, -100000, 100));
+    pbio_test_clock_tick(3);
+    pbio_imu_get_heading_scaled(&heading, &heading_rate, 1000);
+    tt_want(pbio_test_int_is_close(pbio_angle_diff_mdeg(&heading, &heading_start), -300, 5));
+
+    // But not if no frames arrive for a long time.
+    pbio_test_clock_tick(20);
+    pbio_imu_get_heading_scaled(&heading, &heading_rate, 1000);
+    tt_want(pbio_test_int_is_close(pbio_angle_diff_mdeg(&heading, &heading_start), 0, 5));
+}
+
+struct testcase_t pbio_imu_tests[] = {
+    PBIO_TEST(test_imu_attitude),
+    PBIO_TEST(test_imu_calibration),
+    PBIO_TEST(test_imu_heading_timing),
+    END_OF_TESTCASES
+};
@@ -33,13 +33,18 @@ static const uint8_t test_animation[] = {
 };
 
 static uint8_t test_light_matrix_set_pixel_last_brightness[MATRIX_SIZE][MATRIX_SIZE];
+static uint32_t test_light_matrix_set_pixel_count;
 
-static void test_light_matrix_reset(void) {
+// Clears the test driver. This changes the lights without using the frame,
+// so the light matrix is told to send all pixels again.
+static void test_light_matrix_reset(pbio_light_matrix_t *light_matrix) {
     memset(test_light_matrix_set_pixel_last_brightness, 0, DATA_SIZE);
+    pbio_light_matrix_invalidate(light_matrix);
 }
 
 static pbio_error_t test_light_matrix_set_pixel(pbio_light_matrix_t *light_matrix, uint8_t row, uint8_t col, uint8_t brightness) {
     test_light_matrix_set_pixel_last_brightness[row][col] = brightness;
+    test_light_matrix_set_pixel_count++;
     return PBIO_SUCCESS;
 }
 
@@ -57,7 +62,7 @@ static PT_THREAD(test_light_matrix(struct pt *pt)) {
     tt_want_uint_op(pbio_light_matrix_get_size(&test_light_matrix), ==, MATRIX_SIZE);
 
     // set pixel should only set one pixel
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     tt_want_uint_op(pbio_light_matrix_set_pixel(&test_light_matrix, 0, 0, 100), ==, PBIO_SUCCESS);
     tt_want_light_matrix_data(100, 0, 0, 0, 0, 0, 0, 0, 0);
 
@@ -72,19 +77,19 @@ static PT_THREAD(test_light_matrix(struct pt *pt)) {
     tt_want_light_matrix_data(100, 0, 0, 0, 0, 0, 0, 0, 100);
 
     // bitwise mapping
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     tt_want_uint_op(pbio_light_matrix_set_rows(&test_light_matrix, ROW_DATA(0b100, 0b010, 0b001)), ==, PBIO_SUCCESS);
     tt_want_light_matrix_data(100, 0, 0, 0, 100, 0, 0, 0, 100);
 
     // bytewise mapping
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
         IMAGE_DATA(1, 2, 3, 4, 5, 6, 7, 8, 9)), ==, PBIO_SUCCESS);
     tt_want_light_matrix_data(1, 2, 3, 4, 5, 6, 7, 8, 9);
 
     // starting animation should schedule timer event at 0 ms to call
     // set_pixel() after handling pending events.
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     pbio_light_matrix_start_animation(&test_light_matrix, test_animation, 2, INTERVAL);
     pbio_handle_pending_events();
     tt_want_light_matrix_data(1, 2, 3, 4, 5, 6, 7, 8, 9);
@@ -109,7 +114,7 @@ static PT_THREAD(test_light_matrix(struct pt *pt)) {
     tt_want_light_matrix_data(1, 2, 3, 4, 5, 6, 7, 8, 9);
 
     // stopping the animation should not change any pixels
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     pbio_light_matrix_stop_animation(&test_light_matrix);
     pbio_test_clock_tick(INTERVAL * 2);
     PT_YIELD(pt);
@@ -123,7 +128,7 @@ static void test_light_matrix_rotation(void *env) {
     pbio_light_matrix_init(&test_light_matrix, MATRIX_SIZE, &test_light_matrix_funcs);
 
     // Default orientation has pixels in same order as underlying light array
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
         IMAGE_DATA(1, 2, 3, 4, 5, 6, 7, 8, 9)), ==, PBIO_SUCCESS);
     tt_want_light_matrix_data(
@@ -133,7 +138,7 @@ static void test_light_matrix_rotation(void *env) {
 
     // Check that other orientations work
 
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     pbio_light_matrix_set_orientation(&test_light_matrix, PBIO_GEOMETRY_SIDE_LEFT);
     tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
         IMAGE_DATA(1, 2, 3, 4, 5, 6, 7, 8, 9)), ==, PBIO_SUCCESS);
@@ -142,7 +147,7 @@ static void test_light_matrix_rotation(void *env) {
         2, 5, 8,
         1, 4, 7);
 
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     pbio_light_matrix_set_orientation(&test_light_matrix, PBIO_GEOMETRY_SIDE_BOTTOM);
     tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
         IMAGE_DATA(1, 2, 3, 4, 5, 6, 7, 8, 9)), ==, PBIO_SUCCESS);
@@ -151,7 +156,7 @@ static void test_light_matrix_rotation(void *env) {
         6, 5, 4,
         3, 2, 1);
 
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     pbio_light_matrix_set_orientation(&test_light_matrix, PBIO_GEOMETRY_SIDE_RIGHT);
     tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
         IMAGE_DATA(1, 2, 3, 4, 5, 6, 7, 8, 9)), ==, PBIO_SUCCESS);
@@ -161,7 +166,7 @@ static void test_light_matrix_rotation(void *env) {
         9, 6, 3);
 
     // front is same as top
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     pbio_light_matrix_set_orientation(&test_light_matrix, PBIO_GEOMETRY_SIDE_FRONT);
     tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
         IMAGE_DATA(1, 2, 3, 4, 5, 6, 7, 8, 9)), ==, PBIO_SUCCESS);
@@ -171,7 +176,7 @@ static void test_light_matrix_rotation(void *env) {
         7, 8, 9);
 
     // back is same as bottom
-    test_light_matrix_reset();
+    test_light_matrix_reset(&test_light_matrix);
     pbio_light_matrix_set_orientation(&test_light_matrix, PBIO_GEOMETRY_SIDE_BACK);
     tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
         IMAGE_DATA(1, 2, 3, 4, 5, 6, 7, 8, 9)), ==, PBIO_SUCCESS);
@@ -181,8 +186,127 @@ static void test_light_matrix_rotation(void *env) {
         3, 2, 1);
 }
 
+static void test_light_matrix_flush(void *env) {
+    static pbio_light_matrix_t test_light_matrix;
+    pbio_light_matrix_init(&test_light_matrix, MATRIX_SIZE, &test_light_matrix_funcs);
+    test_light_matrix_reset(&test_light_matrix);
+
+    // The first update sends all pixels.
+    test_light_matrix_set_pixel_count = 0;
+    tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
+        IMAGE_DATA(1, 2, 3, 4, 5, 6, 7, 8, 9)), ==, PBIO_SUCCESS);
+    tt_want_int_op(test_light_matrix_set_pixel_count, ==, DATA_SIZE);
+
+    // Showing the same image again sends nothing.
+    test_light_matrix_set_pixel_count = 0;
+    tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
+        IMAGE_DATA(1, 2, 3, 4, 5, 6, 7, 8, 9)), ==, PBIO_SUCCESS);
+    tt_want_int_op(test_light_matrix_set_pixel_count, ==, 0);
+
+    // Only changed pixels are sent.
+    tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
+        IMAGE_DATA(1, 2, 3, 4, 50, 6, 7, 8, 90)), ==, PBIO_SUCCESS);
+    tt_want_int_op(test_light_matrix_set_pixel_count, ==, 2);
+    tt_want_light_matrix_data(1, 2, 3, 4, 50, 6, 7, 8, 90);
+
+    // Also when the orientation changes.
+    test_light_matrix_set_pixel_count = 0;
+    pbio_light_matrix_set_orientation(&test_light_matrix, PBIO_GEOMETRY_SIDE_BOTTOM);
+    tt_want_uint_op(pbio_light_matrix_set_image(&test_light_matrix,
+        IMAGE_DATA(90, 8, 7, 6, 50, 4, 3, 2, 1)), ==, PBIO_SUCCESS);
+    tt_want_int_op(test_light_matrix_set_pixel_count, ==, 0);
+    tt_want_uint_op(pbio_light_matrix_set_pixel(&test_light_matrix, 0, 0, 100), ==, PBIO_SUCCESS);
+    tt_want_int_op(test_light_matrix_set_pixel_count, ==, 1);
+    tt_want_light_matrix_data(1, 2, 3, 4, 50, 6, 7, 8, 100);
+
+    // Filling the matrix changes all but the pixel that is already set.
+    test_light_matrix_set_pixel_count = 0;
+    tt_want_uint_op(pbio_light_matrix_fill(&test_light_matrix, 100), ==, PBIO_SUCCESS);
+    tt_want_int_op(test_light_matrix_set_pixel_count, ==, DATA_SIZE - 1);
+    tt_want_light_matrix_data(100, 100, 100, 100, 100, 100, 100, 100, 100);
+}
+
+static void test_light_matrix_compose(void *env) {
+    static pbio_light_matrix_t test_light_matrix;
+    pbio_light_matrix_init(&test_light_matrix, MATRIX_SIZE, &test_light_matrix_funcs);
+    test_light_matrix_reset(&test_light_matrix);
+    tt_want_uint_op(pbio_light_matrix_clear(&test_light_matrix), ==, PBIO_SUCCESS);
+
+    // Drawing does not show anything until the frame is flushed.
+    test_light_matrix_set_pixel_count = 0;
+    static const uint8_t block[] = {
+        10, 20,
+        30, 0,
+    };
+    pbio_light_matrix_blit(&test_light_matrix, block, 2, 2, 0, 0, PBIO_LIGHT_MATRIX_BLEND_REPLACE);
+    tt_want_int_op(test_light_matrix_set_pixel_count, ==, 0);
+    tt_want_uint_op(pbio_light_matrix_flush(&test_light_matrix), ==, PBIO_SUCCESS);
+    tt_want_int_op(test_light_matrix_set_pixel_count, ==, 3);
+    tt_want_light_matrix_data(
+        10, 20, 0,
+        30, 0, 0,
+        0, 0, 0);
+
+    // Images are clipped at the edges.
+    pbio_light_matrix_blit(&test_light_matrix, block, 2, 2, 2, -1, PBIO_LIGHT_MATRIX_BLEND_REPLACE);
+    pbio_light_matrix_blit(&test_light_matrix, block, 2, 2, -5, 5, PBIO_LIGHT_MATRIX_BLEND_REPLACE);
+    tt_want_uint_op(pbio_light_matrix_flush(&test_light_matrix), ==, PBIO_SUCCESS);
+    tt_want_light_matrix_data(
+        10, 20, 0,
+        30, 0, 0,
+        20, 0, 0);
+
+    // Layers can be drawn over each other with transparency.
+    pbio_light_matrix_blit(&test_light_matrix, block, 2, 2, 1, 1, PBIO_LIGHT_MATRIX_BLEND_OVER);
+    tt_want_uint_op(pbio_light_matrix_flush(&test_light_matrix), ==, PBIO_SUCCESS);
+    tt_want_light_matrix_data(
+        10, 20, 0,
+        30, 10, 20,
+        20, 30, 0);
+
+    // Or keep the brightest pixels.
+    static const uint8_t dim[] = {
+        15, 15, 15,
+        15, 15, 15,
+        15, 15, 15,
+    };
+    pbio_light_matrix_blit(&test_light_matrix, dim, 3, 3, 0, 0, PBIO_LIGHT_MATRIX_BLEND_MAX);
+    tt_want_uint_op(pbio_light_matrix_flush(&test_light_matrix), ==, PBIO_SUCCESS);
+    tt_want_light_matrix_data(
+        15, 20, 15,
+        30, 15, 20,
+        20, 30, 15);
+
+    // Scrolling shifts in pixels that are off.
+    pbio_light_matrix_scroll(&test_light_matrix, 0, -1);
+    tt_want_uint_op(pbio_light_matrix_flush(&test_light_matrix), ==, PBIO_SUCCESS);
+    tt_want_light_matrix_data(
+        20, 15, 0,
+        15, 20, 0,
+        30, 15, 0);
+
+    pbio_light_matrix_scroll(&test_light_matrix, 1, 1);
+    tt_want_uint_op(pbio_light_matrix_flush(&test_light_matrix), ==, PBIO_SUCCESS);
+    tt_want_light_matrix_data(
+        0, 0, 0,
+        0, 20, 15,
+        0, 15, 20);
+
+    // Drawing and scrolling follow the orientation.
+    pbio_light_matrix_set_orientation(&test_light_matrix, PBIO_GEOMETRY_SIDE_LEFT);
+    pbio_light_matrix_scroll(&test_light_matrix, 0, -1);
+    pbio_light_matrix_blit(&test_light_matrix, block, 1, 1, 0, 0, PBIO_LIGHT_MATRIX_BLEND_REPLACE);
+    tt_want_uint_op(pbio_light_matrix_flush(&test_light_matrix), ==, PBIO_SUCCESS);
+    tt_want_light_matrix_data(
+        0, 0, 0,
+        0, 0, 0,
+        10, 20, 15);
+}
+
 struct testcase_t pbio_light_matrix_tests[] = {
     PBIO_PT_THREAD_TEST(test_light_matrix),
     PBIO_TEST(test_light_matrix_rotation),
+    PBIO_TEST(test_light_matrix_flush),
+    PBIO_TEST(test_light_matrix_compose),
     END_OF_TESTCASES
 };
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <contiki.h>
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <pbdrv/motor_driver.h>
+#include <pbio/control.h>
+#include <pbio/error.h>
+#include <pbio/int_math.h>
+#include <pbio/motion_group.h>
+#include <pbio/motor_process.h>
+#include <pbio/servo.h>
+#include <test-pbio.h>
+
+#include "../src/processes.h"
+#include "../drv/core.h"
+#include "../drv/clock/clock_test.h"
+#include "../drv/motor_driver/motor_driver_virtual_simulation.h"
+
+static PT_THREAD(test_motion_group_basics(struct pt *pt)) {
+
+    static struct timer timer;
+
+    static const pbio_port_id_t ports[] = {PBIO_PORT_ID_A, PBIO_PORT_ID_B, PBIO_PORT_ID_F};
+    static pbio_servo_t *servos[3];
+    static pbio_motion_group_t *group;
+    static pbio_motion_group_t *other;
+
+    static int32_t angle[3];
+    static int32_t speed;
+    static bool stalled;
+    static uint32_t stall_duration;
+
+    static pbio_dcmotor_actuation_t actuation;
+    static int32_t voltage;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    // Initialize the servos.
+    for (uint8_t i = 0; i < 3; i++) {
+        pbdrv_legodev_dev_t *legodev;
+        pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+        tt_uint_op(pbdrv_legodev_get_device(ports[i], &id, &legodev), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_get_servo(legodev, &servos[i]), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_setup(servos[i], id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    }
+
+    // A servo can only be used once, and only in one group.
+    pbio_servo_t *duplicate[] = {servos[0], servos[0]};
+    tt_uint_op(pbio_motion_group_get_motion_group(&group, duplicate, 2), ==, PBIO_ERROR_INVALID_ARG);
+    tt_uint_op(pbio_motion_group_get_motion_group(&group, servos, 3), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_motion_group_get_motion_group(&other, servos, 2), ==, PBIO_ERROR_BUSY);
+    tt_uint_op(pbio_motion_group_is_stalled(group, &stalled, &stall_duration), ==, PBIO_SUCCESS);
+    tt_want(!stalled);
+
+    // Axes with different distances should all take as long as the slowest.
+    static const int32_t targets[] = {720, 180, -360};
+    tt_uint_op(pbio_motion_group_move_to(group, targets, 500, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    for (uint8_t i = 1; i < 3; i++) {
+        tt_want_int_op(pbio_trajectory_get_duration(&group->control[i].trajectory), ==,
+            pbio_trajectory_get_duration(&group->control[0].trajectory));
+    }
+
+    // So they move in proportion.
+    pbio_test_sleep_ms(&timer, 700);
+    for (uint8_t i = 0; i < 3; i++) {
+        tt_uint_op(pbio_servo_get_state_user(servos[i], &angle[i], &speed), ==, PBIO_SUCCESS);
+    }
+    tt_want(!pbio_motion_group_is_done(group));
+    tt_want(pbio_test_int_is_close(angle[0] * 100 / targets[0], angle[1] * 100 / targets[1], 20));
+    tt_want(pbio_test_int_is_close(angle[0] * 100 / targets[0], angle[2] * 100 / targets[2], 20));
+
+    // All axes should arrive at their targets.
+    pbio_test_sleep_until(pbio_motion_group_is_done(group));
+    for (uint8_t i = 0; i < 3; i++) {
+        tt_uint_op(pbio_servo_get_state_user(servos[i], &angle[i], &speed), ==, PBIO_SUCCESS);
+        tt_want(pbio_test_int_is_close(angle[i], targets[i], 5));
+    }
+
+    // Relative moves work the same way.
+    static const int32_t distances[] = {-90, 0, 90};
+    tt_uint_op(pbio_motion_group_move_by(group, distances, 0, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_motion_group_is_done(group));
+    for (uint8_t i = 0; i < 3; i++) {
+        tt_uint_op(pbio_servo_get_state_user(servos[i], &angle[i], &speed), ==, PBIO_SUCCESS);
+        tt_want(pbio_test_int_is_close(angle[i], targets[i] + distances[i], 5));
+    }
+
+    // Stopping a single servo should stop the whole group.
+    pbio_dcmotor_get_state(servos[2]->dcmotor, &actuation, &voltage);
+    tt_uint_op(actuation, ==, PBIO_DCMOTOR_ACTUATION_VOLTAGE);
+    tt_uint_op(pbio_servo_stop(servos[0], PBIO_CONTROL_ON_COMPLETION_COAST), ==, PBIO_SUCCESS);
+    for (uint8_t i = 0; i < 3; i++) {
+        pbio_dcmotor_get_state(servos[i]->dcmotor, &actuation, &voltage);
+        tt_uint_op(actuation, ==, PBIO_DCMOTOR_ACTUATION_COAST);
+    }
+
+    // Closing any motor should make group operations invalid.
+    tt_uint_op(pbio_dcmotor_close(servos[1]->dcmotor), ==, PBIO_SUCCESS);
+    pbio_test_sleep_ms(&timer, 100);
+    tt_uint_op(pbio_motion_group_is_stalled(group, &stalled, &stall_duration), ==, PBIO_ERROR_INVALID_OP);
+
+end:
+
+    PT_END(pt);
+}
+
+struct testcase_t pbio_motion_group_tests[] = {
+    PBIO_PT_THREAD_TEST(test_motion_group_basics),
+    END_OF_TESTCASES
+};
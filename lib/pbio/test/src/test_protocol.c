@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <pbio/protocol.h>
+#include <test-pbio.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+/**
+ * Test splitting a broadcast message into fragments and reassembling it,
+ * including when fragments are missed or a new message starts.
+ */
+static void test_broadcast_fragments(void *env) {
+    uint8_t message[60];
+    for (uint32_t i = 0; i < sizeof(message); i++) {
+        message[i] = i;
+    }
+
+    // Three fragments, the last one partially filled.
+    uint8_t fragments[3][PBIO_BROADCAST_DATA_MAX_SIZE];
+    uint8_t sizes[3];
+    tt_want_int_op(pbio_broadcast_get_num_fragments(sizeof(message)), ==, 3);
+    for (uint8_t i = 0; i < 3; i++) {
+        sizes[i] = pbio_broadcast_get_fragment(fragments[i], message, sizeof(message), 5, i);
+    }
+    tt_want_int_op(sizes[0], ==, PBIO_BROADCAST_DATA_MAX_SIZE);
+    tt_want_int_op(sizes[1], ==, PBIO_BROADCAST_DATA_MAX_SIZE);
+    tt_want_int_op(sizes[2], ==, PBIO_BROADCAST_FRAGMENT_HEADER_SIZE + 60 - 2 * PBIO_BROADCAST_FRAGMENT_DATA_SIZE);
+
+    pbio_broadcast_reassembly_t reassembly;
+    pbio_broadcast_reassembly_reset(&reassembly);
+
+    // The message is complete once all fragments are received.
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[0], sizes[0]));
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[1], sizes[1]));
+    tt_want(pbio_broadcast_reassemble(&reassembly, fragments[2], sizes[2]));
+    tt_want_int_op(reassembly.size, ==, sizeof(message));
+    tt_want_int_op(memcmp(reassembly.data, message, sizeof(message)), ==, 0);
+
+    // Fragments keep being broadcast, but the message completes only once.
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[0], sizes[0]));
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[2], sizes[2]));
+
+    // A new message with a missed fragment is completed in the next cycle.
+    message[30] = 0xFF;
+    for (uint8_t i = 0; i < 3; i++) {
+        sizes[i] = pbio_broadcast_get_fragment(fragments[i], message, sizeof(message), 6, i);
+    }
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[0], sizes[0]));
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[2], sizes[2]));
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[0], sizes[0]));
+    tt_want(pbio_broadcast_reassemble(&reassembly, fragments[1], sizes[1]));
+    tt_want_int_op(reassembly.size, ==, sizeof(message));
+    tt_want_int_op(memcmp(reassembly.data, message, sizeof(message)), ==, 0);
+
+    // A partial message is discarded when a newer one starts, so fragments
+    // of different messages are never combined.
+    uint8_t size = pbio_broadcast_get_fragment(fragments[0], message, sizeof(message), 7, 0);
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[0], size));
+    message[0] = 0xFF;
+    size = pbio_broadcast_get_fragment(fragments[0], message, 40, 8, 0);
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[0], size));
+    size = pbio_broadcast_get_fragment(fragments[1], message, 40, 8, 1);
+    tt_want(pbio_broadcast_reassemble(&reassembly, fragments[1], size));
+    tt_want_int_op(reassembly.size, ==, 40);
+    tt_want_int_op(memcmp(reassembly.data, message, 40), ==, 0);
+
+    // Invalid fragments are ignored.
+    pbio_broadcast_reassembly_reset(&reassembly);
+    size = pbio_broadcast_get_fragment(fragments[0], message, 40, 9, 0);
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[0], size - 1));
+    fragments[0][2] = PBIO_BROADCAST_FRAGMENT_MAX_NUM + 1;
+    tt_want(!pbio_broadcast_reassemble(&reassembly, fragments[0], size));
+    tt_want_int_op(reassembly.num_fragments, ==, 0);
+}
+
+struct testcase_t pbio_protocol_tests[] = {
+    PBIO_TEST(test_broadcast_fragments),
+    END_OF_TESTCASES
+};
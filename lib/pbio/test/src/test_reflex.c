@@ -0,0 +1,420 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <contiki.h>
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <pbdrv/legodev.h>
+#include <pbdrv/motor_driver.h>
+#include <pbio/control.h>
+#include <pbio/drivebase.h>
+#include <pbio/error.h>
+#include <pbio/motor_process.h>
+#include <pbio/reflex.h>
+#include <pbio/servo.h>
+#include <pbio/util.h>
+#include <test-pbio.h>
+
+#include "../src/processes.h"
+#include "../drv/core.h"
+#include "../drv/clock/clock_test.h"
+#include "../drv/legodev/legodev_test.h"
+#include "../drv/motor_driver/motor_driver_virtual_simulation.h"
+
+static PT_THREAD(test_reflex_servo(struct pt *pt)) {
+
+    static struct timer timer;
+
+    static const pbio_port_id_t ports[] = {PBIO_PORT_ID_A, PBIO_PORT_ID_B};
+    static pbio_servo_t *servos[2];
+    static pbio_reflex_t *reflex;
+    static pbio_reflex_t *other;
+
+    static int32_t angle;
+    static int32_t speed;
+    static int32_t value;
+    static int32_t output;
+
+    static pbio_dcmotor_actuation_t actuation;
+    static int32_t voltage;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    // Initialize the servos.
+    for (uint8_t i = 0; i < 2; i++) {
+        pbdrv_legodev_dev_t *legodev;
+        pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+        tt_uint_op(pbdrv_legodev_get_device(ports[i], &id, &legodev), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_get_servo(legodev, &servos[i]), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_setup(servos[i], id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    }
+
+    // Use the angle of a servo to drive that same servo, making a simple
+    // position controller that runs entirely within the reflex.
+    static pbio_reflex_input_t input;
+    input.type = PBIO_REFLEX_INPUT_SERVO;
+    input.servo = servos[0];
+    static pbio_reflex_settings_t settings = {
+        .target = 90,
+        .kp = 2000,
+        .ki = 2000,
+        .kd = 20,
+        .limit = 100,
+    };
+
+    // Invalid settings are rejected.
+    settings.limit = -1;
+    tt_uint_op(pbio_reflex_start_servo(&reflex, &input, &settings, servos[0]), ==, PBIO_ERROR_INVALID_ARG);
+
+    // The limit of a servo output can't exceed the duty cycle range.
+    settings.limit = 200;
+    tt_uint_op(pbio_reflex_start_servo(&reflex, &input, &settings, servos[0]), ==, PBIO_SUCCESS);
+    tt_want(pbio_reflex_is_active(reflex));
+    tt_want_int_op(reflex->settings.limit, ==, 100);
+
+    // A servo can only be driven by one reflex at a time.
+    tt_uint_op(pbio_reflex_start_servo(&other, &input, &settings, servos[0]), ==, PBIO_ERROR_BUSY);
+
+    // The servo should settle at the target.
+    pbio_test_sleep_ms(&timer, 3000);
+    tt_uint_op(pbio_servo_get_state_user(servos[0], &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, 90, 5));
+    pbio_reflex_get_state(reflex, &value, &output);
+    tt_want(pbio_test_int_is_close(value, angle, 5));
+    pbio_dcmotor_get_state(servos[0]->dcmotor, &actuation, &voltage);
+    tt_uint_op(actuation, ==, PBIO_DCMOTOR_ACTUATION_VOLTAGE);
+
+    // A new target takes effect without going through the user program.
+    reflex->settings.target = -90;
+    pbio_test_sleep_ms(&timer, 3000);
+    tt_uint_op(pbio_servo_get_state_user(servos[0], &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, -90, 5));
+
+    // Giving the servo another command stops the reflex and frees the servo.
+    tt_uint_op(pbio_servo_run_forever(servos[0], 500), ==, PBIO_SUCCESS);
+    tt_want(!pbio_reflex_is_active(reflex));
+    tt_want(!pbio_parent_exists(&servos[0]->parent));
+    pbio_test_sleep_ms(&timer, 500);
+    tt_uint_op(pbio_servo_get_state_user(servos[0], &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(speed, 500, 50));
+
+    // Use one servo to drive another, and then stop the reflex.
+    settings.target = 0;
+    tt_uint_op(pbio_reflex_start_servo(&reflex, &input, &settings, servos[1]), ==, PBIO_SUCCESS);
+    pbio_test_sleep_ms(&timer, 100);
+    pbio_dcmotor_get_state(servos[1]->dcmotor, &actuation, &voltage);
+    tt_uint_op(actuation, ==, PBIO_DCMOTOR_ACTUATION_VOLTAGE);
+    tt_want_int_op(voltage, <, 0);
+    tt_uint_op(pbio_reflex_stop(reflex), ==, PBIO_SUCCESS);
+    tt_want(!pbio_reflex_is_active(reflex));
+    tt_want(!pbio_parent_exists(&servos[1]->parent));
+    pbio_dcmotor_get_state(servos[1]->dcmotor, &actuation, &voltage);
+    tt_uint_op(actuation, ==, PBIO_DCMOTOR_ACTUATION_COAST);
+
+    // Closing the input stops the reflex.
+    tt_uint_op(pbio_reflex_start_servo(&reflex, &input, &settings, servos[1]), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_dcmotor_close(servos[0]->dcmotor), ==, PBIO_SUCCESS);
+    pbio_test_sleep_ms(&timer, 100);
+    tt_want(!pbio_reflex_is_active(reflex));
+
+end:
+
+    PT_END(pt);
+}
+
+static PT_THREAD(test_reflex_drivebase(struct pt *pt)) {
+
+    static struct timer timer;
+
+    static const pbio_port_id_t ports[] = {PBIO_PORT_ID_A, PBIO_PORT_ID_B, PBIO_PORT_ID_C};
+    static const pbio_direction_t directions[] = {PBIO_DIRECTION_COUNTERCLOCKWISE, PBIO_DIRECTION_CLOCKWISE, PBIO_DIRECTION_CLOCKWISE};
+    static pbio_servo_t *servos[3];
+    static pbio_drivebase_t *db;
+    static pbio_reflex_t *reflex;
+    static pbio_reflex_t *other;
+    static uint32_t generation;
+
+    static int32_t drive_distance;
+    static int32_t drive_speed;
+    static int32_t turn_angle;
+    static int32_t turn_rate;
+    static int32_t value;
+    static int32_t output;
+
+    static pbio_dcmotor_actuation_t actuation;
+    static int32_t voltage;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    // Initialize the drive base servos and one more servo for the input.
+    for (uint8_t i = 0; i < 3; i++) {
+        pbdrv_legodev_dev_t *legodev;
+        pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+        tt_uint_op(pbdrv_legodev_get_device(ports[i], &id, &legodev), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_get_servo(legodev, &servos[i]), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_setup(servos[i], id, directions[i], 1000, true, 0), ==, PBIO_SUCCESS);
+    }
+    tt_uint_op(pbio_drivebase_get_drivebase(&db, servos[0], servos[1], 56000, 112000), ==, PBIO_SUCCESS);
+
+    // Steer the drive base with the angle of the third servo.
+    static pbio_reflex_input_t input;
+    input.type = PBIO_REFLEX_INPUT_SERVO;
+    input.servo = servos[2];
+    static const pbio_reflex_settings_t settings = {
+        .target = 0,
+        .kp = 1000,
+        .limit = 200,
+    };
+    tt_uint_op(pbio_reflex_start_drivebase(&reflex, &input, &settings, db, 100), ==, PBIO_SUCCESS);
+    tt_want(pbio_reflex_is_active(reflex));
+
+    // A drive base can only be steered by one reflex at a time.
+    tt_uint_op(pbio_reflex_start_drivebase(&other, &input, &settings, db, 100), ==, PBIO_ERROR_BUSY);
+
+    // Without an error, the drive base drives straight.
+    pbio_test_sleep_ms(&timer, 1000);
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(drive_speed, 100, 10));
+    tt_want(pbio_test_int_is_close(turn_rate, 0, 5));
+
+    // Turning the input servo makes the drive base turn proportionally.
+    tt_uint_op(pbio_servo_run_target(servos[2], 500, 90, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_ms(&timer, 1500);
+    pbio_reflex_get_state(reflex, &value, &output);
+    tt_want(pbio_test_int_is_close(value, 90, 5));
+    tt_want(pbio_test_int_is_close(output, -90, 5));
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(drive_speed, 100, 10));
+    tt_want(pbio_test_int_is_close(turn_rate, -90, 10));
+
+    // Driving the drive base stops the reflex once it is released.
+    pbio_reflex_release_drivebase(db);
+    tt_want(!pbio_reflex_is_active(reflex));
+    tt_uint_op(pbio_drivebase_drive_forever(db, 100, 45), ==, PBIO_SUCCESS);
+    pbio_test_sleep_ms(&timer, 1000);
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(turn_rate, 45, 10));
+
+    // Starting again hands out a new generation of the same instance, so
+    // the previous user can tell that it is no longer theirs.
+    generation = reflex->generation;
+    tt_uint_op(pbio_reflex_start_drivebase(&other, &input, &settings, db, 100), ==, PBIO_SUCCESS);
+    tt_want(other == reflex);
+    tt_want_uint_op(other->generation, !=, generation);
+
+    // Stopping the reflex stops the drive base.
+    tt_uint_op(pbio_reflex_stop(other), ==, PBIO_SUCCESS);
+    tt_want(!pbio_reflex_is_active(other));
+    pbio_dcmotor_get_state(servos[0]->dcmotor, &actuation, &voltage);
+    tt_uint_op(actuation, ==, PBIO_DCMOTOR_ACTUATION_COAST);
+
+end:
+
+    PT_END(pt);
+}
+
+static PT_THREAD(test_reflex_sensor(struct pt *pt)) {
+    // info messages captured from BOOST Interactive Motor, see test_uartdev.c
+    static const uint8_t msg_speed_115200[] = { 0x52, 0x00, 0xC2, 0x01, 0x00, 0x6E }; // SPEED 115200
+    static const uint8_t msg_ack[] = { 0x04 }; // ACK
+    static const uint8_t msg0[] = { 0x40, 0x26, 0x99 };
+    static const uint8_t msg1[] = { 0x49, 0x03, 0x02, 0xB7 };
+    static const uint8_t msg2[] = { 0x52, 0x00, 0xC2, 0x01, 0x00, 0x6E };
+    static const uint8_t msg3[] = { 0x5F, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0xA0 };
+    static const uint8_t msg4[] = { 0x93, 0x00, 0x54, 0x45, 0x53, 0x54, 0x7A };
+    static const uint8_t msg5[] = { 0x9B, 0x01, 0x00, 0x00, 0xC8, 0xC2, 0x00, 0x00, 0xC8, 0x42, 0xE5 };
+    static const uint8_t msg6[] = { 0x9B, 0x02, 0x00, 0x00, 0xC8, 0xC2, 0x00, 0x00, 0xC8, 0x42, 0xE6 };
+    static const uint8_t msg7[] = { 0x9B, 0x03, 0x00, 0x00, 0xC8, 0xC2, 0x00, 0x00, 0xC8, 0x42, 0xE7 };
+    static const uint8_t msg8[] = { 0x93, 0x04, 0x54, 0x53, 0x54, 0x00, 0x3B };
+    static const uint8_t msg9[] = { 0x8B, 0x05, 0x00, 0x00, 0x71 };
+    static const uint8_t msg10[] = { 0x93, 0x80, 0x05, 0x01, 0x06, 0x00, 0xEE };
+    static const uint8_t msg11[] = { 0x92, 0x00, 0x50, 0x4F, 0x53, 0x00, 0x21 };
+    static const uint8_t msg12[] = { 0x9A, 0x01, 0x00, 0x00, 0xB4, 0xC3, 0x00, 0x00, 0xB4, 0x43, 0xE4 };
+    static const uint8_t msg13[] = { 0x9A, 0x02, 0x00, 0x00, 0xC8, 0xC2, 0x00, 0x00, 0xC8, 0x42, 0xE7 };
+    static const uint8_t msg14[] = { 0x9A, 0x03, 0x00, 0x00, 0xB4, 0xC3, 0x00, 0x00, 0xB4, 0x43, 0xE6 };
+    static const uint8_t msg15[] = { 0x92, 0x04, 0x44, 0x45, 0x47, 0x00, 0x2F };
+    static const uint8_t msg16[] = { 0x8A, 0x05, 0x08, 0x00, 0x78 };
+    static const uint8_t msg17[] = { 0x92, 0x80, 0x01, 0x02, 0x06, 0x00, 0xE8 };
+    static const uint8_t msg18[] = { 0x99, 0x00, 0x53, 0x50, 0x45, 0x45, 0x44, 0x00, 0x00, 0x00, 0x21 };
+    static const uint8_t msg19[] = { 0x99, 0x01, 0x00, 0x00, 0xC8, 0xC2, 0x00, 0x00, 0xC8, 0x42, 0xE7 };
+    static const uint8_t msg20[] = { 0x99, 0x02, 0x00, 0x00, 0xC8, 0xC2, 0x00, 0x00, 0xC8, 0x42, 0xE4 };
+    static const uint8_t msg21[] = { 0x99, 0x03, 0x00, 0x00, 0xC8, 0xC2, 0x00, 0x00, 0xC8, 0x42, 0xE5 };
+    static const uint8_t msg22[] = { 0x91, 0x04, 0x50, 0x43, 0x54, 0x00, 0x2D };
+    static const uint8_t msg23[] = { 0x89, 0x05, 0x10, 0x00, 0x63 };
+    static const uint8_t msg24[] = { 0x91, 0x80, 0x01, 0x00, 0x04, 0x00, 0xEB };
+    static const uint8_t msg25[] = { 0x98, 0x00, 0x50, 0x4F, 0x57, 0x45, 0x52, 0x00, 0x00, 0x00, 0x38 };
+    static const uint8_t msg26[] = { 0x98, 0x01, 0x00, 0x00, 0xC8, 0xC2, 0x00, 0x00, 0xC8, 0x42, 0xE6 };
+    static const uint8_t msg27[] = { 0x98, 0x02, 0x00, 0x00, 0xC8, 0xC2, 0x00, 0x00, 0xC8, 0x42, 0xE5 };
+    static const uint8_t msg28[] = { 0x98, 0x03, 0x00, 0x00, 0xC8, 0xC2, 0x00, 0x00, 0xC8, 0x42, 0xE4 };
+    static const uint8_t msg29[] = { 0x90, 0x04, 0x50, 0x43, 0x54, 0x00, 0x2C };
+    static const uint8_t msg30[] = { 0x88, 0x05, 0x00, 0x50, 0x22 };
+    static const uint8_t msg31[] = { 0x90, 0x80, 0x01, 0x00, 0x04, 0x00, 0xEA };
+    static const uint8_t msg32[] = { 0x88, 0x06, 0x06, 0x00, 0x77 };
+
+    static const uint8_t msg_set_pos[] = { 0x43, 0x02, 0xBE }; // set mode 2
+    static const uint8_t msg_set_speed[] = { 0x43, 0x01, 0xBD }; // set mode 1
+    static const uint8_t msg_nack[] = { 0x02 }; // NACK
+    static const uint8_t msg_pos_0[] = { 0xC0 | 0x10 | 0x02, 0x00, 0x00, 0x00, 0x00, 0x2D }; // mode 2, angle 0
+    static const uint8_t msg_pos_90[] = { 0xC0 | 0x10 | 0x02, 0x5A, 0x00, 0x00, 0x00, 0x77 }; // mode 2, angle 90
+    static const uint8_t msg_speed_0[] = { 0xC0 | 0x00 | 0x01, 0x00, 0x3E }; // mode 1, speed 0
+
+    // used in SIMULATE_RX/TX_MSG macros
+    static struct pt child;
+    static bool ok;
+
+    static pbdrv_legodev_dev_t *sensor;
+    static pbio_servo_t *srv;
+    static pbio_reflex_t *reflex;
+    static pbio_reflex_input_t input;
+    static const pbio_reflex_settings_t settings = {
+        .target = 0,
+        .kp = 1000,
+        .limit = 100,
+    };
+
+    static int32_t value;
+    static int32_t output;
+
+    static pbio_dcmotor_actuation_t actuation;
+    static int32_t voltage;
+
+    static int i;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    // Sync the sensor on port D.
+    pbdrv_legodev_test_start_process();
+    SIMULATE_TX_MSG(msg_speed_115200);
+    SIMULATE_RX_MSG(msg_ack);
+    SIMULATE_RX_MSG(msg0);
+    SIMULATE_RX_MSG(msg1);
+    SIMULATE_RX_MSG(msg2);
+    SIMULATE_RX_MSG(msg3);
+    SIMULATE_RX_MSG(msg4);
+    SIMULATE_RX_MSG(msg5);
+    SIMULATE_RX_MSG(msg6);
+    SIMULATE_RX_MSG(msg7);
+    SIMULATE_RX_MSG(msg8);
+    SIMULATE_RX_MSG(msg9);
+    SIMULATE_RX_MSG(msg10);
+    SIMULATE_RX_MSG(msg11);
+    SIMULATE_RX_MSG(msg12);
+    SIMULATE_RX_MSG(msg13);
+    SIMULATE_RX_MSG(msg14);
+    SIMULATE_RX_MSG(msg15);
+    SIMULATE_RX_MSG(msg16);
+    SIMULATE_RX_MSG(msg17);
+    SIMULATE_RX_MSG(msg18);
+    SIMULATE_RX_MSG(msg19);
+    SIMULATE_RX_MSG(msg20);
+    SIMULATE_RX_MSG(msg21);
+    SIMULATE_RX_MSG(msg22);
+    SIMULATE_RX_MSG(msg23);
+    SIMULATE_RX_MSG(msg24);
+    SIMULATE_RX_MSG(msg25);
+    SIMULATE_RX_MSG(msg26);
+    SIMULATE_RX_MSG(msg27);
+    SIMULATE_RX_MSG(msg28);
+    SIMULATE_RX_MSG(msg29);
+    SIMULATE_RX_MSG(msg30);
+    SIMULATE_RX_MSG(msg31);
+    SIMULATE_RX_MSG(msg32);
+    SIMULATE_RX_MSG(msg_ack);
+    SIMULATE_TX_MSG(msg_ack);
+    SIMULATE_TX_MSG(msg_set_pos);
+    SIMULATE_TX_MSG(msg_nack);
+    SIMULATE_RX_MSG(msg_pos_0);
+
+    // The test driver does not identify the device on this port.
+    pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_NONE;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_D, &id, &sensor), ==, PBIO_SUCCESS);
+
+    // Initialize the servo.
+    static pbdrv_legodev_dev_t *legodev;
+    id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_A, &id, &legodev), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev, &srv), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+
+    // Use the angle reported by the sensor to drive the servo.
+    input.type = PBIO_REFLEX_INPUT_SENSOR;
+    input.sensor.legodev = sensor;
+    input.sensor.mode = PBDRV_LEGODEV_MODE_PUP_REL_MOTOR__POS;
+    input.sensor.index = 0;
+    tt_uint_op(pbio_reflex_start_servo(&reflex, &input, &settings, srv), ==, PBIO_SUCCESS);
+
+    // Each new sample updates the output.
+    for (i = 0; i < 3; i++) {
+        SIMULATE_TX_MSG(msg_nack);
+        SIMULATE_RX_MSG(msg_pos_90);
+    }
+    tt_want(pbio_reflex_is_active(reflex));
+    pbio_reflex_get_state(reflex, &value, &output);
+    tt_want_int_op(value, ==, 90);
+    tt_want_int_op(output, ==, -90);
+    pbio_dcmotor_get_state(srv->dcmotor, &actuation, &voltage);
+    tt_uint_op(actuation, ==, PBIO_DCMOTOR_ACTUATION_VOLTAGE);
+    tt_want_int_op(voltage, <, 0);
+
+    // If the sensor is switched to another mode, the input gives no more
+    // samples, so the reflex stops after a while and coasts the servo.
+    tt_uint_op(pbdrv_legodev_set_mode(sensor, PBDRV_LEGODEV_MODE_PUP_REL_MOTOR__SPEED), ==, PBIO_SUCCESS);
+    SIMULATE_TX_MSG(msg_set_speed);
+    SIMULATE_RX_MSG(msg_speed_0);
+    tt_want(pbio_reflex_is_active(reflex));
+    for (i = 0; i < 6; i++) {
+        SIMULATE_TX_MSG(msg_nack);
+        SIMULATE_RX_MSG(msg_speed_0);
+    }
+    tt_want(!pbio_reflex_is_active(reflex));
+    pbio_dcmotor_get_state(srv->dcmotor, &actuation, &voltage);
+    tt_uint_op(actuation, ==, PBIO_DCMOTOR_ACTUATION_COAST);
+
+end:
+
+    PT_END(pt);
+}
+
+struct testcase_t pbio_reflex_tests[] = {
+    PBIO_PT_THREAD_TEST(test_reflex_servo),
+    PBIO_PT_THREAD_TEST(test_reflex_drivebase),
+    PBIO_PT_THREAD_TEST(test_reflex_sensor),
+    END_OF_TESTCASES
+};
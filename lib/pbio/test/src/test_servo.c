@@ -219,9 +219,161 @@ end:
     PT_END(pt);
 }
 
+static PT_THREAD(test_servo_identify_model(struct pt *pt)) {
+
+    static pbio_servo_t *srv;
+    static pbdrv_legodev_dev_t *legodev;
+    static int32_t inertia_ratio;
+    static int32_t friction;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    // The motor on this port is simulated using the nominal model for its type.
+    pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_A, &id, &legodev), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev, &srv), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+
+    // Result not available while running.
+    tt_uint_op(pbio_servo_identify_model(srv, 6000, 3000), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_identify_model_get_result(srv, &inertia_ratio, &friction), ==, PBIO_ERROR_AGAIN);
+    pbio_test_sleep_until(pbio_servo_identify_model_is_done(srv));
+
+    // The simulated motor has the same friction as the nominal model. Its
+    // inertia is derived from the speed change caused by one uNm of torque
+    // in one 5 ms control loop. In the nominal model that is 2147 / 2332
+    // mdeg/s. The simulation ticks every 1 ms by 0.1898 mdeg/s, so that is
+    // 5 * 0.1898 mdeg/s, making the simulated inertia 97% of nominal.
+    tt_uint_op(pbio_servo_identify_model_get_result(srv, &inertia_ratio, &friction), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(inertia_ratio, 97, 10));
+    tt_want(pbio_test_int_is_close(friction, 21, 2));
+    tt_want(srv->observer.model == &srv->model_custom);
+
+    // Servo should still work normally with the new model.
+    tt_uint_op(pbio_servo_run_target(srv, 500, 90, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_control_is_done(&srv->control));
+
+    // Invalid arguments are rejected without stopping the servo.
+    tt_uint_op(pbio_servo_identify_model(srv, 0, 3000), ==, PBIO_ERROR_INVALID_ARG);
+    tt_uint_op(pbio_servo_identify_model(srv, 6000, 0), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want(pbio_control_is_active(&srv->control));
+
+    // Starting a new maneuver cancels identification.
+    tt_uint_op(pbio_servo_identify_model(srv, 6000, 3000), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_run_forever(srv, 500), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_servo_identify_model_is_done(srv));
+    tt_uint_op(pbio_servo_identify_model_get_result(srv, &inertia_ratio, &friction), ==, PBIO_ERROR_FAILED);
+
+    // Restore default model.
+    tt_uint_op(pbio_servo_reset_model(srv), ==, PBIO_SUCCESS);
+    tt_want(srv->observer.model == srv->model_default);
+
+end:
+
+    PT_END(pt);
+}
+
+static PT_THREAD(test_servo_gain_schedule(struct pt *pt)) {
+
+    static pbio_servo_t *srv;
+    static pbdrv_legodev_dev_t *legodev;
+    static pbio_control_settings_t *settings;
+    static int32_t kp, ki, kd;
+    static int32_t angle;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_A, &id, &legodev), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev, &srv), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    settings = &srv->control.settings;
+
+    // Without a schedule, the fixed gains are used at any speed.
+    pbio_control_settings_get_pid_at_speed(settings, 500000, &kp, &ki, &kd);
+    tt_want_int_op(kp, ==, settings->pid_kp);
+    tt_want_int_op(ki, ==, settings->pid_ki);
+    tt_want_int_op(kd, ==, settings->pid_kd);
+
+    // Speeds must be increasing and gains must not be negative.
+    pbio_control_gain_schedule_point_t bad[] = {
+        {.speed = 500, .pid_kp = 1000, .pid_ki = 0, .pid_kd = 0},
+        {.speed = 100, .pid_kp = 1000, .pid_ki = 0, .pid_kd = 0},
+    };
+    tt_want_int_op(pbio_control_settings_set_gain_schedule(settings, bad, 2), ==, PBIO_ERROR_INVALID_ARG);
+    bad[1].speed = 600;
+    bad[1].pid_kd = -1;
+    tt_want_int_op(pbio_control_settings_set_gain_schedule(settings, bad, 2), ==, PBIO_ERROR_INVALID_ARG);
+
+    // Speeds are in application units (deg/s).
+    pbio_control_gain_schedule_point_t schedule[] = {
+        {.speed = 0, .pid_kp = 20000, .pid_ki = 10000, .pid_kd = 1000},
+        {.speed = 200, .pid_kp = 10000, .pid_ki = 5000, .pid_kd = 2000},
+        {.speed = 600, .pid_kp = 6000, .pid_ki = 3000, .pid_kd = 1000},
+    };
+    tt_uint_op(pbio_control_settings_set_gain_schedule(settings, schedule, 3), ==, PBIO_SUCCESS);
+
+    // Gains are interpolated between points, and held outside the range.
+    pbio_control_settings_get_pid_at_speed(settings, 100000, &kp, &ki, &kd);
+    tt_want_int_op(kp, ==, 15000);
+    tt_want_int_op(ki, ==, 7500);
+    tt_want_int_op(kd, ==, 1500);
+    pbio_control_settings_get_pid_at_speed(settings, 500000, &kp, &ki, &kd);
+    tt_want_int_op(kp, ==, 7000);
+    tt_want_int_op(ki, ==, 3500);
+    tt_want_int_op(kd, ==, 1250);
+    pbio_control_settings_get_pid_at_speed(settings, 1000000, &kp, &ki, &kd);
+    tt_want_int_op(kp, ==, 6000);
+
+    // Schedule can be read back in application units.
+    pbio_control_gain_schedule_point_t readback[PBIO_CONTROL_GAIN_SCHEDULE_SIZE_MAX];
+    tt_want_int_op(pbio_control_settings_get_gain_schedule(settings, readback), ==, 3);
+    tt_want_int_op(readback[1].speed, ==, 200);
+    tt_want_int_op(readback[1].pid_kp, ==, 10000);
+
+    // Servo should still reach its target using the scheduled gains.
+    tt_uint_op(pbio_servo_run_target(srv, 500, 180, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_control_is_done(&srv->control));
+    tt_uint_op(pbio_servo_get_state_user(srv, &angle, &kp), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, 180, 5));
+
+    // Empty schedule restores fixed gains.
+    tt_uint_op(pbio_control_settings_set_gain_schedule(settings, NULL, 0), ==, PBIO_SUCCESS);
+    pbio_control_settings_get_pid_at_speed(settings, 100000, &kp, &ki, &kd);
+    tt_want_int_op(kp, ==, settings->pid_kp);
+
+end:
+
+    PT_END(pt);
+}
+
 struct testcase_t pbio_servo_tests[] = {
     PBIO_PT_THREAD_TEST(test_servo_basics),
     PBIO_PT_THREAD_TEST(test_servo_stall),
     PBIO_PT_THREAD_TEST(test_servo_gearing),
+    PBIO_PT_THREAD_TEST(test_servo_identify_model),
+    PBIO_PT_THREAD_TEST(test_servo_gain_schedule),
     END_OF_TESTCASES
 };
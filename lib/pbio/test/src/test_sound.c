@@ -0,0 +1,332 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <pbio/error.h>
+#include <pbio/int_math.h>
+#include <pbio/sound.h>
+#include <pbio/util.h>
+#include <test-pbio.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+// Number of samples played each time the test driver plays half a buffer.
+#define HALF_SIZE (128)
+
+// 100 samples at 8 kHz of a 440 Hz and a 1234 Hz tone, encoded by tools/adpcm.py.
+static const uint8_t adpcm_data[] = {
+    0x49, 0x4d, 0x41, 0x44, 0x64, 0x00, 0x00, 0x00, 0x40, 0x1f, 0x00, 0x00,
+    0x4b, 0x00, 0x00, 0x00, 0x30, 0x92, 0x99, 0x21, 0xe8, 0xad, 0x19, 0x12,
+    0x99, 0x52, 0x25, 0xa8, 0x8a, 0x00, 0xea, 0x8c, 0x30, 0x02, 0x09, 0x73,
+    0x02, 0xca, 0x89, 0x80, 0xcb, 0x0a, 0x35, 0x01, 0x19, 0x44, 0xa0, 0xad,
+    0x09, 0x90, 0xbb, 0x60, 0x24, 0x80, 0x29, 0x13, 0xfa, 0x9c, 0x10, 0x90,
+    0x8a, 0x73, 0x12, 0x99, 0x28, 0x91,
+};
+
+// The samples before encoding.
+static const int16_t adpcm_reference[] = {
+    0, 9011, 13248, 11720, 7763, 5906, 7809, 10818, 10387, 4252,
+    -5291, -13022, -14964, -11513, -6850, -5167, -7016, -8934, -6671, 819,
+    10108, 15911, 15345, 10173, 5129, 3773, 5505, 6289, 2461, -5741,
+    -14017, -17405, -14325, -7790, -2751, -1883, -3465, -3167, 1843, 10075,
+    16671, 17353, 11965, 4557, -58, -288, 1139, -109, -5843, -13438,
+    -17834, -15747, -8457, -758, 3018, 2489, 1206, 3212, 9178, 15544,
+    17410, 12721, 4099, -3260, -5826, -4463, -3311, -5844, -11562, -16224,
+    -15443, -8536, 723, 7117, 8180, 5973, 4944, 7765, 12803, 15443,
+    12119, 3565, -5574, -10439, -9816, -6831, -5934, -8812, -12822, -13299,
+    -7746, 1750, 10010, 12893, 10535, 6916, 6181, 8919, 11659, 10014,
+};
+
+// The samples as decoded by tools/adpcm.py.
+static const int16_t adpcm_decoded[] = {
+    1186, 8736, 13638, 10964, 8533, 6324, 8332, 11375, 10822, 4280,
+    -5526, -12052, -15611, -12376, -7474, -4800, -7231, -9440, -6092, 604,
+    10410, 16936, 15750, 10357, 5455, 4564, 5374, 6110, 2762, -5152,
+    -14860, -16165, -14979, -7429, -2527, -1636, -4067, -3331, 1356, 10487,
+    17013, 18199, 12806, 3981, 422, -656, 324, -567, -6240, -12870,
+    -17327, -16517, -8414, -864, 2077, 2968, 537, 2746, 8773, 16067,
+    17047, 12590, 3675, -2257, -5492, -4512, -3621, -6052, -11208, -15895,
+    -15287, -8092, 733, 6665, 7743, 6763, 4089, 8141, 13297, 15305,
+    12262, 3960, -6719, -11025, -9720, -6161, -5083, -8024, -12481, -13291,
+    -8135, 1910, 9088, 13003, 9444, 6209, 5229, 9686, 12117, 9908,
+};
+
+// Largest deviation from the center value in the given samples.
+static int32_t get_peak(const uint16_t *data, uint32_t start, uint32_t end) {
+    int32_t peak = 0;
+    for (uint32_t i = start; i < end; i++) {
+        int32_t value = pbio_int_math_abs(data[i] - INT16_MAX);
+        if (value > peak) {
+            peak = value;
+        }
+    }
+    return peak;
+}
+
+static void test_sound_square(void *env) {
+    uint16_t data[HALF_SIZE];
+    uint32_t rate;
+
+    // Nothing plays until a note is started.
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, 0);
+
+    // Default voice is a square wave at full volume. At 1 kHz, each half
+    // period is 8 samples, starting with the low half.
+    tt_want_int_op(pbio_sound_voice_note_on(0, 1000), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(rate, ==, PBIO_SOUND_SAMPLE_RATE);
+    for (uint32_t i = 0; i < HALF_SIZE; i++) {
+        tt_want_int_op(data[i], ==, (i / 8) % 2 ? INT16_MAX + 32766 : 0);
+    }
+
+    // The note keeps playing in newly mixed data.
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(get_peak(data, 0, HALF_SIZE), ==, INT16_MAX);
+    tt_want(pbio_sound_voice_is_busy(0));
+
+    // Without release time, the voice is silent right after the note off,
+    // which can be heard once the data that was already mixed has played.
+    tt_want_int_op(pbio_sound_voice_note_off(0), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(get_peak(data, 0, HALF_SIZE), ==, 0);
+    tt_want(!pbio_sound_voice_is_busy(0));
+
+    // Stopping stops the driver.
+    pbio_sound_stop();
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, 0);
+
+    // Invalid arguments.
+    tt_want_int_op(pbio_sound_voice_note_on(PBIO_CONFIG_SOUND_NUM_VOICES, 1000), ==, PBIO_ERROR_INVALID_ARG);
+    pbio_sound_envelope_t envelope = { .sustain = 101 };
+    tt_want_int_op(pbio_sound_voice_set_envelope(0, &envelope), ==, PBIO_ERROR_INVALID_ARG);
+}
+
+static void test_sound_mix(void *env) {
+    uint16_t data[HALF_SIZE];
+    uint32_t rate;
+
+    // Two voices in phase add up.
+    tt_want_int_op(pbio_sound_voice_set_wave(0, PBIO_SOUND_WAVE_SQUARE, INT16_MAX / 4), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_voice_set_wave(1, PBIO_SOUND_WAVE_SQUARE, INT16_MAX / 4), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_voice_note_on(0, 1000), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_voice_note_on(1, 1000), ==, PBIO_SUCCESS);
+    // Output already mixed for the first voice plays first.
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want(pbio_test_int_is_close(get_peak(data, 0, HALF_SIZE), INT16_MAX / 2, 2));
+
+    // The sum is clipped to the output range.
+    tt_want_int_op(pbio_sound_voice_set_wave(0, PBIO_SOUND_WAVE_SQUARE, INT16_MAX), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_voice_set_wave(1, PBIO_SOUND_WAVE_SQUARE, INT16_MAX), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(get_peak(data, 0, HALF_SIZE), ==, INT16_MAX);
+
+    // Check the shape of the other waveforms.
+    pbio_sound_stop();
+    tt_want_int_op(pbio_sound_voice_set_wave(0, PBIO_SOUND_WAVE_SINE, INT16_MAX), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_voice_note_on(0, 500), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want(pbio_test_int_is_close(get_peak(data, 0, HALF_SIZE), INT16_MAX, 2));
+    // Sine at 500 Hz has a period of 32 samples, so sample 8 is the top.
+    tt_want(pbio_test_int_is_close(data[8], INT16_MAX * 2, 2));
+    tt_want(pbio_test_int_is_close(data[4], INT16_MAX + 23170, 2));
+
+    pbio_sound_stop();
+    tt_want_int_op(pbio_sound_voice_set_wave(0, PBIO_SOUND_WAVE_TRIANGLE, INT16_MAX), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_voice_note_on(0, 500), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want(pbio_test_int_is_close(data[0], 0, 2));
+    tt_want(pbio_test_int_is_close(data[4], INT16_MAX / 2, 2));
+    tt_want(pbio_test_int_is_close(data[16], INT16_MAX * 2, 2));
+
+    // Noise does not repeat.
+    pbio_sound_stop();
+    tt_want_int_op(pbio_sound_voice_set_wave(0, PBIO_SOUND_WAVE_NOISE, INT16_MAX), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_voice_note_on(0, 4000), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    uint32_t changes = 0;
+    for (uint32_t i = 1; i < HALF_SIZE; i++) {
+        changes += data[i] != data[i - 1];
+    }
+    tt_want_int_op(changes, >, HALF_SIZE / 4);
+}
+
+static void test_sound_envelope(void *env) {
+    uint16_t data[HALF_SIZE];
+    uint32_t rate;
+
+    pbio_sound_envelope_t envelope = {
+        .attack = 8,
+        .decay = 0,
+        .sustain = 50,
+        .release = 8,
+    };
+    tt_want_int_op(pbio_sound_voice_set_wave(0, PBIO_SOUND_WAVE_SINE, INT16_MAX), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_voice_set_envelope(0, &envelope), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_voice_note_on(0, 500), ==, PBIO_SUCCESS);
+
+    // The volume goes up during the 8 ms attack.
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(get_peak(data, 0, 32), <, INT16_MAX / 4);
+    tt_want_int_op(get_peak(data, 96, 128), >, INT16_MAX * 3 / 4);
+
+    // Then it stays at the sustain level.
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want(pbio_test_int_is_close(get_peak(data, 0, HALF_SIZE), INT16_MAX / 2, 200));
+
+    // After the note off, it goes to zero within the release time.
+    tt_want_int_op(pbio_sound_voice_note_off(0), ==, PBIO_SUCCESS);
+    tt_want(pbio_sound_voice_is_busy(0));
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want(!pbio_sound_voice_is_busy(0));
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(get_peak(data, 0, HALF_SIZE), ==, 0);
+}
+
+static void test_sound_sequence(void *env) {
+    uint16_t data[HALF_SIZE];
+    uint32_t rate;
+
+    // A 5 ms beep in a 10 ms note, followed by a 10 ms rest.
+    static const pbio_sound_note_t notes[] = {
+        { .frequency = 1000, .duration = 10, .gate = 5 },
+        { .frequency = 0, .duration = 10, .gate = 10 },
+    };
+    tt_want_int_op(pbio_sound_voice_play(0, notes, PBIO_ARRAY_SIZE(notes)), ==, PBIO_SUCCESS);
+    tt_want(pbio_sound_voice_is_busy(0));
+
+    // The first 5 ms are 80 samples.
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(get_peak(data, 0, 80), ==, INT16_MAX);
+    tt_want_int_op(get_peak(data, 80, HALF_SIZE), ==, 0);
+
+    // The sequence plays in the background as the buffer is refilled.
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(get_peak(data, 0, HALF_SIZE), ==, 0);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want(!pbio_sound_voice_is_busy(0));
+
+    // Tied notes continue without a new attack.
+    static const pbio_sound_note_t tied[] = {
+        { .frequency = 1000, .duration = 4, .gate = 4 },
+        { .frequency = 2000, .duration = 4, .gate = 3 },
+    };
+    pbio_sound_envelope_t envelope = {
+        .attack = 2,
+        .sustain = 100,
+    };
+    tt_want_int_op(pbio_sound_voice_set_envelope(0, &envelope), ==, PBIO_SUCCESS);
+    pbio_sound_stop();
+    tt_want_int_op(pbio_sound_voice_play(0, tied, PBIO_ARRAY_SIZE(tied)), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    // Attack of 2 ms is 32 samples.
+    tt_want_int_op(get_peak(data, 0, 12), <, INT16_MAX / 2);
+    // Second note starts at 64 samples, at full volume.
+    tt_want_int_op(get_peak(data, 64, 72), ==, INT16_MAX);
+    // And it is released after 3 ms.
+    tt_want_int_op(get_peak(data, 64 + 48, HALF_SIZE), ==, 0);
+}
+
+static void test_sound_adpcm_decode(void *env) {
+    pbio_sound_adpcm_t decoder;
+    int16_t samples[PBIO_ARRAY_SIZE(adpcm_decoded) + 10];
+
+    tt_want_int_op(pbio_sound_adpcm_init(&decoder, adpcm_data, sizeof(adpcm_data)), ==, PBIO_SUCCESS);
+    tt_want_int_op(decoder.num_samples, ==, PBIO_ARRAY_SIZE(adpcm_decoded));
+    tt_want_int_op(decoder.sample_rate, ==, 8000);
+
+    // Decode in odd sized chunks, so chunks start on both halves of a byte.
+    uint32_t count = 0;
+    uint32_t decoded;
+    while ((decoded = pbio_sound_adpcm_decode(&decoder, &samples[count], 7)) > 0) {
+        count += decoded;
+    }
+    tt_want_int_op(count, ==, PBIO_ARRAY_SIZE(adpcm_decoded));
+
+    // The result matches the encoding tool exactly, and the original samples
+    // within the precision of the encoding.
+    for (uint32_t i = 0; i < count; i++) {
+        tt_want_int_op(samples[i], ==, adpcm_decoded[i]);
+        tt_want(pbio_test_int_is_close(samples[i], adpcm_reference[i], 1500));
+    }
+
+    // Invalid data is rejected.
+    uint8_t data[sizeof(adpcm_data)];
+    memcpy(data, adpcm_data, sizeof(data));
+    tt_want_int_op(pbio_sound_adpcm_init(&decoder, data, PBIO_SOUND_ADPCM_HEADER_SIZE - 1), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want_int_op(pbio_sound_adpcm_init(&decoder, data, sizeof(data) - 1), ==, PBIO_ERROR_INVALID_ARG);
+    data[0] = 'X';
+    tt_want_int_op(pbio_sound_adpcm_init(&decoder, data, sizeof(data)), ==, PBIO_ERROR_INVALID_ARG);
+    data[0] = adpcm_data[0];
+    data[12] = 89;
+    tt_want_int_op(pbio_sound_adpcm_init(&decoder, data, sizeof(data)), ==, PBIO_ERROR_INVALID_ARG);
+}
+
+static void test_sound_adpcm_play(void *env) {
+    uint16_t data[HALF_SIZE * 2];
+    uint32_t rate;
+
+    // The sound is short enough to be mixed entirely when playback starts.
+    tt_want_int_op(pbio_sound_play_adpcm(adpcm_data, sizeof(adpcm_data), INT16_MAX), ==, PBIO_SUCCESS);
+    tt_want(!pbio_sound_adpcm_is_busy());
+    tt_want_int_op(pbio_test_sound_play(&data[0], &rate), ==, HALF_SIZE);
+    tt_want_int_op(pbio_test_sound_play(&data[HALF_SIZE], &rate), ==, HALF_SIZE);
+
+    // At 8 kHz, each sample is played twice as long, with interpolated values
+    // in between.
+    for (uint32_t i = 0; i < PBIO_ARRAY_SIZE(adpcm_decoded); i++) {
+        tt_want_int_op(data[i * 2], ==, INT16_MAX + (adpcm_decoded[i] * INT16_MAX >> 15));
+    }
+    for (uint32_t i = 0; i < PBIO_ARRAY_SIZE(adpcm_decoded) - 1; i++) {
+        int32_t middle = (adpcm_decoded[i] + adpcm_decoded[i + 1]) / 2;
+        tt_want(pbio_test_int_is_close(data[i * 2 + 1], INT16_MAX + middle, 2));
+    }
+
+    // Then it is silent.
+    tt_want_int_op(get_peak(data, PBIO_ARRAY_SIZE(adpcm_decoded) * 2, PBIO_ARRAY_SIZE(data)), ==, 0);
+
+    // While the output is already running, the sound is decoded as the
+    // buffer is refilled. It mixes with voices, and stops with them.
+    tt_want_int_op(pbio_sound_voice_set_wave(0, PBIO_SOUND_WAVE_SQUARE, INT16_MAX / 4), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_voice_note_on(0, 1000), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_sound_play_adpcm(adpcm_data, sizeof(adpcm_data), INT16_MAX / 4), ==, PBIO_SUCCESS);
+    tt_want(pbio_sound_adpcm_is_busy());
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want(pbio_sound_adpcm_is_busy());
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want(!pbio_sound_adpcm_is_busy());
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, HALF_SIZE);
+    tt_want_int_op(get_peak(data, 0, HALF_SIZE), >, INT16_MAX / 4);
+    tt_want_int_op(pbio_sound_play_adpcm(adpcm_data, sizeof(adpcm_data), INT16_MAX / 4), ==, PBIO_SUCCESS);
+    tt_want(pbio_sound_adpcm_is_busy());
+    pbio_sound_stop();
+    tt_want(!pbio_sound_adpcm_is_busy());
+    tt_want_int_op(pbio_test_sound_play(data, &rate), ==, 0);
+
+    // Invalid data does not play.
+    tt_want_int_op(pbio_sound_play_adpcm(adpcm_data, PBIO_SOUND_ADPCM_HEADER_SIZE, INT16_MAX), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want(!pbio_sound_adpcm_is_busy());
+}
+
+struct testcase_t pbio_sound_tests[] = {
+    PBIO_TEST(test_sound_square),
+    PBIO_TEST(test_sound_mix),
+    PBIO_TEST(test_sound_envelope),
+    PBIO_TEST(test_sound_sequence),
+    PBIO_TEST(test_sound_adpcm_decode),
+    PBIO_TEST(test_sound_adpcm_play),
+    END_OF_TESTCASES
+};
@@ -12,6 +12,7 @@
 #include <tinytest.h>
 #include <tinytest_macros.h>
 
+#include <pbdrv/clock.h>
 #include <pbdrv/uart.h>
 #include <pbdrv/legodev.h>
 #include <pbdrv/legodev.h>
@@ -39,6 +40,9 @@ static struct {
     uint8_t *rx_msg;
     uint8_t rx_msg_length;
     pbio_error_t rx_msg_result;
+    uint8_t rx_stream[64];
+    uint8_t rx_stream_length;
+    bool rx_streaming;
     uint8_t *tx_msg;
     struct etimer tx_timer;
     uint8_t tx_msg_length;
@@ -48,11 +52,27 @@ static struct {
 PT_THREAD(simulate_rx_msg(struct pt *pt, const uint8_t *msg, uint8_t length, bool *ok)) {
     PT_BEGIN(pt);
 
-    // First uartdev reads one byte header
+    // Wait for uartdev to either begin a read or to poll for streamed data.
     PT_WAIT_UNTIL(pt, ({
         pbio_test_clock_tick(1);
-        test_uart_dev.rx_msg_result == PBIO_ERROR_AGAIN;
+        test_uart_dev.rx_msg_result == PBIO_ERROR_AGAIN || test_uart_dev.rx_streaming;
     }));
+
+    // Once synced, uartdev takes all received bytes at once.
+    if (test_uart_dev.rx_streaming) {
+        tt_uint_op(test_uart_dev.rx_stream_length + length, <=, sizeof(test_uart_dev.rx_stream));
+        memcpy(&test_uart_dev.rx_stream[test_uart_dev.rx_stream_length], msg, length);
+        test_uart_dev.rx_stream_length += length;
+        pbdrv_legodev_pup_uart_process_poll();
+        PT_WAIT_UNTIL(pt, ({
+            pbio_test_clock_tick(1);
+            test_uart_dev.rx_stream_length == 0;
+        }));
+        *ok = true;
+        PT_EXIT(pt);
+    }
+
+    // During sync, uartdev reads one byte header
     tt_uint_op(test_uart_dev.rx_msg_length, ==, 1);
     memcpy(test_uart_dev.rx_msg, msg, 1);
     test_uart_dev.rx_msg_result = PBIO_SUCCESS;
@@ -105,16 +125,6 @@ end:
     PT_EXIT(pt);
 }
 
-#define SIMULATE_RX_MSG(msg) do { \
-        PT_SPAWN(pt, &child, simulate_rx_msg(&child, (msg), PBIO_ARRAY_SIZE(msg), &ok)); \
-        tt_assert_msg(ok, #msg); \
-} while (0)
-
-#define SIMULATE_TX_MSG(msg) do { \
-        PT_SPAWN(pt, &child, simulate_tx_msg(&child, (msg), PBIO_ARRAY_SIZE(msg), &ok)); \
-        tt_assert_msg(ok, #msg); \
-} while (0)
-
 static const uint8_t msg_speed_115200[] = { 0x52, 0x00, 0xC2, 0x01, 0x00, 0x6E }; // SPEED 115200
 static const uint8_t msg_ack[] = { 0x04 }; // ACK
 
@@ -698,12 +708,41 @@ static PT_THREAD(test_technic_large_motor(struct pt *pt)) {
 
     static const uint8_t msg58[] = { 0x02 }; // NACK
 
+    // line noise, a corrupted message and two valid messages back to back
+    static const uint8_t msg59[] = {
+        0xFF, 0x00,
+        0xC0 | 0x10 | 0x04, 0x09, 0x00, 0x09, 0x00, 0x00,
+        0xC0 | 0x10 | 0x04, 0x03, 0x00, 0x04, 0x00, 0x2C,
+        0xC0 | 0x10 | 0x04, 0x05, 0x00, 0x06, 0x00, 0x28,
+    };
+
+    static const uint8_t msg60[] = { 0x43, 0x01, 0xBD }; // set mode 1
+    static const uint8_t msg61[] = { 0x54, 0x20, 0x10, 0x20, 0x30, 0x8B }; // combine SPEED, POS, APOS
+
+    // combined data: speed -5, position 100000, absolute position -90
+    static const uint8_t msg62[] = { 0xC0 | 0x18 | 0x01, 0xFB, 0xA0, 0x86, 0x01, 0x00, 0xA6, 0xFF, 0x00, 0xA3 };
+
     // used in SIMULATE_RX/TX_MSG macros
     static struct pt child;
     static bool ok;
 
     static pbdrv_legodev_dev_t *legodev;
     static pbdrv_legodev_info_t *info;
+    static int16_t *data;
+    static uint8_t *combi_data;
+    static pbdrv_legodev_sample_info_t *sample_info;
+    static uint32_t sample_count;
+    static struct timer timer;
+
+    static const uint8_t combi_items[] = {
+        PBDRV_LEGODEV_COMBI_ITEM(PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__SPEED, 0),
+        PBDRV_LEGODEV_COMBI_ITEM(PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__POS, 0),
+        PBDRV_LEGODEV_COMBI_ITEM(PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__APOS, 0),
+    };
+    static const uint8_t bad_combi_items[] = {
+        PBDRV_LEGODEV_COMBI_ITEM(PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__POS, 0),
+        PBDRV_LEGODEV_COMBI_ITEM(PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__CALIB, 0),
+    };
 
     PT_BEGIN(pt);
 
@@ -799,6 +838,24 @@ static PT_THREAD(test_technic_large_motor(struct pt *pt)) {
         SIMULATE_RX_MSG(msg57);
     }
 
+    // each data message is counted and the time between them is known
+    tt_uint_op(pbdrv_legodev_get_sample_info(legodev, &sample_info), ==, PBIO_SUCCESS);
+    tt_want_uint_op(sample_info->count, >=, 10);
+    tt_want_uint_op(sample_info->num_missed, ==, 0);
+    tt_want_uint_op(sample_info->interval, >, 0);
+    tt_want_uint_op(pbdrv_clock_get_ms() - sample_info->time, <, 5);
+    sample_count = sample_info->count;
+
+    // parser should get back in sync and keep only the valid messages
+    SIMULATE_RX_MSG(msg59);
+    tt_uint_op(pbdrv_legodev_get_data(legodev, PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__CALIB, (void **)&data), ==, PBIO_SUCCESS);
+    tt_want_int_op(data[0], ==, 5);
+    tt_want_int_op(data[1], ==, 6);
+
+    // the bytes dropped before the valid messages count as one loss
+    tt_want_uint_op(sample_info->count, ==, sample_count + 2);
+    tt_want_uint_op(sample_info->num_missed, ==, 1);
+
     tt_uint_op(pbdrv_legodev_get_info(legodev, &info), ==, PBIO_SUCCESS);
 
     tt_want_uint_op(info->type_id, ==, PBDRV_LEGODEV_TYPE_ID_TECHNIC_L_MOTOR);
@@ -829,6 +886,104 @@ static PT_THREAD(test_technic_large_motor(struct pt *pt)) {
     tt_want_uint_op(info->mode_info[5].data_type, ==, PBDRV_LEGODEV_DATA_TYPE_INT16);
     tt_want_uint_op(info->mode_info[5].writable, ==, 0);
 
+    // Only modes 1, 2, and 3 can be combined on this motor.
+    tt_want_uint_op(info->mode_combos, ==, 0x000E);
+    tt_uint_op(pbdrv_legodev_set_mode_combi(legodev, bad_combi_items, PBIO_ARRAY_SIZE(bad_combi_items)), ==, PBIO_ERROR_NOT_SUPPORTED);
+
+    // Several values are then received in one message, without switching modes.
+    tt_uint_op(pbdrv_legodev_set_mode_combi(legodev, combi_items, PBIO_ARRAY_SIZE(combi_items)), ==, PBIO_SUCCESS);
+    SIMULATE_TX_MSG(msg60);
+    SIMULATE_TX_MSG(msg61);
+    tt_uint_op(pbdrv_legodev_is_ready(legodev), ==, PBIO_ERROR_AGAIN);
+
+    // Combined data is ignored until the device sends the combination back.
+    SIMULATE_RX_MSG(msg62);
+    pbio_test_sleep_ms(&timer, 1);
+    tt_uint_op(pbdrv_legodev_is_ready(legodev), ==, PBIO_ERROR_AGAIN);
+    SIMULATE_RX_MSG(msg61);
+    SIMULATE_RX_MSG(msg62);
+    pbio_test_sleep_ms(&timer, 1);
+    tt_uint_op(pbdrv_legodev_get_data(legodev, PBDRV_LEGODEV_MODE_COMBI, (void **)&combi_data), ==, PBIO_SUCCESS);
+    tt_want_uint_op(info->mode, ==, PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__SPEED);
+    tt_want_int_op((int8_t)combi_data[0], ==, -5);
+    tt_want_int_op((int32_t)pbio_get_uint32_le(combi_data + 1), ==, 100000);
+    tt_want_int_op((int16_t)pbio_get_uint16_le(combi_data + 5), ==, -90);
+
+    // Setting the same combination again does not need another mode switch.
+    tt_uint_op(pbdrv_legodev_set_mode_combi(legodev, combi_items, PBIO_ARRAY_SIZE(combi_items)), ==, PBIO_SUCCESS);
+    tt_uint_op(pbdrv_legodev_is_ready(legodev), ==, PBIO_SUCCESS);
+
+    // Stop responding so the device is lost and has to sync again.
+    pbio_test_sleep_ms(&timer, 400);
+
+    SIMULATE_TX_MSG(msg_speed_115200);
+    SIMULATE_RX_MSG(msg_ack);
+    SIMULATE_RX_MSG(msg2);
+    SIMULATE_RX_MSG(msg3);
+    SIMULATE_RX_MSG(msg4);
+    SIMULATE_RX_MSG(msg5);
+    SIMULATE_RX_MSG(msg6);
+    SIMULATE_RX_MSG(msg7);
+    SIMULATE_RX_MSG(msg8);
+    SIMULATE_RX_MSG(msg9);
+    SIMULATE_RX_MSG(msg10);
+    SIMULATE_RX_MSG(msg11);
+    SIMULATE_RX_MSG(msg12);
+    SIMULATE_RX_MSG(msg13);
+    SIMULATE_RX_MSG(msg14);
+    SIMULATE_RX_MSG(msg15);
+    SIMULATE_RX_MSG(msg16);
+    SIMULATE_RX_MSG(msg17);
+    SIMULATE_RX_MSG(msg18);
+    SIMULATE_RX_MSG(msg19);
+    SIMULATE_RX_MSG(msg20);
+    SIMULATE_RX_MSG(msg21);
+    SIMULATE_RX_MSG(msg22);
+    SIMULATE_RX_MSG(msg23);
+    SIMULATE_RX_MSG(msg24);
+    SIMULATE_RX_MSG(msg25);
+    SIMULATE_RX_MSG(msg26);
+    SIMULATE_RX_MSG(msg27);
+    SIMULATE_RX_MSG(msg28);
+    SIMULATE_RX_MSG(msg29);
+    SIMULATE_RX_MSG(msg30);
+    SIMULATE_RX_MSG(msg31);
+    SIMULATE_RX_MSG(msg32);
+    SIMULATE_RX_MSG(msg33);
+    SIMULATE_RX_MSG(msg34);
+    SIMULATE_RX_MSG(msg35);
+    SIMULATE_RX_MSG(msg36);
+    SIMULATE_RX_MSG(msg37);
+    SIMULATE_RX_MSG(msg38);
+    SIMULATE_RX_MSG(msg39);
+    SIMULATE_RX_MSG(msg40);
+    SIMULATE_RX_MSG(msg41);
+    SIMULATE_RX_MSG(msg42);
+    SIMULATE_RX_MSG(msg43);
+    SIMULATE_RX_MSG(msg44);
+    SIMULATE_RX_MSG(msg45);
+    SIMULATE_RX_MSG(msg46);
+    SIMULATE_RX_MSG(msg47);
+    SIMULATE_RX_MSG(msg48);
+    SIMULATE_RX_MSG(msg49);
+    SIMULATE_RX_MSG(msg50);
+    SIMULATE_RX_MSG(msg51);
+    SIMULATE_RX_MSG(msg52);
+    SIMULATE_RX_MSG(msg53);
+    SIMULATE_RX_MSG(msg54);
+
+    SIMULATE_TX_MSG(msg55);
+    SIMULATE_TX_MSG(msg56);
+    SIMULATE_TX_MSG(msg58);
+    SIMULATE_RX_MSG(msg57);
+
+    tt_uint_op(pbdrv_legodev_get_info(legodev, &info), ==, PBIO_SUCCESS);
+    tt_want_uint_op(info->type_id, ==, PBDRV_LEGODEV_TYPE_ID_TECHNIC_L_MOTOR);
+    tt_want_uint_op(info->num_modes, ==, 6);
+    tt_want_uint_op(info->mode, ==, PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__CALIB);
+    tt_want_uint_op(info->mode_info[5].num_values, ==, 14);
+    tt_want_uint_op(info->mode_info[5].data_type, ==, PBDRV_LEGODEV_DATA_TYPE_INT16);
+    tt_want_str_op(info->mode_info[5].name, ==, "STATS");
 
     PT_YIELD(pt);
 
@@ -1056,6 +1211,8 @@ void pbdrv_uart_set_baud_rate(pbdrv_uart_dev_t *uart, uint32_t baud) {
 }
 
 void pbdrv_uart_flush(pbdrv_uart_dev_t *uart_dev) {
+    test_uart_dev.rx_stream_length = 0;
+    test_uart_dev.rx_streaming = false;
 }
 
 extern bool pbio_legodev_test_process_auto_start;
@@ -1070,6 +1227,7 @@ pbio_error_t pbdrv_uart_read_begin(pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t
 
     test_uart_dev.rx_msg = msg;
     test_uart_dev.rx_msg_length = length;
+    test_uart_dev.rx_streaming = false;
     test_uart_dev.rx_msg_result = PBIO_ERROR_AGAIN;
     etimer_set(&test_uart_dev.rx_timer, timeout);
 
@@ -1094,6 +1252,19 @@ void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart) {
 
 }
 
+uint32_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart, uint8_t *buf, uint32_t length) {
+    assert(!test_uart_dev.rx_msg);
+
+    test_uart_dev.rx_streaming = true;
+
+    uint32_t size = test_uart_dev.rx_stream_length < length ? test_uart_dev.rx_stream_length : length;
+    memcpy(buf, test_uart_dev.rx_stream, size);
+    memmove(test_uart_dev.rx_stream, &test_uart_dev.rx_stream[size], test_uart_dev.rx_stream_length - size);
+    test_uart_dev.rx_stream_length -= size;
+
+    return size;
+}
+
 pbio_error_t pbdrv_uart_write_begin(pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint32_t timeout) {
     if (test_uart_dev.tx_msg) {
         return PBIO_ERROR_AGAIN;
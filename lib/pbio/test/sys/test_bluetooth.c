@@ -9,6 +9,7 @@
 #include <tinytest_macros.h>
 #include <tinytest.h>
 
+#include <pbdrv/bluetooth.h>
 #include <pbio/util.h>
 #include <pbsys/bluetooth.h>
 #include <pbsys/main.h>
@@ -90,6 +91,35 @@ static PT_THREAD(test_bluetooth(struct pt *pt)) {
     tt_want_uint_op(size, ==, strlen("test3\n"));
     tt_want_int_op(strncmp("test3\n", (const char *)rx_data, size), ==, 0);
 
+    // stdout should be sent in larger chunks once a larger MTU is negotiated
+    tt_want_uint_op(pbdrv_bluetooth_get_mtu(PBDRV_BLUETOOTH_CONNECTION_PYBRICKS), ==, 23);
+    pbio_test_bluetooth_exchange_mtu(100);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        pbdrv_bluetooth_get_mtu(PBDRV_BLUETOOTH_CONNECTION_PYBRICKS) == 100;
+    }));
+
+    static const char *test_data_4 = "this line is longer than twenty bytes\n";
+    static uint32_t stdout_count;
+    stdout_count = pbio_test_bluetooth_get_pybricks_service_notification_count();
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        size = strlen(test_data_4);
+        pbsys_bluetooth_tx((const uint8_t *)test_data_4, &size) == PBIO_SUCCESS;
+    }));
+
+    tt_want_uint_op(size, ==, strlen(test_data_4));
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        pbio_test_bluetooth_get_pybricks_service_notification_count() != stdout_count;
+    }));
+
+    // one notification with the event type followed by all of the data
+    tt_want_uint_op(pbio_test_bluetooth_get_pybricks_service_notification_size(), ==, strlen(test_data_4) + 1);
+
     // enabling notifications on Pybricks command characteristic should send
     // a notification right away if status is non-zero
     pbsys_status_set(PBIO_PYBRICKS_STATUS_BATTERY_LOW_VOLTAGE_WARNING);
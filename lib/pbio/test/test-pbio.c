@@ -77,6 +77,7 @@ struct testcase_setup_t pbio_test_setup = {
 };
 
 extern struct testcase_t pbdrv_bluetooth_tests[];
+extern struct testcase_t pbdrv_ble5stack_tests[];
 extern struct testcase_t pbdrv_pwm_tests[];
 extern struct testcase_t pbio_angle_tests[];
 extern struct testcase_t pbio_battery_tests[];
@@ -85,8 +86,13 @@ extern struct testcase_t pbio_drivebase_tests[];
 extern struct testcase_t pbio_light_animation_tests[];
 extern struct testcase_t pbio_color_light_tests[];
 extern struct testcase_t pbio_light_matrix_tests[];
+extern struct testcase_t pbio_imu_tests[];
 extern struct testcase_t pbio_int_math_tests[];
+extern struct testcase_t pbio_motion_group_tests[];
+extern struct testcase_t pbio_protocol_tests[];
+extern struct testcase_t pbio_reflex_tests[];
 extern struct testcase_t pbio_servo_tests[];
+extern struct testcase_t pbio_sound_tests[];
 extern struct testcase_t pbio_task_tests[];
 extern struct testcase_t pbio_trajectory_tests[];
 extern struct testcase_t pbdrv_legodev_tests[];
@@ -95,6 +101,7 @@ extern struct testcase_t pbsys_bluetooth_tests[];
 extern struct testcase_t pbsys_status_tests[];
 static struct testgroup_t test_groups[] = {
     { "drv/bluetooth/", pbdrv_bluetooth_tests },
+    { "drv/ble5stack/", pbdrv_ble5stack_tests },
     { "drv/pwm/", pbdrv_pwm_tests },
     { "src/angle/", pbio_angle_tests },
     { "src/battery/", pbio_battery_tests },
@@ -103,8 +110,13 @@ static struct testgroup_t test_groups[] = {
     { "src/light/", pbio_light_animation_tests },
     { "src/light/", pbio_color_light_tests },
     { "src/light/", pbio_light_matrix_tests },
+    { "src/imu/", pbio_imu_tests },
     { "src/math/", pbio_int_math_tests },
+    { "src/motion_group/", pbio_motion_group_tests },
+    { "src/protocol/", pbio_protocol_tests },
+    { "src/reflex/", pbio_reflex_tests },
     { "src/servo/", pbio_servo_tests },
+    { "src/sound/", pbio_sound_tests },
     { "src/task/", pbio_task_tests, },
     { "src/trajectory/", pbio_trajectory_tests },
     { "src/uartdev/", pbdrv_legodev_tests, },
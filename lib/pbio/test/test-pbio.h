@@ -4,8 +4,11 @@
 #ifndef _TEST_PBIO_H_
 #define _TEST_PBIO_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include <contiki.h>
+
 #include <pbio/button.h>
 #include <pbio/int_math.h>
 #include <pbio/main.h>
@@ -31,6 +34,8 @@ uint32_t pbio_test_bluetooth_get_uart_service_notification_count(void);
 void pbio_test_bluetooth_send_uart_data(const uint8_t *data, uint32_t size);
 void pbio_test_bluetooth_enable_pybricks_service_notifications(void);
 uint32_t pbio_test_bluetooth_get_pybricks_service_notification_count(void);
+uint16_t pbio_test_bluetooth_get_pybricks_service_notification_size(void);
+void pbio_test_bluetooth_exchange_mtu(uint16_t mtu);
 void pbio_test_bluetooth_send_pybricks_command(const uint8_t *data, uint32_t size);
 
 typedef enum {
@@ -44,6 +49,24 @@ pbio_test_bluetooth_control_state_t pbio_test_bluetooth_get_control_state(void);
 void pbio_test_counter_set_angle(int32_t rotations, int32_t millidegrees);
 void pbio_test_counter_set_abs_angle(int32_t millidegrees);
 
+// these can be used by tests that use the sound driver
+uint32_t pbio_test_sound_play(uint16_t *data, uint32_t *sample_rate);
+
+// these can be used by tests that simulate a LEGO UART device on port D
+PT_THREAD(simulate_rx_msg(struct pt *pt, const uint8_t *msg, uint8_t length, bool *ok));
+PT_THREAD(simulate_tx_msg(struct pt *pt, const uint8_t *msg, uint8_t length, bool *ok));
+
+// the calling thread must have `static struct pt child` and `static bool ok`
+#define SIMULATE_RX_MSG(msg) do { \
+        PT_SPAWN(pt, &child, simulate_rx_msg(&child, (msg), PBIO_ARRAY_SIZE(msg), &ok)); \
+        tt_assert_msg(ok, #msg); \
+} while (0)
+
+#define SIMULATE_TX_MSG(msg) do { \
+        PT_SPAWN(pt, &child, simulate_tx_msg(&child, (msg), PBIO_ARRAY_SIZE(msg), &ok)); \
+        tt_assert_msg(ok, #msg); \
+} while (0)
+
 // these can be used by tests like servo or drivebases
 #define pbio_test_sleep_until(condition) \
     while (!(condition)) { \
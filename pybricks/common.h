@@ -8,10 +8,12 @@
 
 #if PYBRICKS_PY_COMMON
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <pbio/button.h>
 #include <pbio/color.h>
+#include <pbio/geometry.h>
 #include <pbio/light.h>
 #include <pbdrv/legodev.h>
 
@@ -95,7 +97,7 @@ mp_obj_t pb_type_Control_obj_make_new(pbio_control_t *control);
 #if PYBRICKS_PY_COMMON_MOTOR_MODEL
 // pybricks._common.MotorModel()
 extern const mp_obj_type_t pb_type_MotorModel;
-mp_obj_t pb_type_MotorModel_obj_make_new(pbio_observer_t *observer);
+mp_obj_t pb_type_MotorModel_obj_make_new(pbio_servo_t *srv, mp_obj_t awaitables);
 #endif
 
 #if PYBRICKS_PY_COMMON_LOGGER
@@ -130,12 +132,17 @@ pbio_servo_t *pb_type_motor_get_servo(mp_obj_t motor_in);
 
 extern const mp_obj_type_t pb_type_Speaker;
 
+// Provided by the port, which knows where the downloaded program is stored.
+const uint8_t *pb_user_program_get_data(const char *name, size_t *size);
+
 #endif // PYBRICKS_PY_COMMON_SPEAKER
 
 #if PYBRICKS_PY_COMMON_IMU
 
 mp_obj_t pb_type_IMU_obj_new(mp_obj_t hub_in, mp_obj_t top_side_axis, mp_obj_t front_side_axis);
 
+void pb_type_imu_extract_axis(mp_obj_t obj_in, pbio_geometry_xyz_t *vector);
+
 #endif // PYBRICKS_PY_COMMON_IMU
 
 
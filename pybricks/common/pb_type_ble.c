@@ -9,7 +9,10 @@
 #include <assert.h>
 #include <string.h>
 
+#include <contiki.h>
+
 #include <pbdrv/bluetooth.h>
+#include <pbio/protocol.h>
 
 #include <pbsys/config.h>
 #include <pbsys/storage_settings.h>
@@ -36,17 +39,44 @@
 #define OBSERVED_DATA_TIMEOUT_MS (1000)
 #define OBSERVED_DATA_MAX_SIZE (31 /* max adv data size */ - 5 /* overhead */)
 
+_Static_assert(OBSERVED_DATA_MAX_SIZE == PBIO_BROADCAST_DATA_MAX_SIZE,
+    "advertisement data size mismatch");
+
+#if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+// Messages that do not fit in one advertisement are split into fragments,
+// which are broadcast one after the other in the background. This is the
+// time that each fragment is advertised before moving on to the next, if
+// the broadcast interval is not set. Otherwise each fragment is advertised
+// for two intervals.
+#define FRAGMENT_TIME_MS (200)
+#define MESSAGE_MAX_SIZE (PBIO_BROADCAST_MESSAGE_MAX_SIZE)
+#define MESSAGE_MAX_SIZE_ERROR_TEXT "payload limited to 184 bytes"
+#else
+#define MESSAGE_MAX_SIZE (OBSERVED_DATA_MAX_SIZE)
+#define MESSAGE_MAX_SIZE_ERROR_TEXT "payload limited to 26 bytes"
+#endif
+
 typedef struct {
+    /** Time of the last received advertisement on this channel. */
     uint32_t timestamp;
+    /** Number of times the message received on this channel changed. */
+    uint32_t num_changes;
     uint8_t channel;
     int8_t rssi;
     uint8_t size;
-    uint8_t data[OBSERVED_DATA_MAX_SIZE];
+    uint8_t data[MESSAGE_MAX_SIZE];
+    #if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+    /** Message being reassembled from fragments. */
+    pbio_broadcast_reassembly_t reassembly;
+    #endif
 } observed_data_t;
 
 // pointer to dynamically allocated memory - needed for driver callback
 static observed_data_t *observed_data;
 static uint8_t num_observed_data;
+// Maps channel number to index in observed_data plus one, or zero if the
+// channel is not observed.
+static uint8_t *observed_index;
 
 static pbio_task_t broadcast_task;
 static pbio_task_t toggle_observe_task;
@@ -54,9 +84,32 @@ static pbio_task_t toggle_observe_task;
 typedef struct {
     mp_obj_base_t base;
     mp_obj_t broadcast_channel;
+    uint8_t *observed_index;
     observed_data_t observed_data[];
 } pb_obj_BLE_t;
 
+// Advertising data that is currently being broadcast.
+static struct {
+    pbdrv_bluetooth_value_t v;
+    uint8_t d[5 + OBSERVED_DATA_MAX_SIZE];
+} broadcast_value;
+
+// Encoded message that is being broadcast.
+static struct {
+    uint8_t data[MESSAGE_MAX_SIZE];
+    size_t size;
+    #if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+    uint8_t channel;
+    /** Sequence number, incremented each time the message changes. */
+    uint8_t sequence;
+    uint8_t num_fragments;
+    uint8_t next_fragment;
+    #endif
+} broadcast_message;
+
+// Broadcast interval in ms set by the user, or 0 for the default.
+static uint32_t broadcast_interval;
+
 /**
  * Type codes used for encoding/decoding data.
  */
@@ -78,8 +131,18 @@ typedef enum {
     PB_BLE_BROADCAST_DATA_TYPE_STR = 5,
     /** The Python @c bytes type. */
     PB_BLE_BROADCAST_DATA_TYPE_BYTES = 6,
+    /**
+     * Indicator that this advertisement is one fragment of a longer message.
+     * The lower five bits hold the fragment index, followed by one byte for
+     * the message sequence number, which is incremented each time the message
+     * changes, and one byte for the number of fragments.
+     */
+    PB_BLE_BROADCAST_DATA_TYPE_FRAGMENT = 7,
 } pb_ble_broadcast_data_type_t;
 
+_Static_assert(PB_BLE_BROADCAST_DATA_TYPE_FRAGMENT == PBIO_BROADCAST_FRAGMENT_TYPE,
+    "fragment type mismatch");
+
 #define MFG_SPECIFIC 0xFF
 #define LEGO_CID 0x0397
 
@@ -91,16 +154,43 @@ typedef enum {
  *                          is not allocated in the table.
  */
 static observed_data_t *lookup_observed_data(uint8_t channel) {
-    for (size_t i = 0; i < num_observed_data; i++) {
-        observed_data_t *data = &observed_data[i];
+    if (!observed_index || !observed_index[channel]) {
+        return NULL;
+    }
+    return &observed_data[observed_index[channel] - 1];
+}
 
-        if (data->channel == channel) {
-            return data;
-        }
+/**
+ * Saves a received message if it is different from the previous one.
+ *
+ * @param [in]  ch_data     The channel data.
+ * @param [in]  data        The message.
+ * @param [in]  size        The size of @p data in bytes.
+ */
+static void update_observed_message(observed_data_t *ch_data, const uint8_t *data, uint8_t size) {
+    if (size == ch_data->size && !memcmp(ch_data->data, data, size)) {
+        return;
     }
+    ch_data->size = size;
+    memcpy(ch_data->data, data, size);
+    ch_data->num_changes++;
+}
 
-    return NULL;
+#if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+/**
+ * Adds a received fragment to the message being reassembled, and saves the
+ * message once all fragments are received.
+ *
+ * @param [in]  ch_data     The channel data.
+ * @param [in]  data        The fragment, starting with the fragment header.
+ * @param [in]  size        The size of @p data in bytes.
+ */
+static void update_observed_fragment(observed_data_t *ch_data, const uint8_t *data, uint8_t size) {
+    if (pbio_broadcast_reassemble(&ch_data->reassembly, data, size)) {
+        update_observed_message(ch_data, ch_data->reassembly.data, ch_data->reassembly.size);
+    }
 }
+#endif // PYBRICKS_PY_COMMON_BLE_FRAGMENTS
 
 /**
  * Handles observe event from the bluetooth driver.
@@ -139,8 +229,19 @@ static void handle_observe_event(pbdrv_bluetooth_ad_type_t event_type, const uin
         ch_data->rssi = (ch_data->rssi * (RSSI_FILTER_WINDOW_MS - diff) + rssi * diff) / RSSI_FILTER_WINDOW_MS;
 
         // Extract user broadcast data from signal.
-        ch_data->size = data[0] - 4;
-        memcpy(ch_data->data, &data[5], OBSERVED_DATA_MAX_SIZE);
+        uint8_t size = data[0] - 4;
+        if (size > length - 5 || size > OBSERVED_DATA_MAX_SIZE) {
+            return;
+        }
+
+        #if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+        if (size && data[5] >> 5 == PB_BLE_BROADCAST_DATA_TYPE_FRAGMENT) {
+            update_observed_fragment(ch_data, &data[5], size);
+            return;
+        }
+        #endif
+
+        update_observed_message(ch_data, &data[5], size);
     }
 }
 
@@ -158,8 +259,8 @@ static void handle_observe_event(pbdrv_bluetooth_ad_type_t event_type, const uin
 static size_t pb_module_ble_append(uint8_t *dst, size_t index, const void *src, size_t size, pb_ble_broadcast_data_type_t type) {
     size_t next_index = index + size + 1;
 
-    if (next_index > OBSERVED_DATA_MAX_SIZE) {
-        mp_raise_ValueError(MP_ERROR_TEXT("payload limited to 26 bytes"));
+    if (next_index > MESSAGE_MAX_SIZE) {
+        mp_raise_ValueError(MP_ERROR_TEXT(MESSAGE_MAX_SIZE_ERROR_TEXT));
     }
 
     dst[index] = type << 5 | size;
@@ -242,11 +343,83 @@ static size_t pb_module_ble_encode(void *dst, size_t index, mp_obj_t arg) {
     MP_UNREACHABLE
 }
 
+/**
+ * Starts broadcasting the advertising data in ::broadcast_value.
+ *
+ * If already broadcasting, the advertising data is replaced without
+ * restarting, so ::broadcast_task completes right away.
+ *
+ * @param [in]  channel     The broadcast channel.
+ * @param [in]  size        The size of the user data, starting at index 5.
+ */
+static void pb_module_ble_start_broadcasting(uint8_t channel, size_t size) {
+    broadcast_value.v.size = size + 5;
+    broadcast_value.v.data[0] = size + 4; // length
+    broadcast_value.v.data[1] = MFG_SPECIFIC;
+    pbio_set_uint16_le(&broadcast_value.v.data[2], LEGO_CID);
+    broadcast_value.v.data[4] = channel;
+
+    pbio_error_t err = pbdrv_bluetooth_update_broadcasting(&broadcast_value.v);
+    if (err == PBIO_ERROR_INVALID_OP) {
+        pbdrv_bluetooth_start_broadcasting(&broadcast_task, &broadcast_value.v);
+        return;
+    }
+    broadcast_task.status = err;
+}
+
+#if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+/**
+ * Starts broadcasting the next fragment of ::broadcast_message, going back to
+ * the first one after the last.
+ */
+static void pb_module_ble_start_broadcasting_fragment(void) {
+    uint8_t index = broadcast_message.next_fragment;
+    broadcast_message.next_fragment = (index + 1) % broadcast_message.num_fragments;
+
+    uint8_t size = pbio_broadcast_get_fragment(&broadcast_value.v.data[5],
+        broadcast_message.data, broadcast_message.size, broadcast_message.sequence, index);
+    pb_module_ble_start_broadcasting(broadcast_message.channel, size);
+}
+
+PROCESS(pb_module_ble_fragment_process, "broadcast fragments");
+
+/**
+ * Cycles through the fragments of ::broadcast_message in the background, so
+ * that observers that missed one can receive it in the next cycle. This keeps
+ * going until the next call to broadcast().
+ */
+PROCESS_THREAD(pb_module_ble_fragment_process, ev, data) {
+    static struct etimer timer;
+
+    PROCESS_BEGIN();
+
+    for (;;) {
+        etimer_set(&timer, broadcast_interval ? broadcast_interval * 2 : FRAGMENT_TIME_MS);
+        PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER && etimer_expired(&timer));
+
+        // Broadcasting may still be starting. Stop if it failed.
+        if (broadcast_task.status == PBIO_ERROR_AGAIN) {
+            continue;
+        }
+        if (broadcast_task.status != PBIO_SUCCESS) {
+            break;
+        }
+
+        pb_module_ble_start_broadcasting_fragment();
+    }
+
+    PROCESS_END();
+}
+#endif // PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+
 /**
  * Sets the broadcast advertising data and enables broadcasting on the Bluetooth
  * radio if it is not already enabled.
  *
  * The data can be one object of the allowed types, or a tuple/list thereof.
+ * Data that does not fit in one advertisement is sent as a series of
+ * fragments, if supported, which are repeated in the background until this
+ * is called again.
  *
  * @param [in]  n_args   The number of args.
  * @param [in]  pos_args The args passed in Python code.
@@ -267,19 +440,23 @@ static mp_obj_t pb_module_ble_broadcast(size_t n_args, const mp_obj_t *pos_args,
         mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("no broadcast channel selected"));
     }
 
+    // Broadcasting may still be starting from a previous call.
+    if (broadcast_task.status == PBIO_ERROR_AGAIN) {
+        pb_assert(PBIO_ERROR_BUSY);
+    }
+
     // Stop broadcasting if data is None.
     if (data_in == mp_const_none) {
+        #if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+        process_exit(&pb_module_ble_fragment_process);
+        #endif
         static pbio_task_t stop_broadcasting_task;
         pbdrv_bluetooth_stop_broadcasting(&stop_broadcasting_task);
         return pb_module_tools_pbio_task_wait_or_await(&stop_broadcasting_task);
     }
 
-    static struct {
-        pbdrv_bluetooth_value_t v;
-        uint8_t d[5 + OBSERVED_DATA_MAX_SIZE];
-    } value;
-
     // Get either one or several data objects ready for transmission.
+    uint8_t message[MESSAGE_MAX_SIZE];
     mp_obj_t *objs;
     size_t n_objs;
     size_t index;
@@ -288,7 +465,7 @@ static mp_obj_t pb_module_ble_broadcast(size_t n_args, const mp_obj_t *pos_args,
         mp_obj_get_array(data_in, &n_objs, &objs);
     } else {
         // Set first type to indicate single object.
-        value.v.data[5] = PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT << 5;
+        message[0] = PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT << 5;
         // The one and only value is included directly after.
         index = 1;
         n_objs = 1;
@@ -297,32 +474,98 @@ static mp_obj_t pb_module_ble_broadcast(size_t n_args, const mp_obj_t *pos_args,
 
     // Encode all objects.
     for (size_t i = 0; i < n_objs; i++) {
-        index = pb_module_ble_encode(&value.v.data[5], index, objs[i]);
+        index = pb_module_ble_encode(message, index, objs[i]);
     }
+    uint8_t channel = mp_obj_get_int(self->broadcast_channel);
 
-    value.v.size = index + 5;
-    value.v.data[0] = index + 4; // length
-    value.v.data[1] = MFG_SPECIFIC;
-    pbio_set_uint16_le(&value.v.data[2], LEGO_CID);
-    value.v.data[4] = mp_obj_get_int(self->broadcast_channel);
+    #if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+    // Stop sending fragments of a previous message, if any.
+    process_exit(&pb_module_ble_fragment_process);
 
-    pbdrv_bluetooth_start_broadcasting(&broadcast_task, &value.v);
+    // The sequence number tells observers which fragments belong together,
+    // so it only changes along with the message.
+    if (index != broadcast_message.size || memcmp(message, broadcast_message.data, index)) {
+        broadcast_message.sequence++;
+    }
+    #endif
+    memcpy(broadcast_message.data, message, index);
+    broadcast_message.size = index;
+
+    #if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+    // Send messages that do not fit in one advertisement as fragments, which
+    // keep being sent in the background.
+    if (index > OBSERVED_DATA_MAX_SIZE) {
+        broadcast_message.channel = channel;
+        broadcast_message.num_fragments = pbio_broadcast_get_num_fragments(index);
+        broadcast_message.next_fragment = 0;
+        pb_module_ble_start_broadcasting_fragment();
+        process_start(&pb_module_ble_fragment_process);
+        return pb_module_tools_pbio_task_wait_or_await(&broadcast_task);
+    }
+    #endif // PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+
+    memcpy(&broadcast_value.v.data[5], message, index);
+    pb_module_ble_start_broadcasting(channel, index);
     return pb_module_tools_pbio_task_wait_or_await(&broadcast_task);
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_module_ble_broadcast_obj, 1, pb_module_ble_broadcast);
 
+/**
+ * Sets the advertising interval used for broadcasting.
+ *
+ * The new interval is used the next time broadcasting starts, so it should
+ * be set before the first call to broadcast(), or after broadcast(None).
+ *
+ * @param [in]  self_in     The BLE object.
+ * @param [in]  interval_in Python object containing the interval in ms.
+ * @returns                 None.
+ * @throws ValueError       If the interval is out of range.
+ * @throws OSError          If the Bluetooth chip does not support it.
+ */
+static mp_obj_t pb_module_ble_broadcast_interval(mp_obj_t self_in, mp_obj_t interval_in) {
+    mp_int_t interval = mp_obj_get_int(interval_in);
+    if (interval < PBDRV_BLUETOOTH_BROADCAST_INTERVAL_MIN || interval > PBDRV_BLUETOOTH_BROADCAST_INTERVAL_MAX) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+    pb_assert(pbdrv_bluetooth_set_broadcast_interval(interval));
+    broadcast_interval = interval;
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(pb_module_ble_broadcast_interval_obj, pb_module_ble_broadcast_interval);
+
+/**
+ * Gets how many times the broadcast data was updated since broadcasting
+ * started.
+ *
+ * @param [in]  self_in     The BLE object.
+ * @returns                 Python object containing a tuple of the number of
+ *                          updates accepted by the Bluetooth chip, and the number
+ *                          of updates that were replaced by newer data before
+ *                          they could be sent.
+ */
+static mp_obj_t pb_module_ble_broadcast_stats(mp_obj_t self_in) {
+    pbdrv_bluetooth_broadcast_stats_t stats;
+    pbdrv_bluetooth_get_broadcast_stats(&stats);
+    mp_obj_t ret[] = {
+        mp_obj_new_int_from_uint(stats.submitted),
+        mp_obj_new_int_from_uint(stats.replaced),
+    };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(ret), ret);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(pb_module_ble_broadcast_stats_obj, pb_module_ble_broadcast_stats);
+
 /**
  * Decodes data that was received by the Bluetooth radio.
  *
- * @param [in]      data    Pointer to the start of the advertising data.
+ * @param [in]      data    Pointer to the start of the received message.
  * @param [in,out]  index   When calling, set to the index in @p data to read.
  *                          On return, the value is updated to the next index.
  * @returns                 The decoded value as a Python object.
  * @throws RuntimeError     If the data was invalid and could not be decoded.
  */
-static mp_obj_t pb_module_ble_decode(const observed_data_t *data, size_t *index) {
-    uint8_t size = data->data[*index] & 0x1F;
-    pb_ble_broadcast_data_type_t data_type = data->data[*index] >> 5;
+static mp_obj_t pb_module_ble_decode(const uint8_t *data, size_t *index) {
+    uint8_t size = data[*index] & 0x1F;
+    pb_ble_broadcast_data_type_t data_type = data[*index] >> 5;
 
     (*index)++;
 
@@ -335,19 +578,19 @@ static mp_obj_t pb_module_ble_decode(const observed_data_t *data, size_t *index)
             return mp_const_false;
         case PB_BLE_BROADCAST_DATA_TYPE_INT:
             if (size == sizeof(int8_t)) {
-                int8_t int8_value = data->data[*index];
+                int8_t int8_value = data[*index];
                 (*index) += sizeof(int8_value);
                 return MP_OBJ_NEW_SMALL_INT(int8_value);
             }
 
             if (size == sizeof(int16_t)) {
-                int16_t int16_value = pbio_get_uint16_le(&data->data[*index]);
+                int16_t int16_value = pbio_get_uint16_le(&data[*index]);
                 (*index) += sizeof(int16_value);
                 return MP_OBJ_NEW_SMALL_INT(int16_value);
             }
 
             if (size == sizeof(int32_t)) {
-                int32_t int32_value = pbio_get_uint32_le(&data->data[*index]);
+                int32_t int32_value = pbio_get_uint32_le(&data[*index]);
                 (*index) += sizeof(int32_value);
                 return mp_obj_new_int(int32_value);
             }
@@ -361,7 +604,7 @@ static mp_obj_t pb_module_ble_decode(const observed_data_t *data, size_t *index)
                 float f;
                 uint32_t u;
             } float_value;
-            float_value.u = pbio_get_uint32_le(&data->data[*index]);
+            float_value.u = pbio_get_uint32_le(&data[*index]);
             (*index) += sizeof(float_value);
             return mp_obj_new_float_from_f(float_value.f);
         }
@@ -370,19 +613,21 @@ static mp_obj_t pb_module_ble_decode(const observed_data_t *data, size_t *index)
             #endif
 
         case PB_BLE_BROADCAST_DATA_TYPE_STR: {
-            const char *str_data = (void *)&data->data[*index];
+            const char *str_data = (void *)&data[*index];
             (*index) += size;
             return mp_obj_new_str(str_data, size);
         }
 
         case PB_BLE_BROADCAST_DATA_TYPE_BYTES: {
-            const byte *bytes_data = (void *)&data->data[*index];
+            const byte *bytes_data = (void *)&data[*index];
             (*index) += size;
             return mp_obj_new_bytes(bytes_data, size);
         }
         case PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT:
+        case PB_BLE_BROADCAST_DATA_TYPE_FRAGMENT:
             // Does not contain data by itself, is only used as indicator
-            // that the next data is the one and only object.
+            // that the next data is the one and only object, or as a header
+            // for message fragments.
             break;
     }
 
@@ -436,31 +681,35 @@ static mp_obj_t pb_module_ble_observe(mp_obj_t self_in, mp_obj_t channel_in) {
     // during any MicroPython function call that allocates memory. So, we have
     // to make a copy of it since we are potentially allocating multiple times
     // in a loop below.
-    const observed_data_t ch_data = *pb_module_ble_get_channel_data(channel_in);
+    const observed_data_t *ch_data = pb_module_ble_get_channel_data(channel_in);
 
     // Have not received data yet or timed out.
-    if (ch_data.rssi == INT8_MIN) {
+    if (ch_data->rssi == INT8_MIN) {
         return mp_const_none;
     }
 
+    uint8_t data[MESSAGE_MAX_SIZE];
+    size_t size = ch_data->size;
+    memcpy(data, ch_data->data, size);
+
     // Handle single object.
-    if (ch_data.size != 0 && ch_data.data[0] >> 5 == PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT) {
+    if (size != 0 && data[0] >> 5 == PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT) {
         size_t value_index = 1;
-        return pb_module_ble_decode(&ch_data, &value_index);
+        return pb_module_ble_decode(data, &value_index);
     }
 
     // Objects can be encoded in as little as one byte so we could have up to
     // this many objects received.
-    mp_obj_t items[OBSERVED_DATA_MAX_SIZE];
+    mp_obj_t items[MESSAGE_MAX_SIZE];
 
     size_t index = 0;
     size_t i;
-    for (i = 0; i < OBSERVED_DATA_MAX_SIZE; i++) {
-        if (index >= ch_data.size) {
+    for (i = 0; i < MESSAGE_MAX_SIZE; i++) {
+        if (index >= size) {
             break;
         }
 
-        items[i] = pb_module_ble_decode(&ch_data, &index);
+        items[i] = pb_module_ble_decode(data, &index);
     }
 
     return mp_obj_new_tuple(i, items);
@@ -503,6 +752,30 @@ static mp_obj_t pb_module_ble_signal_strength(mp_obj_t self_in, mp_obj_t channel
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(pb_module_ble_signal_strength_obj, pb_module_ble_signal_strength);
 
+/**
+ * Retrieves when data was last received on the given channel, and how many
+ * times the received message changed.
+ *
+ * @param [in]  self_in     The BLE object.
+ * @param [in]  channel_in  Python object containing the channel number.
+ * @returns                 Python object containing a tuple of the time in
+ *                          milliseconds since data was last received, or None
+ *                          if no data has been received within
+ *                          ::OBSERVED_DATA_TIMEOUT_MS, and the number of
+ *                          times the message changed since observing
+ *                          started.
+ * @throws ValueError       If the channel is out of range.
+ */
+static mp_obj_t pb_module_ble_observe_info(mp_obj_t self_in, mp_obj_t channel_in) {
+    const observed_data_t *ch_data = pb_module_ble_get_channel_data(channel_in);
+    mp_obj_t ret[] = {
+        ch_data->rssi == INT8_MIN ? mp_const_none : mp_obj_new_int(mp_hal_ticks_ms() - ch_data->timestamp),
+        mp_obj_new_int_from_uint(ch_data->num_changes),
+    };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(ret), ret);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(pb_module_ble_observe_info_obj, pb_module_ble_observe_info);
+
 /**
  * Gets the Bluetooth chip frimware version.
  * @param [in]  self_in     The BLE MicroPython object instance.
@@ -517,8 +790,11 @@ static MP_DEFINE_CONST_FUN_OBJ_1(pb_module_ble_version_obj, pb_module_ble_versio
 
 static const mp_rom_map_elem_t common_BLE_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_broadcast), MP_ROM_PTR(&pb_module_ble_broadcast_obj) },
+    { MP_ROM_QSTR(MP_QSTR_broadcast_interval), MP_ROM_PTR(&pb_module_ble_broadcast_interval_obj) },
+    { MP_ROM_QSTR(MP_QSTR_broadcast_stats), MP_ROM_PTR(&pb_module_ble_broadcast_stats_obj) },
     { MP_ROM_QSTR(MP_QSTR_observe), MP_ROM_PTR(&pb_module_ble_observe_obj) },
     { MP_ROM_QSTR(MP_QSTR_observe_enable), MP_ROM_PTR(&pb_module_ble_observe_enable_obj) },
+    { MP_ROM_QSTR(MP_QSTR_observe_info), MP_ROM_PTR(&pb_module_ble_observe_info_obj) },
     { MP_ROM_QSTR(MP_QSTR_signal_strength), MP_ROM_PTR(&pb_module_ble_signal_strength_obj) },
     { MP_ROM_QSTR(MP_QSTR_version), MP_ROM_PTR(&pb_module_ble_version_obj) },
 };
@@ -563,6 +839,12 @@ mp_obj_t pb_type_BLE_new(mp_obj_t broadcast_channel_in, mp_obj_t observe_channel
     pb_obj_BLE_t *self = mp_obj_malloc_var(pb_obj_BLE_t, observed_data_t, num_observe_channels, &pb_type_BLE);
     self->broadcast_channel = broadcast_channel_in;
 
+    // Index to look up channels directly when receiving advertisements.
+    self->observed_index = NULL;
+    if (num_observe_channels > 0) {
+        self->observed_index = m_new0(uint8_t, UINT8_MAX + 1);
+    }
+
     for (mp_int_t i = 0; i < num_observe_channels; i++) {
         mp_int_t channel = mp_obj_get_int(mp_obj_subscr(
             observe_channels_in, MP_OBJ_NEW_SMALL_INT(i), MP_OBJ_SENTINEL));
@@ -573,6 +855,16 @@ mp_obj_t pb_type_BLE_new(mp_obj_t broadcast_channel_in, mp_obj_t observe_channel
 
         self->observed_data[i].channel = channel;
         self->observed_data[i].rssi = INT8_MIN;
+        self->observed_data[i].size = 0;
+        self->observed_data[i].num_changes = 0;
+        #if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+        pbio_broadcast_reassembly_reset(&self->observed_data[i].reassembly);
+        #endif
+
+        // If a channel is given twice, the first one is used.
+        if (!self->observed_index[channel]) {
+            self->observed_index[channel] = i + 1;
+        }
 
         // Suppress stale data by making everything outdated.
         self->observed_data[i].timestamp = mp_hal_ticks_ms() - RSSI_FILTER_WINDOW_MS - OBSERVED_DATA_TIMEOUT_MS;
@@ -580,6 +872,7 @@ mp_obj_t pb_type_BLE_new(mp_obj_t broadcast_channel_in, mp_obj_t observe_channel
 
     // globals for driver callback
     observed_data = self->observed_data;
+    observed_index = self->observed_index;
     num_observed_data = num_observe_channels;
 
     // Start observing right away by default.
@@ -593,9 +886,15 @@ mp_obj_t pb_type_BLE_new(mp_obj_t broadcast_channel_in, mp_obj_t observe_channel
 void pb_type_ble_start_cleanup(void) {
     static pbio_task_t stop_broadcasting_task;
     static pbio_task_t stop_observing_task;
+    #if PYBRICKS_PY_COMMON_BLE_FRAGMENTS
+    process_exit(&pb_module_ble_fragment_process);
+    #endif
     pbdrv_bluetooth_stop_broadcasting(&stop_broadcasting_task);
     pbdrv_bluetooth_stop_observing(&stop_observing_task);
+    pbdrv_bluetooth_set_broadcast_interval(0);
+    broadcast_interval = 0;
     observed_data = NULL;
+    observed_index = NULL;
     num_observed_data = 0;
     // The aforementioned tasks started here are awaited in pybricks de-init.
 }
@@ -154,10 +154,67 @@ static mp_obj_t pb_type_Control_pid(size_t n_args, const mp_obj_t *pos_args, mp_
 
     pb_assert(pbio_control_settings_set_pid(&self->control->settings, kp, ki, kd, integral_deadzone, integral_change_max));
 
+    #if PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+    // Fixed gains replace the gain schedule, so they are not silently ignored.
+    if (kp_in != mp_const_none || ki_in != mp_const_none || kd_in != mp_const_none) {
+        pb_assert(pbio_control_settings_set_gain_schedule(&self->control->settings, NULL, 0));
+    }
+    #endif
+
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Control_pid_obj, 1, pb_type_Control_pid);
 
+#if PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+// pybricks._common.Control.gain_schedule
+static mp_obj_t pb_type_Control_gain_schedule(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_Control_obj_t, self,
+        PB_ARG_DEFAULT_NONE(points));
+
+    pbio_control_gain_schedule_point_t points[PBIO_CONTROL_GAIN_SCHEDULE_SIZE_MAX];
+
+    // If no values are given, return current schedule as a list of
+    // (speed, kp, ki, kd) tuples.
+    if (points_in == mp_const_none) {
+        uint8_t size = pbio_control_settings_get_gain_schedule(&self->control->settings, points);
+        mp_obj_t ret = mp_obj_new_list(size, NULL);
+        for (uint8_t i = 0; i < size; i++) {
+            mp_obj_t point[] = {
+                mp_obj_new_int(points[i].speed),
+                mp_obj_new_int(points[i].pid_kp),
+                mp_obj_new_int(points[i].pid_ki),
+                mp_obj_new_int(points[i].pid_kd),
+            };
+            mp_obj_list_store(ret, MP_OBJ_NEW_SMALL_INT(i), mp_obj_new_tuple(MP_ARRAY_SIZE(point), point));
+        }
+        return ret;
+    }
+
+    // Set new schedule. An empty list disables it, so the fixed gains from
+    // pid() are used again.
+    size_t size;
+    mp_obj_t *point_objs;
+    mp_obj_get_array(points_in, &size, &point_objs);
+    if (size > PBIO_CONTROL_GAIN_SCHEDULE_SIZE_MAX) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+    for (size_t i = 0; i < size; i++) {
+        mp_obj_t *values;
+        mp_obj_get_array_fixed_n(point_objs[i], 4, &values);
+        points[i].speed = pb_obj_get_int(values[0]);
+        points[i].pid_kp = pb_obj_get_int(values[1]);
+        points[i].pid_ki = pb_obj_get_int(values[2]);
+        points[i].pid_kd = pb_obj_get_int(values[3]);
+    }
+    pb_assert(pbio_control_settings_set_gain_schedule(&self->control->settings, points, size));
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Control_gain_schedule_obj, 1, pb_type_Control_gain_schedule);
+#endif // PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+
 // pybricks._common.Control.target_tolerances
 static mp_obj_t pb_type_Control_target_tolerances(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
 
@@ -292,6 +349,9 @@ static const pb_attr_dict_entry_t pb_type_Control_attr_dict[] = {
 static const mp_rom_map_elem_t pb_type_Control_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_limits), MP_ROM_PTR(&pb_type_Control_limits_obj) },
     { MP_ROM_QSTR(MP_QSTR_pid), MP_ROM_PTR(&pb_type_Control_pid_obj) },
+    #if PBIO_CONFIG_CONTROL_GAIN_SCHEDULE
+    { MP_ROM_QSTR(MP_QSTR_gain_schedule), MP_ROM_PTR(&pb_type_Control_gain_schedule_obj) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_target_tolerances), MP_ROM_PTR(&pb_type_Control_target_tolerances_obj) },
     { MP_ROM_QSTR(MP_QSTR_stall_tolerances), MP_ROM_PTR(&pb_type_Control_stall_tolerances_obj) },
     { MP_ROM_QSTR(MP_QSTR_trajectory), MP_ROM_PTR(&pb_type_Control_trajectory_obj) },
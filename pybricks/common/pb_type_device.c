@@ -12,6 +12,8 @@
 #include <pybricks/pupdevices.h>
 #include <pybricks/common/pb_type_device.h>
 
+#include <pybricks/util_mp/pb_kwarg_helper.h>
+#include <pybricks/util_mp/pb_obj_helper.h>
 #include <pybricks/util_pb/pb_error.h>
 
 #include <py/runtime.h>
@@ -79,6 +81,60 @@ static bool pb_pup_device_test_completion(mp_obj_t self_in, uint32_t end_time) {
     return true;
 }
 
+/**
+ * Like ::pb_pup_device_test_completion, but also waits for data that arrived
+ * after the operation was started.
+ *
+ * @param [in]  self_in     The sensor object instance.
+ * @param [in]  end_time    Not used.
+ * @return                  True if new data is available, false otherwise.
+ */
+static bool pb_pup_device_test_fresh_completion(mp_obj_t self_in, uint32_t end_time) {
+    if (!pb_pup_device_test_completion(self_in, end_time)) {
+        return false;
+    }
+    pb_type_device_obj_base_t *sensor = MP_OBJ_TO_PTR(self_in);
+    pbdrv_legodev_sample_info_t *info;
+    pb_assert(pbdrv_legodev_get_sample_info(sensor->legodev, &info));
+    return info->count != sensor->fresh_count;
+}
+
+/**
+ * Awaits data for the mode that was just set, then maps it to a return value.
+ *
+ * If the sensor is set to read fresh samples, this waits for the next sample
+ * instead of returning the most recent data right away.
+ *
+ * @param [in]  sensor_in   The sensor object instance.
+ * @param [in]  get_values  Creates the return object from the data.
+ * @return                  Awaitable object.
+ */
+static mp_obj_t pb_type_device_await_data(mp_obj_t sensor_in, pb_type_awaitable_return_t get_values) {
+    pb_type_device_obj_base_t *sensor = MP_OBJ_TO_PTR(sensor_in);
+
+    pbdrv_legodev_sample_info_t *info;
+    if (sensor->wait_fresh && pbdrv_legodev_get_sample_info(sensor->legodev, &info) == PBIO_SUCCESS) {
+        sensor->fresh_count = info->count;
+        return pb_type_awaitable_await_or_wait(
+            sensor_in,
+            sensor->awaitables,
+            pb_type_awaitable_end_time_none,
+            pb_pup_device_test_fresh_completion,
+            get_values,
+            pb_type_awaitable_cancel_none,
+            PB_TYPE_AWAITABLE_OPT_NONE);
+    }
+
+    return pb_type_awaitable_await_or_wait(
+        sensor_in,
+        sensor->awaitables,
+        pb_type_awaitable_end_time_none,
+        pb_pup_device_test_completion,
+        get_values,
+        pb_type_awaitable_cancel_none,
+        PB_TYPE_AWAITABLE_OPT_NONE);
+}
+
 /**
  * Implements calling of async sensor methods. This is called when a (constant)
  * entry of pb_type_device_method type in a sensor class is called. It is
@@ -99,14 +155,31 @@ mp_obj_t pb_type_device_method_call(mp_obj_t self_in, size_t n_args, size_t n_kw
     pb_type_device_obj_base_t *sensor = MP_OBJ_TO_PTR(sensor_in);
     pb_assert(pbdrv_legodev_set_mode(sensor->legodev, method->mode));
 
-    return pb_type_awaitable_await_or_wait(
-        sensor_in,
-        sensor->awaitables,
-        pb_type_awaitable_end_time_none,
-        pb_pup_device_test_completion,
-        method->get_values,
-        pb_type_awaitable_cancel_none,
-        PB_TYPE_AWAITABLE_OPT_NONE);
+    return pb_type_device_await_data(sensor_in, method->get_values);
+}
+
+/**
+ * Implements calling of async sensor methods that read values from several
+ * modes at once. Instead of switching between modes, the device is set up to
+ * send all requested values in one message, so alternating between them
+ * costs nothing extra.
+ *
+ * @param [in]  sensor_in   The sensor object instance.
+ * @param [in]  items       The values to read, see ::PBDRV_LEGODEV_COMBI_ITEM.
+ * @param [in]  num_items   The number of values.
+ * @param [in]  get_values  Creates the return object from the combined data.
+ * @return                  Awaitable object, or MP_OBJ_NULL if the device
+ *                          does not support combining these values.
+ */
+mp_obj_t pb_type_device_combi_call(mp_obj_t sensor_in, const uint8_t *items, uint8_t num_items, pb_type_awaitable_return_t get_values) {
+    pb_type_device_obj_base_t *sensor = MP_OBJ_TO_PTR(sensor_in);
+    pbio_error_t err = pbdrv_legodev_set_mode_combi(sensor->legodev, items, num_items);
+    if (err == PBIO_ERROR_NOT_SUPPORTED) {
+        return MP_OBJ_NULL;
+    }
+    pb_assert(err);
+
+    return pb_type_device_await_data(sensor_in, get_values);
 }
 
 /**
@@ -143,6 +216,50 @@ mp_obj_t pb_type_device_set_data(pb_type_device_obj_base_t *sensor, uint8_t mode
         PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
 }
 
+/**
+ * Gets statistics about the samples received from a Powered Up device.
+ *
+ * Returns a tuple with the age of the most recent sample in milliseconds, the
+ * average sample rate in Hz, and the number of times that data was lost due
+ * to transmission errors.
+ */
+static mp_obj_t pb_type_device_samples(mp_obj_t self_in) {
+    pb_type_device_obj_base_t *sensor = MP_OBJ_TO_PTR(self_in);
+
+    pbdrv_legodev_sample_info_t *info;
+    pb_assert(pbdrv_legodev_get_sample_info(sensor->legodev, &info));
+
+    mp_obj_t stats[] = {
+        mp_obj_new_int_from_uint(mp_hal_ticks_ms() - info->time),
+        info->interval ? pb_obj_new_fraction(1000000, info->interval) : MP_OBJ_NEW_SMALL_INT(0),
+        mp_obj_new_int_from_uint(info->num_missed),
+    };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(stats), stats);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_device_samples_obj, pb_type_device_samples);
+
+/**
+ * Gets or sets whether reads wait for a sample that arrives after the call.
+ */
+static mp_obj_t pb_type_device_fresh(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_device_obj_base_t, sensor,
+        PB_ARG_DEFAULT_NONE(enable));
+
+    // If no value is given, return current value.
+    if (enable_in == mp_const_none) {
+        return mp_obj_new_bool(sensor->wait_fresh);
+    }
+
+    // Fresh reads rely on the sample count, so the device must provide it.
+    pbdrv_legodev_sample_info_t *info;
+    pb_assert(pbdrv_legodev_get_sample_info(sensor->legodev, &info));
+
+    sensor->wait_fresh = mp_obj_is_true(enable_in);
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_device_fresh_obj, 1, pb_type_device_fresh);
+
 pbdrv_legodev_type_id_t pb_type_device_init_class(pb_type_device_obj_base_t *self, mp_obj_t port_in, pbdrv_legodev_type_id_t valid_id) {
 
     pb_module_tools_assert_blocking();
@@ -155,6 +272,8 @@ pbdrv_legodev_type_id_t pb_type_device_init_class(pb_type_device_obj_base_t *sel
     }
     pb_assert(err);
     self->awaitables = mp_obj_new_list(0, NULL);
+    self->wait_fresh = false;
+    self->fresh_count = 0;
     return actual_id;
 }
 
@@ -21,6 +21,10 @@ typedef struct _pb_type_device_obj_base_t {
     mp_obj_base_t base;
     pbdrv_legodev_dev_t *legodev;
     mp_obj_t awaitables;
+    // Whether reads wait for a sample that arrives after the call.
+    bool wait_fresh;
+    // Sample count when the most recent read that waits for a new sample began.
+    uint32_t fresh_count;
 } pb_type_device_obj_base_t;
 
 #if PYBRICKS_PY_DEVICES
@@ -58,12 +62,16 @@ extern const mp_obj_type_t pb_type_device_method;
 
 mp_obj_t pb_type_device_method_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args);
 mp_obj_t pb_type_pupdevices_method(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args);
+mp_obj_t pb_type_device_combi_call(mp_obj_t sensor_in, const uint8_t *items, uint8_t num_items, pb_type_awaitable_return_t get_values);
 pbdrv_legodev_type_id_t pb_type_device_init_class(pb_type_device_obj_base_t *self, mp_obj_t port_in, pbdrv_legodev_type_id_t valid_id);
 mp_obj_t pb_type_device_set_data(pb_type_device_obj_base_t *sensor, uint8_t mode, const void *data, uint8_t size);
 void *pb_type_device_get_data(mp_obj_t self_in, uint8_t mode);
 
 void *pb_type_device_get_data_blocking(mp_obj_t self_in, uint8_t mode);
 
+MP_DECLARE_CONST_FUN_OBJ_1(pb_type_device_samples_obj);
+MP_DECLARE_CONST_FUN_OBJ_KW(pb_type_device_fresh_obj);
+
 #endif // PYBRICKS_PY_DEVICES
 
 #endif // PYBRICKS_INCLUDED_PYBRICKS_TYPE_DEVICE_H
@@ -53,9 +53,10 @@ MP_DEFINE_CONST_FUN_OBJ_1(pb_type_imu_up_obj, pb_type_imu_up);
 // pybricks._common.IMU.tilt
 static mp_obj_t pb_type_imu_tilt(mp_obj_t self_in) {
 
-    // Read acceleration in the user frame.
+    // Read estimated up vector in the user frame. Unlike the acceleration,
+    // this is not disturbed when the robot accelerates.
     pbio_geometry_xyz_t accl;
-    pbio_imu_get_acceleration(&accl);
+    pbio_imu_get_tilt_vector(&accl);
 
     mp_obj_t tilt[2];
     // Pitch
@@ -69,7 +70,20 @@ static mp_obj_t pb_type_imu_tilt(mp_obj_t self_in) {
 }
 MP_DEFINE_CONST_FUN_OBJ_1(pb_type_imu_tilt_obj, pb_type_imu_tilt);
 
-static void pb_type_imu_extract_axis(mp_obj_t obj_in, pbio_geometry_xyz_t *vector) {
+// pybricks._common.IMU.orientation
+static mp_obj_t pb_type_imu_orientation(mp_obj_t self_in) {
+    pbio_geometry_matrix_3x3_t rotation;
+    pbio_imu_get_orientation(&rotation);
+
+    // Return as 3x3 matrix.
+    pb_type_Matrix_obj_t *matrix = MP_OBJ_TO_PTR(pb_type_Matrix_make_vector(9, rotation.values, false));
+    matrix->m = 3;
+    matrix->n = 3;
+    return MP_OBJ_FROM_PTR(matrix);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_imu_orientation_obj, pb_type_imu_orientation);
+
+void pb_type_imu_extract_axis(mp_obj_t obj_in, pbio_geometry_xyz_t *vector) {
     if (!mp_obj_is_type(obj_in, &pb_type_Matrix)) {
         mp_raise_TypeError(MP_ERROR_TEXT("Axis must be Matrix."));
     }
@@ -162,28 +176,55 @@ static mp_obj_t pb_type_imu_stationary(mp_obj_t self_in) {
 }
 MP_DEFINE_CONST_FUN_OBJ_1(pb_type_imu_stationary_obj, pb_type_imu_stationary);
 
+// Makes a tuple of the x, y, and z values of a vector.
+static mp_obj_t pb_type_imu_make_xyz_tuple(const pbio_geometry_xyz_t *xyz) {
+    mp_obj_t ret[] = {
+        mp_obj_new_float_from_f(xyz->x),
+        mp_obj_new_float_from_f(xyz->y),
+        mp_obj_new_float_from_f(xyz->z),
+    };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(ret), ret);
+}
+
+// Gets the x, y, and z values of a vector from a tuple.
+static void pb_type_imu_get_xyz_tuple(mp_obj_t obj, pbio_geometry_xyz_t *xyz) {
+    mp_obj_t *values;
+    mp_obj_get_array_fixed_n(obj, 3, &values);
+    for (uint8_t i = 0; i < 3; i++) {
+        xyz->values[i] = mp_obj_get_float(values[i]);
+    }
+}
+
 // pybricks._common.IMU.settings
 static mp_obj_t pb_type_imu_settings(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
         pb_type_imu_obj_t, self,
         PB_ARG_DEFAULT_NONE(angular_velocity_threshold),
         PB_ARG_DEFAULT_NONE(acceleration_threshold),
-        PB_ARG_DEFAULT_NONE(heading_correction));
+        PB_ARG_DEFAULT_NONE(heading_correction),
+        PB_ARG_DEFAULT_NONE(angular_velocity_bias));
 
     (void)self;
 
+    pbio_imu_calibration_t calibration;
+    pbio_imu_get_calibration(&calibration);
+
     // Return current values if no arguments are given.
     if (angular_velocity_threshold_in == mp_const_none &&
         acceleration_threshold_in == mp_const_none &&
-        heading_correction_in == mp_const_none) {
+        heading_correction_in == mp_const_none &&
+        angular_velocity_bias_in == mp_const_none) {
         float angular_velocity;
         float acceleration;
         float heading_correction;
         pbio_imu_get_settings(&angular_velocity, &acceleration, &heading_correction);
+        pbio_geometry_xyz_t bias;
+        pbio_imu_get_gyro_bias(&bias);
         mp_obj_t ret[] = {
             mp_obj_new_float_from_f(angular_velocity),
             mp_obj_new_float_from_f(acceleration),
             mp_obj_new_float_from_f(heading_correction),
+            pb_type_imu_make_xyz_tuple(&bias),
         };
         return mp_obj_new_tuple(MP_ARRAY_SIZE(ret), ret);
     }
@@ -195,7 +236,17 @@ static mp_obj_t pb_type_imu_settings(size_t n_args, const mp_obj_t *pos_args, mp
         heading_correction_in == mp_const_none ? NAN : mp_obj_get_float(heading_correction_in)
         ));
 
-    // Request that changed settings are saved on shutdown.
+    // A given bias applies at the current temperature. It replaces what was
+    // learned so far, apart from the temperature dependency.
+    if (angular_velocity_bias_in != mp_const_none) {
+        pb_type_imu_get_xyz_tuple(angular_velocity_bias_in, &calibration.gyro_bias);
+        calibration.temperature_variance = 0.0f;
+        memset(&calibration.gyro_bias_covariance, 0, sizeof(calibration.gyro_bias_covariance));
+        calibration.temperature = pbio_imu_get_temperature();
+    }
+    pb_assert(pbio_imu_set_calibration(&calibration));
+
+    // Request that the settings and calibration are saved on shutdown.
     pbsys_storage_settings_save_imu_settings();
     return mp_const_none;
 }
@@ -252,6 +303,7 @@ static const mp_rom_map_elem_t pb_type_imu_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_acceleration),     MP_ROM_PTR(&pb_type_imu_acceleration_obj)    },
     { MP_ROM_QSTR(MP_QSTR_angular_velocity), MP_ROM_PTR(&pb_type_imu_angular_velocity_obj)},
     { MP_ROM_QSTR(MP_QSTR_heading),          MP_ROM_PTR(&pb_type_imu_heading_obj)         },
+    { MP_ROM_QSTR(MP_QSTR_orientation),      MP_ROM_PTR(&pb_type_imu_orientation_obj)     },
     { MP_ROM_QSTR(MP_QSTR_ready),            MP_ROM_PTR(&pb_type_imu_ready_obj)           },
     { MP_ROM_QSTR(MP_QSTR_reset_heading),    MP_ROM_PTR(&pb_type_imu_reset_heading_obj)   },
     { MP_ROM_QSTR(MP_QSTR_rotation),         MP_ROM_PTR(&pb_type_imu_rotation_obj)        },
@@ -145,15 +145,7 @@ static mp_obj_t common_LightMatrix_on(size_t n_args, const mp_obj_t *pos_args, m
         common_LightMatrix_obj_t, self,
         PB_ARG_DEFAULT_INT(brightness, 100));
 
-    uint8_t size = pbio_light_matrix_get_size(self->light_matrix);
-
-    mp_int_t brightness = pb_obj_get_pct(brightness_in);
-
-    for (uint8_t i = 0; i < size; i++) {
-        for (uint8_t j = 0; j < size; j++) {
-            pb_assert(pbio_light_matrix_set_pixel(self->light_matrix, i, j, brightness));
-        }
-    }
+    pb_assert(pbio_light_matrix_fill(self->light_matrix, pb_obj_get_pct(brightness_in)));
 
     return mp_const_none;
 }
@@ -119,7 +119,7 @@ static mp_obj_t pb_type_Motor_make_new(const mp_obj_type_t *type, size_t n_args,
 
     #if PYBRICKS_PY_COMMON_MOTOR_MODEL
     // Create an instance of the MotorModel class
-    self->model = pb_type_MotorModel_obj_make_new(&self->srv->observer);
+    self->model = pb_type_MotorModel_obj_make_new(self->srv, self->device_base.awaitables);
     #endif
 
     #if PYBRICKS_PY_COMMON_LOGGER
@@ -6,10 +6,12 @@
 #if PYBRICKS_PY_COMMON_MOTOR_MODEL && MICROPY_PY_BUILTINS_FLOAT
 
 #include <pbio/observer.h>
+#include <pbio/servo.h>
 
 #include "py/obj.h"
 
 #include <pybricks/common.h>
+#include <pybricks/tools/pb_type_awaitable.h>
 
 #include <pybricks/util_pb/pb_error.h>
 #include <pybricks/util_mp/pb_obj_helper.h>
@@ -19,12 +21,17 @@
 typedef struct _pb_type_MotorModel_obj_t {
     mp_obj_base_t base;
     pbio_observer_t *observer;
+    pbio_servo_t *srv;
+    mp_obj_t awaitables;
 } pb_type_MotorModel_obj_t;
 
 // pybricks._common.MotorModel.__init__/__new__
-mp_obj_t pb_type_MotorModel_obj_make_new(pbio_observer_t *observer) {
+mp_obj_t pb_type_MotorModel_obj_make_new(pbio_servo_t *srv, mp_obj_t awaitables) {
     pb_type_MotorModel_obj_t *self = mp_obj_malloc(pb_type_MotorModel_obj_t, &pb_type_MotorModel);
-    self->observer = observer;
+    self->observer = &srv->observer;
+    self->srv = srv;
+    // Shared with the motor, so motor commands cancel identification.
+    self->awaitables = awaitables;
     return MP_OBJ_FROM_PTR(self);
 }
 
@@ -86,10 +93,80 @@ static mp_obj_t pb_type_MotorModel_state(mp_obj_t self_in) {
 }
 MP_DEFINE_CONST_FUN_OBJ_1(pb_type_MotorModel_state_obj, pb_type_MotorModel_state);
 
+#if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
+static bool pb_type_MotorModel_identify_test_completion(mp_obj_t self_in, uint32_t end_time) {
+    pb_type_MotorModel_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    // Handle I/O exceptions like port unplugged.
+    if (!pbio_servo_update_loop_is_running(self->srv)) {
+        pb_assert(PBIO_ERROR_NO_DEV);
+    }
+    return pbio_servo_identify_model_is_done(self->srv);
+}
+
+static mp_obj_t pb_type_MotorModel_identify_return_value(mp_obj_t self_in) {
+    pb_type_MotorModel_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    int32_t inertia_ratio;
+    int32_t friction;
+    pb_assert(pbio_servo_identify_model_get_result(self->srv, &inertia_ratio, &friction));
+
+    mp_obj_t result[] = {
+        mp_obj_new_float_from_f(inertia_ratio / 100.0f),
+        mp_obj_new_int(friction),
+    };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(result), result);
+}
+
+static void pb_type_MotorModel_identify_cancel(mp_obj_t self_in) {
+    pb_type_MotorModel_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_assert(pbio_servo_stop(self->srv, PBIO_CONTROL_ON_COMPLETION_COAST));
+}
+
+// pybricks._common.MotorModel.identify
+static mp_obj_t pb_type_MotorModel_identify(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_MotorModel_obj_t, self,
+        PB_ARG_DEFAULT_INT(voltage, 6000),
+        PB_ARG_DEFAULT_INT(time, 3000));
+
+    // Cancel other motor commands before taking control of the motor.
+    pb_type_awaitable_update_all(self->awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+
+    mp_int_t voltage = mp_obj_get_int(voltage_in);
+    mp_int_t time = pb_obj_get_positive_int(time_in);
+    pb_assert(pbio_servo_identify_model(self->srv, voltage, time));
+
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(self),
+        self->awaitables,
+        pb_type_awaitable_end_time_none,
+        pb_type_MotorModel_identify_test_completion,
+        pb_type_MotorModel_identify_return_value,
+        pb_type_MotorModel_identify_cancel,
+        PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_MotorModel_identify_obj, 1, pb_type_MotorModel_identify);
+
+// pybricks._common.MotorModel.reset
+static mp_obj_t pb_type_MotorModel_reset(mp_obj_t self_in) {
+    pb_type_MotorModel_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_assert(pbio_servo_reset_model(self->srv));
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_MotorModel_reset_obj, pb_type_MotorModel_reset);
+
+#endif // PBIO_CONFIG_OBSERVER_IDENTIFICATION
+
 // dir(pybricks.common.MotorModel)
 static const mp_rom_map_elem_t pb_type_MotorModel_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_state),    MP_ROM_PTR(&pb_type_MotorModel_state_obj) },
     { MP_ROM_QSTR(MP_QSTR_settings), MP_ROM_PTR(&pb_type_MotorModel_settings_obj) },
+    #if PBIO_CONFIG_OBSERVER_IDENTIFICATION
+    { MP_ROM_QSTR(MP_QSTR_identify), MP_ROM_PTR(&pb_type_MotorModel_identify_obj) },
+    { MP_ROM_QSTR(MP_QSTR_reset),    MP_ROM_PTR(&pb_type_MotorModel_reset_obj) },
+    #endif
 };
 static MP_DEFINE_CONST_DICT(pb_type_MotorModel_locals_dict, pb_type_MotorModel_locals_dict_table);
 
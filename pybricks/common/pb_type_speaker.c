@@ -3,9 +3,6 @@
 
 // Speaker class for playing sounds.
 
-// TODO: functions implementations need to be moved to lib/pbio/src/sound/sound.c
-// so that they can be used by pbsys as well.
-
 // TODO: share code with ev3dev Speaker type
 
 #include "py/mpconfig.h"
@@ -13,8 +10,9 @@
 #if PYBRICKS_PY_COMMON_SPEAKER && MICROPY_PY_BUILTINS_FLOAT
 
 #include <math.h>
-#include <pbdrv/sound.h>
+#include <pbio/sound.h>
 
+#include "py/mperrno.h"
 #include "py/mphal.h"
 #include "py/obj.h"
 
@@ -29,12 +27,16 @@ typedef struct {
     mp_obj_base_t base;
 
     // State of awaitable sound
-    mp_obj_t notes_generator;
-    uint32_t note_duration;
     uint32_t beep_end_time;
-    uint32_t release_end_time;
     mp_obj_t awaitables;
 
+    // Notes playing in the background. Kept here so they are not garbage
+    // collected while the sound engine reads them.
+    pbio_sound_note_t *notes;
+
+    // Sound data playing in the background, kept for the same reason.
+    mp_obj_t sound_data;
+
     // volume in 0..100 range
     uint8_t volume;
 
@@ -43,8 +45,6 @@ typedef struct {
     uint16_t sample_attenuator;
 } pb_type_Speaker_obj_t;
 
-static uint16_t waveform_data[128];
-
 static mp_obj_t pb_type_Speaker_volume(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
         pb_type_Speaker_obj_t, self,
@@ -63,48 +63,20 @@ static mp_obj_t pb_type_Speaker_volume(size_t n_args, const mp_obj_t *pos_args,
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Speaker_volume_obj, 1, pb_type_Speaker_volume);
 
-static void pb_type_Speaker_generate_square_wave(uint16_t sample_attenuator) {
-    uint16_t lo_amplitude_value = INT16_MAX - sample_attenuator;
-    uint16_t hi_amplitude_value = sample_attenuator + INT16_MAX;
-
-    size_t i = 0;
-    for (; i < MP_ARRAY_SIZE(waveform_data) / 2; i++) {
-        waveform_data[i] = lo_amplitude_value;
-    }
-    for (; i < MP_ARRAY_SIZE(waveform_data); i++) {
-        waveform_data[i] = hi_amplitude_value;
-    }
-}
-
-// For 0 frequencies that are just flat lines.
-static void pb_type_Speaker_generate_line_wave(void) {
-    for (size_t i = 0; i < MP_ARRAY_SIZE(waveform_data); i++) {
-        waveform_data[i] = INT16_MAX;
-    }
-}
-
 static void pb_type_Speaker_start_beep(uint32_t frequency, uint16_t sample_attenuator) {
-    // TODO: allow other wave shapes - sine, triangle, sawtooth
-    // TODO: don't recreate waveform if it hasn't changed shape or volume
-
-    if (frequency == 0) {
-        pb_type_Speaker_generate_line_wave();
-    } else {
-        pb_type_Speaker_generate_square_wave(sample_attenuator);
-    }
-
-    if (frequency < 64) {
+    if (frequency != 0 && frequency < 64) {
         frequency = 64;
     }
-    if (frequency > 24000) {
-        frequency = 24000;
+    if (frequency > PBIO_SOUND_FREQUENCY_MAX) {
+        frequency = PBIO_SOUND_FREQUENCY_MAX;
     }
 
-    pbdrv_sound_start(&waveform_data[0], MP_ARRAY_SIZE(waveform_data), frequency * MP_ARRAY_SIZE(waveform_data));
+    pb_assert(pbio_sound_voice_set_wave(0, PBIO_SOUND_WAVE_SQUARE, sample_attenuator));
+    pb_assert(pbio_sound_voice_note_on(0, frequency));
 }
 
 static void pb_type_Speaker_stop_beep(void) {
-    pbdrv_sound_stop();
+    pbio_sound_stop();
 }
 
 static mp_obj_t pb_type_Speaker_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
@@ -136,8 +108,8 @@ static void pb_type_Speaker_cancel(mp_obj_t self_in) {
     pb_type_Speaker_stop_beep();
     pb_type_Speaker_obj_t *self = MP_OBJ_TO_PTR(self_in);
     self->beep_end_time = mp_hal_ticks_ms();
-    self->release_end_time = self->beep_end_time;
-    self->notes_generator = MP_OBJ_NULL;
+    self->notes = NULL;
+    self->sound_data = MP_OBJ_NULL;
 }
 
 static mp_obj_t pb_type_Speaker_beep(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
@@ -156,8 +128,8 @@ static mp_obj_t pb_type_Speaker_beep(size_t n_args, const mp_obj_t *pos_args, mp
     }
 
     self->beep_end_time = mp_hal_ticks_ms() + (uint32_t)duration;
-    self->release_end_time = self->beep_end_time;
-    self->notes_generator = MP_OBJ_NULL;
+    self->notes = NULL;
+    self->sound_data = MP_OBJ_NULL;
 
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(self),
@@ -170,7 +142,7 @@ static mp_obj_t pb_type_Speaker_beep(size_t n_args, const mp_obj_t *pos_args, mp
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Speaker_beep_obj, 1, pb_type_Speaker_beep);
 
-static void pb_type_Speaker_play_note(pb_type_Speaker_obj_t *self, mp_obj_t obj, int duration) {
+static void pb_type_Speaker_parse_note(mp_obj_t obj, int duration, pbio_sound_note_t *result) {
     const char *note = mp_obj_str_get_str(obj);
     int pos = 0;
     mp_float_t freq;
@@ -330,39 +302,29 @@ static void pb_type_Speaker_play_note(pb_type_Speaker_obj_t *self, mp_obj_t obj,
         pos--;
     }
 
-    pb_type_Speaker_start_beep((uint32_t)freq, self->sample_attenuator);
+    if (freq > PBIO_SOUND_FREQUENCY_MAX) {
+        freq = PBIO_SOUND_FREQUENCY_MAX;
+    }
+
+    if (duration > UINT16_MAX) {
+        duration = UINT16_MAX;
+    }
 
-    uint32_t time_now = mp_hal_ticks_ms();
-    self->release_end_time = time_now + duration;
-    self->beep_end_time = release ? time_now + 7 * duration / 8 : time_now + duration;
+    result->frequency = (uint16_t)freq;
+    result->duration = duration;
+    result->gate = release ? 7 * duration / 8 : duration;
 }
 
 static bool pb_type_Speaker_notes_test_completion(mp_obj_t self_in, uint32_t end_time) {
-    pb_type_Speaker_obj_t *self = MP_OBJ_TO_PTR(self_in);
-
-    bool release_done = mp_hal_ticks_ms() - self->release_end_time < (uint32_t)INT32_MAX;
-    bool beep_done = mp_hal_ticks_ms() - self->beep_end_time < (uint32_t)INT32_MAX;
-
-    if (self->notes_generator != MP_OBJ_NULL && release_done && beep_done) {
-        // Full note done, so get next note.
-        mp_obj_t item = mp_iternext(self->notes_generator);
-
-        // If there is no next note, generator is done.
-        if (item == MP_OBJ_STOP_ITERATION) {
-            return true;
-        }
-
-        // Start the note.
-        pb_type_Speaker_play_note(self, item, self->note_duration);
+    #if PBIO_CONFIG_SOUND
+    if (pbio_sound_voice_is_busy(0)) {
         return false;
     }
-
-    if (beep_done) {
-        // Time to release.
-        pb_type_Speaker_stop_beep();
-    }
-
-    return false;
+    pb_type_Speaker_stop_beep();
+    return true;
+    #else
+    return pb_type_Speaker_beep_test_completion(self_in, end_time);
+    #endif
 }
 
 static mp_obj_t pb_type_Speaker_play_notes(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
@@ -371,10 +333,41 @@ static mp_obj_t pb_type_Speaker_play_notes(size_t n_args, const mp_obj_t *pos_ar
         PB_ARG_REQUIRED(notes),
         PB_ARG_DEFAULT_INT(tempo, 120));
 
-    self->notes_generator = mp_getiter(notes_in, NULL);
-    self->note_duration = 4 * 60 * 1000 / pb_obj_get_int(tempo_in);
-    self->beep_end_time = mp_hal_ticks_ms();
-    self->release_end_time = self->beep_end_time;
+    int note_duration = 4 * 60 * 1000 / pb_obj_get_int(tempo_in);
+
+    // Parse all notes up front, so they can play in the background without
+    // involving the user program.
+    size_t capacity = 16;
+    size_t count = 0;
+    pbio_sound_note_t *notes = m_new(pbio_sound_note_t, capacity);
+    mp_obj_t iterable = mp_getiter(notes_in, NULL);
+    mp_obj_t item;
+    while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
+        if (count == capacity) {
+            notes = m_renew(pbio_sound_note_t, notes, capacity, capacity * 2);
+            capacity *= 2;
+        }
+        pb_type_Speaker_parse_note(item, note_duration, &notes[count++]);
+    }
+
+    // Stop the previous sound before releasing its notes.
+    pb_type_Speaker_stop_beep();
+    self->notes = notes;
+    self->sound_data = MP_OBJ_NULL;
+
+    #if PBIO_CONFIG_SOUND
+    pb_assert(pbio_sound_voice_set_wave(0, PBIO_SOUND_WAVE_SQUARE, self->sample_attenuator));
+    pb_assert(pbio_sound_voice_play(0, notes, count));
+    #else
+    // Without the sound engine, the notes can't be played in the background,
+    // but this still takes as long as playing them would, like beep().
+    uint32_t duration = 0;
+    for (size_t i = 0; i < count; i++) {
+        duration += notes[i].duration;
+    }
+    self->beep_end_time = mp_hal_ticks_ms() + duration;
+    #endif
+
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(self),
         self->awaitables,
@@ -386,10 +379,58 @@ static mp_obj_t pb_type_Speaker_play_notes(size_t n_args, const mp_obj_t *pos_ar
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Speaker_play_notes_obj, 1, pb_type_Speaker_play_notes);
 
+static bool pb_type_Speaker_file_test_completion(mp_obj_t self_in, uint32_t end_time) {
+    if (pbio_sound_adpcm_is_busy()) {
+        return false;
+    }
+    pb_type_Speaker_stop_beep();
+    return true;
+}
+
+static mp_obj_t pb_type_Speaker_play_file(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_Speaker_obj_t, self,
+        PB_ARG_REQUIRED(file));
+
+    // The sound is played straight from the downloaded program or from the
+    // given object, without copying it.
+    const uint8_t *data;
+    size_t size;
+    if (mp_obj_is_str(file_in)) {
+        data = pb_user_program_get_data(mp_obj_str_get_str(file_in), &size);
+        if (!data) {
+            mp_raise_OSError(MP_ENOENT);
+        }
+    } else {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(file_in, &bufinfo, MP_BUFFER_READ);
+        data = bufinfo.buf;
+        size = bufinfo.len;
+    }
+
+    // Stop the previous sound before releasing its data.
+    pb_type_Speaker_stop_beep();
+    self->notes = NULL;
+    self->sound_data = file_in;
+
+    pb_assert(pbio_sound_play_adpcm(data, size, self->sample_attenuator));
+
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(self),
+        self->awaitables,
+        pb_type_awaitable_end_time_none,
+        pb_type_Speaker_file_test_completion,
+        pb_type_awaitable_return_none,
+        pb_type_Speaker_cancel,
+        PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Speaker_play_file_obj, 1, pb_type_Speaker_play_file);
+
 static const mp_rom_map_elem_t pb_type_Speaker_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_volume), MP_ROM_PTR(&pb_type_Speaker_volume_obj) },
     { MP_ROM_QSTR(MP_QSTR_beep), MP_ROM_PTR(&pb_type_Speaker_beep_obj) },
     { MP_ROM_QSTR(MP_QSTR_play_notes), MP_ROM_PTR(&pb_type_Speaker_play_notes_obj) },
+    { MP_ROM_QSTR(MP_QSTR_play_file), MP_ROM_PTR(&pb_type_Speaker_play_file_obj) },
 };
 static MP_DEFINE_CONST_DICT(pb_type_Speaker_locals_dict, pb_type_Speaker_locals_dict_table);
 
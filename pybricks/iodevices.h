@@ -16,6 +16,7 @@ extern const mp_obj_type_t pb_type_iodevices_PUPDevice;
 
 extern const mp_obj_type_t pb_type_iodevices_LWP3Device;
 extern const mp_obj_type_t pb_type_iodevices_XboxController;
+extern const mp_obj_type_t pb_type_iodevices_PybricksHub;
 
 #endif // PYBRICKS_PY_PUPDEVICES
 
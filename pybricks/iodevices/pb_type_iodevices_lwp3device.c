@@ -8,6 +8,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <lwrb/lwrb.h>
+
 #include <pbdrv/bluetooth.h>
 
 #include <pbio/button.h>
@@ -21,6 +23,7 @@
 #include <pybricks/common.h>
 #include <pybricks/parameters.h>
 #include <pybricks/tools.h>
+#include <pybricks/tools/pb_type_awaitable.h>
 #include <pybricks/util_mp/pb_kwarg_helper.h>
 #include <pybricks/util_mp/pb_obj_helper.h>
 #include <pybricks/util_pb/pb_error.h>
@@ -36,6 +39,9 @@
 // A overhead of 3 yields a max message size of 20 (=23-3)
 #define LWP3_MAX_MESSAGE_SIZE 20
 
+// Number of messages that can be queued for LWP3Device.read().
+#define LWP3_NOTIFICATION_QUEUE_SIZE 16
+
 enum {
     REMOTE_PORT_LEFT_BUTTONS    = 0,
     REMOTE_PORT_RIGHT_BUTTONS   = 1,
@@ -88,8 +94,9 @@ static pbdrv_bluetooth_peripheral_char_t pb_lwp3device_char = {
 typedef struct {
     pbio_task_t task;
     #if PYBRICKS_PY_IODEVICES
-    uint8_t buffer[LWP3_MAX_MESSAGE_SIZE];
-    bool notification_received;
+    // Received messages, each starting with its own length byte.
+    lwrb_t notifications;
+    uint8_t notification_buf[LWP3_MAX_MESSAGE_SIZE * LWP3_NOTIFICATION_QUEUE_SIZE + 1];
     #endif // PYBRICKS_PY_IODEVICES
     uint8_t left[3];
     uint8_t right[3];
@@ -103,15 +110,69 @@ typedef struct {
 
 static pb_lwp3device_t pb_lwp3device_singleton;
 
+#if PYBRICKS_PY_IODEVICES
+/**
+ * Replaces a queued port value with a newer value for the same port.
+ *
+ * This is used when the queue is full, so that the latest value of each port
+ * is still available to the user instead of being dropped. The oldest value
+ * for the port is removed and the new value is added to the end of the queue,
+ * so messages are still read in the order they were received.
+ *
+ * @param [in]  ring    The notification queue.
+ * @param [in]  msg     The new message, with a valid length.
+ * @return              True if the message was queued, otherwise false.
+ */
+static bool pb_lwp3device_coalesce(lwrb_t *ring, const uint8_t *msg) {
+    if (msg[2] != LWP3_MSG_TYPE_PORT_VALUE && msg[2] != LWP3_MSG_TYPE_PORT_COMBO_VALUE) {
+        return false;
+    }
+
+    // Find the oldest message of the same type for the same port.
+    size_t full = lwrb_get_full(ring);
+    size_t match;
+    uint8_t header[LWP3_HEADER_SIZE + 1];
+    for (match = 0; match < full; match += header[0]) {
+        lwrb_peek(ring, match, header, sizeof(header));
+        if (header[2] == msg[2] && header[3] == msg[3]) {
+            break;
+        }
+    }
+
+    if (match >= full || lwrb_get_free(ring) + header[0] < msg[0]) {
+        return false;
+    }
+
+    // Cycle all messages through the queue once, leaving out the old value.
+    for (size_t offset = 0; offset < full;) {
+        uint8_t entry[LWP3_MAX_MESSAGE_SIZE];
+        lwrb_peek(ring, 0, entry, 1);
+        lwrb_read(ring, entry, entry[0]);
+        if (offset != match) {
+            lwrb_write(ring, entry, entry[0]);
+        }
+        offset += entry[0];
+    }
+
+    lwrb_write(ring, msg, msg[0]);
+    return true;
+}
+#endif // PYBRICKS_PY_IODEVICES
+
 // Handles LEGO Wireless protocol messages from the LWP3 Device.
 static pbio_pybricks_error_t handle_notification(pbdrv_bluetooth_connection_t connection, const uint8_t *value, uint32_t size) {
     pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
 
     #if PYBRICKS_PY_IODEVICES
-    // Each message overwrites the previous received messages
-    // Messages will be lost if they are not read fast enough
-    memcpy(lwp3device->buffer, &value[0], (size < LWP3_MAX_MESSAGE_SIZE) ? size : LWP3_MAX_MESSAGE_SIZE);
-    lwp3device->notification_received = true;
+    // Queue messages until they are read. If the queue is full, port values
+    // replace older values of the same port and other messages are dropped.
+    if (value[0] >= LWP3_HEADER_SIZE && value[0] <= LWP3_MAX_MESSAGE_SIZE && value[0] <= size) {
+        if (lwrb_get_free(&lwp3device->notifications) >= value[0]) {
+            lwrb_write(&lwp3device->notifications, value, value[0]);
+        } else {
+            pb_lwp3device_coalesce(&lwp3device->notifications, value);
+        }
+    }
 
     if (lwp3device->hub_kind != LWP3_HUB_KIND_HANDSET) {
         // This is not a handset, so we don't care about button state.
@@ -202,6 +263,9 @@ static void pb_lwp3device_connect(const char *name, mp_int_t timeout, lwp3_hub_k
     // needed to ensure that no buttons are "pressed" after reconnecting since
     // we are using static memory
     memset(lwp3device, 0, sizeof(*lwp3device));
+    #if PYBRICKS_PY_IODEVICES
+    lwrb_init(&lwp3device->notifications, lwp3device->notification_buf, sizeof(lwp3device->notification_buf));
+    #endif // PYBRICKS_PY_IODEVICES
 
     // Hub kind and name are set to filter advertisements and responses.
     lwp3device->hub_kind = hub_kind;
@@ -379,6 +443,9 @@ typedef struct _pb_type_pupdevices_Remote_obj_t {
     mp_obj_base_t base;
     mp_obj_t buttons;
     mp_obj_t light;
+    #if PYBRICKS_PY_IODEVICES
+    mp_obj_t read_awaitables;
+    #endif // PYBRICKS_PY_IODEVICES
 } pb_type_pupdevices_Remote_obj_t;
 
 static mp_obj_t pb_type_pupdevices_Remote_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
@@ -488,6 +555,7 @@ static mp_obj_t pb_type_iodevices_LWP3Device_make_new(const mp_obj_type_t *type,
         PB_ARG_DEFAULT_FALSE(pair));
 
     pb_type_pupdevices_Remote_obj_t *self = mp_obj_malloc(pb_type_pupdevices_Remote_obj_t, type);
+    self->read_awaitables = mp_obj_new_list(0, NULL);
 
     const char *name = name_in == mp_const_none ? NULL : mp_obj_str_get_str(name_in);
     mp_int_t timeout = timeout_in == mp_const_none ? -1 : pb_obj_get_positive_int(timeout_in);
@@ -527,28 +595,41 @@ static mp_obj_t lwp3device_write(mp_obj_t self_in, mp_obj_t buf_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(lwp3device_write_obj, lwp3device_write);
 
-static mp_obj_t lwp3device_read(mp_obj_t self_in) {
+static bool lwp3device_read_test_completion(mp_obj_t self_in, uint32_t end_time) {
     pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
 
-    // wait until a notification is received
-    for (;;) {
-        pb_lwp3device_assert_connected();
+    // Queued messages can still be read after disconnecting.
+    if (lwrb_get_full(&lwp3device->notifications)) {
+        return true;
+    }
 
-        if (lwp3device->notification_received) {
-            lwp3device->notification_received = false;
-            break;
-        }
+    pb_lwp3device_assert_connected();
+    return false;
+}
 
-        MICROPY_EVENT_POLL_HOOK
-    }
+static mp_obj_t lwp3device_read_return_value(mp_obj_t self_in) {
+    pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
 
-    size_t len = lwp3device->buffer[0];
+    uint8_t len;
+    lwrb_peek(&lwp3device->notifications, 0, &len, 1);
 
-    if (len < LWP3_HEADER_SIZE || len > LWP3_MAX_MESSAGE_SIZE) {
-        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("bad data"));
-    }
+    vstr_t vstr;
+    vstr_init_len(&vstr, len);
+    lwrb_read(&lwp3device->notifications, vstr.buf, len);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
 
-    return mp_obj_new_bytes(lwp3device->buffer, len);
+static mp_obj_t lwp3device_read(mp_obj_t self_in) {
+    pb_type_pupdevices_Remote_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(self),
+        self->read_awaitables,
+        pb_type_awaitable_end_time_none,
+        lwp3device_read_test_completion,
+        lwp3device_read_return_value,
+        pb_type_awaitable_cancel_none,
+        PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(lwp3device_read_obj, lwp3device_read);
 
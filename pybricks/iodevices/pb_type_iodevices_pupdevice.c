@@ -10,6 +10,7 @@
 #include <pbdrv/legodev.h>
 #include <pbdrv/legodev.h>
 #include <pbio/int_math.h>
+#include <pbio/util.h>
 
 #include "py/objstr.h"
 
@@ -29,6 +30,9 @@ typedef struct _iodevices_PUPDevice_obj_t {
     // on the awaitable instead, as extra context. For now, it is safe since
     // concurrent reads with the same sensor are not permitted.
     uint8_t last_mode;
+    // Values used when initiating awaitable read of several modes at once.
+    uint8_t combi_items[PBDRV_LEGODEV_MAX_COMBI_ITEMS];
+    uint8_t combi_num_items;
     // ID of a passive device, if any.
     pbdrv_legodev_type_id_t passive_id;
 } iodevices_PUPDevice_obj_t;
@@ -109,9 +113,48 @@ static mp_obj_t iodevices_PUPDevice_info(mp_obj_t self_in) {
 }
 MP_DEFINE_CONST_FUN_OBJ_1(iodevices_PUPDevice_info_obj, iodevices_PUPDevice_info);
 
+/**
+ * Gets one value from raw device data and advances past it. The data does not
+ * have to be aligned.
+ *
+ * @param [in, out] data        The raw data.
+ * @param [in]      data_type   Type of the value.
+ * @return                      The value.
+ */
+static mp_obj_t get_pup_value(const uint8_t **data, pbdrv_legodev_data_type_t data_type) {
+    mp_obj_t value;
+    switch (data_type) {
+        case PBDRV_LEGODEV_DATA_TYPE_INT8:
+            value = mp_obj_new_int(*(int8_t *)*data);
+            *data += sizeof(int8_t);
+            break;
+        case PBDRV_LEGODEV_DATA_TYPE_INT16:
+            value = mp_obj_new_int((int16_t)pbio_get_uint16_le(*data));
+            *data += sizeof(int16_t);
+            break;
+        case PBDRV_LEGODEV_DATA_TYPE_INT32:
+            value = mp_obj_new_int((int32_t)pbio_get_uint32_le(*data));
+            *data += sizeof(int32_t);
+            break;
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case PBDRV_LEGODEV_DATA_TYPE_FLOAT: {
+            float f;
+            memcpy(&f, *data, sizeof(f));
+            value = mp_obj_new_float_from_f(f);
+            *data += sizeof(float);
+            break;
+        }
+        #endif
+        default:
+            pb_assert(PBIO_ERROR_IO);
+            return mp_const_none;
+    }
+    return value;
+}
+
 static mp_obj_t get_pup_data_tuple(mp_obj_t self_in) {
     iodevices_PUPDevice_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    void *data = pb_type_device_get_data(self_in, self->last_mode);
+    const uint8_t *data = pb_type_device_get_data(self_in, self->last_mode);
 
     pbdrv_legodev_info_t *info;
     pb_assert(pbdrv_legodev_get_info(self->device_base.legodev, &info));
@@ -119,29 +162,74 @@ static mp_obj_t get_pup_data_tuple(mp_obj_t self_in) {
     mp_obj_t values[PBDRV_LEGODEV_MAX_DATA_SIZE];
 
     for (uint8_t i = 0; i < info->mode_info[info->mode].num_values; i++) {
-        switch (info->mode_info[info->mode].data_type) {
-            case PBDRV_LEGODEV_DATA_TYPE_INT8:
-                values[i] = mp_obj_new_int(((int8_t *)data)[i]);
-                break;
-            case PBDRV_LEGODEV_DATA_TYPE_INT16:
-                values[i] = mp_obj_new_int(((int16_t *)data)[i]);
-                break;
-            case PBDRV_LEGODEV_DATA_TYPE_INT32:
-                values[i] = mp_obj_new_int(((int32_t *)data)[i]);
-                break;
-            #if MICROPY_PY_BUILTINS_FLOAT
-            case PBDRV_LEGODEV_DATA_TYPE_FLOAT:
-                values[i] = mp_obj_new_float_from_f(((float *)data)[i]);
-                break;
-            #endif
-            default:
-                pb_assert(PBIO_ERROR_IO);
-        }
+        values[i] = get_pup_value(&data, info->mode_info[info->mode].data_type);
     }
 
     return mp_obj_new_tuple(info->mode_info[info->mode].num_values, values);
 }
 
+static mp_obj_t get_pup_combi_data_tuple(mp_obj_t self_in) {
+    iodevices_PUPDevice_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    const uint8_t *data = pb_type_device_get_data(self_in, PBDRV_LEGODEV_MODE_COMBI);
+
+    pbdrv_legodev_info_t *info;
+    pb_assert(pbdrv_legodev_get_info(self->device_base.legodev, &info));
+
+    mp_obj_t modes[PBDRV_LEGODEV_MAX_COMBI_ITEMS];
+    mp_obj_t values[PBDRV_LEGODEV_MAX_COMBI_ITEMS];
+    uint8_t num_modes = 0;
+    uint8_t num_values = 0;
+
+    // Values are grouped into one tuple per mode.
+    for (uint8_t i = 0; i < self->combi_num_items; i++) {
+        uint8_t mode = self->combi_items[i] >> 4;
+        values[num_values++] = get_pup_value(&data, info->mode_info[mode].data_type);
+        if (i + 1 == self->combi_num_items || self->combi_items[i + 1] >> 4 != mode) {
+            modes[num_modes++] = mp_obj_new_tuple(num_values, values);
+            num_values = 0;
+        }
+    }
+
+    return mp_obj_new_tuple(num_modes, modes);
+}
+
+/**
+ * Reads all values of several modes at once.
+ *
+ * @param [in]  self        The PUP device.
+ * @param [in]  modes_in    Sequence of modes.
+ * @return                  Awaitable that gives a tuple of values per mode.
+ */
+static mp_obj_t iodevices_PUPDevice_read_combi(iodevices_PUPDevice_obj_t *self, mp_obj_t modes_in) {
+
+    pbdrv_legodev_info_t *info;
+    pb_assert(pbdrv_legodev_get_info(self->device_base.legodev, &info));
+
+    mp_obj_t *modes;
+    size_t num_modes;
+    mp_obj_get_array(modes_in, &num_modes, &modes);
+
+    self->combi_num_items = 0;
+    for (size_t m = 0; m < num_modes; m++) {
+        mp_int_t mode = mp_obj_get_int(modes[m]);
+        if (mode < 0 || mode >= info->num_modes) {
+            mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid mode"));
+        }
+        for (uint8_t i = 0; i < info->mode_info[mode].num_values; i++) {
+            if (self->combi_num_items == PBDRV_LEGODEV_MAX_COMBI_ITEMS) {
+                mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("Expected at most %d values"), PBDRV_LEGODEV_MAX_COMBI_ITEMS);
+            }
+            self->combi_items[self->combi_num_items++] = PBDRV_LEGODEV_COMBI_ITEM(mode, i);
+        }
+    }
+
+    mp_obj_t result = pb_type_device_combi_call(MP_OBJ_FROM_PTR(self), self->combi_items, self->combi_num_items, get_pup_combi_data_tuple);
+    if (result == MP_OBJ_NULL) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Modes cannot be combined"));
+    }
+    return result;
+}
+
 // pybricks.iodevices.PUPDevice.read
 static mp_obj_t iodevices_PUPDevice_read(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
@@ -153,6 +241,11 @@ static mp_obj_t iodevices_PUPDevice_read(size_t n_args, const mp_obj_t *pos_args
         pb_assert(PBIO_ERROR_INVALID_OP);
     }
 
+    // Given several modes, read them all at once.
+    if (!mp_obj_is_int(mode_in)) {
+        return iodevices_PUPDevice_read_combi(self, mode_in);
+    }
+
     self->last_mode = mp_obj_get_int(mode_in);
 
     // We can re-use the same code as for specific sensor types, only the mode
@@ -256,6 +349,8 @@ static const mp_rom_map_elem_t iodevices_PUPDevice_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_read),       MP_ROM_PTR(&iodevices_PUPDevice_read_obj) },
     { MP_ROM_QSTR(MP_QSTR_write),      MP_ROM_PTR(&iodevices_PUPDevice_write_obj)},
     { MP_ROM_QSTR(MP_QSTR_info),       MP_ROM_PTR(&iodevices_PUPDevice_info_obj)},
+    { MP_ROM_QSTR(MP_QSTR_samples),    MP_ROM_PTR(&pb_type_device_samples_obj)},
+    { MP_ROM_QSTR(MP_QSTR_fresh),      MP_ROM_PTR(&pb_type_device_fresh_obj)},
 };
 static MP_DEFINE_CONST_DICT(iodevices_PUPDevice_locals_dict, iodevices_PUPDevice_locals_dict_table);
 
@@ -0,0 +1,448 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include "py/mpconfig.h"
+
+#if PYBRICKS_PY_IODEVICES && PYBRICKS_PY_IODEVICES_PYBRICKS_HUB
+
+#include <stdint.h>
+#include <string.h>
+
+#include <lwrb/lwrb.h>
+
+#include <pbdrv/bluetooth.h>
+#include <pbio/error.h>
+#include <pbio/protocol.h>
+#include <pbio/task.h>
+#include <pbio/util.h>
+
+#include <pbsys/config.h>
+#include <pbsys/storage_settings.h>
+
+#include <pybricks/common.h>
+#include <pybricks/tools.h>
+#include <pybricks/tools/pb_type_awaitable.h>
+#include <pybricks/util_mp/pb_kwarg_helper.h>
+#include <pybricks/util_mp/pb_obj_helper.h>
+#include <pybricks/util_pb/pb_error.h>
+
+#include "py/mphal.h"
+#include "py/runtime.h"
+#include "py/obj.h"
+#include "py/mperrno.h"
+
+// Largest value that fits in pbdrv_bluetooth_value_t, including the command.
+#define PYBRICKS_HUB_MAX_VALUE_SIZE ((PBDRV_BLUETOOTH_MAX_MTU_SIZE - 3) < UINT8_MAX ? (PBDRV_BLUETOOTH_MAX_MTU_SIZE - 3) : UINT8_MAX)
+
+// Buffer for stdout data received from the other hub. Notifications cannot be
+// held back, so data is dropped if it is not read fast enough.
+#define PYBRICKS_HUB_RX_BUFFER_SIZE (512)
+
+// Maximum length of the name in the scan response.
+#define PYBRICKS_HUB_MAX_NAME_SIZE (20)
+
+// Time to wait before retrying a write that the other hub could not accept.
+#define PYBRICKS_HUB_RETRY_TIME_MS (10)
+
+/**
+ * Pybricks Command/Event Characteristic on the other hub.
+ */
+static pbdrv_bluetooth_peripheral_char_t pb_pybricks_hub_char = {
+    .handle = 0, // Will be set during discovery.
+    .properties = 0,
+    .uuid16 = 0,
+    .uuid128 = {
+        0xC5, 0xF5, 0x00, 0x02, 0x82, 0x80, 0x46, 0xDA,
+        0x89, 0xF4, 0x6D, 0x80, 0x51, 0xE4, 0xAE, 0xEF,
+    },
+    .request_notification = true,
+};
+
+typedef struct {
+    pbio_task_t task;
+    // Received stdout data.
+    lwrb_t rx_ring;
+    uint8_t rx_buf[PYBRICKS_HUB_RX_BUFFER_SIZE + 1];
+    // Number of received bytes that did not fit in the buffer.
+    uint32_t rx_dropped;
+    // Last status flags reported by the other hub.
+    uint32_t status;
+    // Data written by the user, sent in chunks.
+    const uint8_t *write_data;
+    size_t write_size;
+    size_t write_done;
+    size_t write_chunk;
+    uint32_t write_time;
+    struct {
+        pbdrv_bluetooth_value_t value;
+        uint8_t payload[PYBRICKS_HUB_MAX_VALUE_SIZE];
+    } __attribute__((packed)) msg;
+    // Name used to filter scan responses.
+    char name[PYBRICKS_HUB_MAX_NAME_SIZE + 1];
+} pb_pybricks_hub_t;
+
+static pb_pybricks_hub_t pb_pybricks_hub_singleton;
+
+// Handles Pybricks protocol events from the other hub.
+static pbio_pybricks_error_t handle_notification(pbdrv_bluetooth_connection_t connection, const uint8_t *value, uint32_t size) {
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+
+    if (size < 1) {
+        return PBIO_PYBRICKS_ERROR_OK;
+    }
+
+    switch (value[0]) {
+        case PBIO_PYBRICKS_EVENT_STATUS_REPORT:
+            if (size >= 5) {
+                hub->status = pbio_get_uint32_le(&value[1]);
+            }
+            break;
+        case PBIO_PYBRICKS_EVENT_WRITE_STDOUT:
+            hub->rx_dropped += size - 1 - lwrb_write(&hub->rx_ring, &value[1], size - 1);
+            break;
+        default:
+            break;
+    }
+
+    return PBIO_PYBRICKS_ERROR_OK;
+}
+
+static pbdrv_bluetooth_ad_match_result_flags_t pybricks_hub_advertisement_matches(uint8_t event_type, const uint8_t *data, const char *name, const uint8_t *addr, const uint8_t *match_addr) {
+    pbdrv_bluetooth_ad_match_result_flags_t flags = PBDRV_BLUETOOTH_AD_MATCH_NONE;
+
+    // Whether this looks like the advertisement of an idle Pybricks hub.
+    if (event_type == PBDRV_BLUETOOTH_AD_TYPE_ADV_IND
+        && data[3] == 17 /* length */
+        && (data[4] == PBDRV_BLUETOOTH_AD_DATA_TYPE_128_BIT_SERV_UUID_COMPLETE_LIST
+            || data[4] == PBDRV_BLUETOOTH_AD_DATA_TYPE_128_BIT_SERV_UUID_INCOMPLETE_LIST)
+        && pbio_uuid128_reverse_compare(&data[5], pbio_pybricks_service_uuid)) {
+        flags |= PBDRV_BLUETOOTH_AD_MATCH_VALUE;
+    }
+
+    // Compare address in advertisement to previously scanned address.
+    if (memcmp(addr, match_addr, 6) == 0) {
+        flags |= PBDRV_BLUETOOTH_AD_MATCH_ADDRESS;
+    }
+    return flags;
+}
+
+static pbdrv_bluetooth_ad_match_result_flags_t pybricks_hub_advertisement_response_matches(uint8_t event_type, const uint8_t *data, const char *name, const uint8_t *addr, const uint8_t *match_addr) {
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+
+    pbdrv_bluetooth_ad_match_result_flags_t flags = PBDRV_BLUETOOTH_AD_MATCH_NONE;
+
+    if (event_type == PBDRV_BLUETOOTH_AD_TYPE_SCAN_RSP) {
+        flags |= PBDRV_BLUETOOTH_AD_MATCH_VALUE;
+    }
+
+    // Compare address in response to previously scanned address.
+    if (memcmp(addr, match_addr, 6) == 0) {
+        flags |= PBDRV_BLUETOOTH_AD_MATCH_ADDRESS;
+    }
+
+    // Compare name to user-provided name if given.
+    if (hub->name[0] != '\0' && strncmp(name, hub->name, PYBRICKS_HUB_MAX_NAME_SIZE) != 0) {
+        flags |= PBDRV_BLUETOOTH_AD_MATCH_NAME_FAILED;
+    }
+
+    return flags;
+}
+
+static void pb_pybricks_hub_assert_connected(void) {
+    if (!pbdrv_bluetooth_is_connected(PBDRV_BLUETOOTH_CONNECTION_PERIPHERAL)) {
+        mp_raise_OSError(MP_ENODEV);
+    }
+}
+
+// pybricks.iodevices.PybricksHub class object
+typedef struct _pb_type_iodevices_PybricksHub_obj_t {
+    mp_obj_base_t base;
+    mp_obj_t write_awaitables;
+    mp_obj_t read_awaitables;
+    // Keeps the data being written and the requested read size.
+    mp_obj_t write_obj;
+    size_t read_size;
+} pb_type_iodevices_PybricksHub_obj_t;
+
+// pybricks.iodevices.PybricksHub.__init__
+static mp_obj_t pb_type_iodevices_PybricksHub_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    PB_PARSE_ARGS_CLASS(n_args, n_kw, args,
+        PB_ARG_DEFAULT_NONE(name),
+        PB_ARG_DEFAULT_INT(timeout, 10000));
+
+    #if PBSYS_CONFIG_BLUETOOTH_TOGGLE
+    if (!pbsys_storage_settings_bluetooth_enabled()) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Bluetooth not enabled"));
+    }
+    #endif // PBSYS_CONFIG_BLUETOOTH_TOGGLE
+
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+
+    // REVISIT: for now, we only allow a single peripheral connection.
+    if (pbdrv_bluetooth_is_connected(PBDRV_BLUETOOTH_CONNECTION_PERIPHERAL)) {
+        pb_assert(PBIO_ERROR_BUSY);
+    }
+
+    const char *name = name_in == mp_const_none ? NULL : mp_obj_str_get_str(name_in);
+    mp_int_t timeout = timeout_in == mp_const_none ? -1 : pb_obj_get_positive_int(timeout_in);
+
+    pb_type_iodevices_PybricksHub_obj_t *self = mp_obj_malloc(pb_type_iodevices_PybricksHub_obj_t, type);
+    self->write_awaitables = mp_obj_new_list(0, NULL);
+    self->read_awaitables = mp_obj_new_list(0, NULL);
+    self->write_obj = mp_const_none;
+
+    // HACK: scan and connect may block sending other Bluetooth messages, so we
+    // need to make sure the stdout queue is drained first to avoid unexpected
+    // behavior
+    mp_hal_stdout_tx_flush();
+
+    memset(hub, 0, sizeof(*hub));
+    lwrb_init(&hub->rx_ring, hub->rx_buf, sizeof(hub->rx_buf));
+    if (name) {
+        strncpy(hub->name, name, PYBRICKS_HUB_MAX_NAME_SIZE);
+    }
+
+    pbdrv_bluetooth_peripheral_scan_and_connect(&hub->task,
+        pybricks_hub_advertisement_matches,
+        pybricks_hub_advertisement_response_matches,
+        handle_notification,
+        PBDRV_BLUETOOTH_PERIPHERAL_OPTIONS_NONE);
+    pb_module_tools_pbio_task_do_blocking(&hub->task, timeout);
+
+    // Copy the name so we can read it back later.
+    strncpy(hub->name, pbdrv_bluetooth_peripheral_get_name(), PYBRICKS_HUB_MAX_NAME_SIZE);
+
+    // Discover the characteristic and enable notifications. This also
+    // negotiates the MTU if the Bluetooth chip supports it.
+    pbdrv_bluetooth_periperal_discover_characteristic(&hub->task, &pb_pybricks_hub_char);
+    pb_module_tools_pbio_task_do_blocking(&hub->task, timeout);
+
+    pbio_set_uint16_le(hub->msg.value.handle, pb_pybricks_hub_char.handle);
+    hub->msg.payload[0] = PBIO_PYBRICKS_COMMAND_WRITE_STDIN;
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+// Sends the next chunk of the data being written.
+static void pb_pybricks_hub_write_chunk(pb_pybricks_hub_t *hub) {
+    // Use as much of the negotiated MTU as possible.
+    size_t max_size = pbdrv_bluetooth_get_mtu(PBDRV_BLUETOOTH_CONNECTION_PERIPHERAL) - 3;
+    if (max_size > PYBRICKS_HUB_MAX_VALUE_SIZE) {
+        max_size = PYBRICKS_HUB_MAX_VALUE_SIZE;
+    }
+
+    hub->write_chunk = hub->write_size - hub->write_done;
+    if (hub->write_chunk > max_size - 1) {
+        hub->write_chunk = max_size - 1;
+    }
+
+    memcpy(&hub->msg.payload[1], &hub->write_data[hub->write_done], hub->write_chunk);
+    hub->msg.value.size = hub->write_chunk + 1;
+    hub->write_time = mp_hal_ticks_ms();
+    pbdrv_bluetooth_peripheral_write(&hub->task, &hub->msg.value);
+}
+
+static bool pb_pybricks_hub_write_test_completion(mp_obj_t self_in, uint32_t end_time) {
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+
+    if (hub->task.status == PBIO_ERROR_AGAIN) {
+        return false;
+    }
+
+    // The other hub replies busy while its stdin buffer is full. This is the
+    // flow control, so send the same chunk again a bit later.
+    if (hub->task.status == PBIO_ERROR_BUSY) {
+        if (mp_hal_ticks_ms() - hub->write_time >= PYBRICKS_HUB_RETRY_TIME_MS) {
+            pb_pybricks_hub_write_chunk(hub);
+        }
+        return false;
+    }
+
+    if (hub->task.status != PBIO_SUCCESS) {
+        hub->write_size = hub->write_done;
+        pb_assert(hub->task.status);
+    }
+
+    hub->write_done += hub->write_chunk;
+    if (hub->write_done == hub->write_size) {
+        return true;
+    }
+
+    pb_pybricks_hub_write_chunk(hub);
+    return false;
+}
+
+static void pb_pybricks_hub_write_cancel(mp_obj_t self_in) {
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+
+    // A chunk that was already sent can't be canceled, but don't send more.
+    hub->write_size = hub->write_done;
+}
+
+// pybricks.iodevices.PybricksHub.write
+static mp_obj_t pb_type_iodevices_PybricksHub_write(mp_obj_t self_in, mp_obj_t data_in) {
+    pb_type_iodevices_PybricksHub_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+
+    pb_pybricks_hub_assert_connected();
+
+    // Only one write at a time, since each one uses the same task.
+    if (hub->task.status == PBIO_ERROR_AGAIN || hub->write_done != hub->write_size) {
+        pb_assert(PBIO_ERROR_BUSY);
+    }
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data_in, &bufinfo, MP_BUFFER_READ);
+
+    if (bufinfo.len == 0) {
+        return pb_type_awaitable_await_or_wait(
+            MP_OBJ_FROM_PTR(self),
+            self->write_awaitables,
+            pb_type_awaitable_end_time_none,
+            pb_type_awaitable_test_completion_yield_once,
+            pb_type_awaitable_return_none,
+            pb_type_awaitable_cancel_none,
+            PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
+    }
+
+    // Keep a reference so the data stays valid until it is all sent.
+    self->write_obj = data_in;
+    hub->write_data = bufinfo.buf;
+    hub->write_size = bufinfo.len;
+    hub->write_done = 0;
+    pb_pybricks_hub_write_chunk(hub);
+
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(self),
+        self->write_awaitables,
+        pb_type_awaitable_end_time_none,
+        pb_pybricks_hub_write_test_completion,
+        pb_type_awaitable_return_none,
+        pb_pybricks_hub_write_cancel,
+        PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(pb_type_iodevices_PybricksHub_write_obj, pb_type_iodevices_PybricksHub_write);
+
+static bool pb_pybricks_hub_read_test_completion(mp_obj_t self_in, uint32_t end_time) {
+    pb_type_iodevices_PybricksHub_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+
+    if (lwrb_get_full(&hub->rx_ring) >= self->read_size) {
+        return true;
+    }
+
+    pb_pybricks_hub_assert_connected();
+    return false;
+}
+
+static mp_obj_t pb_pybricks_hub_read_return_value(mp_obj_t self_in) {
+    pb_type_iodevices_PybricksHub_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+
+    vstr_t vstr;
+    vstr_init_len(&vstr, self->read_size);
+    lwrb_read(&hub->rx_ring, vstr.buf, self->read_size);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+
+// pybricks.iodevices.PybricksHub.read
+static mp_obj_t pb_type_iodevices_PybricksHub_read(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_iodevices_PybricksHub_obj_t, self,
+        PB_ARG_DEFAULT_INT(length, 1));
+
+    mp_int_t length = pb_obj_get_positive_int(length_in);
+    if (length > PYBRICKS_HUB_RX_BUFFER_SIZE) {
+        mp_raise_ValueError(MP_ERROR_TEXT("length exceeds buffer size"));
+    }
+    self->read_size = length;
+
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(self),
+        self->read_awaitables,
+        pb_type_awaitable_end_time_none,
+        pb_pybricks_hub_read_test_completion,
+        pb_pybricks_hub_read_return_value,
+        pb_type_awaitable_cancel_none,
+        PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_iodevices_PybricksHub_read_obj, 1, pb_type_iodevices_PybricksHub_read);
+
+// pybricks.iodevices.PybricksHub.read_all
+static mp_obj_t pb_type_iodevices_PybricksHub_read_all(mp_obj_t self_in) {
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+
+    vstr_t vstr;
+    vstr_init_len(&vstr, lwrb_get_full(&hub->rx_ring));
+    lwrb_read(&hub->rx_ring, vstr.buf, vstr.len);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(pb_type_iodevices_PybricksHub_read_all_obj, pb_type_iodevices_PybricksHub_read_all);
+
+// pybricks.iodevices.PybricksHub.waiting
+static mp_obj_t pb_type_iodevices_PybricksHub_waiting(mp_obj_t self_in) {
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+    return mp_obj_new_int(lwrb_get_full(&hub->rx_ring));
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(pb_type_iodevices_PybricksHub_waiting_obj, pb_type_iodevices_PybricksHub_waiting);
+
+// pybricks.iodevices.PybricksHub.dropped
+static mp_obj_t pb_type_iodevices_PybricksHub_dropped(mp_obj_t self_in) {
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+    return mp_obj_new_int(hub->rx_dropped);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(pb_type_iodevices_PybricksHub_dropped_obj, pb_type_iodevices_PybricksHub_dropped);
+
+// pybricks.iodevices.PybricksHub.running
+static mp_obj_t pb_type_iodevices_PybricksHub_running(mp_obj_t self_in) {
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+    pb_pybricks_hub_assert_connected();
+    return mp_obj_new_bool(hub->status & PBIO_PYBRICKS_STATUS_FLAG(PBIO_PYBRICKS_STATUS_USER_PROGRAM_RUNNING));
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(pb_type_iodevices_PybricksHub_running_obj, pb_type_iodevices_PybricksHub_running);
+
+// pybricks.iodevices.PybricksHub.mtu
+static mp_obj_t pb_type_iodevices_PybricksHub_mtu(mp_obj_t self_in) {
+    pb_pybricks_hub_assert_connected();
+    return mp_obj_new_int(pbdrv_bluetooth_get_mtu(PBDRV_BLUETOOTH_CONNECTION_PERIPHERAL));
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(pb_type_iodevices_PybricksHub_mtu_obj, pb_type_iodevices_PybricksHub_mtu);
+
+// pybricks.iodevices.PybricksHub.name
+static mp_obj_t pb_type_iodevices_PybricksHub_name(mp_obj_t self_in) {
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+    return mp_obj_new_str(hub->name, strlen(hub->name));
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(pb_type_iodevices_PybricksHub_name_obj, pb_type_iodevices_PybricksHub_name);
+
+// pybricks.iodevices.PybricksHub.disconnect
+static mp_obj_t pb_type_iodevices_PybricksHub_disconnect(mp_obj_t self_in) {
+    pb_pybricks_hub_t *hub = &pb_pybricks_hub_singleton;
+    pb_pybricks_hub_assert_connected();
+    pbdrv_bluetooth_peripheral_disconnect(&hub->task);
+    return pb_module_tools_pbio_task_wait_or_await(&hub->task);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(pb_type_iodevices_PybricksHub_disconnect_obj, pb_type_iodevices_PybricksHub_disconnect);
+
+// dir(pybricks.iodevices.PybricksHub)
+static const mp_rom_map_elem_t pb_type_iodevices_PybricksHub_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_write),      MP_ROM_PTR(&pb_type_iodevices_PybricksHub_write_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_read),       MP_ROM_PTR(&pb_type_iodevices_PybricksHub_read_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_read_all),   MP_ROM_PTR(&pb_type_iodevices_PybricksHub_read_all_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_waiting),    MP_ROM_PTR(&pb_type_iodevices_PybricksHub_waiting_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_dropped),    MP_ROM_PTR(&pb_type_iodevices_PybricksHub_dropped_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_running),    MP_ROM_PTR(&pb_type_iodevices_PybricksHub_running_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_mtu),        MP_ROM_PTR(&pb_type_iodevices_PybricksHub_mtu_obj)        },
+    { MP_ROM_QSTR(MP_QSTR_name),       MP_ROM_PTR(&pb_type_iodevices_PybricksHub_name_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_disconnect), MP_ROM_PTR(&pb_type_iodevices_PybricksHub_disconnect_obj) },
+};
+static MP_DEFINE_CONST_DICT(pb_type_iodevices_PybricksHub_locals_dict, pb_type_iodevices_PybricksHub_locals_dict_table);
+
+// type(pybricks.iodevices.PybricksHub)
+MP_DEFINE_CONST_OBJ_TYPE(pb_type_iodevices_PybricksHub,
+    MP_QSTR_PybricksHub,
+    MP_TYPE_FLAG_NONE,
+    make_new, pb_type_iodevices_PybricksHub_make_new,
+    locals_dict, &pb_type_iodevices_PybricksHub_locals_dict);
+
+#endif // PYBRICKS_PY_IODEVICES && PYBRICKS_PY_IODEVICES_PYBRICKS_HUB
@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include <pbdrv/bluetooth.h>
+#include <pbdrv/clock.h>
 #include <pbio/button.h>
 #include <pbio/color.h>
 #include <pbio/error.h>
@@ -21,6 +22,7 @@
 #include <pybricks/common.h>
 #include <pybricks/parameters.h>
 #include <pybricks/tools.h>
+#include <pybricks/tools/pb_type_awaitable.h>
 #include <pybricks/util_mp/pb_kwarg_helper.h>
 #include <pybricks/util_mp/pb_obj_helper.h>
 #include <pybricks/util_pb/pb_error.h>
@@ -77,18 +79,171 @@ typedef struct __attribute__((packed)) {
     uint8_t paddles;
 } xbox_input_map_t;
 
+/**
+ * Names of the buttons, indexed by their bit in the mask given by
+ * pb_xbox_get_pressed(). Unused bits are MP_QSTR_NULL.
+ */
+static const qstr pb_xbox_button_names[] = {
+    MP_QSTR_A, MP_QSTR_B, MP_QSTR_NULL, MP_QSTR_X,
+    MP_QSTR_Y, MP_QSTR_NULL, MP_QSTR_LB, MP_QSTR_RB,
+    MP_QSTR_NULL, MP_QSTR_NULL, MP_QSTR_VIEW, MP_QSTR_MENU,
+    MP_QSTR_GUIDE, MP_QSTR_LJ, MP_QSTR_RJ, MP_QSTR_NULL,
+    MP_QSTR_UPLOAD, MP_QSTR_P1, MP_QSTR_P2, MP_QSTR_P3,
+    MP_QSTR_P4, MP_QSTR_UP, MP_QSTR_RIGHT, MP_QSTR_DOWN,
+    MP_QSTR_LEFT,
+};
+
+// Bit offsets of the buttons that are not in the main buttons field.
+#define XBOX_BUTTON_BIT_UPLOAD (16)
+#define XBOX_BUTTON_BIT_PADDLES (17)
+#define XBOX_BUTTON_BIT_DPAD (21)
+
+/**
+ * Names of the analog inputs, indexed by xbox_event_t.index for axis events.
+ */
+static const qstr pb_xbox_axis_names[] = {
+    MP_QSTR_LX, MP_QSTR_LY, MP_QSTR_RX, MP_QSTR_RY, MP_QSTR_LT, MP_QSTR_RT,
+};
+
+#define XBOX_NUM_AXES (MP_ARRAY_SIZE(pb_xbox_axis_names))
+
+// Number of input events that can be queued for XboxController.event().
+#define XBOX_EVENT_QUEUE_SIZE (32)
+
+typedef enum {
+    XBOX_EVENT_BUTTON,
+    XBOX_EVENT_AXIS,
+} xbox_event_kind_t;
+
+typedef struct {
+    // Time of the input report that caused this event.
+    uint32_t time;
+    // Whether this is a button or analog input change.
+    uint8_t kind;
+    // Button bit or axis index.
+    uint8_t index;
+    // Button state (0 or 1) or axis value (-100 to 100).
+    int8_t value;
+} xbox_event_t;
+
 typedef struct {
     pbio_task_t task;
     xbox_input_map_t state;
+    // Deadzone and minimum change for analog input events, in percent.
+    int8_t joystick_deadzone;
+    int8_t event_threshold;
+    // Last reported state of buttons and analog inputs.
+    uint32_t pressed;
+    int8_t axes[XBOX_NUM_AXES];
+    // Queued input events. If full, the oldest event is dropped.
+    xbox_event_t events[XBOX_EVENT_QUEUE_SIZE];
+    uint8_t events_first;
+    uint8_t events_count;
 } pb_xbox_t;
 
 static pb_xbox_t pb_xbox_singleton;
 
+/**
+ * Gets the state of all buttons as a mask, including paddles and dpad.
+ *
+ * @param [in]  state   The input report.
+ * @return              Mask of pressed buttons, see ::pb_xbox_button_names.
+ */
+static uint32_t pb_xbox_get_pressed(const xbox_input_map_t *state) {
+    // Dpad value 1 is up, going clockwise in steps of 45 degrees.
+    static const uint8_t dpad_directions[] = {
+        0, 0x01, 0x03, 0x02, 0x06, 0x04, 0x0c, 0x08, 0x09,
+    };
+
+    uint32_t pressed = state->buttons;
+    if (state->upload) {
+        pressed |= 1 << XBOX_BUTTON_BIT_UPLOAD;
+    }
+    pressed |= (uint32_t)(state->paddles & 0x0f) << XBOX_BUTTON_BIT_PADDLES;
+    if (state->dpad < MP_ARRAY_SIZE(dpad_directions)) {
+        pressed |= (uint32_t)dpad_directions[state->dpad] << XBOX_BUTTON_BIT_DPAD;
+    }
+    return pressed;
+}
+
+/**
+ * Scales joystick values to percent and applies a square deadzone.
+ *
+ * @param [in]  deadzone    Deadzone in percent.
+ * @param [in]  x_raw       Raw horizontal value.
+ * @param [in]  y_raw       Raw vertical value.
+ * @param [out] x           Horizontal value, positive to the right.
+ * @param [out] y           Vertical value, positive to the top.
+ */
+static void pb_xbox_get_joystick(int32_t deadzone, uint16_t x_raw, uint16_t y_raw, int32_t *x, int32_t *y) {
+    *x = (x_raw - INT16_MAX) * 100 / INT16_MAX;
+    *y = (INT16_MAX - y_raw) * 100 / INT16_MAX;
+
+    // Apply square deadzone to prevent drift.
+    if (*x < deadzone && *x > -deadzone && *y < deadzone && *y > -deadzone) {
+        *x = 0;
+        *y = 0;
+    }
+}
+
+static void pb_xbox_push_event(pb_xbox_t *xbox, uint32_t time, xbox_event_kind_t kind, uint8_t index, int8_t value) {
+    if (xbox->events_count == XBOX_EVENT_QUEUE_SIZE) {
+        xbox->events_first = (xbox->events_first + 1) % XBOX_EVENT_QUEUE_SIZE;
+        xbox->events_count--;
+    }
+    xbox_event_t *event = &xbox->events[(xbox->events_first + xbox->events_count) % XBOX_EVENT_QUEUE_SIZE];
+    event->time = time;
+    event->kind = kind;
+    event->index = index;
+    event->value = value;
+    xbox->events_count++;
+}
+
+/**
+ * Queues an event for each button that was pressed or released and for each
+ * analog input that changed by at least the event threshold since the last
+ * event for that input. Returning to zero or reaching full scale is always
+ * reported, so the last event of an input matches its final state.
+ *
+ * @param [in]  xbox    The controller state, with the new input report.
+ */
+static void pb_xbox_update_events(pb_xbox_t *xbox) {
+    uint32_t time = pbdrv_clock_get_ms();
+
+    uint32_t pressed = pb_xbox_get_pressed(&xbox->state);
+    uint32_t changed = pressed ^ xbox->pressed;
+    for (uint8_t i = 0; i < MP_ARRAY_SIZE(pb_xbox_button_names); i++) {
+        if ((changed & (1 << i)) && pb_xbox_button_names[i] != MP_QSTR_NULL) {
+            pb_xbox_push_event(xbox, time, XBOX_EVENT_BUTTON, i, !!(pressed & (1 << i)));
+        }
+    }
+    xbox->pressed = pressed;
+
+    int32_t axes[XBOX_NUM_AXES];
+    pb_xbox_get_joystick(xbox->joystick_deadzone, xbox->state.x, xbox->state.y, &axes[0], &axes[1]);
+    pb_xbox_get_joystick(xbox->joystick_deadzone, xbox->state.z, xbox->state.rz, &axes[2], &axes[3]);
+    axes[4] = xbox->state.left_trigger * 100 / 1023;
+    axes[5] = xbox->state.right_trigger * 100 / 1023;
+
+    for (uint8_t i = 0; i < XBOX_NUM_AXES; i++) {
+        int32_t change = axes[i] - xbox->axes[i];
+        if (change == 0) {
+            continue;
+        }
+        if (change >= xbox->event_threshold || change <= -xbox->event_threshold
+            || axes[i] == 0 || axes[i] == 100 || axes[i] == -100) {
+            pb_xbox_push_event(xbox, time, XBOX_EVENT_AXIS, i, axes[i]);
+            xbox->axes[i] = axes[i];
+        }
+    }
+}
+
 // Handles LEGO Wireless protocol messages from the XBOX Device.
 static pbio_pybricks_error_t handle_notification(pbdrv_bluetooth_connection_t connection, const uint8_t *value, uint32_t size) {
     pb_xbox_t *xbox = &pb_xbox_singleton;
     if (size <= sizeof(xbox_input_map_t)) {
         memcpy(&xbox->state, &value[0], size);
+        pb_xbox_update_events(xbox);
     }
     return PBIO_PYBRICKS_ERROR_OK;
 }
@@ -173,6 +328,7 @@ typedef struct _pb_type_xbox_obj_t {
     mp_obj_base_t base;
     mp_obj_t buttons;
     mp_int_t joystick_deadzone;
+    mp_obj_t event_awaitables;
 } pb_type_xbox_obj_t;
 
 static void pb_xbox_discover_and_read(pbdrv_bluetooth_peripheral_char_t *char_info) {
@@ -194,83 +350,18 @@ static xbox_input_map_t *pb_xbox_get_buttons(void) {
 }
 
 static mp_obj_t pb_xbox_button_pressed(void) {
-    xbox_input_map_t *buttons = pb_xbox_get_buttons();
+    uint32_t pressed = pb_xbox_get_pressed(pb_xbox_get_buttons());
 
     // At most 16 simultaneous button presses, plus up to two dpad directions.
     mp_obj_t items[16 + 2];
     size_t count = 0;
 
-    if (buttons->buttons & 1) {
-        items[count++] = pb_type_button_new(MP_QSTR_A);
-    }
-    if (buttons->buttons & (1 << 1)) {
-        items[count++] = pb_type_button_new(MP_QSTR_B);
-    }
-    if (buttons->buttons & (1 << 3)) {
-        items[count++] = pb_type_button_new(MP_QSTR_X);
-    }
-    if (buttons->buttons & (1 << 4)) {
-        items[count++] = pb_type_button_new(MP_QSTR_Y);
-    }
-    if (buttons->buttons & (1 << 6)) {
-        items[count++] = pb_type_button_new(MP_QSTR_LB);
-    }
-    if (buttons->buttons & (1 << 7)) {
-        items[count++] = pb_type_button_new(MP_QSTR_RB);
-    }
-    if (buttons->buttons & (1 << 10)) {
-        items[count++] = pb_type_button_new(MP_QSTR_VIEW);
-    }
-    if (buttons->buttons & (1 << 11)) {
-        items[count++] = pb_type_button_new(MP_QSTR_MENU);
-    }
-    if (buttons->buttons & (1 << 12)) {
-        items[count++] = pb_type_button_new(MP_QSTR_GUIDE);
-    }
-    if (buttons->buttons & (1 << 13)) {
-        items[count++] = pb_type_button_new(MP_QSTR_LJ);
-    }
-    if (buttons->buttons & (1 << 14)) {
-        items[count++] = pb_type_button_new(MP_QSTR_RJ);
-    }
-    if (buttons->upload) {
-        items[count++] = pb_type_button_new(MP_QSTR_UPLOAD);
-    }
-    if (buttons->paddles & (1 << 0)) {
-        items[count++] = pb_type_button_new(MP_QSTR_P1);
-    }
-    if (buttons->paddles & (1 << 1)) {
-        items[count++] = pb_type_button_new(MP_QSTR_P2);
-    }
-    if (buttons->paddles & (1 << 2)) {
-        items[count++] = pb_type_button_new(MP_QSTR_P3);
-    }
-    if (buttons->paddles & (1 << 3)) {
-        items[count++] = pb_type_button_new(MP_QSTR_P4);
-    }
-
     // Dpad is available as separate method, but can also be used as
     // a normal set of buttons.
-    if (buttons->dpad == 1) {
-        items[count++] = pb_type_button_new(MP_QSTR_UP);
-    } else if (buttons->dpad == 2) {
-        items[count++] = pb_type_button_new(MP_QSTR_UP);
-        items[count++] = pb_type_button_new(MP_QSTR_RIGHT);
-    } else if (buttons->dpad == 3) {
-        items[count++] = pb_type_button_new(MP_QSTR_RIGHT);
-    } else if (buttons->dpad == 4) {
-        items[count++] = pb_type_button_new(MP_QSTR_RIGHT);
-        items[count++] = pb_type_button_new(MP_QSTR_DOWN);
-    } else if (buttons->dpad == 5) {
-        items[count++] = pb_type_button_new(MP_QSTR_DOWN);
-    } else if (buttons->dpad == 6) {
-        items[count++] = pb_type_button_new(MP_QSTR_DOWN);
-        items[count++] = pb_type_button_new(MP_QSTR_LEFT);
-    } else if (buttons->dpad == 7) {
-        items[count++] = pb_type_button_new(MP_QSTR_LEFT);
-    } else if (buttons->dpad == 8) {
-        items[count++] = pb_type_button_new(MP_QSTR_LEFT);
-        items[count++] = pb_type_button_new(MP_QSTR_UP);
+    for (uint8_t i = 0; i < MP_ARRAY_SIZE(pb_xbox_button_names) && count < MP_ARRAY_SIZE(items); i++) {
+        if ((pressed & (1 << i)) && pb_xbox_button_names[i] != MP_QSTR_NULL) {
+            items[count++] = pb_type_button_new(pb_xbox_button_names[i]);
+        }
     }
 
     return mp_obj_new_set(count, items);
@@ -279,7 +370,8 @@ static mp_obj_t pb_xbox_button_pressed(void) {
 static mp_obj_t pb_type_xbox_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
 
     PB_PARSE_ARGS_CLASS(n_args, n_kw, args,
-        PB_ARG_DEFAULT_INT(joystick_deadzone, 10)
+        PB_ARG_DEFAULT_INT(joystick_deadzone, 10),
+        PB_ARG_DEFAULT_INT(event_threshold, 5)
         // Debug parameter to stay connected to the host on Technic Hub.
         // Works only on some hosts for the moment, so False by default.
         #if PYBRICKS_HUB_TECHNICHUB
@@ -295,6 +387,7 @@ static mp_obj_t pb_type_xbox_make_new(const mp_obj_type_t *type, size_t n_args,
 
     pb_type_xbox_obj_t *self = mp_obj_malloc(pb_type_xbox_obj_t, type);
     self->joystick_deadzone = pb_obj_get_pct(joystick_deadzone_in);
+    self->event_awaitables = mp_obj_new_list(0, NULL);
 
     pb_xbox_t *xbox = &pb_xbox_singleton;
 
@@ -311,7 +404,15 @@ static mp_obj_t pb_type_xbox_make_new(const mp_obj_type_t *type, size_t n_args,
     // needed to ensure that no buttons are "pressed" after reconnecting since
     // we are using static memory
     memset(&xbox->state, 0, sizeof(xbox_input_map_t));
+    memset(xbox->axes, 0, sizeof(xbox->axes));
+    xbox->pressed = 0;
+    xbox->events_count = 0;
     xbox->state.x = xbox->state.y = xbox->state.z = xbox->state.rz = INT16_MAX;
+    xbox->joystick_deadzone = self->joystick_deadzone;
+    xbox->event_threshold = pb_obj_get_pct(event_threshold_in);
+    if (xbox->event_threshold < 1) {
+        xbox->event_threshold = 1;
+    }
 
     // Xbox Controller requires pairing.
     pbdrv_bluetooth_peripheral_options_t options = PBDRV_BLUETOOTH_PERIPHERAL_OPTIONS_PAIR;
@@ -380,6 +481,9 @@ static mp_obj_t pb_type_xbox_make_new(const mp_obj_type_t *type, size_t n_args,
 
     self->buttons = pb_type_Keypad_obj_new(pb_xbox_button_pressed);
 
+    // Only report changes that happen after connecting.
+    xbox->events_count = 0;
+
     return MP_OBJ_FROM_PTR(self);
 }
 
@@ -427,15 +531,9 @@ static MP_DEFINE_CONST_FUN_OBJ_1(pb_xbox_profile_obj, pb_xbox_profile);
 static mp_obj_t pb_xbox_joystick(mp_obj_t self_in, uint16_t x_raw, uint16_t y_raw) {
     pb_type_xbox_obj_t *self = MP_OBJ_TO_PTR(self_in);
 
-    mp_int_t x = (x_raw - INT16_MAX) * 100 / INT16_MAX;
-    mp_int_t y = (INT16_MAX - y_raw) * 100 / INT16_MAX;
-
-    // Apply square deadzone to prevent drift.
-    if (x < self->joystick_deadzone && x > -self->joystick_deadzone &&
-        y < self->joystick_deadzone && y > -self->joystick_deadzone) {
-        x = 0;
-        y = 0;
-    }
+    int32_t x;
+    int32_t y;
+    pb_xbox_get_joystick(self->joystick_deadzone, x_raw, y_raw, &x, &y);
 
     mp_obj_t directions[] = {
         mp_obj_new_int(x),
@@ -466,6 +564,47 @@ static mp_obj_t pb_xbox_triggers(mp_obj_t self_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(pb_xbox_triggers_obj, pb_xbox_triggers);
 
+static bool pb_xbox_event_test_completion(mp_obj_t self_in, uint32_t end_time) {
+    // Queued events can still be read after disconnecting.
+    if (pb_xbox_singleton.events_count) {
+        return true;
+    }
+    pb_xbox_assert_connected();
+    return false;
+}
+
+static mp_obj_t pb_xbox_event_return_value(mp_obj_t self_in) {
+    pb_xbox_t *xbox = &pb_xbox_singleton;
+
+    xbox_event_t *event = &xbox->events[xbox->events_first];
+    xbox->events_first = (xbox->events_first + 1) % XBOX_EVENT_QUEUE_SIZE;
+    xbox->events_count--;
+
+    mp_obj_t ret[3];
+    if (event->kind == XBOX_EVENT_BUTTON) {
+        ret[0] = pb_type_button_new(pb_xbox_button_names[event->index]);
+        ret[1] = mp_obj_new_bool(event->value);
+    } else {
+        ret[0] = MP_OBJ_NEW_QSTR(pb_xbox_axis_names[event->index]);
+        ret[1] = mp_obj_new_int(event->value);
+    }
+    ret[2] = mp_obj_new_int_from_uint(event->time);
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(ret), ret);
+}
+
+static mp_obj_t pb_xbox_event(mp_obj_t self_in) {
+    pb_type_xbox_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(self),
+        self->event_awaitables,
+        pb_type_awaitable_end_time_none,
+        pb_xbox_event_test_completion,
+        pb_xbox_event_return_value,
+        pb_type_awaitable_cancel_none,
+        PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(pb_xbox_event_obj, pb_xbox_event);
+
 typedef struct {
     uint8_t activation_flags;
     uint8_t power_left_trigger;
@@ -566,6 +705,7 @@ static const mp_rom_map_elem_t pb_type_xbox_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_joystick_right), MP_ROM_PTR(&pb_xbox_joystick_right_obj) },
     { MP_ROM_QSTR(MP_QSTR_triggers), MP_ROM_PTR(&pb_xbox_triggers_obj) },
     { MP_ROM_QSTR(MP_QSTR_rumble), MP_ROM_PTR(&pb_xbox_rumble_obj) },
+    { MP_ROM_QSTR(MP_QSTR_event), MP_ROM_PTR(&pb_xbox_event_obj) },
 };
 static MP_DEFINE_CONST_DICT(pb_type_xbox_locals_dict, pb_type_xbox_locals_dict_table);
 
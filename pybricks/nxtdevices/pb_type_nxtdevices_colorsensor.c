@@ -19,6 +19,7 @@ typedef struct _nxtdevices_ColorSensor_obj_t {
     pb_type_device_obj_base_t device_base;
     mp_obj_t color_map;
     mp_obj_t light;
+    pbio_color_calibration_t calibration;
 } nxtdevices_ColorSensor_obj_t;
 
 static mp_obj_t nxtdevices_ColorSensor_light_on(void *context, const pbio_color_hsv_t *hsv) {
@@ -54,6 +55,7 @@ static mp_obj_t nxtdevices_ColorSensor_make_new(const mp_obj_type_t *type, size_
 
     // Save default color settings
     pb_color_map_save_default(&self->color_map);
+    pbio_color_calibration_set_defaults(&self->calibration, 255);
 
     return MP_OBJ_FROM_PTR(self);
 }
@@ -88,9 +90,11 @@ static MP_DEFINE_CONST_FUN_OBJ_1(nxtdevices_ColorSensor_ambient_obj, nxtdevices_
 
 // pybricks.nxtdevices.ColorSensor.hsv
 static mp_obj_t nxtdevices_ColorSensor_hsv(mp_obj_t self_in) {
+    nxtdevices_ColorSensor_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
     // Read sensor data
     int32_t *all = pb_type_device_get_data_blocking(self_in, PBDRV_LEGODEV_MODE_NXT_COLOR_SENSOR__MEASURE);
-    pbio_color_rgb_t rgb = {
+    const pbio_color_raw_t raw = {
         .r = all[0],
         .g = all[1],
         .b = all[2],
@@ -100,7 +104,7 @@ static mp_obj_t nxtdevices_ColorSensor_hsv(mp_obj_t self_in) {
     pb_type_Color_obj_t *color = pb_type_Color_new_empty();
 
     // Convert and store RGB as HSV
-    pb_color_map_rgb_to_hsv(&rgb, &color->hsv);
+    pbio_color_calibration_get_hsv(&self->calibration, &raw, NULL, &color->hsv);
 
     // Return color
     return MP_OBJ_FROM_PTR(color);
@@ -114,12 +118,12 @@ static mp_obj_t nxtdevices_ColorSensor_color(mp_obj_t self_in) {
     int32_t *all = pb_type_device_get_data_blocking(self_in, PBDRV_LEGODEV_MODE_NXT_COLOR_SENSOR__MEASURE);
 
     pbio_color_hsv_t hsv;
-    pbio_color_rgb_t rgb = {
+    const pbio_color_raw_t raw = {
         .r = all[0],
         .g = all[1],
         .b = all[2],
     };
-    pb_color_map_rgb_to_hsv(&rgb, &hsv);
+    pbio_color_calibration_get_hsv(&self->calibration, &raw, NULL, &hsv);
 
     // Get and return discretized color based on HSV
     return pb_color_map_get_color(&self->color_map, &hsv);
@@ -22,8 +22,13 @@ typedef struct _pupdevices_ColorDistanceSensor_obj_t {
     pb_type_device_obj_base_t device_base;
     mp_obj_t color_map;
     mp_obj_t light;
+    pbio_port_id_t port;
+    pbio_color_calibration_t calibration;
 } pupdevices_ColorDistanceSensor_obj_t;
 
+// Raw RGB values of a white surface. This is the maximum observed value.
+#define PUPDEVICES_COLOR_DISTANCE_SENSOR_FULL_SCALE (440)
+
 /**
  * Gets base powered up object from the sensor. Used for Power Functions motor.
  *
@@ -76,19 +81,22 @@ static mp_obj_t pupdevices_ColorDistanceSensor_make_new(const mp_obj_type_t *typ
     // Save default color settings
     pb_color_map_save_default(&self->color_map);
 
+    // Use calibration of the sensor on this port, if any.
+    self->port = pb_type_enum_get_value(port_in, &pb_enum_type_Port);
+    pb_color_map_load_calibration(&self->calibration, self->port, PBDRV_LEGODEV_TYPE_ID_COLOR_DIST_SENSOR, PUPDEVICES_COLOR_DISTANCE_SENSOR_FULL_SCALE);
+
     return MP_OBJ_FROM_PTR(self);
 }
 
 // Ensures sensor is in RGB mode then converts the measured raw RGB value to HSV.
 static void get_hsv_data(pupdevices_ColorDistanceSensor_obj_t *self, pbio_color_hsv_t *hsv) {
-    int16_t *raw = pb_type_device_get_data(MP_OBJ_FROM_PTR(&self->device_base), PBDRV_LEGODEV_MODE_PUP_COLOR_DISTANCE_SENSOR__RGB_I);
-
-    // Max observed value is ~440 so we scale to get a range of 0..255.
-    pbio_color_rgb_t rgb;
-    rgb.r = 1187 * raw[0] / 2048;
-    rgb.g = 1187 * raw[1] / 2048;
-    rgb.b = 1187 * raw[2] / 2048;
-    pb_color_map_rgb_to_hsv(&rgb, hsv);
+    int16_t *data = pb_type_device_get_data(MP_OBJ_FROM_PTR(&self->device_base), PBDRV_LEGODEV_MODE_PUP_COLOR_DISTANCE_SENSOR__RGB_I);
+    const pbio_color_raw_t raw = {
+        .r = data[0],
+        .g = data[1],
+        .b = data[2],
+    };
+    pbio_color_calibration_get_hsv(&self->calibration, &raw, NULL, hsv);
 }
 
 // pybricks.pupdevices.ColorDistanceSensor.color
@@ -130,6 +138,26 @@ static mp_obj_t get_hsv(mp_obj_t self_in) {
 }
 static PB_DEFINE_CONST_TYPE_DEVICE_METHOD_OBJ(get_hsv_obj, PBDRV_LEGODEV_MODE_PUP_COLOR_DISTANCE_SENSOR__RGB_I, get_hsv);
 
+// pybricks.pupdevices.ColorDistanceSensor.calibrate
+static mp_obj_t calibrate(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pupdevices_ColorDistanceSensor_obj_t, self,
+        PB_ARG_DEFAULT_NONE(reference));
+
+    // Measure the reference surface with the light on.
+    pbio_color_raw_t raw = { 0 };
+    if (reference_in != mp_const_none) {
+        int16_t *data = pb_type_device_get_data_blocking(MP_OBJ_FROM_PTR(self), PBDRV_LEGODEV_MODE_PUP_COLOR_DISTANCE_SENSOR__RGB_I);
+        for (uint8_t i = 0; i < 3; i++) {
+            raw.values[i] = data[i];
+        }
+    }
+    pb_color_map_calibrate(&self->calibration, self->port, PBDRV_LEGODEV_TYPE_ID_COLOR_DIST_SENSOR,
+        PUPDEVICES_COLOR_DISTANCE_SENSOR_FULL_SCALE, reference_in, &raw);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(calibrate_obj, 1, calibrate);
+
 static const pb_attr_dict_entry_t pupdevices_ColorDistanceSensor_attr_dict[] = {
     PB_DEFINE_CONST_ATTR_RO(MP_QSTR_light, pupdevices_ColorDistanceSensor_obj_t, light),
     PB_ATTR_DICT_SENTINEL
@@ -143,6 +171,9 @@ static const mp_rom_map_elem_t pupdevices_ColorDistanceSensor_locals_dict_table[
     { MP_ROM_QSTR(MP_QSTR_distance),    MP_ROM_PTR(&get_distance_obj)             },
     { MP_ROM_QSTR(MP_QSTR_hsv),         MP_ROM_PTR(&get_hsv_obj)                  },
     { MP_ROM_QSTR(MP_QSTR_detectable_colors),   MP_ROM_PTR(&pb_ColorSensor_detectable_colors_obj)                            },
+    { MP_ROM_QSTR(MP_QSTR_calibrate),   MP_ROM_PTR(&calibrate_obj)                },
+    { MP_ROM_QSTR(MP_QSTR_samples),     MP_ROM_PTR(&pb_type_device_samples_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_fresh),       MP_ROM_PTR(&pb_type_device_fresh_obj)     },
 };
 static MP_DEFINE_CONST_DICT(pupdevices_ColorDistanceSensor_locals_dict, pupdevices_ColorDistanceSensor_locals_dict_table);
 
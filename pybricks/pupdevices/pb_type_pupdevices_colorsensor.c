@@ -22,8 +22,13 @@ typedef struct _pupdevices_ColorSensor_obj_t {
     pb_type_device_obj_base_t device_base;
     mp_obj_t color_map;
     mp_obj_t lights;
+    pbio_port_id_t port;
+    pbio_color_calibration_t calibration;
 } pupdevices_ColorSensor_obj_t;
 
+// Raw RGB values of a white surface.
+#define PUPDEVICES_COLOR_SENSOR_FULL_SCALE (1024)
+
 // pybricks.pupdevices.ColorSensor.__init__
 static mp_obj_t pupdevices_ColorSensor_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     PB_PARSE_ARGS_CLASS(n_args, n_kw, args,
@@ -41,6 +46,10 @@ static mp_obj_t pupdevices_ColorSensor_make_new(const mp_obj_type_t *type, size_
     // Save default settings
     pb_color_map_save_default(&self->color_map);
 
+    // Use calibration of the sensor on this port, if any.
+    self->port = pb_type_enum_get_value(port_in, &pb_enum_type_Port);
+    pb_color_map_load_calibration(&self->calibration, self->port, PBDRV_LEGODEV_TYPE_ID_SPIKE_COLOR_SENSOR, PUPDEVICES_COLOR_SENSOR_FULL_SCALE);
+
     return MP_OBJ_FROM_PTR(self);
 }
 
@@ -53,6 +62,10 @@ static mp_obj_t get_reflection(mp_obj_t self_in) {
 static PB_DEFINE_CONST_TYPE_DEVICE_METHOD_OBJ(get_reflection_obj, PBDRV_LEGODEV_MODE_PUP_COLOR_SENSOR__RGB_I, get_reflection);
 
 // pybricks.pupdevices.ColorSensor.ambient
+// Unlike the UltrasonicSensor, this does not use a mode combination to avoid
+// switching modes. The sensor turns its lights on or off depending on the
+// mode, so RGB_I and SHSV values from one combined message could not both be
+// valid.
 static mp_obj_t get_ambient(mp_obj_t self_in) {
     // Get ambient from "V" in SHSV (0--10000), scaled to 0 to 100
     int16_t *data = pb_type_device_get_data(self_in, PBDRV_LEGODEV_MODE_PUP_COLOR_SENSOR__SHSV);
@@ -62,13 +75,14 @@ static PB_DEFINE_CONST_TYPE_DEVICE_METHOD_OBJ(get_ambient_obj, PBDRV_LEGODEV_MOD
 
 // Helper for getting HSV with the light on.
 static void get_hsv_reflected(mp_obj_t self_in, pbio_color_hsv_t *hsv) {
+    pupdevices_ColorSensor_obj_t *self = MP_OBJ_TO_PTR(self_in);
     int16_t *data = pb_type_device_get_data(self_in, PBDRV_LEGODEV_MODE_PUP_COLOR_SENSOR__RGB_I);
-    const pbio_color_rgb_t rgb = {
-        .r = data[0] == 1024 ? 255 : data[0] >> 2,
-        .g = data[1] == 1024 ? 255 : data[1] >> 2,
-        .b = data[2] == 1024 ? 255 : data[2] >> 2,
+    const pbio_color_raw_t raw = {
+        .r = data[0],
+        .g = data[1],
+        .b = data[2],
     };
-    pb_color_map_rgb_to_hsv(&rgb, hsv);
+    pbio_color_calibration_get_hsv(&self->calibration, &raw, NULL, hsv);
 }
 
 // Helper for getting HSV with the light off, scale saturation and value to
@@ -148,6 +162,26 @@ static mp_obj_t get_color(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(get_color_obj, 1, get_color);
 
+// pybricks.pupdevices.ColorSensor.calibrate
+static mp_obj_t calibrate(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pupdevices_ColorSensor_obj_t, self,
+        PB_ARG_DEFAULT_NONE(reference));
+
+    // Measure the reference surface with the light on.
+    pbio_color_raw_t raw = { 0 };
+    if (reference_in != mp_const_none) {
+        int16_t *data = pb_type_device_get_data_blocking(MP_OBJ_FROM_PTR(self), PBDRV_LEGODEV_MODE_PUP_COLOR_SENSOR__RGB_I);
+        for (uint8_t i = 0; i < 3; i++) {
+            raw.values[i] = data[i];
+        }
+    }
+    pb_color_map_calibrate(&self->calibration, self->port, PBDRV_LEGODEV_TYPE_ID_SPIKE_COLOR_SENSOR,
+        PUPDEVICES_COLOR_SENSOR_FULL_SCALE, reference_in, &raw);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(calibrate_obj, 1, calibrate);
+
 static const pb_attr_dict_entry_t pupdevices_ColorSensor_attr_dict[] = {
     PB_DEFINE_CONST_ATTR_RO(MP_QSTR_lights, pupdevices_ColorSensor_obj_t, lights),
     PB_ATTR_DICT_SENTINEL
@@ -160,6 +194,9 @@ static const mp_rom_map_elem_t pupdevices_ColorSensor_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_reflection),  MP_ROM_PTR(&get_reflection_obj)           },
     { MP_ROM_QSTR(MP_QSTR_ambient),     MP_ROM_PTR(&get_ambient_obj)              },
     { MP_ROM_QSTR(MP_QSTR_detectable_colors),   MP_ROM_PTR(&pb_ColorSensor_detectable_colors_obj)                    },
+    { MP_ROM_QSTR(MP_QSTR_calibrate),   MP_ROM_PTR(&calibrate_obj)                },
+    { MP_ROM_QSTR(MP_QSTR_samples),     MP_ROM_PTR(&pb_type_device_samples_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_fresh),       MP_ROM_PTR(&pb_type_device_fresh_obj)     },
 };
 static MP_DEFINE_CONST_DICT(pupdevices_ColorSensor_locals_dict, pupdevices_ColorSensor_locals_dict_table);
 
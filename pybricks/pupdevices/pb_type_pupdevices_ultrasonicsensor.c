@@ -5,6 +5,8 @@
 
 #if PYBRICKS_PY_PUPDEVICES
 
+#include <pbio/util.h>
+
 #include <pybricks/common.h>
 #include <pybricks/parameters.h>
 #include <pybricks/pupdevices.h>
@@ -35,19 +37,58 @@ static mp_obj_t pupdevices_UltrasonicSensor_make_new(const mp_obj_type_t *type,
     return MP_OBJ_FROM_PTR(self);
 }
 
+// Distance and presence are read together if the sensor supports it, so that
+// alternating between them does not require mode switches.
+static const uint8_t combi_items[] = {
+    PBDRV_LEGODEV_COMBI_ITEM(PBDRV_LEGODEV_MODE_PUP_ULTRASONIC_SENSOR__DISTL, 0),
+    PBDRV_LEGODEV_COMBI_ITEM(PBDRV_LEGODEV_MODE_PUP_ULTRASONIC_SENSOR__LISTN, 0),
+};
+
+static mp_obj_t get_distance_value(int16_t distance) {
+    return mp_obj_new_int(distance < 0 || distance >= 2000 ? 2000 : distance);
+}
+
 // pybricks.pupdevices.UltrasonicSensor.distance
 static mp_obj_t get_distance(mp_obj_t self_in) {
     int16_t *data = pb_type_device_get_data(self_in, PBDRV_LEGODEV_MODE_PUP_ULTRASONIC_SENSOR__DISTL);
-    return mp_obj_new_int(data[0] < 0 || data[0] >= 2000 ? 2000 : data[0]);
+    return get_distance_value(data[0]);
+}
+static PB_DEFINE_CONST_TYPE_DEVICE_METHOD_OBJ(get_distance_single_obj, PBDRV_LEGODEV_MODE_PUP_ULTRASONIC_SENSOR__DISTL, get_distance);
+
+static mp_obj_t get_distance_combi(mp_obj_t self_in) {
+    uint8_t *data = pb_type_device_get_data(self_in, PBDRV_LEGODEV_MODE_COMBI);
+    return get_distance_value((int16_t)pbio_get_uint16_le(data));
 }
-static PB_DEFINE_CONST_TYPE_DEVICE_METHOD_OBJ(get_distance_obj, PBDRV_LEGODEV_MODE_PUP_ULTRASONIC_SENSOR__DISTL, get_distance);
+
+static mp_obj_t get_distance_or_combi(mp_obj_t self_in) {
+    mp_obj_t result = pb_type_device_combi_call(self_in, combi_items, MP_ARRAY_SIZE(combi_items), get_distance_combi);
+    if (result != MP_OBJ_NULL) {
+        return result;
+    }
+    return pb_type_device_method_call(MP_OBJ_FROM_PTR(&get_distance_single_obj), 1, 0, &self_in);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(get_distance_obj, get_distance_or_combi);
 
 // pybricks.pupdevices.UltrasonicSensor.presence
 static mp_obj_t get_presence(mp_obj_t self_in) {
     int8_t *data = pb_type_device_get_data(self_in, PBDRV_LEGODEV_MODE_PUP_ULTRASONIC_SENSOR__LISTN);
     return mp_obj_new_bool(data[0]);
 }
-static PB_DEFINE_CONST_TYPE_DEVICE_METHOD_OBJ(get_presence_obj, PBDRV_LEGODEV_MODE_PUP_ULTRASONIC_SENSOR__LISTN, get_presence);
+static PB_DEFINE_CONST_TYPE_DEVICE_METHOD_OBJ(get_presence_single_obj, PBDRV_LEGODEV_MODE_PUP_ULTRASONIC_SENSOR__LISTN, get_presence);
+
+static mp_obj_t get_presence_combi(mp_obj_t self_in) {
+    uint8_t *data = pb_type_device_get_data(self_in, PBDRV_LEGODEV_MODE_COMBI);
+    return mp_obj_new_bool(data[2]);
+}
+
+static mp_obj_t get_presence_or_combi(mp_obj_t self_in) {
+    mp_obj_t result = pb_type_device_combi_call(self_in, combi_items, MP_ARRAY_SIZE(combi_items), get_presence_combi);
+    if (result != MP_OBJ_NULL) {
+        return result;
+    }
+    return pb_type_device_method_call(MP_OBJ_FROM_PTR(&get_presence_single_obj), 1, 0, &self_in);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(get_presence_obj, get_presence_or_combi);
 
 static const pb_attr_dict_entry_t pupdevices_UltrasonicSensor_attr_dict[] = {
     PB_DEFINE_CONST_ATTR_RO(MP_QSTR_lights, pupdevices_UltrasonicSensor_obj_t, lights),
@@ -58,6 +99,8 @@ static const pb_attr_dict_entry_t pupdevices_UltrasonicSensor_attr_dict[] = {
 static const mp_rom_map_elem_t pupdevices_UltrasonicSensor_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_distance),     MP_ROM_PTR(&get_distance_obj)              },
     { MP_ROM_QSTR(MP_QSTR_presence),     MP_ROM_PTR(&get_presence_obj)              },
+    { MP_ROM_QSTR(MP_QSTR_samples),      MP_ROM_PTR(&pb_type_device_samples_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_fresh),        MP_ROM_PTR(&pb_type_device_fresh_obj)      },
 };
 static MP_DEFINE_CONST_DICT(pupdevices_UltrasonicSensor_locals_dict, pupdevices_UltrasonicSensor_locals_dict_table);
 
@@ -12,15 +12,27 @@
 
 #include "py/obj.h"
 
+#include <pbio/drivebase.h>
+
 #include "pybricks/util_mp/pb_obj_helper.h"
 
 extern const mp_obj_type_t pb_type_car;
 extern const mp_obj_type_t pb_type_drivebase;
 
+pbio_drivebase_t *pb_type_drivebase_get_drivebase(mp_obj_t db_in);
+
 #if PYBRICKS_PY_ROBOTICS_DRIVEBASE_SPIKE
 extern const mp_obj_type_t pb_type_spikebase;
 #endif
 
+#if PYBRICKS_PY_ROBOTICS_MOTION_GROUP
+extern const mp_obj_type_t pb_type_motiongroup;
+#endif
+
+#if PYBRICKS_PY_ROBOTICS_REFLEX
+extern const mp_obj_type_t pb_type_reflex;
+#endif
+
 
 #endif // PYBRICKS_PY_ROBOTICS
 
@@ -19,6 +19,12 @@ static const mp_rom_map_elem_t robotics_globals_table[] = {
     #if PYBRICKS_PY_ROBOTICS_DRIVEBASE_SPIKE
     { MP_ROM_QSTR(MP_QSTR_SpikeBase),   MP_ROM_PTR(&pb_type_spikebase)  },
     #endif
+    #if PYBRICKS_PY_ROBOTICS_MOTION_GROUP
+    { MP_ROM_QSTR(MP_QSTR_MotionGroup), MP_ROM_PTR(&pb_type_motiongroup) },
+    #endif
+    #if PYBRICKS_PY_ROBOTICS_REFLEX
+    { MP_ROM_QSTR(MP_QSTR_Reflex),      MP_ROM_PTR(&pb_type_reflex)      },
+    #endif
     #endif
 };
 static MP_DEFINE_CONST_DICT(pb_module_robotics_globals, robotics_globals_table);
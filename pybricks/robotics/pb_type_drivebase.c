@@ -10,6 +10,7 @@
 
 #include <pbio/drivebase.h>
 #include <pbio/int_math.h>
+#include <pbio/reflex.h>
 
 #include "py/mphal.h"
 
@@ -36,6 +37,11 @@ struct _pb_type_DriveBase_obj_t {
     mp_obj_t awaitables;
 };
 
+// Gets the drive base instance of a DriveBase object.
+pbio_drivebase_t *pb_type_drivebase_get_drivebase(mp_obj_t db_in) {
+    return ((pb_type_DriveBase_obj_t *)pb_obj_get_base_class_obj(db_in, &pb_type_drivebase))->db;
+}
+
 // pybricks.robotics.DriveBase.reset
 static mp_obj_t pb_type_DriveBase_reset(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
 
@@ -98,8 +104,16 @@ static bool pb_type_DriveBase_test_completion(mp_obj_t self_in, uint32_t end_tim
     return pbio_drivebase_is_done(self->db);
 }
 
+// Stops a Reflex that steers this drive base, so it won't override a new command.
+static void pb_type_DriveBase_release_reflex(pb_type_DriveBase_obj_t *self) {
+    #if PYBRICKS_PY_ROBOTICS_REFLEX
+    pbio_reflex_release_drivebase(self->db);
+    #endif
+}
+
 static void pb_type_DriveBase_cancel(mp_obj_t self_in) {
     pb_type_DriveBase_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_type_DriveBase_release_reflex(self);
     pb_assert(pbio_drivebase_stop(self->db, PBIO_CONTROL_ON_COMPLETION_COAST));
 }
 
@@ -217,6 +231,52 @@ static mp_obj_t pb_type_DriveBase_arc(size_t n_args, const mp_obj_t *pos_args, m
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_DriveBase_arc_obj, 1, pb_type_DriveBase_arc);
 
+#if PBIO_CONFIG_DRIVEBASE_PATH
+// pybricks.robotics.DriveBase.path
+static mp_obj_t pb_type_DriveBase_path(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_DriveBase_obj_t, self,
+        PB_ARG_REQUIRED(segments),
+        PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
+        PB_ARG_DEFAULT_TRUE(wait));
+
+    // Unpack segments, each given as (distance, angle) or (distance, angle, smooth).
+    size_t num_segments;
+    mp_obj_t *segment_objs;
+    mp_obj_get_array(segments_in, &num_segments, &segment_objs);
+    if (num_segments == 0 || num_segments > PBIO_DRIVEBASE_PATH_NUM_SEGMENTS_MAX) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    pbio_drivebase_path_segment_t segments[PBIO_DRIVEBASE_PATH_NUM_SEGMENTS_MAX];
+    for (size_t i = 0; i < num_segments; i++) {
+        size_t len;
+        mp_obj_t *values;
+        mp_obj_get_array(segment_objs[i], &len, &values);
+        if (len != 2 && len != 3) {
+            mp_raise_ValueError(MP_ERROR_TEXT("Each segment must be (distance, angle) or (distance, angle, smooth)."));
+        }
+        segments[i] = (pbio_drivebase_path_segment_t) {
+            .distance = pb_obj_get_int(values[0]),
+            .angle = pb_obj_get_int(values[1]),
+            .smooth = len == 3 && mp_obj_is_true(values[2]),
+        };
+    }
+
+    pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
+
+    pb_assert(pbio_drivebase_drive_path(self->db, segments, num_segments, then));
+
+    // Old way to do parallel movement is to start and not wait on anything.
+    if (!mp_obj_is_true(wait_in)) {
+        return mp_const_none;
+    }
+    // Handle completion by awaiting or blocking.
+    return await_or_wait(self);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_DriveBase_path_obj, 1, pb_type_DriveBase_path);
+#endif // PBIO_CONFIG_DRIVEBASE_PATH
+
 // pybricks.robotics.DriveBase.drive
 static mp_obj_t pb_type_DriveBase_drive(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
@@ -231,6 +291,7 @@ static mp_obj_t pb_type_DriveBase_drive(size_t n_args, const mp_obj_t *pos_args,
     // Cancel awaitables but not hardware. Drive forever will handle this.
     pb_type_awaitable_update_all(self->awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
 
+    pb_type_DriveBase_release_reflex(self);
     pb_assert(pbio_drivebase_drive_forever(self->db, speed, turn_rate));
     return mp_const_none;
 }
@@ -258,6 +319,7 @@ static mp_obj_t pb_type_DriveBase_brake(mp_obj_t self_in) {
     pb_type_awaitable_update_all(self->awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
 
     // Stop hardware.
+    pb_type_DriveBase_release_reflex(self);
     pb_assert(pbio_drivebase_stop(self->db, PBIO_CONTROL_ON_COMPLETION_BRAKE));
 
     return mp_const_none;
@@ -308,6 +370,66 @@ static mp_obj_t pb_type_DriveBase_state(mp_obj_t self_in) {
 }
 MP_DEFINE_CONST_FUN_OBJ_1(pb_type_DriveBase_state_obj, pb_type_DriveBase_state);
 
+#if PBIO_CONFIG_DRIVEBASE_POSE
+// pybricks.robotics.DriveBase.pose
+static mp_obj_t pb_type_DriveBase_pose(mp_obj_t self_in) {
+    pb_type_DriveBase_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    float x, y, angle;
+    pb_assert(pbio_drivebase_get_pose(self->db, &x, &y, &angle));
+
+    mp_obj_t ret[3];
+    #if MICROPY_PY_BUILTINS_FLOAT
+    ret[0] = mp_obj_new_float_from_f(x);
+    ret[1] = mp_obj_new_float_from_f(y);
+    ret[2] = mp_obj_new_float_from_f(angle);
+    #else
+    ret[0] = mp_obj_new_int((mp_int_t)x);
+    ret[1] = mp_obj_new_int((mp_int_t)y);
+    ret[2] = mp_obj_new_int((mp_int_t)angle);
+    #endif
+    return mp_obj_new_tuple(3, ret);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_DriveBase_pose_obj, pb_type_DriveBase_pose);
+
+// pybricks.robotics.DriveBase.reset_pose
+static mp_obj_t pb_type_DriveBase_reset_pose(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_DriveBase_obj_t, self,
+        PB_ARG_DEFAULT_INT(x, 0),
+        PB_ARG_DEFAULT_INT(y, 0),
+        PB_ARG_DEFAULT_INT(angle, 0));
+
+    pb_assert(pbio_drivebase_reset_pose(self->db, pb_obj_get_int(x_in), pb_obj_get_int(y_in), pb_obj_get_int(angle_in)));
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_DriveBase_reset_pose_obj, 1, pb_type_DriveBase_reset_pose);
+
+// pybricks.robotics.DriveBase.drive_to
+static mp_obj_t pb_type_DriveBase_drive_to(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_DriveBase_obj_t, self,
+        PB_ARG_REQUIRED(x),
+        PB_ARG_REQUIRED(y),
+        PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
+        PB_ARG_DEFAULT_TRUE(wait));
+
+    pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
+
+    pb_assert(pbio_drivebase_drive_to(self->db, pb_obj_get_int(x_in), pb_obj_get_int(y_in), then));
+
+    // Old way to do parallel movement is to start and not wait on anything.
+    if (!mp_obj_is_true(wait_in)) {
+        return mp_const_none;
+    }
+    // Handle completion by awaiting or blocking.
+    return await_or_wait(self);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_DriveBase_drive_to_obj, 1, pb_type_DriveBase_drive_to);
+#endif // PBIO_CONFIG_DRIVEBASE_POSE
+
 // pybricks.robotics.DriveBase.done
 static mp_obj_t pb_type_DriveBase_done(mp_obj_t self_in) {
     pb_type_DriveBase_obj_t *self = MP_OBJ_TO_PTR(self_in);
@@ -399,6 +521,9 @@ static const pb_attr_dict_entry_t pb_type_DriveBase_attr_dict[] = {
 static const mp_rom_map_elem_t pb_type_DriveBase_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_arc),              MP_ROM_PTR(&pb_type_DriveBase_arc_obj)      },
     { MP_ROM_QSTR(MP_QSTR_curve),            MP_ROM_PTR(&pb_type_DriveBase_curve_obj)    },
+    #if PBIO_CONFIG_DRIVEBASE_PATH
+    { MP_ROM_QSTR(MP_QSTR_path),             MP_ROM_PTR(&pb_type_DriveBase_path_obj)     },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_straight),         MP_ROM_PTR(&pb_type_DriveBase_straight_obj) },
     { MP_ROM_QSTR(MP_QSTR_turn),             MP_ROM_PTR(&pb_type_DriveBase_turn_obj)     },
     { MP_ROM_QSTR(MP_QSTR_drive),            MP_ROM_PTR(&pb_type_DriveBase_drive_obj)    },
@@ -409,6 +534,11 @@ static const mp_rom_map_elem_t pb_type_DriveBase_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_done),             MP_ROM_PTR(&pb_type_DriveBase_done_obj)     },
     { MP_ROM_QSTR(MP_QSTR_state),            MP_ROM_PTR(&pb_type_DriveBase_state_obj)    },
     { MP_ROM_QSTR(MP_QSTR_reset),            MP_ROM_PTR(&pb_type_DriveBase_reset_obj)    },
+    #if PBIO_CONFIG_DRIVEBASE_POSE
+    { MP_ROM_QSTR(MP_QSTR_pose),             MP_ROM_PTR(&pb_type_DriveBase_pose_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_reset_pose),       MP_ROM_PTR(&pb_type_DriveBase_reset_pose_obj) },
+    { MP_ROM_QSTR(MP_QSTR_drive_to),         MP_ROM_PTR(&pb_type_DriveBase_drive_to_obj) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_settings),         MP_ROM_PTR(&pb_type_DriveBase_settings_obj) },
     { MP_ROM_QSTR(MP_QSTR_stalled),          MP_ROM_PTR(&pb_type_DriveBase_stalled_obj)  },
     #if PYBRICKS_PY_ROBOTICS_DRIVEBASE_GYRO
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include "py/mpconfig.h"
+
+#if PYBRICKS_PY_ROBOTICS && PYBRICKS_PY_COMMON_MOTORS && PYBRICKS_PY_ROBOTICS_MOTION_GROUP
+
+#include <pbio/motion_group.h>
+
+#include "py/runtime.h"
+
+#include <pybricks/common.h>
+#include <pybricks/parameters.h>
+#include <pybricks/robotics.h>
+#include <pybricks/tools/pb_type_awaitable.h>
+
+#include <pybricks/util_mp/pb_kwarg_helper.h>
+#include <pybricks/util_mp/pb_obj_helper.h>
+#include <pybricks/util_pb/pb_error.h>
+
+// pybricks.robotics.MotionGroup class object
+typedef struct _pb_type_MotionGroup_obj_t {
+    mp_obj_base_t base;
+    pbio_motion_group_t *group;
+    mp_obj_t awaitables;
+} pb_type_MotionGroup_obj_t;
+
+// pybricks.robotics.MotionGroup.__init__
+static mp_obj_t pb_type_MotionGroup_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+
+    // Motors are given as positional arguments, one for each axis.
+    mp_arg_check_num(n_args, n_kw, 2, PBIO_MOTION_GROUP_NUM_AXES_MAX, false);
+
+    pb_type_MotionGroup_obj_t *self = mp_obj_malloc(pb_type_MotionGroup_obj_t, type);
+
+    pbio_servo_t *servos[PBIO_MOTION_GROUP_NUM_AXES_MAX];
+    for (size_t i = 0; i < n_args; i++) {
+        servos[i] = pb_type_motor_get_servo(args[i]);
+    }
+    pb_assert(pbio_motion_group_get_motion_group(&self->group, servos, n_args));
+
+    // List of awaitables associated with this group. By keeping track,
+    // we can cancel them as needed when a new movement is started.
+    self->awaitables = mp_obj_new_list(0, NULL);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static bool pb_type_MotionGroup_test_completion(mp_obj_t self_in, uint32_t end_time) {
+
+    pb_type_MotionGroup_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // Handle I/O exceptions like port unplugged.
+    if (!pbio_motion_group_update_loop_is_running(self->group)) {
+        pb_assert(PBIO_ERROR_NO_DEV);
+    }
+
+    // Get completion state.
+    return pbio_motion_group_is_done(self->group);
+}
+
+static void pb_type_MotionGroup_cancel(mp_obj_t self_in) {
+    pb_type_MotionGroup_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_assert(pbio_motion_group_stop(self->group, PBIO_CONTROL_ON_COMPLETION_COAST));
+}
+
+// Common implementation of absolute and relative moves.
+static mp_obj_t pb_type_MotionGroup_move(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args, bool relative) {
+
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_MotionGroup_obj_t, self,
+        PB_ARG_REQUIRED(targets),
+        PB_ARG_DEFAULT_INT(speed, 0),
+        PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
+        PB_ARG_DEFAULT_TRUE(wait));
+
+    // Unpack one target for each axis.
+    mp_obj_t *target_objs;
+    mp_obj_get_array_fixed_n(targets_in, self->group->num_axes, &target_objs);
+    int32_t targets[PBIO_MOTION_GROUP_NUM_AXES_MAX];
+    for (uint8_t i = 0; i < self->group->num_axes; i++) {
+        targets[i] = pb_obj_get_int(target_objs[i]);
+    }
+
+    mp_int_t speed = pb_obj_get_int(speed_in);
+    pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
+
+    pb_assert(relative ?
+        pbio_motion_group_move_by(self->group, targets, speed, then) :
+        pbio_motion_group_move_to(self->group, targets, speed, then));
+
+    if (!mp_obj_is_true(wait_in)) {
+        return mp_const_none;
+    }
+
+    // Handle completion by awaiting or blocking.
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(self),
+        self->awaitables,
+        pb_type_awaitable_end_time_none,
+        pb_type_MotionGroup_test_completion,
+        pb_type_awaitable_return_none,
+        pb_type_MotionGroup_cancel,
+        PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+}
+
+// pybricks.robotics.MotionGroup.move_to
+static mp_obj_t pb_type_MotionGroup_move_to(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    return pb_type_MotionGroup_move(n_args, pos_args, kw_args, false);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_MotionGroup_move_to_obj, 1, pb_type_MotionGroup_move_to);
+
+// pybricks.robotics.MotionGroup.move_by
+static mp_obj_t pb_type_MotionGroup_move_by(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    return pb_type_MotionGroup_move(n_args, pos_args, kw_args, true);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_MotionGroup_move_by_obj, 1, pb_type_MotionGroup_move_by);
+
+// pybricks.robotics.MotionGroup.stop
+static mp_obj_t pb_type_MotionGroup_stop(mp_obj_t self_in) {
+
+    // Cancel awaitables.
+    pb_type_MotionGroup_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_type_awaitable_update_all(self->awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+
+    // Stop hardware.
+    pb_type_MotionGroup_cancel(self_in);
+
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_MotionGroup_stop_obj, pb_type_MotionGroup_stop);
+
+// pybricks.robotics.MotionGroup.brake
+static mp_obj_t pb_type_MotionGroup_brake(mp_obj_t self_in) {
+
+    // Cancel awaitables.
+    pb_type_MotionGroup_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_type_awaitable_update_all(self->awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+
+    // Stop hardware.
+    pb_assert(pbio_motion_group_stop(self->group, PBIO_CONTROL_ON_COMPLETION_BRAKE));
+
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_MotionGroup_brake_obj, pb_type_MotionGroup_brake);
+
+// pybricks.robotics.MotionGroup.done
+static mp_obj_t pb_type_MotionGroup_done(mp_obj_t self_in) {
+    pb_type_MotionGroup_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_bool(pbio_motion_group_is_done(self->group));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_MotionGroup_done_obj, pb_type_MotionGroup_done);
+
+// pybricks.robotics.MotionGroup.stalled
+static mp_obj_t pb_type_MotionGroup_stalled(mp_obj_t self_in) {
+    pb_type_MotionGroup_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    bool stalled;
+    uint32_t stall_duration;
+    pb_assert(pbio_motion_group_is_stalled(self->group, &stalled, &stall_duration));
+    return mp_obj_new_bool(stalled);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_MotionGroup_stalled_obj, pb_type_MotionGroup_stalled);
+
+// dir(pybricks.robotics.MotionGroup)
+static const mp_rom_map_elem_t pb_type_MotionGroup_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_move_to),          MP_ROM_PTR(&pb_type_MotionGroup_move_to_obj) },
+    { MP_ROM_QSTR(MP_QSTR_move_by),          MP_ROM_PTR(&pb_type_MotionGroup_move_by_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop),             MP_ROM_PTR(&pb_type_MotionGroup_stop_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_brake),            MP_ROM_PTR(&pb_type_MotionGroup_brake_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_done),             MP_ROM_PTR(&pb_type_MotionGroup_done_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_stalled),          MP_ROM_PTR(&pb_type_MotionGroup_stalled_obj) },
+};
+static MP_DEFINE_CONST_DICT(pb_type_MotionGroup_locals_dict, pb_type_MotionGroup_locals_dict_table);
+
+// type(pybricks.robotics.MotionGroup)
+MP_DEFINE_CONST_OBJ_TYPE(pb_type_motiongroup,
+    MP_QSTR_MotionGroup,
+    MP_TYPE_FLAG_NONE,
+    make_new, pb_type_MotionGroup_make_new,
+    locals_dict, &pb_type_MotionGroup_locals_dict);
+
+#endif // PYBRICKS_PY_ROBOTICS && PYBRICKS_PY_COMMON_MOTORS && PYBRICKS_PY_ROBOTICS_MOTION_GROUP
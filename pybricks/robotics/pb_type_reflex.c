@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include "py/mpconfig.h"
+
+#if PYBRICKS_PY_ROBOTICS && PYBRICKS_PY_COMMON_MOTORS && PYBRICKS_PY_ROBOTICS_REFLEX
+
+#include <pbio/reflex.h>
+
+#include "py/mphal.h"
+#include "py/runtime.h"
+
+#include <pybricks/common.h>
+#include <pybricks/parameters.h>
+#include <pybricks/robotics.h>
+#include <pybricks/tools/pb_type_matrix.h>
+
+#include <pybricks/util_mp/pb_kwarg_helper.h>
+#include <pybricks/util_mp/pb_obj_helper.h>
+#include <pybricks/util_pb/pb_error.h>
+
+// pybricks.robotics.Reflex class object
+typedef struct _pb_type_Reflex_obj_t {
+    mp_obj_base_t base;
+    pbio_reflex_t *reflex;
+    uint32_t generation;
+    pbio_reflex_input_t input;
+    pbio_reflex_settings_t settings;
+} pb_type_Reflex_obj_t;
+
+// pybricks.robotics.Reflex.__init__
+static mp_obj_t pb_type_Reflex_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+
+    PB_PARSE_ARGS_CLASS(n_args, n_kw, args,
+        PB_ARG_REQUIRED(source),
+        PB_ARG_REQUIRED(target),
+        PB_ARG_REQUIRED(kp),
+        PB_ARG_DEFAULT_INT(ki, 0),
+        PB_ARG_DEFAULT_INT(kd, 0),
+        PB_ARG_DEFAULT_INT(mode, 0),
+        PB_ARG_DEFAULT_INT(index, 0));
+
+    pb_type_Reflex_obj_t *self = mp_obj_malloc(pb_type_Reflex_obj_t, type);
+    self->reflex = NULL;
+
+    if (mp_obj_is_type(source_in, &pb_enum_type_Port)) {
+        // A port selects one value of the sensor attached to it.
+        pbio_port_id_t port = pb_type_enum_get_value(source_in, &pb_enum_type_Port);
+        pbio_error_t err;
+        pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_LUMP_UART;
+        while ((err = pbdrv_legodev_get_device(port, &id, &self->input.sensor.legodev)) == PBIO_ERROR_AGAIN) {
+            mp_hal_delay_ms(50);
+        }
+        pb_assert(err);
+        self->input.type = PBIO_REFLEX_INPUT_SENSOR;
+        self->input.sensor.mode = mp_obj_get_int(mode_in);
+        self->input.sensor.index = mp_obj_get_int(index_in);
+    }
+    #if PYBRICKS_PY_COMMON_IMU
+    else if (mp_obj_is_type(source_in, &pb_type_Matrix)) {
+        // An axis selects the angular velocity of the hub around it.
+        self->input.type = PBIO_REFLEX_INPUT_IMU;
+        pb_type_imu_extract_axis(source_in, &self->input.axis);
+    }
+    #endif
+    else {
+        // Otherwise it must be a motor, which provides its angle.
+        self->input.type = PBIO_REFLEX_INPUT_SERVO;
+        self->input.servo = pb_type_motor_get_servo(source_in);
+    }
+
+    self->settings.target = pb_obj_get_int(target_in);
+    self->settings.kp = pb_obj_get_scaled_int(kp_in, PBIO_REFLEX_GAIN_SCALE);
+    self->settings.ki = pb_obj_get_scaled_int(ki_in, PBIO_REFLEX_GAIN_SCALE);
+    self->settings.kd = pb_obj_get_scaled_int(kd_in, PBIO_REFLEX_GAIN_SCALE);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+// Gets the reflex of this object, or NULL if it was handed out to another
+// object after it stopped.
+static pbio_reflex_t *pb_type_Reflex_get_reflex(pb_type_Reflex_obj_t *self) {
+    if (!self->reflex || self->reflex->generation != self->generation) {
+        return NULL;
+    }
+    return self->reflex;
+}
+
+// Checks if this object is still the user of its reflex.
+static bool pb_type_Reflex_is_active(pb_type_Reflex_obj_t *self) {
+    pbio_reflex_t *reflex = pb_type_Reflex_get_reflex(self);
+    return reflex && pbio_reflex_is_active(reflex);
+}
+
+// pybricks.robotics.Reflex.start
+static mp_obj_t pb_type_Reflex_start(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_Reflex_obj_t, self,
+        PB_ARG_REQUIRED(output),
+        PB_ARG_DEFAULT_INT(speed, 0),
+        PB_ARG_DEFAULT_INT(limit, 100));
+
+    if (pb_type_Reflex_is_active(self)) {
+        pb_assert(PBIO_ERROR_BUSY);
+    }
+
+    self->settings.limit = pb_obj_get_int(limit_in);
+
+    // The output is either a drive base or a motor.
+    pbio_error_t err;
+    if (mp_obj_is_type(output_in, &pb_type_drivebase)) {
+        pbio_drivebase_t *db = pb_type_drivebase_get_drivebase(output_in);
+        int32_t speed = pb_obj_get_int(speed_in);
+        // Sensors may still be switching modes, so try again if needed.
+        while ((err = pbio_reflex_start_drivebase(&self->reflex, &self->input, &self->settings, db, speed)) == PBIO_ERROR_AGAIN) {
+            mp_hal_delay_ms(10);
+        }
+    } else {
+        pbio_servo_t *srv = pb_type_motor_get_servo(output_in);
+        while ((err = pbio_reflex_start_servo(&self->reflex, &self->input, &self->settings, srv)) == PBIO_ERROR_AGAIN) {
+            mp_hal_delay_ms(10);
+        }
+    }
+    pb_assert(err);
+    self->generation = self->reflex->generation;
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Reflex_start_obj, 1, pb_type_Reflex_start);
+
+// pybricks.robotics.Reflex.stop
+static mp_obj_t pb_type_Reflex_stop(mp_obj_t self_in) {
+    pb_type_Reflex_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (pb_type_Reflex_is_active(self)) {
+        pb_assert(pbio_reflex_stop(self->reflex));
+    }
+    self->reflex = NULL;
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_Reflex_stop_obj, pb_type_Reflex_stop);
+
+// pybricks.robotics.Reflex.active
+static mp_obj_t pb_type_Reflex_active(mp_obj_t self_in) {
+    pb_type_Reflex_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_bool(pb_type_Reflex_is_active(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_Reflex_active_obj, pb_type_Reflex_active);
+
+// pybricks.robotics.Reflex.target
+static mp_obj_t pb_type_Reflex_target(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_Reflex_obj_t, self,
+        PB_ARG_DEFAULT_NONE(target));
+
+    // Return current target if no argument given.
+    if (target_in == mp_const_none) {
+        return mp_obj_new_int(self->settings.target);
+    }
+
+    // Otherwise set the target, which also applies while running.
+    self->settings.target = pb_obj_get_int(target_in);
+    if (pb_type_Reflex_is_active(self)) {
+        self->reflex->settings.target = self->settings.target;
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Reflex_target_obj, 1, pb_type_Reflex_target);
+
+// pybricks.robotics.Reflex.state
+static mp_obj_t pb_type_Reflex_state(mp_obj_t self_in) {
+    pb_type_Reflex_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    int32_t value = 0;
+    int32_t output = 0;
+    pbio_reflex_t *reflex = pb_type_Reflex_get_reflex(self);
+    if (reflex) {
+        pbio_reflex_get_state(reflex, &value, &output);
+    }
+
+    mp_obj_t ret[] = {
+        mp_obj_new_int(value),
+        mp_obj_new_int(output),
+    };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(ret), ret);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_Reflex_state_obj, pb_type_Reflex_state);
+
+// dir(pybricks.robotics.Reflex)
+static const mp_rom_map_elem_t pb_type_Reflex_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_start),            MP_ROM_PTR(&pb_type_Reflex_start_obj)  },
+    { MP_ROM_QSTR(MP_QSTR_stop),             MP_ROM_PTR(&pb_type_Reflex_stop_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_active),           MP_ROM_PTR(&pb_type_Reflex_active_obj) },
+    { MP_ROM_QSTR(MP_QSTR_target),           MP_ROM_PTR(&pb_type_Reflex_target_obj) },
+    { MP_ROM_QSTR(MP_QSTR_state),            MP_ROM_PTR(&pb_type_Reflex_state_obj)  },
+};
+static MP_DEFINE_CONST_DICT(pb_type_Reflex_locals_dict, pb_type_Reflex_locals_dict_table);
+
+// type(pybricks.robotics.Reflex)
+MP_DEFINE_CONST_OBJ_TYPE(pb_type_reflex,
+    MP_QSTR_Reflex,
+    MP_TYPE_FLAG_NONE,
+    make_new, pb_type_Reflex_make_new,
+    locals_dict, &pb_type_Reflex_locals_dict);
+
+#endif // PYBRICKS_PY_ROBOTICS && PYBRICKS_PY_COMMON_MOTORS && PYBRICKS_PY_ROBOTICS_REFLEX
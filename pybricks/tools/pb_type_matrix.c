@@ -16,6 +16,108 @@
 
 #if MICROPY_PY_BUILTINS_FLOAT
 
+// Largest size of square matrices that can be inverted.
+#define PB_TYPE_MATRIX_INV_MAX (6)
+
+// Allocates a matrix that owns its data.
+static pb_type_Matrix_obj_t *pb_type_Matrix_new(const mp_obj_type_t *type, size_t m, size_t n) {
+    pb_type_Matrix_obj_t *self = mp_obj_malloc(pb_type_Matrix_obj_t, type);
+    self->m = m;
+    self->n = n;
+    self->data = m_new(float, m * n);
+    self->scale = 1;
+    self->transposed = false;
+    self->owns_data = true;
+    return self;
+}
+
+// Gets the distance in the data between consecutive rows and columns, so
+// that (i, j) -> i * row_stride + j * col_stride. The transposed attribute
+// tells us whether data is stored row by row or column by column:
+// regular:    i * self->n + j
+// transposed: j * self->m + i
+static void pb_type_Matrix_get_strides(const pb_type_Matrix_obj_t *self, size_t *row_stride, size_t *col_stride) {
+    *row_stride = self->transposed ? 1 : self->n;
+    *col_stride = self->transposed ? self->m : 1;
+}
+
+// Gets a matrix argument, raising TypeError if it is something else.
+static pb_type_Matrix_obj_t *pb_type_Matrix_get(mp_obj_t obj) {
+    pb_assert_type(obj, &pb_type_Matrix);
+    return MP_OBJ_TO_PTR(obj);
+}
+
+// Gets a matrix to store the result of an operation in.
+static pb_type_Matrix_obj_t *pb_type_Matrix_get_out(mp_obj_t obj, size_t m, size_t n) {
+    pb_type_Matrix_obj_t *out = pb_type_Matrix_get(obj);
+
+    // Views share data with another matrix, so they can't be written to.
+    if (!out->owns_data) {
+        pb_assert(PBIO_ERROR_INVALID_OP);
+    }
+
+    // Shape must match the result.
+    if (out->m != m || out->n != n) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+    return out;
+}
+
+// Tests if a matrix is a transposed view of the output data, so that the
+// output can't be computed one entry at a time without overwriting inputs.
+static bool pb_type_Matrix_is_transposed_view(const pb_type_Matrix_obj_t *out, const pb_type_Matrix_obj_t *a) {
+    return a->data == out->data && a->transposed;
+}
+
+// Computes out = a + b or out = a - b. The output may be a or b, but not a
+// transposed view of them.
+static void pb_type_Matrix_add_kernel(pb_type_Matrix_obj_t *out, const pb_type_Matrix_obj_t *a, const pb_type_Matrix_obj_t *b, bool add) {
+    size_t a_rs, a_cs, b_rs, b_cs;
+    pb_type_Matrix_get_strides(a, &a_rs, &a_cs);
+    pb_type_Matrix_get_strides(b, &b_rs, &b_cs);
+
+    float a_scale = a->scale;
+    float b_scale = add ? b->scale : -b->scale;
+
+    float *out_p = out->data;
+    for (size_t r = 0; r < out->m; r++) {
+        const float *a_p = a->data + r * a_rs;
+        const float *b_p = b->data + r * b_rs;
+        for (size_t c = 0; c < out->n; c++) {
+            *out_p++ = *a_p * a_scale + *b_p * b_scale;
+            a_p += a_cs;
+            b_p += b_cs;
+        }
+    }
+}
+
+// Computes out = a * b. The output must not share data with a or b.
+static void pb_type_Matrix_mul_kernel(pb_type_Matrix_obj_t *out, const pb_type_Matrix_obj_t *a, const pb_type_Matrix_obj_t *b) {
+    size_t a_rs, a_cs, b_rs, b_cs;
+    pb_type_Matrix_get_strides(a, &a_rs, &a_cs);
+    pb_type_Matrix_get_strides(b, &b_rs, &b_cs);
+
+    // Scale is commutative, so we can do it separately
+    float scale = a->scale * b->scale;
+
+    float *out_p = out->data;
+    for (size_t r = 0; r < out->m; r++) {
+        for (size_t c = 0; c < out->n; c++) {
+            // This entry is obtained as the sum of the products of the entries
+            // of the r'th row of a and the c'th column of b, so size a->n.
+            const float *a_p = a->data + r * a_rs;
+            const float *b_p = b->data + c * b_cs;
+            float sum = 0;
+            for (size_t k = 0; k < a->n; k++) {
+                sum += *a_p * *b_p;
+                a_p += a_cs;
+                b_p += b_rs;
+            }
+            *out_p++ = sum * scale;
+        }
+    }
+}
+
 // pybricks.tools.Matrix.__init__
 static mp_obj_t pb_type_Matrix_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     PB_PARSE_ARGS_CLASS(n_args, n_kw, args,
@@ -50,10 +152,7 @@ static mp_obj_t pb_type_Matrix_make_new(const mp_obj_type_t *type, size_t n_args
     }
 
     // Create objects and save dimensions
-    pb_type_Matrix_obj_t *self = mp_obj_malloc(pb_type_Matrix_obj_t, type);
-    self->m = m;
-    self->n = n;
-    self->data = m_new(float, m * n);
+    pb_type_Matrix_obj_t *self = pb_type_Matrix_new(type, m, n);
 
     // Iterate through each of the rows to get the scalars
     for (size_t r = 0; r < m; r++) {
@@ -71,10 +170,6 @@ static mp_obj_t pb_type_Matrix_make_new(const mp_obj_type_t *type, size_t n_args
         }
     }
 
-    // Modifiers that allow basic modifications without moving data around
-    self->scale = 1;
-    self->transposed = false;
-
     return MP_OBJ_FROM_PTR(self);
 }
 
@@ -178,7 +273,12 @@ void pb_type_Matrix_print(const mp_print_t *print, mp_obj_t self_in, mp_print_ki
 }
 
 // pybricks.tools.Matrix._add
-static mp_obj_t pb_type_Matrix__add(mp_obj_t lhs_obj, mp_obj_t rhs_obj, bool add) {
+static mp_obj_t pb_type_Matrix__add(mp_obj_t lhs_obj, mp_obj_t rhs_obj, bool add, bool inplace) {
+
+    // Only matrices can be added to matrices
+    if (!mp_obj_is_type(rhs_obj, &pb_type_Matrix)) {
+        return MP_OBJ_NULL;
+    }
 
     // Get left and right matrices
     pb_type_Matrix_obj_t *lhs = MP_OBJ_TO_PTR(lhs_obj);
@@ -189,35 +289,15 @@ static mp_obj_t pb_type_Matrix__add(mp_obj_t lhs_obj, mp_obj_t rhs_obj, bool add
         pb_assert(PBIO_ERROR_INVALID_ARG);
     }
 
-    // Result has same shape as both sides
-    pb_type_Matrix_obj_t *ret = mp_obj_malloc(pb_type_Matrix_obj_t, &pb_type_Matrix);
-    ret->m = lhs->m;
-    ret->n = rhs->n;
-    ret->data = m_new(float, ret->m * ret->n);
-
-    // Scale must be reset; it has been and multiplied out above
-    ret->scale = 1;
-    ret->transposed = false;
-
-    // Add the matrices by looping over rows and columns
-    for (size_t r = 0; r < ret->m; r++) {
-        for (size_t c = 0; c < ret->n; c++) {
-            // This entry is obtained as the sum of scalars of both matrices
-            // First find the index of sources and destination.
-            size_t ret_idx = r * ret->n + c;
-            size_t lhs_idx = lhs->transposed ? c * ret->m + r : ret_idx;
-            size_t rhs_idx = rhs->transposed ? c * ret->m + r : ret_idx;
-
-            // Either add or subtract to get result.
-            if (add) {
-                ret->data[ret_idx] = lhs->data[lhs_idx] * lhs->scale + rhs->data[rhs_idx] * rhs->scale;
-            } else {
-                ret->data[ret_idx] = lhs->data[lhs_idx] * lhs->scale - rhs->data[rhs_idx] * rhs->scale;
-            }
-
-        }
+    // Update the left hand side without allocating a new matrix if we can.
+    if (inplace && lhs->owns_data && !pb_type_Matrix_is_transposed_view(lhs, rhs)) {
+        pb_type_Matrix_add_kernel(lhs, lhs, rhs, add);
+        return lhs_obj;
     }
 
+    // Result has same shape as both sides
+    pb_type_Matrix_obj_t *ret = pb_type_Matrix_new(&pb_type_Matrix, lhs->m, lhs->n);
+    pb_type_Matrix_add_kernel(ret, lhs, rhs, add);
     return MP_OBJ_FROM_PTR(ret);
 }
 
@@ -234,38 +314,15 @@ static mp_obj_t pb_type_Matrix__mul(mp_obj_t lhs_in, mp_obj_t rhs_in) {
     }
 
     // Result has as many rows as left hand side and as many columns as right hand side.
-    pb_type_Matrix_obj_t *ret = mp_obj_malloc(pb_type_Matrix_obj_t, &pb_type_Matrix);
-    ret->m = lhs->m;
-    ret->n = rhs->n;
-    ret->data = m_new(float, ret->m * ret->n);
-
-    // Scale is commutative, so we can do it separately
-    ret->scale = lhs->scale * rhs->scale;
-    ret->transposed = false;
-
-    // Multiply the matrices by looping over rows and columns
-    for (size_t r = 0; r < ret->m; r++) {
-        for (size_t c = 0; c < ret->n; c++) {
-            // This entry is obtained as the sum of the products of the entries
-            // of the r'th row of lhs and the c'th column of rhs, so size lhs->n.
-            float sum = 0;
-            for (size_t k = 0; k < lhs->n; k++) {
-                // k'th entry on the r'th row (i = r, j = k)
-                size_t lhs_idx = lhs->transposed ? k * lhs->m + r : r * lhs->n + k;
-                // k'th entry on the c'th column  (i = k, j = c)
-                size_t rhs_idx = rhs->transposed ? c * rhs->m + k : k * rhs->n + c;
-                sum += lhs->data[lhs_idx] * rhs->data[rhs_idx];
-            }
-            ret->data[ret->n * r + c] = sum;
-        }
-    }
+    pb_type_Matrix_obj_t *ret = pb_type_Matrix_new(&pb_type_Matrix, lhs->m, rhs->n);
+    pb_type_Matrix_mul_kernel(ret, lhs, rhs);
 
     // If the result is a 1x1, return as scalar. This solves all the
     // usual matrix library problems where you have to type things like
     // C[0][0] just to get the scalar, such as for the inner product of two
     // vectors. The same is done for 1x1 initialization above.
     if (ret->m == 1 && ret->n == 1) {
-        return mp_obj_new_float_from_f(ret->data[0] * ret->scale);
+        return mp_obj_new_float_from_f(ret->data[0]);
     }
 
     return MP_OBJ_FROM_PTR(ret);
@@ -275,18 +332,40 @@ static mp_obj_t pb_type_Matrix__mul(mp_obj_t lhs_in, mp_obj_t rhs_in) {
 static mp_obj_t pb_type_Matrix__scale(mp_obj_t self_in, float scale) {
     pb_type_Matrix_obj_t *self = MP_OBJ_TO_PTR(self_in);
 
-    pb_type_Matrix_obj_t *copy = mp_obj_malloc(pb_type_Matrix_obj_t, &pb_type_Matrix);
+    // Copy the data, so that the result does not change along with the
+    // original when it is modified in place.
+    pb_type_Matrix_obj_t *copy = pb_type_Matrix_new(&pb_type_Matrix, self->m, self->n);
 
-    // Point to the same data instead of copying
-    copy->data = self->data;
-    copy->n = self->n;
-    copy->m = self->m;
-    copy->scale = self->scale * scale;
-    copy->transposed = self->transposed;
+    size_t rs, cs;
+    pb_type_Matrix_get_strides(self, &rs, &cs);
+    scale *= self->scale;
+    float *out_p = copy->data;
+    for (size_t r = 0; r < self->m; r++) {
+        for (size_t c = 0; c < self->n; c++) {
+            *out_p++ = self->data[r * rs + c * cs] * scale;
+        }
+    }
 
     return MP_OBJ_FROM_PTR(copy);
 }
 
+// pybricks.tools.Matrix._scale_inplace
+static mp_obj_t pb_type_Matrix__scale_inplace(mp_obj_t self_in, float scale) {
+    pb_type_Matrix_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // Views share data, so return a scaled copy instead.
+    if (!self->owns_data) {
+        return pb_type_Matrix__scale(self_in, scale);
+    }
+
+    // Scale the data, so that views of this matrix see the change too.
+    float *p = self->data;
+    for (size_t i = 0; i < self->m * self->n; i++) {
+        *p++ *= scale;
+    }
+    return self_in;
+}
+
 // pybricks.tools.Matrix._get_scalar
 float pb_type_Matrix_get_scalar(mp_obj_t self_in, size_t r, size_t c) {
     pb_type_Matrix_obj_t *self = MP_OBJ_TO_PTR(self_in);
@@ -311,6 +390,7 @@ static mp_obj_t pb_type_Matrix__T(mp_obj_t self_in) {
     copy->m = self->n;
     copy->scale = self->scale;
     copy->transposed = !self->transposed;
+    copy->owns_data = false;
 
     return MP_OBJ_FROM_PTR(copy);
 }
@@ -335,6 +415,8 @@ static void pb_type_Matrix_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
             dest[0] = mp_obj_new_tuple(2, shape);
             return;
         }
+        // Continue lookup in locals dict.
+        dest[1] = MP_OBJ_SENTINEL;
     }
 }
 
@@ -376,91 +458,122 @@ static mp_obj_t pb_type_Matrix_binary_op(mp_binary_op_t op, mp_obj_t lhs_in, mp_
 
     switch (op) {
         case MP_BINARY_OP_ADD:
+            return pb_type_Matrix__add(lhs_in, rhs_in, true, false);
         case MP_BINARY_OP_INPLACE_ADD:
-            return pb_type_Matrix__add(lhs_in, rhs_in, true);
+            return pb_type_Matrix__add(lhs_in, rhs_in, true, true);
         case MP_BINARY_OP_SUBTRACT:
+            return pb_type_Matrix__add(lhs_in, rhs_in, false, false);
         case MP_BINARY_OP_INPLACE_SUBTRACT:
-            return pb_type_Matrix__add(lhs_in, rhs_in, false);
+            return pb_type_Matrix__add(lhs_in, rhs_in, false, true);
         case MP_BINARY_OP_MULTIPLY:
-        case MP_BINARY_OP_INPLACE_MULTIPLY:
             // If right of operand is a number, just scale to be faster
             if (mp_obj_is_float(rhs_in) || mp_obj_is_int(rhs_in)) {
                 return pb_type_Matrix__scale(lhs_in, mp_obj_get_float_to_f(rhs_in));
             }
             // Otherwise we have to do full multiplication.
             return pb_type_Matrix__mul(lhs_in, rhs_in);
+        case MP_BINARY_OP_INPLACE_MULTIPLY:
+            if (mp_obj_is_float(rhs_in) || mp_obj_is_int(rhs_in)) {
+                return pb_type_Matrix__scale_inplace(lhs_in, mp_obj_get_float_to_f(rhs_in));
+            }
+            // The product generally has a different shape, so it is always
+            // allocated. Use Matrix.mul() to multiply into an existing matrix.
+            return pb_type_Matrix__mul(lhs_in, rhs_in);
         case MP_BINARY_OP_REVERSE_MULTIPLY:
             // This gets called for c*A, so scale A by c (rhs/lhs is meaningless here)
             return pb_type_Matrix__scale(lhs_in, mp_obj_get_float_to_f(rhs_in));
         case MP_BINARY_OP_TRUE_DIVIDE:
-        case MP_BINARY_OP_INPLACE_TRUE_DIVIDE:
             // Scalar division by c is scalar multiplication by 1/c
             return pb_type_Matrix__scale(lhs_in, 1 / mp_obj_get_float_to_f(rhs_in));
+        case MP_BINARY_OP_INPLACE_TRUE_DIVIDE:
+            return pb_type_Matrix__scale_inplace(lhs_in, 1 / mp_obj_get_float_to_f(rhs_in));
         default:
             // Other operations not supported
             return MP_OBJ_NULL;
     }
 }
 
-static mp_obj_t pb_type_Matrix_subscr(mp_obj_t self_in, mp_obj_t index_in, mp_obj_t value_in) {
+// Gets the data index of the entry at the given integer index or (row, col)
+// pair, or -1 if there is no such entry.
+static mp_int_t pb_type_Matrix_get_index(pb_type_Matrix_obj_t *self, mp_obj_t index_in) {
 
-    pb_type_Matrix_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    // Integer index is just reading straight from self->data[idx].
+    // But we need to do some checks to make sure we read within bounds.
+    mp_int_t len = self->m * self->n;
+    mp_int_t idx = -1;
 
-    if (value_in == MP_OBJ_SENTINEL) {
-        // Integer index is just reading straight from self->data[idx].
-        // But we need to do some checks to make sure we read within bounds.
-        mp_int_t len = self->m * self->n;
-        mp_int_t idx = -1;
-
-        if (mp_obj_is_int(index_in)) {
-            // Get requested index as int
-            idx = mp_obj_get_int(index_in);
-
-            // This is Python, so allow for negative index
-            if (idx < 0) {
-                idx += len;
-            }
+    if (mp_obj_is_int(index_in)) {
+        // Get requested index as int
+        idx = mp_obj_get_int(index_in);
 
-            // Data may be stored as transposed for efficiency reasons,
-            // but the user will still expect a consistent value by index.
-            if (self->transposed) {
-                idx = idx / self->n + (idx % self->n) * self->m;
+        // This is Python, so allow for negative index
+        if (idx < 0) {
+            idx += len;
+        }
+
+        // Data may be stored as transposed for efficiency reasons,
+        // but the user will still expect a consistent value by index.
+        if (self->transposed) {
+            idx = idx / self->n + (idx % self->n) * self->m;
+        }
+    } else {
+        // Get requested value at (row, col) pair
+        size_t s;
+        mp_obj_t *shape;
+        mp_obj_get_array(index_in, &s, &shape);
+
+        // Only proceed if the index is indeed of shape (row, col)
+        if (s == 2) {
+            // Get row index, allowing for negative
+            mp_int_t r = mp_obj_get_int(shape[0]);
+            if (r < 0) {
+                r += self->m;
             }
-        } else {
-            // Get requested value at (row, col) pair
-            size_t s;
-            mp_obj_t *shape;
-            mp_obj_get_array(index_in, &s, &shape);
-
-            // Only proceed if the index is indeed of shape (row, col)
-            if (s == 2) {
-                // Get row index, allowing for negative
-                mp_int_t r = mp_obj_get_int(shape[0]);
-                if (r < 0) {
-                    r += self->m;
-                }
-                // Get col index, allowing for negative
-                mp_int_t c = mp_obj_get_int(shape[1]);
-                if (c < 0) {
-                    c += self->n;
-                }
-                // Make sure requested row/col exist within (m, n)
-                if (c >= 0 && r >= 0 && (size_t)c < self->n && (size_t)r < self->m) {
-                    idx = self->transposed ? c * self->m + r : r * self->n + c;
-                }
+            // Get col index, allowing for negative
+            mp_int_t c = mp_obj_get_int(shape[1]);
+            if (c < 0) {
+                c += self->n;
+            }
+            // Make sure requested row/col exist within (m, n)
+            if (c >= 0 && r >= 0 && (size_t)c < self->n && (size_t)r < self->m) {
+                idx = self->transposed ? c * self->m + r : r * self->n + c;
             }
         }
+    }
 
-        // Make sure we have meanwhile a valid index by now
-        if (idx < 0 || idx >= len) {
-            // FIXME: raise dimension error
-            mp_raise_msg(&mp_type_IndexError, MP_ERROR_TEXT("index out of range"));
-        }
+    if (idx >= len) {
+        return -1;
+    }
+    return idx;
+}
+
+static mp_obj_t pb_type_Matrix_subscr(mp_obj_t self_in, mp_obj_t index_in, mp_obj_t value_in) {
+
+    pb_type_Matrix_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // Deleting entries is not supported
+    if (value_in == MP_OBJ_NULL) {
+        return MP_OBJ_NULL;
+    }
 
-        // Return result
+    // Make sure we have a valid index
+    mp_int_t idx = pb_type_Matrix_get_index(self, index_in);
+    if (idx < 0) {
+        // FIXME: raise dimension error
+        mp_raise_msg(&mp_type_IndexError, MP_ERROR_TEXT("index out of range"));
+    }
+
+    // Return result
+    if (value_in == MP_OBJ_SENTINEL) {
         return mp_obj_new_float_from_f(self->scale * self->data[idx]);
     }
-    return MP_OBJ_NULL;
+
+    // Views share data with another matrix, so they can't be written to.
+    if (!self->owns_data) {
+        pb_assert(PBIO_ERROR_INVALID_OP);
+    }
+    self->data[idx] = mp_obj_get_float_to_f(value_in);
+    return mp_const_none;
 }
 
 typedef struct {
@@ -513,6 +626,281 @@ static mp_obj_t pb_type_Matrix_getiter(mp_obj_t o_in, mp_obj_iter_buf_t *iter_bu
     return MP_OBJ_FROM_PTR(matrix_it);
 }
 
+// pybricks.tools.Matrix.set
+static mp_obj_t pb_type_Matrix_set(mp_obj_t self_in, mp_obj_t a_in) {
+    pb_type_Matrix_obj_t *a = pb_type_Matrix_get(a_in);
+    pb_type_Matrix_obj_t *self = pb_type_Matrix_get_out(self_in, a->m, a->n);
+
+    if (pb_type_Matrix_is_transposed_view(self, a)) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    size_t a_rs, a_cs;
+    pb_type_Matrix_get_strides(a, &a_rs, &a_cs);
+
+    float *out_p = self->data;
+    for (size_t r = 0; r < self->m; r++) {
+        const float *a_p = a->data + r * a_rs;
+        for (size_t c = 0; c < self->n; c++) {
+            *out_p++ = *a_p * a->scale;
+            a_p += a_cs;
+        }
+    }
+    return self_in;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(pb_type_Matrix_set_obj, pb_type_Matrix_set);
+
+// pybricks.tools.Matrix.mul
+static mp_obj_t pb_type_Matrix_mul(mp_obj_t self_in, mp_obj_t a_in, mp_obj_t b_in) {
+    pb_type_Matrix_obj_t *a = pb_type_Matrix_get(a_in);
+    pb_type_Matrix_obj_t *b = pb_type_Matrix_get(b_in);
+
+    if (a->n != b->m) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    pb_type_Matrix_obj_t *self = pb_type_Matrix_get_out(self_in, a->m, b->n);
+
+    // Each entry depends on a whole row and column of the inputs, so they
+    // can't be stored in the output.
+    if (a->data == self->data || b->data == self->data) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    pb_type_Matrix_mul_kernel(self, a, b);
+    return self_in;
+}
+static MP_DEFINE_CONST_FUN_OBJ_3(pb_type_Matrix_mul_obj, pb_type_Matrix_mul);
+
+// pybricks.tools.Matrix.outer
+static mp_obj_t pb_type_Matrix_outer(mp_obj_t self_in, mp_obj_t a_in, mp_obj_t b_in) {
+    pb_type_Matrix_obj_t *a = pb_type_Matrix_get(a_in);
+    pb_type_Matrix_obj_t *b = pb_type_Matrix_get(b_in);
+
+    // Both must be vectors. Their data is in order either way.
+    if ((a->m != 1 && a->n != 1) || (b->m != 1 && b->n != 1)) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    pb_type_Matrix_obj_t *self = pb_type_Matrix_get_out(self_in, a->m * a->n, b->m * b->n);
+
+    if (a->data == self->data || b->data == self->data) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    float scale = a->scale * b->scale;
+    float *out_p = self->data;
+    for (size_t r = 0; r < self->m; r++) {
+        float a_r = a->data[r] * scale;
+        const float *b_p = b->data;
+        for (size_t c = 0; c < self->n; c++) {
+            *out_p++ = a_r * *b_p++;
+        }
+    }
+    return self_in;
+}
+static MP_DEFINE_CONST_FUN_OBJ_3(pb_type_Matrix_outer_obj, pb_type_Matrix_outer);
+
+// pybricks.tools.Matrix.inv
+static mp_obj_t pb_type_Matrix_inv(mp_obj_t self_in, mp_obj_t a_in) {
+    pb_type_Matrix_obj_t *a = pb_type_Matrix_get(a_in);
+    size_t n = a->n;
+
+    if (a->m != n || n > PB_TYPE_MATRIX_INV_MAX) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    pb_type_Matrix_obj_t *self = pb_type_Matrix_get_out(self_in, n, n);
+
+    // Gauss-Jordan elimination reduces a copy of a to the identity matrix,
+    // while the same row operations turn the identity matrix into the
+    // inverse. Working on copies lets the output be the same as a, and
+    // leaves the output unchanged if a is singular.
+    float work[PB_TYPE_MATRIX_INV_MAX * PB_TYPE_MATRIX_INV_MAX];
+    float inv[PB_TYPE_MATRIX_INV_MAX * PB_TYPE_MATRIX_INV_MAX];
+
+    size_t a_rs, a_cs;
+    pb_type_Matrix_get_strides(a, &a_rs, &a_cs);
+    for (size_t r = 0; r < n; r++) {
+        for (size_t c = 0; c < n; c++) {
+            work[r * n + c] = a->data[r * a_rs + c * a_cs] * a->scale;
+            inv[r * n + c] = r == c;
+        }
+    }
+
+    for (size_t k = 0; k < n; k++) {
+
+        // Use the largest remaining entry in this column as the pivot.
+        size_t pivot = k;
+        for (size_t r = k + 1; r < n; r++) {
+            if (fabsf(work[r * n + k]) > fabsf(work[pivot * n + k])) {
+                pivot = r;
+            }
+        }
+        if (!(fabsf(work[pivot * n + k]) > 0)) {
+            pb_assert(PBIO_ERROR_INVALID_ARG);
+        }
+
+        // Move it to the diagonal and scale that row so the pivot is 1.
+        float *work_k = &work[k * n];
+        float *inv_k = &inv[k * n];
+        float *work_p = &work[pivot * n];
+        float *inv_p = &inv[pivot * n];
+        float f = 1 / work_p[k];
+        for (size_t c = 0; c < n; c++) {
+            float w = work_p[c];
+            float i = inv_p[c];
+            work_p[c] = work_k[c];
+            inv_p[c] = inv_k[c];
+            work_k[c] = w * f;
+            inv_k[c] = i * f;
+        }
+
+        // Eliminate this column from all other rows.
+        for (size_t r = 0; r < n; r++) {
+            float *work_r = &work[r * n];
+            float *inv_r = &inv[r * n];
+            f = work_r[k];
+            if (r == k || f == 0) {
+                continue;
+            }
+            for (size_t c = 0; c < n; c++) {
+                work_r[c] -= f * work_k[c];
+                inv_r[c] -= f * inv_k[c];
+            }
+        }
+    }
+
+    memcpy(self->data, inv, n * n * sizeof(float));
+    return self_in;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(pb_type_Matrix_inv_obj, pb_type_Matrix_inv);
+
+// pybricks.tools.Matrix.cholesky
+static mp_obj_t pb_type_Matrix_cholesky(mp_obj_t self_in, mp_obj_t a_in) {
+    pb_type_Matrix_obj_t *a = pb_type_Matrix_get(a_in);
+    size_t n = a->n;
+
+    if (a->m != n) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    pb_type_Matrix_obj_t *self = pb_type_Matrix_get_out(self_in, n, n);
+
+    size_t a_rs, a_cs;
+    pb_type_Matrix_get_strides(a, &a_rs, &a_cs);
+
+    // Computes lower triangular L such that a = L * L.T, one row at a time.
+    // This only reads the lower triangle of a, and each entry is read
+    // before it is replaced by L, so the output may be a itself.
+    float *l = self->data;
+    for (size_t i = 0; i < n; i++) {
+        float *l_i = &l[i * n];
+        for (size_t j = 0; j <= i; j++) {
+            float *l_j = &l[j * n];
+            float sum = a->data[i * a_rs + j * a_cs] * a->scale;
+            for (size_t k = 0; k < j; k++) {
+                sum -= l_i[k] * l_j[k];
+            }
+            if (i != j) {
+                l_i[j] = sum / l_j[j];
+                continue;
+            }
+            // Matrix must be positive definite.
+            if (!(sum > 0)) {
+                pb_assert(PBIO_ERROR_INVALID_ARG);
+            }
+            l_i[i] = sqrtf(sum);
+        }
+    }
+
+    // Clear the upper triangle.
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = i + 1; j < n; j++) {
+            l[i * n + j] = 0;
+        }
+    }
+    return self_in;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(pb_type_Matrix_cholesky_obj, pb_type_Matrix_cholesky);
+
+// pybricks.tools.Matrix.cho_solve
+static mp_obj_t pb_type_Matrix_cho_solve(mp_obj_t self_in, mp_obj_t l_in, mp_obj_t b_in) {
+    pb_type_Matrix_obj_t *l = pb_type_Matrix_get(l_in);
+    pb_type_Matrix_obj_t *b = pb_type_Matrix_get(b_in);
+    size_t n = l->n;
+
+    if (l->m != n || b->m != n) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    pb_type_Matrix_obj_t *self = pb_type_Matrix_get_out(self_in, n, b->n);
+
+    // The output may be b, but not L.
+    if (l->data == self->data || pb_type_Matrix_is_transposed_view(self, b)) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    size_t l_rs, l_cs, b_rs, b_cs;
+    pb_type_Matrix_get_strides(l, &l_rs, &l_cs);
+    pb_type_Matrix_get_strides(b, &b_rs, &b_cs);
+
+    // Check diagonal first so the output is unchanged on failure.
+    for (size_t i = 0; i < n; i++) {
+        if (l->data[i * (l_rs + l_cs)] == 0) {
+            pb_assert(PBIO_ERROR_INVALID_ARG);
+        }
+    }
+
+    // The factor L may be scaled by s, which scales L * L.T by s^2.
+    float scale = 1 / (l->scale * l->scale);
+
+    // Solve (L * L.T) * x = b one column at a time.
+    size_t stride = self->n;
+    for (size_t c = 0; c < stride; c++) {
+        float *x = self->data + c;
+
+        // Forward substitution solves L * y = b.
+        for (size_t i = 0; i < n; i++) {
+            const float *l_p = l->data + i * l_rs;
+            float sum = b->data[i * b_rs + c * b_cs] * b->scale;
+            for (size_t k = 0; k < i; k++) {
+                sum -= *l_p * x[k * stride];
+                l_p += l_cs;
+            }
+            x[i * stride] = sum / *l_p;
+        }
+
+        // Back substitution solves L.T * x = y.
+        for (size_t i = n; i-- > 0;) {
+            const float *l_p = l->data + (n - 1) * l_rs + i * l_cs;
+            float sum = x[i * stride];
+            for (size_t k = n - 1; k > i; k--) {
+                sum -= *l_p * x[k * stride];
+                l_p -= l_rs;
+            }
+            x[i * stride] = sum / *l_p;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            x[i * stride] *= scale;
+        }
+    }
+    return self_in;
+}
+static MP_DEFINE_CONST_FUN_OBJ_3(pb_type_Matrix_cho_solve_obj, pb_type_Matrix_cho_solve);
+
+// dir(pybricks.tools.Matrix)
+static const mp_rom_map_elem_t pb_type_Matrix_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_set),         MP_ROM_PTR(&pb_type_Matrix_set_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_mul),         MP_ROM_PTR(&pb_type_Matrix_mul_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_outer),       MP_ROM_PTR(&pb_type_Matrix_outer_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_inv),         MP_ROM_PTR(&pb_type_Matrix_inv_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_cholesky),    MP_ROM_PTR(&pb_type_Matrix_cholesky_obj)  },
+    { MP_ROM_QSTR(MP_QSTR_cho_solve),   MP_ROM_PTR(&pb_type_Matrix_cho_solve_obj) },
+};
+static MP_DEFINE_CONST_DICT(pb_type_Matrix_locals_dict, pb_type_Matrix_locals_dict_table);
+
 // type(pybricks.tools.Matrix)
 MP_DEFINE_CONST_OBJ_TYPE(pb_type_Matrix,
     MP_QSTR_Matrix,
@@ -523,24 +911,26 @@ MP_DEFINE_CONST_OBJ_TYPE(pb_type_Matrix,
     unary_op, pb_type_Matrix_unary_op,
     binary_op, pb_type_Matrix_binary_op,
     subscr, pb_type_Matrix_subscr,
-    iter, pb_type_Matrix_getiter);
+    iter, pb_type_Matrix_getiter,
+    locals_dict, &pb_type_Matrix_locals_dict);
 
 // pybricks.tools._make_vector
 mp_obj_t pb_type_Matrix_make_vector(size_t m, float *data, bool normalize) {
 
     // Create object and save dimensions
-    pb_type_Matrix_obj_t *mat = mp_obj_malloc(pb_type_Matrix_obj_t, &pb_type_Matrix);
-    mat->m = m;
-    mat->n = 1;
-    mat->data = m_new(float, m);
+    pb_type_Matrix_obj_t *mat = pb_type_Matrix_new(&pb_type_Matrix, m, 1);
 
-    // Copy data and compute norm
+    // Compute norm
     float squares = 0;
     for (size_t i = 0; i < m; i++) {
-        mat->data[i] = data[i];
         squares += data[i] * data[i];
     }
-    mat->scale = normalize ? 1 / sqrtf(squares) : 1;
+    float scale = normalize ? 1 / sqrtf(squares) : 1;
+
+    // Copy data
+    for (size_t i = 0; i < m; i++) {
+        mat->data[i] = data[i] * scale;
+    }
 
     return MP_OBJ_FROM_PTR(mat);
 }
@@ -549,14 +939,10 @@ mp_obj_t pb_type_Matrix_make_vector(size_t m, float *data, bool normalize) {
 mp_obj_t pb_type_Matrix_make_bitmap(size_t m, size_t n, float scale, uint32_t src) {
 
     // Create object and save dimensions
-    pb_type_Matrix_obj_t *mat = mp_obj_malloc(pb_type_Matrix_obj_t, &pb_type_Matrix);
-    mat->m = m;
-    mat->n = n;
-    mat->scale = scale;
-    mat->data = m_new(float, m * n);
+    pb_type_Matrix_obj_t *mat = pb_type_Matrix_new(&pb_type_Matrix, m, n);
 
     for (size_t i = 0; i < m * n; i++) {
-        mat->data[m * n - i - 1] = (src & (1 << i)) != 0;
+        mat->data[m * n - i - 1] = (src & (1 << i)) ? scale : 0;
     }
 
     return MP_OBJ_FROM_PTR(mat);
@@ -589,16 +975,13 @@ static mp_obj_t pb_type_matrix_cross(mp_obj_t a_in, mp_obj_t b_in) {
     }
 
     // Create c vector.
-    pb_type_Matrix_obj_t *c = mp_obj_malloc(pb_type_Matrix_obj_t, &pb_type_Matrix);
-    c->m = 3;
-    c->n = 1;
-    c->data = m_new(float, 3);
+    pb_type_Matrix_obj_t *c = pb_type_Matrix_new(&pb_type_Matrix, 3, 1);
 
     // Evaluate cross product
-    c->data[0] = a->data[1] * b->data[2] - a->data[2] * b->data[1];
-    c->data[1] = a->data[2] * b->data[0] - a->data[0] * b->data[2];
-    c->data[2] = a->data[0] * b->data[1] - a->data[1] * b->data[0];
-    c->scale = a->scale * b->scale;
+    float scale = a->scale * b->scale;
+    c->data[0] = (a->data[1] * b->data[2] - a->data[2] * b->data[1]) * scale;
+    c->data[1] = (a->data[2] * b->data[0] - a->data[0] * b->data[2]) * scale;
+    c->data[2] = (a->data[0] * b->data[1] - a->data[1] * b->data[0]) * scale;
 
     return MP_OBJ_FROM_PTR(c);
 }
@@ -19,6 +19,11 @@ typedef struct _pb_type_Matrix_obj_t {
     size_t m;
     size_t n;
     bool transposed;
+    // Whether data belongs to this matrix, so it can be modified in place.
+    // This is false for views such as the transpose, which share the data
+    // of another matrix. A matrix that owns its data is never transposed or
+    // scaled, so views of it remain valid when the data changes.
+    bool owns_data;
 } pb_type_Matrix_obj_t;
 
 mp_obj_t pb_type_Matrix_make_vector(size_t m, float *data, bool normalize);
@@ -14,6 +14,7 @@
 
 #include <pbio/error.h>
 #include <pbio/color.h>
+#include <pbsys/storage_settings.h>
 
 #include "py/obj.h"
 
@@ -24,24 +25,28 @@
 #include <pybricks/util_pb/pb_color_map.h>
 #include <pybricks/util_pb/pb_error.h>
 
-// This expands pbio_color_rgb_to_hsv with additional calibration steps that
-// ultimately must be properly done in pbio_color_rgb_to_hsv, just like
-// pbio_color_hsv_to_rgb, by adjusting RGB instead of hacking at the HSV value.
-void pb_color_map_rgb_to_hsv(const pbio_color_rgb_t *rgb, pbio_color_hsv_t *hsv) {
-
-    // Standard conversion
-    pbio_color_rgb_to_hsv(rgb, hsv);
-
-    // Slight shift for lower hues to make yellow somewhat more accurate
-    if (hsv->h < 40) {
-        uint8_t offset = ((hsv->h - 20) << 8) / 20;
-        int32_t scale = 200 - ((100 * (offset * offset)) >> 16);
-        hsv->h = hsv->h * scale / 100;
+// Loads the stored calibration of a color sensor, or the default calibration
+// if there is none.
+void pb_color_map_load_calibration(pbio_color_calibration_t *calibration, pbio_port_id_t port, pbdrv_legodev_type_id_t type_id, int32_t full_scale) {
+    if (!pbsys_storage_settings_get_color_calibration(port, type_id, calibration)) {
+        pbio_color_calibration_set_defaults(calibration, full_scale);
     }
+}
 
-    // Value and saturation correction
-    hsv->s = hsv->s * (200 - hsv->s) / 100;
-    hsv->v = hsv->v * (200 - hsv->v) / 100;
+// Updates the calibration of a color sensor using the raw reading of a white
+// or black reference surface, or resets it if no reference is given. The
+// result is saved so that it is used again for this sensor type on this port.
+void pb_color_map_calibrate(pbio_color_calibration_t *calibration, pbio_port_id_t port, pbdrv_legodev_type_id_t type_id, int32_t full_scale, mp_obj_t reference_in, const pbio_color_raw_t *raw) {
+    if (reference_in == mp_const_none) {
+        pbio_color_calibration_set_defaults(calibration, full_scale);
+    } else if (reference_in == MP_OBJ_FROM_PTR(&pb_Color_WHITE_obj)) {
+        pb_assert(pbio_color_calibration_set_reference(calibration, PBIO_COLOR_WHITE, raw));
+    } else if (reference_in == MP_OBJ_FROM_PTR(&pb_Color_BLACK_obj)) {
+        pb_assert(pbio_color_calibration_set_reference(calibration, PBIO_COLOR_BLACK, raw));
+    } else {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+    pbsys_storage_settings_save_color_calibration(port, type_id, calibration);
 }
 
 static const mp_rom_obj_tuple_t pb_color_map_default = {
@@ -57,37 +62,69 @@ static const mp_rom_obj_tuple_t pb_color_map_default = {
     }
 };
 
-// Set initial default map
-void pb_color_map_save_default(mp_obj_t *color_map) {
-    *color_map = MP_OBJ_FROM_PTR(&pb_color_map_default);
-}
+// Detectable colors along with their precomputed coordinates in the HSV
+// bicone, so that matching a color does not need to unpack the colors or
+// compute the sine and cosine of each hue.
+typedef struct _pb_color_map_obj_t {
+    mp_obj_base_t base;
+    // Colors as given by the user.
+    mp_obj_t colors;
+    // Number of colors.
+    size_t num_colors;
+    // Color objects in the order given.
+    mp_obj_t *color_objs;
+    // Bicone coordinates of each color.
+    pbio_color_bicone_t *bicones;
+} pb_color_map_obj_t;
 
-// Get a discrete color that matches the given hsv values most closely
-mp_obj_t pb_color_map_get_color(mp_obj_t *color_map, pbio_color_hsv_t *hsv) {
+static MP_DEFINE_CONST_OBJ_TYPE(pb_type_color_map,
+    MP_QSTR_ColorMap,
+    MP_TYPE_FLAG_NONE);
+
+// Compiles a sequence of colors into a color map
+static mp_obj_t pb_color_map_compile(mp_obj_t colors_in) {
 
-    // Unpack the main list
-    mp_obj_t *colors;
+    // Unpack the main list, ensuring all elements have the right type
+    mp_obj_t *color_objs;
     size_t n;
-    mp_obj_get_array(*color_map, &n, &colors);
+    mp_obj_get_array(colors_in, &n, &color_objs);
+    for (size_t i = 0; i < n; i++) {
+        pb_assert_type(color_objs[i], &pb_type_Color);
+    }
 
-    // Initialize minimal cost to maximum
-    mp_obj_t match = mp_const_none;
-    int32_t cost_now = INT32_MAX;
-    int32_t cost_min = INT32_MAX;
+    pb_color_map_obj_t *map = mp_obj_malloc(pb_color_map_obj_t, &pb_type_color_map);
+    map->colors = colors_in;
+    map->num_colors = n;
+    map->color_objs = m_new(mp_obj_t, n);
+    map->bicones = m_new(pbio_color_bicone_t, n);
 
-    // Compute cost for each candidate
     for (size_t i = 0; i < n; i++) {
+        map->color_objs[i] = color_objs[i];
+        pbio_color_hsv_to_bicone(pb_type_Color_get_hsv(color_objs[i]), &map->bicones[i]);
+    }
+    return MP_OBJ_FROM_PTR(map);
+}
 
-        // Evaluate the cost function
-        cost_now = pbio_color_get_bicone_squared_distance(hsv, pb_type_Color_get_hsv(colors[i]));
+// Set initial default map. It is compiled when it is first used.
+void pb_color_map_save_default(mp_obj_t *color_map) {
+    *color_map = MP_OBJ_FROM_PTR(&pb_color_map_default);
+}
 
-        // If cost is less than before, update the minimum and the match
-        if (cost_now < cost_min) {
-            cost_min = cost_now;
-            match = colors[i];
-        }
+// Get a discrete color that matches the given hsv values most closely
+mp_obj_t pb_color_map_get_color(mp_obj_t *color_map, pbio_color_hsv_t *hsv) {
+
+    // Compile the map on first use
+    if (!mp_obj_is_type(*color_map, &pb_type_color_map)) {
+        *color_map = pb_color_map_compile(*color_map);
+    }
+    pb_color_map_obj_t *map = MP_OBJ_TO_PTR(*color_map);
+
+    // Find the nearest color, if any
+    size_t match = pbio_color_bicone_get_nearest(map->bicones, map->num_colors, hsv);
+    if (match == map->num_colors) {
+        return mp_const_none;
     }
-    return match;
+    return map->color_objs[match];
 }
 
 // HACK: all color sensor structures must have color_map as second item
@@ -103,21 +140,16 @@ static mp_obj_t pupdevices_ColorDistanceSensor_detectable_colors(size_t n_args,
         pb_ColorSensor_obj_t, self,
         PB_ARG_DEFAULT_NONE(colors));
 
-    // If no arguments are given, return current map
+    // If no arguments are given, return current colors
     if (colors_in == mp_const_none) {
+        if (mp_obj_is_type(self->color_map, &pb_type_color_map)) {
+            return ((pb_color_map_obj_t *)MP_OBJ_TO_PTR(self->color_map))->colors;
+        }
         return self->color_map;
     }
 
-    // If arguments given, ensure all tuple elements have the right type
-    mp_obj_t *color_objs;
-    size_t n;
-    mp_obj_get_array(colors_in, &n, &color_objs);
-    for (size_t i = 0; i < n; i++) {
-        pb_assert_type(color_objs[i], &pb_type_Color);
-    }
-
-    // Save the given map
-    self->color_map = colors_in;
+    // Save the given map, ready for matching
+    self->color_map = pb_color_map_compile(colors_in);
 
     return mp_const_none;
 }
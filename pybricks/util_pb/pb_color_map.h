@@ -4,11 +4,16 @@
 #ifndef _PBHSV_H_
 #define _PBHSV_H_
 
+#include <pbdrv/legodev.h>
+
 #include <pbio/color.h>
+#include <pbio/port.h>
 
 #include "py/obj.h"
 
-void pb_color_map_rgb_to_hsv(const pbio_color_rgb_t *rgb, pbio_color_hsv_t *hsv);
+void pb_color_map_load_calibration(pbio_color_calibration_t *calibration, pbio_port_id_t port, pbdrv_legodev_type_id_t type_id, int32_t full_scale);
+
+void pb_color_map_calibrate(pbio_color_calibration_t *calibration, pbio_port_id_t port, pbdrv_legodev_type_id_t type_id, int32_t full_scale, mp_obj_t reference_in, const pbio_color_raw_t *raw);
 
 void pb_color_map_save_default(mp_obj_t *color_map);
 
@@ -0,0 +1,82 @@
+from pybricks.tools import Matrix, vector
+
+# In-place operations modify the matrix, so views of it see the change.
+A = Matrix([[1, 2], [3, 4]])
+B = A
+At = A.T
+A += Matrix([[1, 1], [1, 1]])
+print("A is B =", A is B)
+print("A.T =", At)
+A *= 2
+print("A *= 2 =", B)
+A /= 2
+print("A /= 2 =", B)
+
+# A transposed view of itself gives a new matrix, leaving the original as is.
+A -= A.T
+print("A is B =", A is B)
+print("A - A.T =", A)
+print("B =", B)
+
+# Setting entries.
+B[0, 1] = 10
+B[-1] = 20
+print("B =", B)
+print("B.T =", B.T)
+
+# Views can't be modified.
+try:
+    B.T[0, 0] = 1
+except OSError:
+    print("OSError")
+try:
+    B.T.set(B)
+except OSError:
+    print("OSError")
+
+# Scaling gives a new matrix, so it doesn't change along with the original.
+A = Matrix([[1, 2], [3, 4]])
+D = A * 2
+E = -A.T
+A += Matrix([[1, 1], [1, 1]])
+print("D =", D)
+print("E =", E)
+D[0, 0] = 0
+print("D =", D)
+print("A =", A)
+
+# Products into existing matrices.
+A = Matrix([[1, 2], [3, 4]])
+C = Matrix([[0, 0], [0, 0]])
+print("C.mul(A, A.T) =", C.mul(A, A.T))
+y = vector(0, 0)
+print("y.mul(A, vector(1, 1)) =", y.mul(A, vector(1, 1)))
+print("C.outer(vector(1, 2), vector(3, 4).T) =", C.outer(vector(1, 2), vector(3, 4).T))
+print("C.set(-A) =", C.set(-A))
+
+# Output of a product can't be one of the inputs.
+try:
+    C.mul(C, A)
+except ValueError:
+    print("ValueError")
+
+# Inverse, also in place.
+M = Matrix([[1, 1, 0], [0, 1, 1], [0, 0, 1]])
+N = Matrix([[0, 0, 0], [0, 0, 0], [0, 0, 0]])
+print("N.inv(M) =", N.inv(M))
+print("M.inv(M) =", M.inv(M))
+try:
+    C.inv(Matrix([[1, 2], [2, 4]]))
+except ValueError:
+    print("ValueError")
+
+# Cholesky factorization and solving.
+P = Matrix([[4, 2], [2, 5]])
+L = Matrix([[0, 0], [0, 0]])
+print("L.cholesky(P) =", L.cholesky(P))
+x = vector(0, 0)
+print("x.cho_solve(L, vector(2, 5)) =", x.cho_solve(L, vector(2, 5)))
+try:
+    L.cholesky(Matrix([[1, 2], [2, 1]]))
+except ValueError:
+    print("ValueError")
@@ -0,0 +1,61 @@
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 The Pybricks Authors
+
+"""
+Hardware Module: Any hub with pybricks.iodevices.PybricksHub.
+
+Description: Central side of the hub-to-hub stream benchmark. First load
+hub_stream_peripheral.py onto another hub and disconnect it from the
+computer so that it advertises. Then run this script. Once connected, start
+the program on the other hub with its button.
+
+It measures the round-trip latency of short messages and the sustained
+throughput of a bulk transfer to the other hub.
+"""
+
+from pybricks.iodevices import PybricksHub
+from pybricks.tools import StopWatch, wait
+
+PING_ROUNDS = 50
+TRANSFER_SIZE = 16 * 1024
+CHUNK_SIZE = 512
+
+hub = PybricksHub()
+print("Connected to", hub.name(), "with MTU", hub.mtu())
+
+print("Waiting for program on other hub to start...")
+while not hub.running():
+    wait(10)
+
+watch = StopWatch()
+
+# Round-trip latency.
+total = 0
+worst = 0
+for i in range(PING_ROUNDS):
+    message = b"P" + i.to_bytes(7, "little")
+    watch.reset()
+    hub.write(message)
+    reply = hub.read(len(message))
+    elapsed = watch.time()
+    if reply != message:
+        raise RuntimeError("bad echo")
+    total += elapsed
+    worst = max(worst, elapsed)
+
+print("Round trip:", total / PING_ROUNDS, "ms average,", worst, "ms worst")
+
+# Sustained throughput.
+chunk = bytes(i & 0xFF for i in range(CHUNK_SIZE))
+watch.reset()
+hub.write(b"T" + TRANSFER_SIZE.to_bytes(4, "little"))
+for _ in range(TRANSFER_SIZE // CHUNK_SIZE):
+    hub.write(chunk)
+if hub.read(1) != b"D":
+    raise RuntimeError("bad acknowledgement")
+elapsed = watch.time()
+
+print("Throughput:", TRANSFER_SIZE * 1000 // elapsed, "bytes/s")
+print("Dropped:", hub.dropped(), "bytes")
+
+hub.disconnect()
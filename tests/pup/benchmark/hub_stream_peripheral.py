@@ -0,0 +1,28 @@
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 The Pybricks Authors
+
+"""
+Hardware Module: Any hub with stdin/stdout support (PYBRICKS_OPT_EXTRA_MOD).
+
+Description: Peripheral side of the hub-to-hub stream benchmark. Run this on
+the first hub, then run hub_stream_central.py on a second hub. It echoes ping
+messages and acknowledges bulk transfers.
+
+Protocol:
+    - b"P" + 7 bytes: reply with the same 8 bytes.
+    - b"T" + 4 byte little endian size: consume that many bytes, then reply
+      with b"D".
+"""
+
+from usys import stdin, stdout
+
+while True:
+    command = stdin.buffer.read(1)
+
+    if command == b"P":
+        stdout.buffer.write(command + stdin.buffer.read(7))
+    elif command == b"T":
+        remaining = int.from_bytes(stdin.buffer.read(4), "little")
+        while remaining:
+            remaining -= len(stdin.buffer.read(min(remaining, 128)))
+        stdout.buffer.write(b"D")
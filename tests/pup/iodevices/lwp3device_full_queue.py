@@ -0,0 +1,60 @@
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 The Pybricks Authors
+
+"""
+Hardware Module: Any hub with pybricks.iodevices.LWP3Device, and a Technic
+Hub with the LEGO firmware.
+
+Description: Fills the LWP3Device.read() queue with a stream of accelerometer
+and gyro values from the Technic Hub and checks what is kept. Other messages
+must not be dropped, every port must still have a value, and messages must
+stay in the order they were received.
+"""
+
+from pybricks.iodevices import LWP3Device
+from pybricks.tools import wait
+
+TECHNIC_HUB = 0x80
+ACCEL_PORT = 0x61
+GYRO_PORT = 0x62
+
+PORT_VALUE = 0x45
+PORT_INPUT_FORMAT = 0x47
+
+# Same as LWP3_MAX_MESSAGE_SIZE * LWP3_NOTIFICATION_QUEUE_SIZE.
+QUEUE_SIZE = 20 * 16
+
+device = LWP3Device(TECHNIC_HUB)
+
+# Subscribe to both sensors with a delta of 1, so values keep coming.
+for port in (ACCEL_PORT, GYRO_PORT):
+    device.write(bytes([0x0A, 0x00, 0x41, port, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01]))
+
+# Don't read anything until the queue has been full for a while.
+wait(2000)
+
+# Queued messages can be read after disconnecting, but no new ones arrive.
+device.disconnect()
+
+messages = []
+while True:
+    try:
+        messages.append(device.read())
+    except OSError:
+        break
+
+assert sum(len(m) for m in messages) <= QUEUE_SIZE
+
+# Both acknowledgements were queued before the values that filled the queue.
+acks = [m[3] for m in messages if m[2] == PORT_INPUT_FORMAT]
+assert acks == [ACCEL_PORT, GYRO_PORT], acks
+
+# Replaced values go to the end of the queue, so only values come after the
+# acknowledgements.
+first_value = max(i for i, m in enumerate(messages) if m[2] == PORT_INPUT_FORMAT) + 1
+assert all(m[2] == PORT_VALUE for m in messages[first_value:])
+
+ports = set(m[3] for m in messages[first_value:])
+assert ports == {ACCEL_PORT, GYRO_PORT}, ports
+
+print("OK")
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 The Pybricks Authors
+
+"""
+Pybricks sound encoding tool.
+
+Converts a .wav file to IMA ADPCM sound data that can be played with
+Speaker.play_file(), either by downloading it along with the program or by
+passing its contents as bytes.
+
+File format (all values little endian):
+    magic               4 bytes "IMAD"
+    num-samples         uint32  number of samples
+    sample-rate         uint16  sample rate in Hz
+    predictor           int16   value of the sample before the first sample
+    step-index          uint8   initial step index, 0 to 88
+    reserved            3 bytes zero
+    data                4 bits per sample, first sample in the low bits
+"""
+
+import argparse
+import struct
+import wave
+
+MAGIC = b"IMAD"
+
+HEADER = struct.Struct("<4sIHhB3x")
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+]  # fmt: skip
+
+
+def decode_nibble(predictor, index, nibble):
+    """Decodes one sample, exactly like the hub does.
+
+    Returns:
+        The new predictor, which is the decoded sample, and the new index.
+    """
+    step = STEP_TABLE[index]
+    diff = step >> 3
+    if nibble & 4:
+        diff += step
+    if nibble & 2:
+        diff += step >> 1
+    if nibble & 1:
+        diff += step >> 2
+    if nibble & 8:
+        predictor -= diff
+    else:
+        predictor += diff
+    predictor = max(-32768, min(32767, predictor))
+    index = max(0, min(88, index + INDEX_TABLE[nibble & 7]))
+    return predictor, index
+
+
+def encode(samples, sample_rate):
+    """Encodes 16-bit samples.
+
+    Arguments:
+        samples: List of samples.
+        sample_rate: Sample rate in Hz.
+
+    Returns:
+        The encoded data, including header.
+    """
+    predictor = samples[0] if samples else 0
+    index = 0
+
+    # Find a step size that fits the start of the sound, so that the first
+    # samples are not distorted while the step size adapts.
+    if len(samples) > 1:
+        first_diff = abs(samples[1] - samples[0])
+        while index < 88 and STEP_TABLE[index] < first_diff:
+            index += 1
+
+    header = HEADER.pack(MAGIC, len(samples), sample_rate, predictor, index)
+
+    nibbles = []
+    for sample in samples:
+        # Pick the nibble that gives the decoded value closest to the sample.
+        diff = sample - predictor
+        nibble = 8 if diff < 0 else 0
+        diff = abs(diff)
+        step = STEP_TABLE[index]
+        if diff >= step:
+            nibble |= 4
+            diff -= step
+        if diff >= step >> 1:
+            nibble |= 2
+            diff -= step >> 1
+        if diff >= step >> 2:
+            nibble |= 1
+        predictor, index = decode_nibble(predictor, index, nibble)
+        nibbles.append(nibble)
+
+    if len(nibbles) % 2:
+        nibbles.append(0)
+
+    data = bytes(lo | (hi << 4) for lo, hi in zip(nibbles[0::2], nibbles[1::2]))
+    return header + data
+
+
+def decode(data):
+    """Decodes encoded data, including header.
+
+    Returns:
+        Tuple of sample list and sample rate.
+    """
+    magic, num_samples, sample_rate, predictor, index = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise ValueError("not IMA ADPCM data")
+
+    samples = []
+    for i in range(num_samples):
+        byte = data[HEADER.size + i // 2]
+        nibble = (byte >> 4) if i % 2 else (byte & 0x0F)
+        predictor, index = decode_nibble(predictor, index, nibble)
+        samples.append(predictor)
+    return samples, sample_rate
+
+
+def read_wav(in_file):
+    """Reads a .wav file as 16-bit mono samples.
+
+    Returns:
+        Tuple of sample list and sample rate.
+    """
+    with wave.open(in_file, "rb") as wav:
+        channels = wav.getnchannels()
+        width = wav.getsampwidth()
+        rate = wav.getframerate()
+        frames = wav.readframes(wav.getnframes())
+
+    # Convert each value to 16 bits. 8-bit data is unsigned, the rest is signed.
+    if width == 1:
+        values = [(b - 128) << 8 for b in frames]
+    else:
+        values = [
+            int.from_bytes(frames[i : i + width], "little", signed=True) >> (8 * (width - 2))
+            for i in range(0, len(frames), width)
+        ]
+
+    # Mix all channels.
+    samples = [
+        sum(values[i : i + channels]) // channels for i in range(0, len(values), channels)
+    ]
+    return samples, rate
+
+
+def resample(samples, rate, new_rate):
+    """Resamples using linear interpolation."""
+    if rate == new_rate or not samples:
+        return samples
+
+    count = len(samples) * new_rate // rate
+    result = []
+    for i in range(count):
+        position = i * rate / new_rate
+        index = int(position)
+        fraction = position - index
+        next_sample = samples[min(index + 1, len(samples) - 1)]
+        result.append(round(samples[index] * (1 - fraction) + next_sample * fraction))
+    return result
+
+
+def convert(in_file, out_file, sample_rate):
+    """Converts a .wav file to IMA ADPCM data."""
+    samples, rate = read_wav(in_file)
+    samples = resample(samples, rate, sample_rate)
+    out_file.write(encode(samples, sample_rate))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert a .wav file to IMA ADPCM.")
+    parser.add_argument(
+        "in_file",
+        metavar="<input-file>",
+        type=argparse.FileType("rb"),
+        help="input .wav file name",
+    )
+    parser.add_argument(
+        "out_file",
+        metavar="<output-file>",
+        type=argparse.FileType("wb"),
+        help="output file name",
+    )
+    parser.add_argument(
+        "--rate",
+        type=int,
+        default=8000,
+        help="sample rate of the output in Hz (default: 8000)",
+    )
+
+    args = parser.parse_args()
+    convert(args.in_file, args.out_file, args.rate)